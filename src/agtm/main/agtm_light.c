@@ -0,0 +1,718 @@
+/*-------------------------------------------------------------------------
+ *
+ * agtm_light.c
+ *	  Event-driven service for AGTM snapshot and xid status messages
+ *
+ * Every coordinator or datanode backend connected to AGTM normally gets its
+ * own AGTM backend, that is needed for messages bound to the transaction of
+ * the session (GXID, sequence).  Getting a global snapshot or the status of
+ * a xid is not bound to any session, so this background worker serves them
+ * for all clients in one process, waiting on the client sockets with a
+ * WaitEventSet.
+ *
+ * Snapshot requests received in the same wakeup are answered by one
+ * GetSnapshotData() call.  The snapshot is taken after all of them have been
+ * received, so it is valid for each of them.
+ *
+ * A message from client is "int32 length, int32 message type, data", the
+ * length counts itself.  A reply is "int32 length, result", where result is
+ * the same as the bytea AGTM backend returns for the message.
+ *
+ * The service listens on agtm_light_port of listen_addresses.  There is no
+ * authentication exchange, so a client is only served when pg_hba.conf
+ * trusts its host for the AGTM user and database.
+ *
+ * Portions Copyright (c) 2016, ASIAINFO BDX ADB Group
+ *
+ * IDENTIFICATION
+ *	  src/agtm/main/agtm_light.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "access/transam.h"
+#include "access/xact.h"
+#include "agtm/agtm_light.h"
+#include "agtm/agtm_msg.h"
+#include "agtm/agtm_transaction.h"
+#include "libpq/hba.h"
+#include "libpq/ip.h"
+#include "libpq/libpq.h"
+#include "libpq/pqformat.h"
+#include "libpq/pqsignal.h"
+#include "miscadmin.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/postmaster.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/procarray.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/memutils.h"
+
+#define AGTM_LIGHT_RECV_SIZE	1024
+#define AGTM_LIGHT_MAXLISTEN	64
+
+typedef struct AGtmLightClient
+{
+	pgsocket		sock;
+	int				event_pos;		/* position in light_wait_set */
+	bool			want_write;		/* waiting socket writeable */
+	bool			active;			/* in light_active */
+	bool			closed;
+	StringInfoData	in;
+	StringInfoData	out;			/* out.cursor is sent length */
+} AGtmLightClient;
+
+/* GUC parameters */
+int agtm_light_port = 0;
+int agtm_light_max_clients = 1000;
+
+static volatile sig_atomic_t got_sigterm = false;
+static volatile sig_atomic_t got_sighup = false;
+
+static MemoryContext light_context = NULL;
+static pgsocket light_listen_socks[AGTM_LIGHT_MAXLISTEN];
+static int light_nlisten = 0;
+static WaitEventSet *light_wait_set = NULL;
+static bool light_need_rebuild = false;
+
+static AGtmLightClient **light_clients = NULL;
+static int light_nclients = 0;
+static AGtmLightClient **light_active = NULL;	/* clients have I/O in this loop */
+static int light_nactive = 0;
+static AGtmLightClient *light_current_client = NULL;
+
+static StringInfoData light_reply;
+static StringInfoData light_snapshot_reply;
+static bool light_have_snapshot = false;
+
+static void AGtmLightSigterm(SIGNAL_ARGS);
+static void AGtmLightSighup(SIGNAL_ARGS);
+static void AGtmLightListen(void);
+static void AGtmLightLoadHba(void);
+static void AGtmLightRebuildWaitSet(void);
+static void AGtmLightAccept(pgsocket listen_sock);
+static bool AGtmLightCheckHba(SockAddr *raddr);
+static void AGtmLightRecv(AGtmLightClient *client);
+static void AGtmLightSend(AGtmLightClient *client);
+static void AGtmLightProcessClient(AGtmLightClient *client);
+static void AGtmLightAppendReply(AGtmLightClient *client, const char *data, int len);
+static void AGtmLightTakeSnapshot(void);
+static void AGtmLightSetActive(AGtmLightClient *client);
+static void AGtmLightCloseClient(AGtmLightClient *client);
+static void AGtmLightForgetClosed(void);
+
+/*
+ * register the service worker, called by postmaster at startup
+ */
+void
+AGtmLightRegister(void)
+{
+	BackgroundWorker	worker;
+
+	if (agtm_light_port == 0)
+		return;
+
+	MemSet(&worker, 0, sizeof(worker));
+	snprintf(worker.bgw_name, BGW_MAXLEN, "agtm light service");
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS | BGWORKER_BACKEND_DATABASE_CONNECTION;
+	worker.bgw_start_time = BgWorkerStart_RecoveryFinished;
+	worker.bgw_restart_time = 1;
+	worker.bgw_main = NULL;
+	sprintf(worker.bgw_library_name, "postgres");
+	sprintf(worker.bgw_function_name, "AGtmLightMain");
+	worker.bgw_main_arg = (Datum) 0;
+	worker.bgw_notify_pid = 0;
+
+	RegisterBackgroundWorker(&worker);
+}
+
+void
+AGtmLightMain(Datum main_arg)
+{
+	sigjmp_buf			local_sigjmp_buf;
+	WaitEvent		   *events;
+	AGtmLightClient	   *client;
+	int					max_events;
+	int					nevents;
+	int					i;
+
+	pqsignal(SIGTERM, AGtmLightSigterm);
+	pqsignal(SIGHUP, AGtmLightSighup);
+	BackgroundWorkerUnblockSignals();
+
+	/* pg_hba.conf matches roles and databases by catalog */
+	BackgroundWorkerInitializeConnection(AGTM_DBNAME, NULL);
+
+	light_context = AllocSetContextCreate(TopMemoryContext,
+										  "AGTM light service",
+										  ALLOCSET_DEFAULT_SIZES);
+	MemoryContextSwitchTo(light_context);
+
+	AGtmLightLoadHba();
+	AGtmLightListen();
+
+	/* latch, postmaster death, listen sockets and clients */
+	max_events = agtm_light_max_clients + light_nlisten + 2;
+	events = palloc(sizeof(WaitEvent) * max_events);
+	light_clients = palloc0(sizeof(AGtmLightClient*) * agtm_light_max_clients);
+	light_active = palloc0(sizeof(AGtmLightClient*) * agtm_light_max_clients);
+	initStringInfo(&light_reply);
+	initStringInfo(&light_snapshot_reply);
+
+	AGtmLightRebuildWaitSet();
+
+	ereport(LOG,
+			(errmsg("agtm light service listening on port %d", agtm_light_port)));
+
+	/*
+	 * An error while serving a message drops the client, other clients
+	 * are not affected.
+	 */
+	if (sigsetjmp(local_sigjmp_buf, 1) != 0)
+	{
+		HOLD_INTERRUPTS();
+		EmitErrorReport();
+		AbortCurrentTransaction();
+		FlushErrorState();
+		LWLockReleaseAll();
+		if (light_current_client)
+			AGtmLightCloseClient(light_current_client);
+		light_current_client = NULL;
+		MemoryContextSwitchTo(light_context);
+		RESUME_INTERRUPTS();
+	}
+	PG_exception_stack = &local_sigjmp_buf;
+
+	while (!got_sigterm)
+	{
+		if (got_sighup)
+		{
+			got_sighup = false;
+			ProcessConfigFile(PGC_SIGHUP);
+			AGtmLightLoadHba();
+		}
+
+		if (light_need_rebuild)
+			AGtmLightRebuildWaitSet();
+
+		/* don't wait when clients left by an error have data */
+		nevents = WaitEventSetWait(light_wait_set,
+								   light_nactive > 0 ? 0L : -1L,
+								   events,
+								   max_events);
+
+		for (i = 0; i < nevents; i++)
+		{
+			WaitEvent *event = &events[i];
+
+			if (event->events & WL_LATCH_SET)
+			{
+				ResetLatch(MyLatch);
+			}else if (event->events & WL_POSTMASTER_DEATH)
+			{
+				proc_exit(1);
+			}else if (event->user_data == NULL)
+			{
+				AGtmLightAccept(event->fd);
+			}else
+			{
+				client = event->user_data;
+				if (client->closed)
+					continue;
+				if (event->events & WL_SOCKET_READABLE)
+					AGtmLightRecv(client);
+				if (event->events & WL_SOCKET_WRITEABLE)
+					AGtmLightSetActive(client);
+			}
+		}
+
+		/* all messages received, answer them and send results */
+		light_have_snapshot = false;
+		for (i = 0; i < light_nactive; i++)
+		{
+			client = light_active[i];
+			if (!client->closed)
+				AGtmLightProcessClient(client);
+			if (!client->closed)
+				AGtmLightSend(client);
+		}
+		for (i = 0; i < light_nactive; i++)
+			light_active[i]->active = false;
+		light_nactive = 0;
+
+		AGtmLightForgetClosed();
+	}
+
+	proc_exit(0);
+}
+
+static void
+AGtmLightSigterm(SIGNAL_ARGS)
+{
+	int			save_errno = errno;
+
+	got_sigterm = true;
+	SetLatch(MyLatch);
+
+	errno = save_errno;
+}
+
+static void
+AGtmLightSighup(SIGNAL_ARGS)
+{
+	int			save_errno = errno;
+
+	got_sighup = true;
+	SetLatch(MyLatch);
+
+	errno = save_errno;
+}
+
+/*
+ * Listen on agtm_light_port of every listen_addresses entry, as postmaster
+ * does for the normal port.
+ */
+static void
+AGtmLightListen(void)
+{
+	char	   *rawstring;
+	List	   *elemlist;
+	ListCell   *l;
+	int			i;
+
+	for (i = 0; i < AGTM_LIGHT_MAXLISTEN; i++)
+		light_listen_socks[i] = PGINVALID_SOCKET;
+
+	/* Need a modifiable copy of ListenAddresses */
+	rawstring = pstrdup(ListenAddresses ? ListenAddresses : "");
+	if (!SplitIdentifierString(rawstring, ',', &elemlist))
+		ereport(FATAL,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid list syntax in parameter \"%s\"",
+						"listen_addresses")));
+
+	foreach(l, elemlist)
+	{
+		char	   *curhost = (char *) lfirst(l);
+
+		(void) StreamServerPort(AF_UNSPEC,
+								strcmp(curhost, "*") == 0 ? NULL : curhost,
+								(unsigned short) agtm_light_port,
+								NULL,
+								light_listen_socks,
+								AGTM_LIGHT_MAXLISTEN);
+	}
+	list_free(elemlist);
+	pfree(rawstring);
+
+	for (i = 0; i < AGTM_LIGHT_MAXLISTEN; i++)
+	{
+		if (light_listen_socks[i] == PGINVALID_SOCKET)
+			continue;
+		if (!pg_set_noblock(light_listen_socks[i]))
+			ereport(FATAL,
+					(errcode_for_socket_access(),
+					 errmsg("could not set socket to nonblocking mode: %m")));
+		light_listen_socks[light_nlisten++] = light_listen_socks[i];
+	}
+
+	if (light_nlisten == 0)
+		ereport(FATAL,
+				(errmsg("could not create any TCP/IP sockets for agtm light service")));
+}
+
+/*
+ * load_hba() keeps the parsed lines under PostmasterContext, which
+ * InitPostgres has deleted in this process, so make our own.
+ */
+static void
+AGtmLightLoadHba(void)
+{
+	if (PostmasterContext == NULL)
+		PostmasterContext = AllocSetContextCreate(TopMemoryContext,
+												  "Postmaster",
+												  ALLOCSET_DEFAULT_SIZES);
+	if (!load_hba())
+		ereport(LOG,
+				(errmsg("pg_hba.conf not reloaded")));
+}
+
+/*
+ * WaitEventSet can not remove a event, so make a new one after some
+ * clients closed
+ */
+static void
+AGtmLightRebuildWaitSet(void)
+{
+	AGtmLightClient	   *client;
+	int					i;
+
+	if (light_wait_set)
+		FreeWaitEventSet(light_wait_set);
+
+	light_wait_set = CreateWaitEventSet(light_context,
+										agtm_light_max_clients + light_nlisten + 2);
+	AddWaitEventToSet(light_wait_set, WL_LATCH_SET, PGINVALID_SOCKET, MyLatch, NULL);
+	AddWaitEventToSet(light_wait_set, WL_POSTMASTER_DEATH, PGINVALID_SOCKET, NULL, NULL);
+	for (i = 0; i < light_nlisten; i++)
+		AddWaitEventToSet(light_wait_set, WL_SOCKET_READABLE, light_listen_socks[i], NULL, NULL);
+	for (i = 0; i < light_nclients; i++)
+	{
+		client = light_clients[i];
+		Assert(!client->closed);
+		client->event_pos = AddWaitEventToSet(light_wait_set,
+											  client->want_write ?
+											  WL_SOCKET_READABLE | WL_SOCKET_WRITEABLE :
+											  WL_SOCKET_READABLE,
+											  client->sock,
+											  NULL,
+											  client);
+	}
+
+	light_need_rebuild = false;
+}
+
+static void
+AGtmLightAccept(pgsocket listen_sock)
+{
+	AGtmLightClient	   *client;
+	SockAddr			raddr;
+	pgsocket			sock;
+	int					on = 1;
+
+	MemSet(&raddr, 0, sizeof(raddr));
+	raddr.salen = sizeof(raddr.addr);
+	sock = accept(listen_sock, (struct sockaddr *) &raddr.addr, &raddr.salen);
+	if (sock == PGINVALID_SOCKET)
+	{
+		if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+			ereport(LOG,
+					(errcode_for_socket_access(),
+					 errmsg("could not accept new connection: %m")));
+		return;
+	}
+
+	/*
+	 * closed clients still count until end of this loop, the client will
+	 * retry by a normal AGTM connection
+	 */
+	if (light_nclients >= agtm_light_max_clients)
+	{
+		ereport(LOG,
+				(errmsg("too many agtm light service clients, max is %d",
+						agtm_light_max_clients)));
+		closesocket(sock);
+		return;
+	}
+
+	if (!pg_set_noblock(sock))
+	{
+		ereport(LOG,
+				(errcode_for_socket_access(),
+				 errmsg("could not set socket to nonblocking mode: %m")));
+		closesocket(sock);
+		return;
+	}
+#ifdef TCP_NODELAY
+	(void) setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char *) &on, sizeof(on));
+#endif
+
+	client = palloc0(sizeof(*client));
+	client->sock = sock;
+	initStringInfo(&client->in);
+	initStringInfo(&client->out);
+	client->event_pos = AddWaitEventToSet(light_wait_set,
+										  WL_SOCKET_READABLE,
+										  sock,
+										  NULL,
+										  client);
+	light_clients[light_nclients++] = client;
+
+	/* an error in the check drops the client */
+	light_current_client = client;
+	if (!AGtmLightCheckHba(&raddr))
+		AGtmLightCloseClient(client);
+	light_current_client = NULL;
+}
+
+/*
+ * The service has no authentication exchange, so only serve hosts which
+ * pg_hba.conf trusts for the user and database of AGTM connections.  Any
+ * other client gets closed and falls back to a normal AGTM connection,
+ * which authenticates as configured.
+ */
+static bool
+AGtmLightCheckHba(SockAddr *raddr)
+{
+	Port		port;
+	char		remote_host[NI_MAXHOST];
+	bool		trusted;
+
+	MemSet(&port, 0, sizeof(port));
+	memcpy(&port.raddr, raddr, sizeof(port.raddr));
+	port.database_name = AGTM_DBNAME;
+	port.user_name = AGTM_USER;
+
+	StartTransactionCommand();
+	hba_getauthmethod(&port);
+	trusted = (port.hba->auth_method == uaTrust);
+	CommitTransactionCommand();
+	MemoryContextSwitchTo(light_context);
+
+	if (!trusted)
+	{
+		remote_host[0] = '\0';
+		(void) pg_getnameinfo_all(&raddr->addr, raddr->salen,
+								  remote_host, sizeof(remote_host),
+								  NULL, 0,
+								  NI_NUMERICHOST | NI_NUMERICSERV);
+		ereport(LOG,
+				(errmsg("agtm light service connection from host \"%s\" rejected, "
+						"pg_hba.conf does not trust it for user \"%s\", database \"%s\"",
+						remote_host, AGTM_USER, AGTM_DBNAME)));
+	}
+
+	return trusted;
+}
+
+static void
+AGtmLightRecv(AGtmLightClient *client)
+{
+	int			rc;
+
+	enlargeStringInfo(&client->in, AGTM_LIGHT_RECV_SIZE);
+	rc = recv(client->sock,
+			  client->in.data + client->in.len,
+			  client->in.maxlen - client->in.len - 1,
+			  0);
+	if (rc < 0)
+	{
+		if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+			return;
+		ereport(COMMERROR,
+				(errcode_for_socket_access(),
+				 errmsg("could not receive data from agtm light client: %m")));
+		AGtmLightCloseClient(client);
+		return;
+	}else if (rc == 0)
+	{
+		/* client closed connection */
+		AGtmLightCloseClient(client);
+		return;
+	}
+
+	client->in.len += rc;
+	client->in.data[client->in.len] = '\0';
+	AGtmLightSetActive(client);
+}
+
+static void
+AGtmLightSend(AGtmLightClient *client)
+{
+	int			rc;
+
+	while (client->out.cursor < client->out.len)
+	{
+		rc = send(client->sock,
+				  client->out.data + client->out.cursor,
+				  client->out.len - client->out.cursor,
+				  0);
+		if (rc < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			ereport(COMMERROR,
+					(errcode_for_socket_access(),
+					 errmsg("could not send data to agtm light client: %m")));
+			AGtmLightCloseClient(client);
+			return;
+		}
+		client->out.cursor += rc;
+	}
+
+	if (client->out.cursor == client->out.len)
+	{
+		resetStringInfo(&client->out);
+		if (client->want_write)
+		{
+			ModifyWaitEvent(light_wait_set, client->event_pos, WL_SOCKET_READABLE, NULL);
+			client->want_write = false;
+		}
+	}else if (client->want_write == false)
+	{
+		ModifyWaitEvent(light_wait_set,
+						client->event_pos,
+						WL_SOCKET_READABLE | WL_SOCKET_WRITEABLE,
+						NULL);
+		client->want_write = true;
+	}
+}
+
+static void
+AGtmLightProcessClient(AGtmLightClient *client)
+{
+	StringInfoData	msg;
+	uint32			n32;
+	int				len;
+	int				msg_type;
+
+	light_current_client = client;
+	while (client->in.len - client->in.cursor >= 4)
+	{
+		memcpy(&n32, client->in.data + client->in.cursor, 4);
+		len = (int) ntohl(n32);
+		if (len < 8 || len > AGTM_LIGHT_MAX_REQUEST)
+		{
+			ereport(COMMERROR,
+					(errcode(ERRCODE_PROTOCOL_VIOLATION),
+					 errmsg("invalid agtm light message length %d", len)));
+			AGtmLightCloseClient(client);
+			break;
+		}
+		if (client->in.len - client->in.cursor < len)
+			break;	/* wait more data */
+
+		msg.data = client->in.data + client->in.cursor + 4;
+		msg.len = msg.maxlen = len - 4;
+		msg.cursor = 0;
+		client->in.cursor += len;
+
+		msg_type = pq_getmsgint(&msg, 4);
+		switch (msg_type)
+		{
+			case AGTM_MSG_SNAPSHOT_GET_IF_CHANGED:
+				if ((uint64) pq_getmsgint64(&msg) == ProcArrayGetCommitSeq())
+				{
+					pq_getmsgend(&msg);
+					n32 = htonl(AGTM_SNAPSHOT_UNCHANGED_RESULT);
+					AGtmLightAppendReply(client, (char *) &n32, 4);
+					break;
+				}
+				/* fall through */
+			case AGTM_MSG_SNAPSHOT_GET:
+				pq_getmsgend(&msg);
+				if (!light_have_snapshot)
+					AGtmLightTakeSnapshot();
+				AGtmLightAppendReply(client,
+									 light_snapshot_reply.data,
+									 light_snapshot_reply.len);
+				break;
+			case AGTM_MSG_GET_XACT_STATUS:
+				resetStringInfo(&light_reply);
+				ProcessGetXactStatus(&msg, &light_reply);
+				AGtmLightAppendReply(client, light_reply.data, light_reply.len);
+				break;
+			case AGTM_MSG_GET_XACT_STATUS_BATCH:
+				resetStringInfo(&light_reply);
+				ProcessGetXactStatusBatch(&msg, &light_reply);
+				AGtmLightAppendReply(client, light_reply.data, light_reply.len);
+				break;
+			default:
+				ereport(COMMERROR,
+						(errcode(ERRCODE_PROTOCOL_VIOLATION),
+						 errmsg("unsupported agtm light message type %d", msg_type)));
+				AGtmLightCloseClient(client);
+				break;
+		}
+		if (client->closed)
+			break;
+	}
+
+	/* discard processed messages */
+	if (!client->closed && client->in.cursor > 0)
+	{
+		client->in.len -= client->in.cursor;
+		memmove(client->in.data, client->in.data + client->in.cursor, client->in.len);
+		client->in.data[client->in.len] = '\0';
+		client->in.cursor = 0;
+	}
+	light_current_client = NULL;
+}
+
+static void
+AGtmLightAppendReply(AGtmLightClient *client, const char *data, int len)
+{
+	uint32		n32 = htonl((uint32) (len + 4));
+
+	appendBinaryStringInfo(&client->out, (char *) &n32, 4);
+	appendBinaryStringInfo(&client->out, data, len);
+}
+
+/*
+ * take one snapshot for all snapshot requests of this loop
+ */
+static void
+AGtmLightTakeSnapshot(void)
+{
+	StringInfoData	msg;
+
+	msg.data = NULL;
+	msg.len = msg.maxlen = msg.cursor = 0;
+
+	resetStringInfo(&light_snapshot_reply);
+	ProcessGetSnapshot(&msg, &light_snapshot_reply);
+
+	/* we are not in a transaction, don't hold back global xmin */
+	MyPgXact->xmin = InvalidTransactionId;
+
+	light_have_snapshot = true;
+}
+
+static void
+AGtmLightSetActive(AGtmLightClient *client)
+{
+	if (client->active)
+		return;
+	client->active = true;
+	light_active[light_nactive++] = client;
+}
+
+static void
+AGtmLightCloseClient(AGtmLightClient *client)
+{
+	if (client->closed)
+		return;
+
+	closesocket(client->sock);
+	client->sock = PGINVALID_SOCKET;
+	client->closed = true;
+}
+
+/*
+ * free closed clients, called when no client is in light_active
+ */
+static void
+AGtmLightForgetClosed(void)
+{
+	AGtmLightClient	   *client;
+	int					i;
+
+	Assert(light_nactive == 0);
+	for (i = 0; i < light_nclients;)
+	{
+		client = light_clients[i];
+		if (client->closed == false)
+		{
+			++i;
+			continue;
+		}
+
+		pfree(client->in.data);
+		pfree(client->out.data);
+		pfree(client);
+		light_clients[i] = light_clients[--light_nclients];
+		light_need_rebuild = true;
+	}
+}
@@ -60,10 +60,16 @@ ProcessAGtmCommand(StringInfo input_message, CommandDest dest)
 		case AGTM_MSG_SNAPSHOT_GET:
 			output = ProcessGetSnapshot(input_message, &buf);
 			break;
+		case AGTM_MSG_SNAPSHOT_GET_IF_CHANGED:
+			output = ProcessGetSnapshotIfChanged(input_message, &buf);
+			break;
 
 		case AGTM_MSG_GET_XACT_STATUS:
 			output = ProcessGetXactStatus(input_message, &buf);
 			break;
+		case AGTM_MSG_GET_XACT_STATUS_BATCH:
+			output = ProcessGetXactStatusBatch(input_message, &buf);
+			break;
 
 		case AGTM_MSG_SYNC_XID:
 			output = ProcessSyncXID(input_message, &buf);
@@ -115,6 +121,10 @@ ProcessAGtmCommand(StringInfo input_message, CommandDest dest)
 			} PG_END_TRY();
 			break;
 
+		case AGTM_MSG_SEQUENCE_GET_RANGE:
+			output = ProcessNextSeqRangeCommand(input_message, &buf);
+			break;
+
 		case AGTM_MSG_SEQUENCE_GET_CUR:
 			output = ProcessCurSeqCommand(input_message, &buf);
 			break;
@@ -58,6 +58,35 @@ ProcessNextSeqCommand(StringInfo message, StringInfo output)
 	return output;
 }
 
+StringInfo
+ProcessNextSeqRangeCommand(StringInfo message, StringInfo output)
+{
+	Datum seq_name_to_oid;
+	int64 count;
+	int64 first;
+	int64 last;
+	int64 increment;
+
+	seq_name_to_oid= prase_to_agtm_sequence_name(message);
+	memcpy(&count, pq_getmsgbytes(message, sizeof(count)), sizeof(count));
+	pq_getmsgend(message);
+
+	if (count <= 0)
+		ereport(ERROR,
+			(errmsg("invalid sequence range count " INT64_FORMAT, count)));
+
+	first = nextval_range(DatumGetObjectId(seq_name_to_oid), count,
+						  &last, &increment);
+
+	/* Respond to the client */
+	pq_sendint(output, AGTM_SEQUENCE_GET_RANGE_RESULT, 4);
+	pq_sendbytes(output, (char *)&first, sizeof(first));
+	pq_sendbytes(output, (char *)&last, sizeof(last));
+	pq_sendbytes(output, (char *)&increment, sizeof(increment));
+
+	return output;
+}
+
 StringInfo
 ProcessCurSeqCommand(StringInfo message, StringInfo output)
 {
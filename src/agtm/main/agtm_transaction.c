@@ -71,6 +71,7 @@ StringInfo ProcessGetSnapshot(StringInfo message, StringInfo output)
 {
 	Snapshot			snapshot;
 	TimestampTz			globalXactStartTimestamp;
+	uint64				commit_seq;
 	static SnapshotData GlobalAgtmSnapshotData = {
 		NULL,
 		InvalidTransactionId,
@@ -92,6 +93,8 @@ StringInfo ProcessGetSnapshot(StringInfo message, StringInfo output)
 
 	pq_getmsgend(message);
 	globalXactStartTimestamp = GetCurrentTimestamp();
+	/* must be read before the snapshot, see ProcArrayGetCommitSeq */
+	commit_seq = ProcArrayGetCommitSeq();
 	snapshot = GetSnapshotData(&GlobalAgtmSnapshotData);
 
 	/* Respond to the client */
@@ -116,10 +119,30 @@ StringInfo ProcessGetSnapshot(StringInfo message, StringInfo output)
 	pq_sendbytes(output, (char *)&snapshot->curcid, sizeof(snapshot->curcid));
 	pq_sendbytes(output, (char *)&snapshot->active_count, sizeof(snapshot->active_count));
 	pq_sendbytes(output, (char *)&snapshot->regd_count, sizeof(snapshot->regd_count));
+	pq_sendint64(output, commit_seq);
 
 	return output;
 }
 
+/*
+ * Client sends count of ended transactions its last snapshot reflects,
+ * a new snapshot is only taken and sent when the count changed.
+ */
+StringInfo ProcessGetSnapshotIfChanged(StringInfo message, StringInfo output)
+{
+	uint64				commit_seq;
+
+	commit_seq = (uint64) pq_getmsgint64(message);
+	if (commit_seq == ProcArrayGetCommitSeq())
+	{
+		pq_getmsgend(message);
+		pq_sendint(output, AGTM_SNAPSHOT_UNCHANGED_RESULT, 4);
+		return output;
+	}
+
+	return ProcessGetSnapshot(message, output);
+}
+
 StringInfo
 ProcessGetXactStatus(StringInfo message, StringInfo output)
 {
@@ -140,6 +163,35 @@ ProcessGetXactStatus(StringInfo message, StringInfo output)
 	return output;
 }
 
+StringInfo
+ProcessGetXactStatusBatch(StringInfo message, StringInfo output)
+{
+	TransactionId	xids[AGTM_XACT_STATUS_BATCH_MAX];
+	XidStatus		xid_status;
+	XLogRecPtr		xid_lsn;
+	int				count;
+	int				i;
+
+	count = pq_getmsgint(message, sizeof(count));
+	if (count < 0 || count > AGTM_XACT_STATUS_BATCH_MAX)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("invalid xid count %d in xid status request", count)));
+	pq_copymsgbytes(message, (char *)xids, sizeof(TransactionId) * count);
+	pq_getmsgend(message);
+
+	/* Respond to the client */
+	pq_sendint(output, AGTM_GET_XACT_STATUS_BATCH_RESULT, 4);
+	pq_sendint(output, count, 4);
+	for (i = 0; i < count; i++)
+	{
+		xid_status = TransactionIdGetStatus(xids[i], &xid_lsn);
+		pq_sendbytes(output, (char *)&xid_status, sizeof(XidStatus));
+	}
+
+	return output;
+}
+
 StringInfo
 ProcessSyncXID(StringInfo message, StringInfo output)
 {
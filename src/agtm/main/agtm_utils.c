@@ -15,7 +15,9 @@ const char *gtm_util_message_name(AGTM_MessageType type)
 	CASE_TYPE_(AGTM_MSG_GET_TIMESTAMP);
 	CASE_TYPE_(AGTM_MSG_GXID_LIST);
 	CASE_TYPE_(AGTM_MSG_SNAPSHOT_GET);
+	CASE_TYPE_(AGTM_MSG_SNAPSHOT_GET_IF_CHANGED);
 	CASE_TYPE_(AGTM_MSG_GET_XACT_STATUS);
+	CASE_TYPE_(AGTM_MSG_GET_XACT_STATUS_BATCH);
 	CASE_TYPE_(AGTM_MSG_SYNC_XID);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_INIT);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_ALTER);
@@ -24,6 +26,7 @@ const char *gtm_util_message_name(AGTM_MessageType type)
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_RENAME);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_RENAME_BYDB);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_GET_NEXT);
+	CASE_TYPE_(AGTM_MSG_SEQUENCE_GET_RANGE);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_GET_CUR);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_GET_LAST);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_SET_VAL);
@@ -43,7 +46,9 @@ const char *gtm_util_result_name(AGTM_ResultType type)
 	CASE_TYPE_(AGTM_GET_TIMESTAMP_RESULT);
 	CASE_TYPE_(AGTM_GXID_LIST_RESULT);
 	CASE_TYPE_(AGTM_SNAPSHOT_GET_RESULT);
+	CASE_TYPE_(AGTM_SNAPSHOT_UNCHANGED_RESULT);
 	CASE_TYPE_(AGTM_GET_XACT_STATUS_RESULT);
+	CASE_TYPE_(AGTM_GET_XACT_STATUS_BATCH_RESULT);
 	CASE_TYPE_(AGTM_SYNC_XID_RESULT);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_INIT_RESULT);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_ALTER_RESULT);
@@ -52,6 +57,7 @@ const char *gtm_util_result_name(AGTM_ResultType type)
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_RENAME_RESULT);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_RENAME_BYDB_RESULT);
 	CASE_TYPE_(AGTM_SEQUENCE_GET_NEXT_RESULT);
+	CASE_TYPE_(AGTM_SEQUENCE_GET_RANGE_RESULT);
 	CASE_TYPE_(AGTM_MSG_SEQUENCE_GET_CUR_RESULT);
 	CASE_TYPE_(AGTM_SEQUENCE_GET_LAST_RESULT);
 	CASE_TYPE_(AGTM_SEQUENCE_SET_VAL_RESULT);
@@ -72,6 +72,17 @@ static relopt_bool boolRelOpts[] =
 		},
 		false
 	},
+#ifdef ADB
+	{
+		{
+			"coordinator_cache",
+			"Lets coordinators cache results of queries on this replicated table",
+			RELOPT_KIND_HEAP,
+			AccessExclusiveLock
+		},
+		false
+	},
+#endif
 	{
 		{
 			"fastupdate",
@@ -1308,6 +1319,10 @@ default_reloptions(Datum reloptions, bool validate, relopt_kind kind)
 		offsetof(StdRdOptions, user_catalog_table)},
 		{"parallel_workers", RELOPT_TYPE_INT,
 		offsetof(StdRdOptions, parallel_workers)}
+#ifdef ADB
+		,{"coordinator_cache", RELOPT_TYPE_BOOL,
+		offsetof(StdRdOptions, coordinator_cache)}
+#endif
 	};
 
 	options = parseRelOptions(reloptions, validate, kind, &numoptions);
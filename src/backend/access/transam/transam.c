@@ -27,6 +27,7 @@
 #ifdef ADB
 #include "agtm/agtm.h"
 #include "pgxc/pgxc.h"
+#include "pgxc/xactstatuscache.h"
 #include "storage/proc.h"
 #include "utils/tqual.h"
 #include <time.h>
@@ -179,7 +180,8 @@ bool TransactionIdDidCommitGTM(TransactionId transactionId, bool try_gtm)
 #ifdef ADB
 		if (try_gtm &&
 			IsUnderAGTM() &&
-			XidInMVCCSnapshot(transactionId, GetRecentGTMSnapshot(false)))
+			XidInMVCCSnapshot(transactionId, GetRecentGTMSnapshot(false)) &&
+			!XactStatusCacheCompleted(transactionId, GetRecentGTMSnapshot(false)))
 		{
 			time_t now,end;
 			end = time(0);
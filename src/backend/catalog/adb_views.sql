@@ -26,6 +26,28 @@ LANGUAGE 'plpgsql';
 CREATE VIEW pgxc_prepared_xacts AS
     SELECT DISTINCT * from pgxc_prepared_xact();
 
+CREATE VIEW pg_stat_progress_redistribute AS
+	SELECT
+		S.pid AS pid, S.datid AS datid, D.datname AS datname,
+		S.relid AS relid,
+		CASE S.param1 WHEN 0 THEN 'initializing'
+					  WHEN 1 THEN 'copying data out'
+					  WHEN 2 THEN 'deleting moved data'
+					  WHEN 3 THEN 'copying data in'
+					  WHEN 4 THEN 'truncating table'
+					  WHEN 5 THEN 'rebuilding indexes'
+					  WHEN 6 THEN 'waiting for final lock'
+					  WHEN 7 THEN 'updating locator'
+					  END AS phase,
+		S.param2 AS buckets_total, S.param3 AS buckets_moved,
+		S.param4 AS tuples_moved, S.param5 AS bytes_moved,
+		clock_timestamp() - A.query_start AS elapsed,
+		(S.param5 / GREATEST(extract(epoch FROM clock_timestamp() - A.query_start), 0.001))::bigint
+			AS bytes_per_second
+    FROM pg_stat_get_progress_info('REDISTRIBUTE') AS S
+		 JOIN pg_database D ON S.datid = D.oid
+		 LEFT JOIN pg_stat_get_activity(NULL) AS A ON S.pid = A.pid;
+
 CREATE OR REPLACE VIEW rxact_get_running AS
     SELECT r.gid,r.database,CASE WHEN n.node_name IS NULL THEN 'AGTM' ELSE n.node_name END,r.backend,r.type,r.status[r.i]
       FROM (SELECT *,generate_series(1,array_length(nodes,1)) AS i
@@ -91,6 +91,7 @@
 #include "intercomm/inter-comm.h"
 #include "pgxc/execRemote.h"
 #include "pgxc/pgxc.h"
+#include "pgxc/seqcache.h"
 #endif
 
 /*
@@ -1256,6 +1257,10 @@ doDeletion(const ObjectAddress *object, int flags)
 						heap_drop_with_catalog(object->objectId);
 				}
 #ifdef ADB
+				/* each coordinator running the DROP discards its ranges */
+				if (relKind == RELKIND_SEQUENCE)
+					SeqCacheInvalidate(object->objectId);
+
 				/*
 				 * Do not do extra process if this session is connected to a remote
 				 * Coordinator.
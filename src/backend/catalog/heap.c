@@ -85,12 +85,15 @@
 #include "commands/dbcommands.h"
 #include "intercomm/inter-node.h"
 #include "nodes/makefuncs.h"
+#include "optimizer/planner.h"
 #include "optimizer/reduceinfo.h"
 #include "parser/parse_func.h"
 #include "pgxc/locator.h"
 #include "pgxc/nodemgr.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
+#include "utils/array.h"
+#include "utils/typcache.h"
 
 extern bool distribute_by_replication_default;
 #endif
@@ -1330,6 +1333,137 @@ GetUserDefinedDistribution(Oid relid,
 	pfree(funcargs);
 }
 
+/*
+ * GetRangeDistribution
+ *
+ * Parse the ranges of "DISTRIBUTE BY RANGE(column, [node,] bound, ...)",
+ * bounds are constants of the column type in ascending order, and when
+ * nodes are given each range names its node.
+ */
+static void
+GetRangeDistribution(Oid relid,
+					 DistributeBy *distributeby,
+					 TupleDesc descriptor,
+					 AttrNumber attnum,
+					 Datum *rangebounds,
+					 List **rangenodes)
+{
+	Form_pg_attribute attr = descriptor->attrs[attnum - 1];
+	TypeCacheEntry *typentry;
+	ParseState *pstate;
+	ListCell   *lc;
+	Datum	   *bounds;
+	List	   *nodes = NIL;
+	Oid			arraytype;
+	int			nbounds = 0;
+	int			i;
+
+	Assert(distributeby->disttype == DISTTYPE_RANGE);
+
+	arraytype = get_array_type(attr->atttypid);
+	typentry = lookup_type_cache(attr->atttypid, TYPECACHE_CMP_PROC_FINFO);
+	if (!OidIsValid(arraytype) || !OidIsValid(typentry->cmp_proc_finfo.fn_oid))
+		ereport(ERROR,
+				(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+				 errmsg("Column \"%s\" is not range distributable data type",
+						distributeby->colname)));
+
+	pstate = make_parsestate(NULL);
+	bounds = palloc(sizeof(Datum) * list_length(distributeby->funcargs));
+	i = 0;
+	foreach(lc, distributeby->funcargs)
+	{
+		Node	   *arg = lfirst(lc);
+		Node	   *expr;
+		Const	   *bound;
+
+		/* a single name is the node of next range */
+		if (IsA(arg, ColumnRef) &&
+			list_length(((ColumnRef *) arg)->fields) == 1 &&
+			IsA(linitial(((ColumnRef *) arg)->fields), String))
+		{
+			char   *node_name = strVal(linitial(((ColumnRef *) arg)->fields));
+			Oid		noid = get_pgxc_nodeoid(node_name);
+
+			if (!OidIsValid(noid))
+				ereport(ERROR,
+						(errcode(ERRCODE_UNDEFINED_OBJECT),
+						 errmsg("PGXC Node \"%s\": object not defined", node_name)));
+			if (get_pgxc_nodetype(noid) != PGXC_NODE_DATANODE)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("PGXC node \"%s\": not a Datanode", node_name)));
+			if (i % 2 != 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("Invalid range specified for \"RANGE\""),
+						 errhint("Valid syntax input: RANGE(column, [node,] bound, [node,] bound, ... [, node])")));
+			nodes = lappend_oid(nodes, noid);
+			i++;
+			continue;
+		}
+
+		expr = transformExpr(pstate, arg, EXPR_KIND_COLUMN_DEFAULT);
+		expr = coerce_to_target_type(pstate,
+									 expr, exprType(expr),
+									 attr->atttypid, attr->atttypmod,
+									 COERCION_ASSIGNMENT,
+									 COERCE_IMPLICIT_CAST,
+									 -1);
+		if (expr == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATATYPE_MISMATCH),
+					 errmsg("range bound is not of type %s",
+							format_type_be(attr->atttypid)),
+					 parser_errposition(pstate, exprLocation(arg))));
+		assign_expr_collations(pstate, expr);
+		expr = (Node *) expression_planner((Expr *) expr);
+		if (!IsA(expr, Const) || ((Const *) expr)->constisnull)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+					 errmsg("range bound must be a not null constant"),
+					 parser_errposition(pstate, exprLocation(arg))));
+		bound = (Const *) expr;
+
+		if (nbounds > 0 &&
+			DatumGetInt32(FunctionCall2Coll(&typentry->cmp_proc_finfo,
+											attr->attcollation,
+											bounds[nbounds - 1],
+											bound->constvalue)) >= 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+					 errmsg("range bounds must be in strictly ascending order"),
+					 parser_errposition(pstate, exprLocation(arg))));
+		bounds[nbounds++] = bound->constvalue;
+		if (nodes != NIL)
+			i++;
+	}
+
+	if (nodes != NIL && list_length(nodes) != nbounds + 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_SYNTAX_ERROR),
+				 errmsg("Invalid range specified for \"RANGE\""),
+				 errdetail("Each of %d ranges should be given a node.", nbounds + 1),
+				 errhint("Valid syntax input: RANGE(column, [node,] bound, [node,] bound, ... [, node])")));
+
+	if (rangebounds)
+	{
+		if (nbounds > 0)
+			*rangebounds = PointerGetDatum(construct_array(bounds, nbounds,
+														   attr->atttypid,
+														   attr->attlen,
+														   attr->attbyval,
+														   attr->attalign));
+		else
+			*rangebounds = (Datum) 0;
+	}
+	if (rangenodes)
+		*rangenodes = nodes;
+
+	pfree(bounds);
+	free_parsestate(pstate);
+}
+
 /* --------------------------------
 *	   AddRelationDistribution
 *
@@ -1354,6 +1488,8 @@ AddRelationDistribution(Oid relid,
 	Oid				funcid = InvalidOid;
 	int				numatts = 0;
 	int16		   *attnums = NULL;
+	Datum			rangebounds = (Datum) 0;
+	List		   *rangenodes = NIL;
 
 	/* Obtain details of nodes and classify them */
 	if (IsDnNode())
@@ -1375,7 +1511,9 @@ AddRelationDistribution(Oid relid,
 								 &attnum,
 								 &funcid,
 								 &numatts,
-								 &attnums);
+								 &attnums,
+								 &rangebounds,
+								 &rangenodes);
 
 	/*
 	 * 1st column of auxiliary table is default auxiliary column,
@@ -1417,7 +1555,8 @@ AddRelationDistribution(Oid relid,
 
 	/* Now OK to insert data in catalog */
 	PgxcClassCreate(relid, locatortype, attnum, hashalgorithm,
-					hashbuckets, numnodes, nodeoids, funcid, numatts, attnums);
+					hashbuckets, numnodes, nodeoids, funcid, numatts, attnums,
+					rangebounds, rangenodes);
 
 	/* Make dependency entries */
 	myself.classId = PgxcClassRelationId;
@@ -1453,7 +1592,9 @@ GetRelationDistributionItems(Oid relid,
 							AttrNumber *attnum,
 							Oid *funcid,
 							int *numatts,
-							int16 **attnums)
+							int16 **attnums,
+							Datum *rangebounds,
+							List **rangenodes)
 {
 	int local_hashalgorithm = 0;
 	int local_hashbuckets = 0;
@@ -1497,6 +1638,7 @@ GetRelationDistributionItems(Oid relid,
 		switch (distributeby->disttype)
 		{
 			case DISTTYPE_HASH:
+			case DISTTYPE_BUCKET:
 				/*
 				 * Validate user-specified hash column.
 				 * System columns cannot be used.
@@ -1545,6 +1687,28 @@ GetRelationDistributionItems(Oid relid,
 				}
 				break;
 
+			case DISTTYPE_RANGE:
+				/*
+				 * Validate user specified range column.
+				 * System columns cannot be used.
+				 */
+				local_attnum = get_attnum(relid, distributeby->colname);
+				if (local_attnum <= 0 && local_attnum >= -(int) lengthof(SysAtt))
+				{
+					ereport(ERROR,
+							(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+							 errmsg("Invalid distribution column specified")));
+				}
+				local_locatortype = LOCATOR_TYPE_RANGE;
+				if (rangebounds || rangenodes)
+					GetRangeDistribution(relid,
+										 distributeby,
+										 descriptor,
+										 local_attnum,
+										 rangebounds,
+										 rangenodes);
+				break;
+
 			case DISTTYPE_REPLICATION:
 				local_locatortype = LOCATOR_TYPE_REPLICATED;
 				break;
@@ -1576,7 +1740,10 @@ GetRelationDistributionItems(Oid relid,
 	/* Use default hash values */
 	if (local_locatortype == LOCATOR_TYPE_HASH)
 	{
-		local_hashalgorithm = 1;
+		if (distributeby && distributeby->disttype == DISTTYPE_BUCKET)
+			local_hashalgorithm = LOCATOR_HASH_BUCKET;
+		else
+			local_hashalgorithm = LOCATOR_HASH_MODULO;
 		local_hashbuckets = HASH_SIZE;
 	}
 
@@ -27,6 +27,101 @@
 #include "pgxc/locator.h"
 #include "utils/array.h"
 
+static Datum BuildBucketMapDatum(const Oid *map, int nbuckets,
+								 const Oid *nodes, int numnodes);
+static Oid *GetOldBucketMap(HeapTuple tup);
+static int GetRangeCount(Datum rangebounds);
+
+/*
+ * BuildBucketMapDatum
+ *		Make the int2[] value of pcbucketmap, each bucket is stored as the
+ *		index of its node in nodeoids.
+ */
+static Datum
+BuildBucketMapDatum(const Oid *map, int nbuckets, const Oid *nodes, int numnodes)
+{
+	Datum	   *indexes;
+	ArrayType  *array;
+	int			i, j;
+
+	indexes = palloc(sizeof(Datum) * nbuckets);
+	for (i = 0; i < nbuckets; i++)
+	{
+		for (j = 0; j < numnodes; j++)
+		{
+			if (nodes[j] == map[i])
+				break;
+		}
+		Assert(j < numnodes);
+		indexes[i] = Int16GetDatum((int16) j);
+	}
+
+	array = construct_array(indexes, nbuckets, INT2OID, sizeof(int16), true, 's');
+	pfree(indexes);
+
+	return PointerGetDatum(array);
+}
+
+/*
+ * GetOldBucketMap
+ *		Get node Oid of each bucket or range from a pgxc_class tuple, NULL if
+ *		the table is not distributed by buckets or ranges.
+ */
+static Oid *
+GetOldBucketMap(HeapTuple tup)
+{
+	Form_pgxc_class pgxc_class = (Form_pgxc_class) GETSTRUCT(tup);
+	ArrayType  *array;
+	Datum		datum;
+	bool		isnull;
+	int16	   *indexes;
+	Oid		   *map;
+	int			nbuckets;
+	int			i;
+
+	if (pgxc_class->pclocatortype != LOCATOR_TYPE_RANGE &&
+		(pgxc_class->pclocatortype != LOCATOR_TYPE_HASH ||
+		 pgxc_class->pchashalgorithm != LOCATOR_HASH_BUCKET))
+		return NULL;
+
+	datum = SysCacheGetAttr(PGXCCLASSRELID, tup,
+							Anum_pgxc_class_pcbucketmap, &isnull);
+	if (isnull)
+		return NULL;
+
+	array = DatumGetArrayTypeP(datum);
+	nbuckets = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	if (pgxc_class->pclocatortype == LOCATOR_TYPE_HASH &&
+		nbuckets != pgxc_class->pchashbuckets)
+		return NULL;
+
+	indexes = (int16 *) ARR_DATA_PTR(array);
+	map = palloc(sizeof(Oid) * nbuckets);
+	for (i = 0; i < nbuckets; i++)
+	{
+		if (indexes[i] < 0 || indexes[i] >= pgxc_class->nodeoids.dim1)
+			elog(ERROR, "invalid bucket map of relation %u", pgxc_class->pcrelid);
+		map[i] = pgxc_class->nodeoids.values[indexes[i]];
+	}
+
+	return map;
+}
+
+/*
+ * GetRangeCount
+ *		Number of ranges of a table with given pcrangebounds, no bounds is
+ *		one range.
+ */
+static int
+GetRangeCount(Datum rangebounds)
+{
+	ArrayType  *array;
+
+	if (rangebounds == (Datum) 0)
+		return 1;
+	array = DatumGetArrayTypeP(rangebounds);
+	return ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array)) + 1;
+}
 
 /*
  * PgxcClassCreate
@@ -42,7 +137,9 @@ PgxcClassCreate(Oid pcrelid,
 				Oid *nodes,
 				Oid pcfuncid,
 				int numatts,
-				int16 *pcfuncattnums)
+				int16 *pcfuncattnums,
+				Datum pcrangebounds,
+				List *rangenodes)
 {
 	Relation	pgxcclassrel;
 	HeapTuple	htup;
@@ -71,11 +168,43 @@ PgxcClassCreate(Oid pcrelid,
 		values[Anum_pgxc_class_pcattnum - 1] = UInt16GetDatum(pcattnum);
 		values[Anum_pgxc_class_pchashalgorithm - 1] = UInt16GetDatum(pchashalgorithm);
 		values[Anum_pgxc_class_pchashbuckets - 1] = UInt16GetDatum(pchashbuckets);
+	} else if (pclocatortype == LOCATOR_TYPE_RANGE)
+	{
+		values[Anum_pgxc_class_pcattnum - 1] = UInt16GetDatum(pcattnum);
 	}
 
 	/* Node information */
 	values[Anum_pgxc_class_nodes - 1] = PointerGetDatum(nodes_array);
 
+	/* Initial bucket map, buckets are spread evenly on nodes */
+	if (pclocatortype == LOCATOR_TYPE_HASH &&
+		pchashalgorithm == LOCATOR_HASH_BUCKET &&
+		numnodes > 0)
+	{
+		Oid		   *map = MakeBucketMap(pchashbuckets, NULL, nodes, numnodes);
+
+		values[Anum_pgxc_class_pcbucketmap - 1] =
+			BuildBucketMapDatum(map, pchashbuckets, nodes, numnodes);
+		pfree(map);
+	} else if (pclocatortype == LOCATOR_TYPE_RANGE && numnodes > 0)
+	{
+		int			nranges = GetRangeCount(pcrangebounds);
+		Oid		   *map = MakeRangeMap(nranges, rangenodes, NULL, nodes, numnodes);
+
+		values[Anum_pgxc_class_pcbucketmap - 1] =
+			BuildBucketMapDatum(map, nranges, nodes, numnodes);
+		pfree(map);
+	} else
+	{
+		nulls[Anum_pgxc_class_pcbucketmap - 1] = true;
+	}
+
+	/* Range bounds */
+	if (pclocatortype == LOCATOR_TYPE_RANGE && pcrangebounds != (Datum) 0)
+		values[Anum_pgxc_class_pcrangebounds - 1] = pcrangebounds;
+	else
+		nulls[Anum_pgxc_class_pcrangebounds - 1] = true;
+
 	if (pclocatortype == LOCATOR_TYPE_USER_DEFINED)
 	{
 		Assert(OidIsValid(pcfuncid));
@@ -121,12 +250,21 @@ PgxcClassAlter(Oid pcrelid,
 			   PgxcClassAlterType type,
 			   Oid pcfuncid,
 			   int numatts,
-			   int16 *pcfuncattnums)
+			   int16 *pcfuncattnums,
+			   Datum pcrangebounds,
+			   List *rangenodes)
 {
 	Relation	rel;
 	HeapTuple	oldtup, newtup;
+	Form_pgxc_class old_class;
 	oidvector  *nodes_array;
 	int2vector	*attrs_array = NULL;
+	char		new_locatortype;
+	int			new_hashalgorithm;
+	int			new_hashbuckets;
+	int			new_numnodes;
+	Oid		   *new_nodes;
+	Datum		new_rangebounds;
 
 	Datum		new_record[Natts_pgxc_class];
 	bool		new_record_nulls[Natts_pgxc_class];
@@ -159,6 +297,7 @@ PgxcClassAlter(Oid pcrelid,
 			new_record_repl[Anum_pgxc_class_pchashbuckets - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncid - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncattnums - 1] = true;
+			new_record_repl[Anum_pgxc_class_pcrangebounds - 1] = true;
 			break;
 		case PGXC_CLASS_ALTER_NODES:
 			new_record_repl[Anum_pgxc_class_nodes - 1] = true;
@@ -173,6 +312,7 @@ PgxcClassAlter(Oid pcrelid,
 			new_record_repl[Anum_pgxc_class_nodes - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncid - 1] = true;
 			new_record_repl[Anum_pgxc_class_pcfuncattnums - 1] = true;
+			new_record_repl[Anum_pgxc_class_pcrangebounds - 1] = true;
 	}
 
 	/* Set up new fields */
@@ -242,6 +382,83 @@ PgxcClassAlter(Oid pcrelid,
 		}
 	}
 
+	/* Range bounds */
+	if (new_record_repl[Anum_pgxc_class_pcrangebounds - 1])
+	{
+		if (pclocatortype == LOCATOR_TYPE_RANGE && pcrangebounds != (Datum) 0)
+			new_record[Anum_pgxc_class_pcrangebounds - 1] = pcrangebounds;
+		else
+			new_record_nulls[Anum_pgxc_class_pcrangebounds - 1] = true;
+		new_rangebounds = pcrangebounds;
+	} else
+	{
+		bool		isnull;
+
+		new_rangebounds = SysCacheGetAttr(PGXCCLASSRELID, oldtup,
+										  Anum_pgxc_class_pcrangebounds, &isnull);
+		if (isnull)
+			new_rangebounds = (Datum) 0;
+	}
+
+	/*
+	 * Bucket map, always computed again from the final distribution and node
+	 * list.  When only the node list changes buckets stay on their node as
+	 * much as possible, so redistribution just moves the others.
+	 */
+	old_class = (Form_pgxc_class) GETSTRUCT(oldtup);
+	if (new_record_repl[Anum_pgxc_class_pclocatortype - 1])
+	{
+		new_locatortype = pclocatortype;
+		new_hashalgorithm = pchashalgorithm;
+		new_hashbuckets = pchashbuckets;
+	} else
+	{
+		new_locatortype = old_class->pclocatortype;
+		new_hashalgorithm = old_class->pchashalgorithm;
+		new_hashbuckets = old_class->pchashbuckets;
+	}
+	if (new_record_repl[Anum_pgxc_class_nodes - 1])
+	{
+		new_numnodes = numnodes;
+		new_nodes = nodes;
+	} else
+	{
+		new_numnodes = old_class->nodeoids.dim1;
+		new_nodes = old_class->nodeoids.values;
+	}
+
+	new_record_repl[Anum_pgxc_class_pcbucketmap - 1] = true;
+	if (new_locatortype == LOCATOR_TYPE_HASH &&
+		new_hashalgorithm == LOCATOR_HASH_BUCKET &&
+		new_numnodes > 0)
+	{
+		Oid		   *old_map = NULL;
+		Oid		   *map;
+
+		if (type == PGXC_CLASS_ALTER_NODES)
+			old_map = GetOldBucketMap(oldtup);
+		map = MakeBucketMap(new_hashbuckets, old_map, new_nodes, new_numnodes);
+		new_record[Anum_pgxc_class_pcbucketmap - 1] =
+			BuildBucketMapDatum(map, new_hashbuckets, new_nodes, new_numnodes);
+	} else if (new_locatortype == LOCATOR_TYPE_RANGE && new_numnodes > 0)
+	{
+		int			nranges = GetRangeCount(new_rangebounds);
+		Oid		   *old_map = NULL;
+		Oid		   *map;
+
+		/* Ranges of remaining nodes stay, others merge to neighbour range */
+		if (type == PGXC_CLASS_ALTER_NODES)
+			old_map = GetOldBucketMap(oldtup);
+		map = MakeRangeMap(nranges,
+						   type == PGXC_CLASS_ALTER_NODES ? NIL : rangenodes,
+						   old_map, new_nodes, new_numnodes);
+		new_record[Anum_pgxc_class_pcbucketmap - 1] =
+			BuildBucketMapDatum(map, nranges, new_nodes, new_numnodes);
+	} else
+	{
+		new_record_nulls[Anum_pgxc_class_pcbucketmap - 1] = true;
+	}
+
 	/* Update relation */
 	newtup = heap_modify_tuple(oldtup, RelationGetDescr(rel),
 							   new_record,
@@ -359,6 +359,9 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 	Oid			save_userid;
 	int			save_sec_context;
 	int			save_nestlevel;
+#ifdef ADB
+	List	   *remote_distinct = NIL;
+#endif
 
 	if (inh)
 		ereport(elevel,
@@ -568,6 +571,19 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 											ALLOCSET_DEFAULT_SIZES);
 		old_context = MemoryContextSwitchTo(col_context);
 
+#ifdef ADB
+		/*
+		 * Datanodes have their own statistics computed from much more rows
+		 * than our sample, use them to correct n_distinct
+		 */
+		if (acquirefunc == CnAcquireSampleRowsFunc && !inh)
+		{
+			MemoryContextSwitchTo(anl_context);
+			remote_distinct = CnGetRemoteDistinct(onerel);
+			MemoryContextSwitchTo(col_context);
+		}
+#endif /* ADB */
+
 		for (i = 0; i < attr_cnt; i++)
 		{
 			VacAttrStats *stats = vacattrstats[i];
@@ -579,6 +595,9 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 									 std_fetch_func,
 									 numrows,
 									 totalrows);
+#ifdef ADB
+			CnMergeRemoteDistinct(onerel, remote_distinct, stats, totalrows);
+#endif /* ADB */
 
 			/*
 			 * If the appropriate flavor of the n_distinct option is
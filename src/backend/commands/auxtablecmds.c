@@ -410,10 +410,10 @@ AnalyzeRewriteCreateAuxStmt(CreateAuxStmt *auxstmt)
 		case LOCATOR_TYPE_USER_DEFINED:
 		case LOCATOR_TYPE_HASH:
 		case LOCATOR_TYPE_MODULO:
+		case LOCATOR_TYPE_RANGE:
 			/* it is OK */
 			break;
 		case LOCATOR_TYPE_CUSTOM:
-		case LOCATOR_TYPE_RANGE:
 			/* not support yet */
 			break;
 		case LOCATOR_TYPE_NONE:
@@ -59,6 +59,7 @@
 #include "optimizer/reduceinfo.h"
 #include "parser/analyze.h"
 #include "pgxc/pgxc.h"
+#include "pgxc/repcache.h"
 #include "reduce/adb_reduce.h"
 #include "storage/buffile.h"
 #include "storage/bufmgr.h"
@@ -1093,6 +1094,7 @@ DoCopy(const CopyStmt *stmt, const char *queryString, uint64 *processed ADB_ONLY
 							   stmt->attlist, stmt->options);
 		cstate->range_table = range_table;
 #ifdef ADB
+		RepCacheNoteModified(range_table);
 		if(rel->rd_locator_info)
 			*processed = CoordinatorCopyFrom(cstate);
 		else
@@ -5837,6 +5839,7 @@ static TupleTableSlot* NextRowFromReduce(CopyState cstate, ExprContext *econtext
 									 state->convert_state ? state->convert_slot : state->base_slot,
 									 NULL,
 									 &nodeoid,
+									 NULL,
 									 NULL);
 			if (OidIsValid(nodeoid))
 			{
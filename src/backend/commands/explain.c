@@ -40,8 +40,10 @@
 #include "utils/xml.h"
 #ifdef ADB
 #include "catalog/pgxc_node.h"
+#include "executor/nodeClusterReduce.h"
 #include "intercomm/inter-node.h"
 #include "optimizer/pgxcplan.h"
+#include "pgxc/execRemote.h"
 #include "pgxc/pgxcnode.h"
 #endif
 
@@ -118,6 +120,9 @@ static void show_instrumentation_count(const char *qlabel, int which,
 static void show_foreignscan_info(ForeignScanState *fsstate, ExplainState *es);
 static const char *explain_get_index_name(Oid indexId);
 static void show_buffer_usage(ExplainState *es, const BufferUsage *usage);
+#ifdef ADB
+static void show_cluster_instrument(ClusterInstrumentation *ci, ExplainState *es);
+#endif
 static void ExplainIndexScanDetails(Oid indexid, ScanDirection indexorderdir,
 						ExplainState *es);
 static void ExplainScanTarget(Scan *plan, ExplainState *es);
@@ -184,7 +189,10 @@ ExplainQuery(ExplainStmt *stmt, const char *queryString,
 			es->buffers = defGetBoolean(opt);
 #ifdef ADB
 		else if (strcmp(opt->defname, "nodes") == 0)
+		{
 			es->nodes = defGetBoolean(opt);
+			es->node_stats = es->nodes;
+		}
 		else if (strcmp(opt->defname, "num_nodes") == 0)
 			es->num_nodes = defGetBoolean(opt);
 		else if (strcmp(opt->defname, "plan_id") == 0)
@@ -1602,6 +1610,14 @@ ExplainNode(PlanState *planstate, List *ancestors,
 		case T_HashJoin:
 			show_upper_qual(((HashJoin *) plan)->hashclauses,
 							"Hash Cond", planstate, ancestors, es);
+#ifdef ADB
+			if (((HashJoin *) plan)->cluster_reduce_filter)
+			{
+				ExplainPropertyText("Reduce Filter", "Bloom", es);
+				show_instrumentation_count("Rows Removed by Reduce Filter", 1,
+										   outerPlanState(planstate), es);
+			}
+#endif /* ADB */
 			show_upper_qual(((HashJoin *) plan)->join.joinqual,
 							"Join Filter", planstate, ancestors, es);
 			if (((HashJoin *) plan)->join.joinqual)
@@ -1774,12 +1790,29 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			ExplainCloseGroup("Workers", "Workers", false, es);
 	}
 #ifdef ADB
-	if(es->analyze && es->verbose && planstate->list_cluster_instrument != NIL)
+	/* network statistics of ClusterReduce running on this node */
+	if (es->analyze && (es->verbose || es->node_stats) &&
+		planstate->instrument && IsA(planstate, ClusterReduceState))
+	{
+		ClusterInstrumentation ci;
+
+		MemSet(&ci, 0, sizeof(ci));
+		ExecClusterReduceGetInstrument((ClusterReduceState *) planstate, &ci);
+		show_cluster_instrument(&ci, es);
+		if (ci.peers)
+			pfree(ci.peers);
+	}
+
+	if(es->analyze && (es->verbose || es->node_stats) &&
+	   planstate->list_cluster_instrument != NIL)
 	{
 		ListCell *lc;
 		ClusterInstrumentation *ci;
 		int		i;
 		bool	opened_group;
+		double	max_rows = 0.0;
+		double	sum_rows = 0.0;
+		int		num_executed = 0;
 
 		foreach(lc, planstate->list_cluster_instrument)
 		{
@@ -1787,17 +1820,21 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			double		startup_sec;
 			double		total_sec;
 			double		rows;
+			char	   *nodename;
 			ci = lfirst(lc);
 
+			nodename = get_pgxc_nodename(ci->nodeOid);
 			if(es->format == EXPLAIN_FORMAT_TEXT)
 			{
 				appendStringInfoSpaces(es->str, es->indent * 2);
-				appendStringInfo(es->str, "Node %u:", ci->nodeOid);
+				appendStringInfo(es->str, "Node %s:", nodename);
 			}else
 			{
 				ExplainOpenGroup("Node", "Node", false, es);
 				ExplainPropertyInteger("Oid", ci->nodeOid, es);
+				ExplainPropertyText("Node Name", nodename, es);
 			}
+			pfree(nodename);
 			nloops = ci->instrument[0].nloops;
 			if(nloops <= 0)
 			{
@@ -1815,6 +1852,9 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			startup_sec = 1000.0 * ci->instrument[0].startup / nloops;
 			total_sec = 1000.0 * ci->instrument[0].total / nloops;
 			rows = ci->instrument[0].ntuples / nloops;
+			max_rows = Max(max_rows, ci->instrument[0].ntuples);
+			sum_rows += ci->instrument[0].ntuples;
+			num_executed++;
 
 			if(es->format == EXPLAIN_FORMAT_TEXT)
 			{
@@ -1838,12 +1878,11 @@ ExplainNode(PlanState *planstate, List *ancestors,
 				ExplainPropertyFloat("Actual Loops", nloops, 0, es);
 			}
 
+			es->indent++;
 			if (es->buffers)
-			{
-				es->indent++;
 				show_buffer_usage(es, &ci->instrument[0].bufusage);
-				es->indent--;
-			}
+			show_cluster_instrument(ci, es);
+			es->indent--;
 			opened_group = false;
 			es->indent++;
 			for(i=1;i<=ci->num_workers;++i)
@@ -1900,10 +1939,17 @@ ExplainNode(PlanState *planstate, List *ancestors,
 					ExplainCloseGroup("Worker", NULL, true, es);
 				}
 			}
+			if (opened_group)
+				ExplainCloseGroup("Workers", "Workers", false, es);
 			es->indent--;
+
+			ExplainCloseGroup("Node", "Node", false, es);
 		}
 
-		ExplainCloseGroup("Node", "Node", false, es);
+		/* largest rows of one node against the average, 1.00 is no skew */
+		if (num_executed > 1 && sum_rows > 0.0)
+			ExplainPropertyFloat("Rows Skew",
+								 max_rows * num_executed / sum_rows, 2, es);
 	}
 #endif /* ADB */
 
@@ -2807,6 +2853,90 @@ show_buffer_usage(ExplainState *es, const BufferUsage *usage)
 	}
 }
 
+#ifdef ADB
+/*
+ * Show memory and network statistics of a plan node on one node
+ */
+static void
+show_cluster_instrument(ClusterInstrumentation *ci, ExplainState *es)
+{
+	bool		has_network;
+	int			i;
+
+	has_network = (ci->network_time > 0.0 ||
+				   ci->spill_bytes > 0 ||
+				   ci->num_peers > 0);
+
+	if (es->format == EXPLAIN_FORMAT_TEXT)
+	{
+		if (ci->space_used > 0)
+		{
+			appendStringInfoSpaces(es->str, es->indent * 2);
+			appendStringInfo(es->str, "Memory: %ldkB\n", ci->space_used);
+		}
+		if (has_network)
+		{
+			appendStringInfoSpaces(es->str, es->indent * 2);
+			appendStringInfoString(es->str, "Network:");
+			if (es->timing)
+				appendStringInfo(es->str, " wait=%.3f",
+								 1000.0 * ci->network_time);
+			appendStringInfo(es->str, " spill=" UINT64_FORMAT "kB\n",
+							 (ci->spill_bytes + 1023) / 1024);
+		}
+		for (i = 0; i < ci->num_peers; i++)
+		{
+			ReducePeerInstrumentation *peer = &ci->peers[i];
+			char	   *nodename;
+
+			if (peer->send_tuples == 0 && peer->recv_tuples == 0)
+				continue;
+			nodename = get_pgxc_nodename(peer->nodeOid);
+			appendStringInfoSpaces(es->str, es->indent * 2);
+			appendStringInfo(es->str,
+							 "Peer %s: sent rows=" UINT64_FORMAT " bytes=" UINT64_FORMAT
+							 ", received rows=" UINT64_FORMAT " bytes=" UINT64_FORMAT "\n",
+							 nodename,
+							 peer->send_tuples, peer->send_bytes,
+							 peer->recv_tuples, peer->recv_bytes);
+			pfree(nodename);
+		}
+	}
+	else
+	{
+		if (ci->space_used > 0)
+			ExplainPropertyLong("Peak Memory Usage", ci->space_used, es);
+		if (has_network)
+		{
+			if (es->timing)
+				ExplainPropertyFloat("Network Wait Time",
+									 1000.0 * ci->network_time, 3, es);
+			ExplainPropertyLong("Spill Space", (long) ((ci->spill_bytes + 1023) / 1024), es);
+		}
+		if (ci->num_peers > 0)
+		{
+			ExplainOpenGroup("Peers", "Peers", false, es);
+			for (i = 0; i < ci->num_peers; i++)
+			{
+				ReducePeerInstrumentation *peer = &ci->peers[i];
+				char	   *nodename;
+
+				nodename = get_pgxc_nodename(peer->nodeOid);
+				ExplainOpenGroup("Peer", NULL, true, es);
+				ExplainPropertyText("Node Name", nodename, es);
+				ExplainPropertyLong("Sent Rows", (long) peer->send_tuples, es);
+				ExplainPropertyLong("Sent Bytes", (long) peer->send_bytes, es);
+				ExplainPropertyLong("Received Rows", (long) peer->recv_tuples, es);
+				ExplainPropertyLong("Received Bytes", (long) peer->recv_bytes, es);
+				ExplainCloseGroup("Peer", NULL, true, es);
+				pfree(nodename);
+			}
+			ExplainCloseGroup("Peers", "Peers", false, es);
+		}
+	}
+}
+#endif /* ADB */
+
 /*
  * Add some additional details about an IndexScan or IndexOnlyScan
  */
@@ -3783,6 +3913,20 @@ ExplainRemoteQuery(RemoteQuery *plan, PlanState *planstate, List *ancestors, Exp
 	/* Remote query statement */
 	if (es->verbose)
 		ExplainPropertyText("Remote query", plan->sql_statement, es);
+
+	/* planstate is of parent node for remote subplans */
+	if (es->analyze &&
+		planstate != NULL &&
+		IsA(planstate, RemoteQueryState) &&
+		planstate->plan == (Plan *) plan)
+	{
+		RemoteQueryState *rqs = (RemoteQueryState *) planstate;
+
+		if (rqs->rep_cache_status != REP_CACHE_NONE)
+			ExplainPropertyText("Coordinator Cache",
+								rqs->rep_cache_status == REP_CACHE_HIT ? "hit" : "miss",
+								es);
+	}
 }
 #endif /*ADB*/
 
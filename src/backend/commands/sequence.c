@@ -42,6 +42,7 @@
 
 #ifdef ADB
 #include "pgxc/pgxc.h"
+#include "pgxc/seqcache.h"
 #include "commands/dbcommands.h"
 #endif
 
@@ -91,6 +92,11 @@ static HTAB *seqhashtab = NULL; /* hash table for SeqTable items */
  */
 static SeqTableData *last_used_seq = NULL;
 
+#ifdef AGTM
+/* values reserved by nextval_internal instead of cache_value when not 0 */
+static int64 seq_range_count = 0;
+#endif
+
 static void fill_seq_with_data(Relation rel, HeapTuple tuple);
 static int64 nextval_internal(Oid relid);
 static Relation open_share_lock(SeqTable seq);
@@ -655,6 +661,12 @@ AlterSequence(AlterSeqStmt *stmt)
 		agtm_AlterSequence(RelationGetRelationName(seqrel), databaseName,
 			schemaName, seqOptions);
 	}
+
+	/*
+	 * Values reserved before are not what ALTER wants, discard them once
+	 * AGTM has changed.  Other coordinators do so when running this ALTER.
+	 */
+	SeqCacheInvalidate(relid);
 #endif
 	return address;
 }
@@ -756,6 +768,32 @@ nextval_internal(Oid relid)
 	seq = read_seq_tuple(elm, seqrel, &buf, &seqtuple);
 	page = BufferGetPage(buf);
 
+#ifdef ADB
+	/*
+	 * Take from value ranges shared by backends of this coordinator, only
+	 * CACHE > 1 sequences are there.  Don't keep the buffer locked, other
+	 * backends take values concurrently.
+	 */
+	if (seqrel->rd_backend != MyBackendId &&
+		seq_cache_size > 0 &&
+		seq->cache_value > 1)
+	{
+		int64	cache = seq->cache_value;
+
+		UnlockReleaseBuffer(buf);
+		if (SeqCacheNextVal(seqrel, cache, &result))
+		{
+			elm->last = elm->cached = result;
+			elm->last_valid = true;
+			last_used_seq = elm;
+			relation_close(seqrel, NoLock);
+			return result;
+		}
+		seq = read_seq_tuple(elm, seqrel, &buf, &seqtuple);
+		page = BufferGetPage(buf);
+	}
+#endif
+
 #ifdef ADB
 	is_temp = seqrel->rd_backend == MyBackendId;
 	if (IsCoordMaster() && !is_temp)
@@ -836,6 +874,11 @@ nextval_internal(Oid relid)
 	}
 #endif
 
+#ifdef AGTM
+	if (seq_range_count > 0)
+		fetch = cache = seq_range_count;
+	else
+#endif
 	fetch = cache = seq->cache_value;
 	log = seq->log_cnt;
 
@@ -1045,6 +1088,41 @@ nextval_internal(Oid relid)
 	return result;
 }
 
+#ifdef AGTM
+/*
+ * nextval_range
+ *
+ * Reserve count values of sequence at once for a coordinator, returns the
+ * first value, last value and increment of the range.  The range can be
+ * shorter than count at the end of a not cycled sequence.
+ */
+int64
+nextval_range(Oid relid, int64 count, int64 *last, int64 *increment)
+{
+	int64		result;
+
+	AssertArg(count > 0);
+
+	seq_range_count = count;
+	PG_TRY();
+	{
+		result = nextval_internal(relid);
+	}PG_CATCH();
+	{
+		seq_range_count = 0;
+		PG_RE_THROW();
+	}PG_END_TRY();
+	seq_range_count = 0;
+
+	/* AGTM keeps no cached values, "last" is the last fetched value */
+	Assert(last_used_seq && last_used_seq->relid == relid);
+	*last = last_used_seq->last;
+	*increment = last_used_seq->increment;
+
+	return result;
+}
+#endif /* AGTM */
+
 Datum
 currval_oid(PG_FUNCTION_ARGS)
 {
@@ -1275,6 +1353,7 @@ setval_oid(PG_FUNCTION_ARGS)
 			schemaName = get_namespace_name(RelationGetNamespace(seqrel));
 
 			seq_val = agtm_SetSeqVal(seqName, databaseName, schemaName, next);
+			SeqCacheInvalidateAll(seqrel);
 			relation_close(seqrel, NoLock);
 			/* do location */
 			do_setval(relid, next, true);
@@ -1327,6 +1406,7 @@ setval3_oid(PG_FUNCTION_ARGS)
 			schemaName = get_namespace_name(RelationGetNamespace(seqrel));
 
 			seq_val = agtm_SetSeqValCalled(seqName, databaseName, schemaName, next, iscalled);
+			SeqCacheInvalidateAll(seqrel);
 			relation_close(seqrel, NoLock);
 			/* do location */
 			do_setval(relid, next, iscalled);
@@ -12158,6 +12158,8 @@ AtExecDistributeBy(Relation rel, DistributeBy *options)
 	Oid funcid = InvalidOid;
 	int numatts = 0;
 	int16 *attnums = NULL;
+	Datum rangebounds = (Datum) 0;
+	List *rangenodes = NIL;
 
 	if (options == NULL)
 		return;
@@ -12174,7 +12176,9 @@ AtExecDistributeBy(Relation rel, DistributeBy *options)
 								 &attnum,
 								 &funcid,
 								 &numatts,
-								 &attnums
+								 &attnums,
+								 &rangebounds,
+								 &rangenodes
 								 );
 
 	/*
@@ -12193,7 +12197,9 @@ AtExecDistributeBy(Relation rel, DistributeBy *options)
 				   PGXC_CLASS_ALTER_DISTRIBUTION,
 				   funcid,
 				   numatts,
-				   attnums
+				   attnums,
+				   rangebounds,
+				   rangenodes
 				   );
 
 	/* Make the additional catalog changes visible */
@@ -12233,7 +12239,9 @@ AtExecSubCluster(Relation rel, PGXCSubCluster *options)
 				   PGXC_CLASS_ALTER_NODES,
 				   0,
 				   0,
-				   NULL
+				   NULL,
+				   (Datum) 0,
+				   NIL
 				   );
 
 	/* Make the additional catalog changes visible */
@@ -12283,7 +12291,9 @@ AtExecAddNode(Relation rel, List *options)
 				   PGXC_CLASS_ALTER_NODES,
 				   0,
 				   0,
-				   NULL
+				   NULL,
+				   (Datum) 0,
+				   NIL
 				   );
 
 	/* Make the additional catalog changes visible */
@@ -12330,7 +12340,9 @@ AtExecDeleteNode(Relation rel, List *options)
 				   PGXC_CLASS_ALTER_NODES,
 				   0,
 				   0,
-				   NULL
+				   NULL,
+				   (Datum) 0,
+				   NIL
 				   );
 
 	/* Make the additional catalog changes visible */
@@ -12396,6 +12408,10 @@ BuildRedistribCommands(Oid relid, List *subCmds)
 	int			numatts = 0;
 	int			idx = 0;
 	int16	   *attnums = NULL;
+	int			hashalgorithm = 0;
+	int			hashbuckets = 0;
+	Datum		rangebounds = (Datum) 0;
+	List	   *rangenodes = NIL;
 
 	/* Get necessary information about relation */
 	rel = relation_open(redistribState->relid, NoLock);
@@ -12428,12 +12444,14 @@ BuildRedistribCommands(Oid relid, List *subCmds)
 											 (DistributeBy *) cmd->def,
 											 RelationGetDescr(rel),
 											 &(newLocInfo->locatorType),
-											 NULL,
-											 NULL,
+											 &hashalgorithm,
+											 &hashbuckets,
 											 (AttrNumber *)&(newLocInfo->partAttrNum),
 											 &funcid,
 											 &numatts,
-											 &attnums
+											 &attnums,
+											 &rangebounds,
+											 &rangenodes
 											 );
 
 				newLocInfo->funcid = funcid;
@@ -12445,6 +12463,40 @@ BuildRedistribCommands(Oid relid, List *subCmds)
 				for (idx = 0; idx < numatts; idx++)
 					newLocInfo->funcAttrNums = lappend_int(newLocInfo->funcAttrNums,
 															attnums[idx]);
+
+				/* A new distribution starts with a new bucket map, as PgxcClassAlter does */
+				if (newLocInfo->bucketMap)
+					pfree(newLocInfo->bucketMap);
+				newLocInfo->bucketMap = NULL;
+				newLocInfo->nbuckets = 0;
+				if (newLocInfo->rangeBounds != (Datum) 0)
+					pfree(DatumGetPointer(newLocInfo->rangeBounds));
+				newLocInfo->rangeBounds = (Datum) 0;
+				newLocInfo->rangeCollation = InvalidOid;
+				if (newLocInfo->locatorType == LOCATOR_TYPE_HASH &&
+					hashalgorithm == LOCATOR_HASH_BUCKET)
+				{
+					newLocInfo->bucketMap = MakeBucketMap(hashbuckets, NULL,
+														  new_oid_array, new_num);
+					if (newLocInfo->bucketMap)
+						newLocInfo->nbuckets = hashbuckets;
+				} else if (newLocInfo->locatorType == LOCATOR_TYPE_RANGE)
+				{
+					int		nranges = 1;
+
+					if (rangebounds != (Datum) 0)
+					{
+						ArrayType *bounds = DatumGetArrayTypeP(rangebounds);
+						nranges += ArrayGetNItems(ARR_NDIM(bounds), ARR_DIMS(bounds));
+					}
+					newLocInfo->rangeBounds = rangebounds;
+					newLocInfo->rangeCollation =
+						RelationGetDescr(rel)->attrs[newLocInfo->partAttrNum - 1]->attcollation;
+					newLocInfo->bucketMap = MakeRangeMap(nranges, rangenodes, NULL,
+														 new_oid_array, new_num);
+					if (newLocInfo->bucketMap)
+						newLocInfo->nbuckets = nranges;
+				}
 				break;
 			case AT_SubCluster:
 				/* Update new list of nodes */
@@ -12471,6 +12523,25 @@ BuildRedistribCommands(Oid relid, List *subCmds)
 			default:
 				Assert(0); /* Should not happen */
 		}
+
+		/*
+		 * Move the buckets or ranges the same way as PgxcClassAlter, so
+		 * redistribution only moves the ones whose node is changed.
+		 */
+		if (cmd->subtype != AT_DistributeBy && newLocInfo->bucketMap)
+		{
+			Oid *old_map = newLocInfo->bucketMap;
+
+			if (IsRelationDistributedByRange(newLocInfo))
+				newLocInfo->bucketMap = MakeRangeMap(newLocInfo->nbuckets, NIL, old_map,
+													 new_oid_array, new_num);
+			else
+				newLocInfo->bucketMap = MakeBucketMap(newLocInfo->nbuckets, old_map,
+													  new_oid_array, new_num);
+			if (newLocInfo->bucketMap == NULL)
+				newLocInfo->nbuckets = 0;
+			pfree(old_map);
+		}
 	}
 
 	/* Build relation node list for new locator info */
@@ -10,6 +10,8 @@
 #include "executor/clusterReceiver.h"
 #include "executor/execCluster.h"
 #include "executor/executor.h"
+#include "executor/hashjoin.h"
+#include "executor/nodeClusterReduce.h"
 #include "executor/tuptable.h"
 #include "libpq/libpq.h"
 #include "libpq/libpq-node.h"
@@ -18,9 +20,14 @@
 #include "storage/ipc.h"
 #include "tcop/dest.h"
 #include "utils/memutils.h"
+#include "utils/tuplesort.h"
 
 #include <time.h>
 
+bool ClusterPlanStopCheck = false;
+bool ClusterPlanStopped = false;
+int ClusterStopCheckCountdown = CLUSTER_STOP_CHECK_INTERVAL;
+
 typedef struct ClusterPlanReceiver
 {
 	DestReceiver pub;
@@ -50,6 +57,8 @@ static void cluster_receive_startup(DestReceiver *self,int operation,TupleDesc t
 static void cluster_receive_shutdown(DestReceiver *self);
 static void cluster_receive_destroy(DestReceiver *self);
 static bool serialize_instrument_walker(PlanState *ps, SerializeInstrumentContext *context);
+static void serialize_instrument_extra(PlanState *ps, StringInfo buf);
+static long planstate_space_used(PlanState *ps);
 static void restore_instrument_message(PlanState *ps, const char *msg, int len, struct pg_conn *conn);
 static bool restore_instrument_walker(PlanState *ps, RestoreInstrumentContext *context);
 
@@ -127,7 +136,10 @@ bool clusterRecvTupleEx(ClusterRecvState *state, const char *msg, int len, struc
 	switch(*msg)
 	{
 	case CLUSTER_MSG_TUPLE_DATA:
-		restore_slot_message(msg+1, len-1, state->base_slot);
+		if (state->slot_need_copy)
+			restore_slot_message(msg+1, len-1, state->base_slot);
+		else
+			restore_slot_message_nocopy(msg+1, len-1, state->base_slot, &state->recv_buf);
 		return true;
 	case CLUSTER_MSG_TUPLE_DESC:
 		compare_slot_head_message(msg+1, len-1, state->base_slot->tts_tupleDescriptor);
@@ -169,7 +181,8 @@ bool clusterRecvTupleEx(ClusterRecvState *state, const char *msg, int len, struc
 	case CLUSTER_MSG_CONVERT_TUPLE:
 		if(state->convert)
 		{
-			restore_slot_message(msg+1, len-1, state->convert_slot);
+			/* convert_slot is not returned, it only live until converted */
+			restore_slot_message_nocopy(msg+1, len-1, state->convert_slot, &state->recv_buf);
 			do_type_convert_slot_in(state->convert, state->convert_slot, state->base_slot, state->slot_need_copy_datum);
 			return true;
 		}else
@@ -197,66 +210,30 @@ static bool cluster_receive_slot(TupleTableSlot *slot, DestReceiver *self)
 	time_t time_now;
 	bool need_more_slot;
 
-	resetStringInfo(&r->buf);
-	if(r->convert)
+	if (ClusterPlanStopped)
 	{
-		do_type_convert_slot_out(r->convert, slot, r->convert_slot, false);
-		serialize_slot_message(&r->buf, r->convert_slot, CLUSTER_MSG_CONVERT_TUPLE);
+		/* coordinator don't need more slot, scans stopped early */
+		need_more_slot = false;
 	}else
 	{
-		serialize_slot_message(&r->buf, slot, CLUSTER_MSG_TUPLE_DATA);
-	}
-	pq_putmessage('d', r->buf.data, r->buf.len);
-	pq_flush();
-
-	/* check client message */
-	need_more_slot = true;
-	if(r->check_end_msg && (time_now = time(NULL)) != r->lastCheckTime)
-	{
-		int n;
-		unsigned char first_char;
-		r->lastCheckTime = time_now;
-		pq_startmsgread();
-		n = pq_getbyte_if_available(&first_char);
-		if(n == 0)
-		{
-			/* no message from client */
-			pq_endmsgread();
-			need_more_slot = true;
-		}else if(n < 0)
+		resetStringInfo(&r->buf);
+		if(r->convert)
 		{
-			/* eof, we don't need more slot */
-			pq_endmsgread();
-			need_more_slot = false;
+			do_type_convert_slot_out(r->convert, slot, r->convert_slot, false);
+			serialize_slot_message(&r->buf, r->convert_slot, CLUSTER_MSG_CONVERT_TUPLE);
 		}else
 		{
-			resetStringInfo(&r->buf);
-			if(pq_getmessage(&r->buf, 0))
-			{
-				ereport(COMMERROR,
-						(errcode(ERRCODE_PROTOCOL_VIOLATION),
-						 errmsg("unexpected EOF on coordinator connection")));
-				proc_exit(0);
-			}
+			serialize_slot_message(&r->buf, slot, CLUSTER_MSG_TUPLE_DATA);
+		}
+		pq_putmessage('d', r->buf.data, r->buf.len);
+		pq_flush();
 
-			if(first_char == 'c'
-				|| first_char == 'X')
-			{
-				/* copy end */
-				need_more_slot = false;
-			}else if(first_char == 'd')
-			{
-				/* message */
-				ereport(ERROR,
-						(errcode(ERRCODE_PROTOCOL_VIOLATION),
-						errmsg("not support copy data in yet")));
-			}else
-			{
-				ereport(FATAL,
-						(errcode(ERRCODE_PROTOCOL_VIOLATION),
-						 errmsg("invalid coordinator message type \"%c\"",
-								first_char)));
-			}
+		/* check client message */
+		need_more_slot = true;
+		if(r->check_end_msg && (time_now = time(NULL)) != r->lastCheckTime)
+		{
+			r->lastCheckTime = time_now;
+			need_more_slot = !ClusterCheckStopMessage();
 		}
 	}
 
@@ -336,6 +313,8 @@ ClusterRecvState *createClusterRecvState(PlanState *ps, bool need_copy)
 	state = palloc0(sizeof(*state));
 	state->base_slot = slot;
 	state->ps = ps;
+	state->slot_need_copy = need_copy;
+	initStringInfo(&state->recv_buf);
 
 	state->convert = create_type_convert(slot->tts_tupleDescriptor, false, true);
 	if(state->convert != NULL)
@@ -361,6 +340,7 @@ void freeClusterRecvState(ClusterRecvState *state)
 		}
 		if(state->convert)
 			free_type_convert(state->convert);
+		pfree(state->recv_buf.data);
 		pfree(state);
 	}
 }
@@ -378,6 +358,84 @@ bool clusterRecvSetCheckEndMsg(DestReceiver *r, bool check)
 	return old_check;
 }
 
+/*
+ * Read message from coordinator if any, return true when coordinator
+ * don't need more slot (copy end, terminate or connection lost).
+ */
+bool ClusterCheckStopMessage(void)
+{
+	StringInfoData buf;
+	int n;
+	unsigned char first_char;
+
+	ClusterStopCheckCountdown = CLUSTER_STOP_CHECK_INTERVAL;
+	if (ClusterPlanStopped)
+		return true;
+
+	pq_startmsgread();
+	n = pq_getbyte_if_available(&first_char);
+	if(n == 0)
+	{
+		/* no message from client */
+		pq_endmsgread();
+		return false;
+	}else if(n < 0)
+	{
+		/* eof, we don't need more slot */
+		pq_endmsgread();
+		ClusterPlanStopped = true;
+		return true;
+	}
+
+	initStringInfo(&buf);
+	if(pq_getmessage(&buf, 0))
+	{
+		ereport(COMMERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("unexpected EOF on coordinator connection")));
+		proc_exit(0);
+	}
+	pfree(buf.data);
+
+	if(first_char == 'c'
+		|| first_char == 'X')
+	{
+		/* copy end */
+		ClusterPlanStopped = true;
+	}else if(first_char == 'd')
+	{
+		/* message */
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				errmsg("not support copy data in yet")));
+	}else
+	{
+		ereport(FATAL,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("invalid coordinator message type \"%c\"",
+						first_char)));
+	}
+
+	return ClusterPlanStopped;
+}
+
+/*
+ * Start check stop message in scan nodes,
+ * only for plan not modify any data
+ */
+void clusterRecvStartStopCheck(bool enable)
+{
+	ClusterPlanStopCheck = enable;
+	ClusterPlanStopped = false;
+	ClusterStopCheckCountdown = CLUSTER_STOP_CHECK_INTERVAL;
+}
+
+void clusterRecvResetStopCheck(void)
+{
+	ClusterPlanStopCheck = false;
+	ClusterPlanStopped = false;
+}
+
 void clusterRecvSetTopPlanState(DestReceiver *r, PlanState *ps)
 {
 	ClusterPlanReceiver *self;
@@ -663,6 +721,26 @@ TupleTableSlot* restore_slot_message(const char *msg, int len, TupleTableSlot *s
 	return ExecStoreMinimalTuple(tup, slot, true);
 }
 
+/*
+ * like restore_slot_message, but not palloc a new tuple for each message.
+ * when msg is aligned slot point to it directly, else tuple copy to buf.
+ * So result only valid until next message received or buf changed
+ */
+TupleTableSlot* restore_slot_message_nocopy(const char *msg, int len, TupleTableSlot *slot, StringInfo buf)
+{
+	uint32 t_len = *(uint32*)msg;
+	if(t_len > len)
+		ereport(ERROR, (errmsg("invalid tuple message length")));
+	if (msg != (const char*)MAXALIGN(msg))
+	{
+		resetStringInfo(buf);
+		enlargeStringInfo(buf, t_len);
+		memcpy(buf->data, msg, t_len);
+		msg = buf->data;
+	}
+	return ExecStoreMinimalTuple((MinimalTuple)msg, slot, false);
+}
+
 static bool serialize_instrument_walker(PlanState *ps, SerializeInstrumentContext *context)
 {
 	int num_worker;
@@ -695,10 +773,64 @@ static bool serialize_instrument_walker(PlanState *ps, SerializeInstrumentContex
 		appendBinaryStringInfo(context->buf,
 							   (char*)(ps->worker_instrument->instrument),
 							   sizeof(Instrumentation) * num_worker);
+	serialize_instrument_extra(ps, context->buf);
 
 	return planstate_tree_walker(ps, serialize_instrument_walker, context);
 }
 
+/*
+ * serialize memory and network statistics of plan node, see
+ * ClusterInstrumentation
+ */
+static void serialize_instrument_extra(PlanState *ps, StringInfo buf)
+{
+	ClusterInstrumentation ci;
+
+	MemSet(&ci, 0, sizeof(ci));
+	ci.space_used = planstate_space_used(ps);
+	if (IsA(ps, ClusterReduceState))
+		ExecClusterReduceGetInstrument((ClusterReduceState*)ps, &ci);
+
+	appendBinaryStringInfo(buf, (char*)&(ci.space_used), sizeof(ci.space_used));
+	appendBinaryStringInfo(buf, (char*)&(ci.network_time), sizeof(ci.network_time));
+	appendBinaryStringInfo(buf, (char*)&(ci.spill_bytes), sizeof(ci.spill_bytes));
+	appendBinaryStringInfo(buf, (char*)&(ci.num_peers), sizeof(ci.num_peers));
+	if (ci.num_peers > 0)
+		appendBinaryStringInfo(buf,
+							   (char*)ci.peers,
+							   sizeof(ci.peers[0]) * ci.num_peers);
+	if (ci.peers)
+		pfree(ci.peers);
+}
+
+/* peak memory in kB used by Sort or Hash, 0 if unknown */
+static long planstate_space_used(PlanState *ps)
+{
+	if (IsA(ps, SortState))
+	{
+		SortState  *sortstate = (SortState *) ps;
+		const char *sortMethod;
+		const char *spaceType;
+		long		spaceUsed;
+
+		if (sortstate->sort_Done && sortstate->tuplesortstate != NULL)
+		{
+			tuplesort_get_stats((Tuplesortstate *) sortstate->tuplesortstate,
+								&sortMethod, &spaceType, &spaceUsed);
+			if (strcmp(spaceType, "Memory") == 0)
+				return spaceUsed;
+		}
+	}else if (IsA(ps, HashState))
+	{
+		HashJoinTable hashtable = ((HashState *) ps)->hashtable;
+
+		if (hashtable)
+			return (hashtable->spacePeak + 1023) / 1024;
+	}
+
+	return 0;
+}
+
 static bool restore_instrument_walker(PlanState *ps, RestoreInstrumentContext *context)
 {
 	if(ps == NULL)
@@ -722,6 +854,21 @@ static bool restore_instrument_walker(PlanState *ps, RestoreInstrumentContext *c
 		pq_copymsgbytes(&(context->buf),
 						(char*)&(ci->instrument[0]),
 						sizeof(ci->instrument[0]) * (n+1));
+
+		/* memory and network statistics */
+		pq_copymsgbytes(&(context->buf), (char*)&(ci->space_used), sizeof(ci->space_used));
+		pq_copymsgbytes(&(context->buf), (char*)&(ci->network_time), sizeof(ci->network_time));
+		pq_copymsgbytes(&(context->buf), (char*)&(ci->spill_bytes), sizeof(ci->spill_bytes));
+		pq_copymsgbytes(&(context->buf), (char*)&(ci->num_peers), sizeof(ci->num_peers));
+		ci->peers = NULL;
+		if (ci->num_peers > 0)
+		{
+			ci->peers = MemoryContextAlloc(ps->state->es_query_cxt,
+										   sizeof(ci->peers[0]) * ci->num_peers);
+			pq_copymsgbytes(&(context->buf),
+							(char*)ci->peers,
+							sizeof(ci->peers[0]) * ci->num_peers);
+		}
 		return true;
 	}
 	return planstate_tree_walker(ps, restore_instrument_walker, context);
@@ -5,6 +5,7 @@
 #include "catalog/pgxc_node.h"
 #include "commands/copy.h"
 #include "commands/defrem.h"
+#include "common/pg_lzcompress.h"
 #include "executor/nodeEmptyResult.h"
 #include "executor/clusterHeapScan.h"
 #include "executor/execdesc.h"
@@ -23,6 +24,7 @@
 #include "nodes/plannodes.h"
 #include "parser/parsetree.h"
 #include "pgstat.h"
+#include "portability/instr_time.h"
 #include "storage/lmgr.h"
 #include "storage/mem_toc.h"
 #include "tcop/dest.h"
@@ -54,6 +56,23 @@
 #define REMOTE_KEY_REDUCE_GROUP				0xFFFFFF0B
 #define REMOTE_KEY_CUSTOM_FUNCTION			0xFFFFFF0C
 #define REMOTE_KEY_COORD_INFO				0xFFFFFF0D
+#define REMOTE_KEY_PLAN_FORMAT				0xFFFFFF0E
+
+/*
+ * version of serialized PlannedStmt, when REMOTE_KEY_PLAN_FORMAT exist
+ * range table and plan entry begin with a ClusterPlanEntryHeader, and
+ * catalog objects are referenced by index after first saved in range
+ * table, plan and param entries.
+ */
+#define CLUSTER_PLAN_FORMAT_VERSION			1
+/* compress range table or plan when serialized data larger than it */
+#define CLUSTER_PLAN_COMPRESS_MIN_SIZE		8192
+
+typedef struct ClusterPlanEntryHeader
+{
+	int32	raw_size;		/* size before compress, 0 for not compressed */
+	int32	data_size;		/* size of data follow this header */
+}ClusterPlanEntryHeader;
 
 typedef struct ClusterPlanContext
 {
@@ -94,6 +113,9 @@ static void restore_cluster_plan_info(StringInfo buf);
 static QueryDesc *create_cluster_query_desc(StringInfo buf, DestReceiver *r);
 
 static void SerializePlanInfo(StringInfo msg, PlannedStmt *stmt, ParamListInfo param, ClusterPlanContext *context);
+static void SerializePlanEntry(StringInfo msg, uint32 key, StringInfo data);
+static bool RestorePlanEntry(StringInfo info, uint32 key, StringInfo buf, bool has_format);
+static uint32 RestorePlanFormat(StringInfo info);
 static void SerializeTransactionInfo(StringInfo msg);
 static bool SerializePlanHook(StringInfo buf, Node *node, void *context);
 static void *LoadPlanHook(StringInfo buf, NodeTag tag, void *context);
@@ -263,8 +285,16 @@ static void ExecClusterPlanStmt(StringInfo buf, ClusterCoordInfo *info)
 
 	set_cluster_display("<cluster query>", false, info);
 
+	/*
+	 * when plan not modify data, scans can stop early after coordinator
+	 * don't need more tuple (e.g. LIMIT reached)
+	 */
+	clusterRecvStartStopCheck((eflags & EXEC_FLAG_UPDATE_CMD_ID) == 0 &&
+							  query_desc->operation == CMD_SELECT);
+
 	/* run plan */
 	ExecutorRun(query_desc, ForwardScanDirection, 0L);
+	clusterRecvResetStopCheck();
 
 	/* send processed message */
 	initStringInfo(&msg);
@@ -338,6 +368,10 @@ static NodeTag GetClusterPlanType(StringInfo buf)
 	NodeTag tag;
 	StringInfoData plan;
 
+	/* only PlannedStmt serialize format info */
+	if (RestorePlanFormat(buf) != 0)
+		return T_PlannedStmt;
+
 	plan.data = mem_toc_lookup(buf, REMOTE_KEY_PLAN_STMT, &plan.len);
 	if (plan.data == NULL)
 	{
@@ -397,55 +431,72 @@ static QueryDesc *create_cluster_query_desc(StringInfo info, DestReceiver *r)
 	RangeTblEntry *rte;
 	ParamListInfo paramLI;
 	StringInfoData buf;
+	instr_time start_time;
+	instr_time end_time;
 	int es_instrument;
 	int i,n;
+	bool has_format;
 
-	buf.data = mem_toc_lookup(info, REMOTE_KEY_RTE_LIST, &buf.len);
-	if(buf.data == NULL)
-		ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION)
-			, errmsg("can not find range table list")));
-	buf.maxlen = buf.len;
-	buf.cursor = 0;
-	rte_list = (List*)loadNodeAndHook(&buf, LoadPlanHook, NULL);
+	INSTR_TIME_SET_CURRENT(start_time);
+	has_format = (RestorePlanFormat(info) != 0);
+	if (has_format)
+		BeginLoadCatalogCache();
 
-	n = list_length(rte_list);
-	base_rels = palloc(sizeof(Relation) * n);
-	for(i=0,lc=list_head(rte_list);lc!=NULL;lc=lnext(lc),++i)
+	PG_TRY();
 	{
-		rte = lfirst(lc);
-		if(rte->rtekind == RTE_RELATION)
-			base_rels[i] = heap_open(rte->relid, NoLock);
-		else
-			base_rels[i] = NULL;
-	}
+		if (RestorePlanEntry(info, REMOTE_KEY_RTE_LIST, &buf, has_format) == false)
+			ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION)
+				, errmsg("can not find range table list")));
+		rte_list = (List*)loadNodeAndHook(&buf, LoadPlanHook, NULL);
+
+		n = list_length(rte_list);
+		base_rels = palloc(sizeof(Relation) * n);
+		for(i=0,lc=list_head(rte_list);lc!=NULL;lc=lnext(lc),++i)
+		{
+			rte = lfirst(lc);
+			if(rte->rtekind == RTE_RELATION)
+				base_rels[i] = heap_open(rte->relid, NoLock);
+			else
+				base_rels[i] = NULL;
+		}
 
-	buf.data = mem_toc_lookup(info, REMOTE_KEY_PLAN_STMT, &buf.len);
-	if(buf.data == NULL)
-		ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION)
-			, errmsg("Can not find PlannedStmt")));
-	buf.maxlen = buf.len;
-	buf.cursor = 0;
-	stmt = (PlannedStmt*)loadNodeAndHook(&buf, LoadPlanHook, (void*)base_rels);
-	stmt->rtable = rte_list;
-	foreach(lc, stmt->planTree->targetlist)
-		((TargetEntry*)lfirst(lc))->resjunk = false;
-	for(i=0;i<n;++i)
-	{
-		if(base_rels[i])
-			heap_close(base_rels[i], NoLock);
-	}
-	pfree(base_rels);
+		if (RestorePlanEntry(info, REMOTE_KEY_PLAN_STMT, &buf, has_format) == false)
+			ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION)
+				, errmsg("Can not find PlannedStmt")));
+		stmt = (PlannedStmt*)loadNodeAndHook(&buf, LoadPlanHook, (void*)base_rels);
+		stmt->rtable = rte_list;
+		foreach(lc, stmt->planTree->targetlist)
+			((TargetEntry*)lfirst(lc))->resjunk = false;
+		for(i=0;i<n;++i)
+		{
+			if(base_rels[i])
+				heap_close(base_rels[i], NoLock);
+		}
+		pfree(base_rels);
 
-	buf.data = mem_toc_lookup(info, REMOTE_KEY_PARAM, &buf.len);
-	if(buf.data)
-	{
-		buf.cursor = 0;
-		buf.maxlen = buf.len;
-		paramLI = LoadParamList(&buf);
-	}else
+		buf.data = mem_toc_lookup(info, REMOTE_KEY_PARAM, &buf.len);
+		if(buf.data)
+		{
+			buf.cursor = 0;
+			buf.maxlen = buf.len;
+			paramLI = LoadParamList(&buf);
+		}else
+		{
+			paramLI = NULL;
+		}
+	}PG_CATCH();
 	{
-		paramLI = NULL;
-	}
+		if (has_format)
+			EndLoadCatalogCache();
+		PG_RE_THROW();
+	}PG_END_TRY();
+
+	if (has_format)
+		EndLoadCatalogCache();
+	INSTR_TIME_SET_CURRENT(end_time);
+	INSTR_TIME_SUBTRACT(end_time, start_time);
+	elog(DEBUG1, "cluster plan of %d bytes restored in %.3f ms",
+		 info->len, INSTR_TIME_GET_MILLISEC(end_time));
 
 	buf.data = mem_toc_lookup(info, REMOTE_KEY_ES_INSTRUMENT, 0);
 	if(buf.data)
@@ -687,6 +738,10 @@ static void SerializePlanInfo(StringInfo msg, PlannedStmt *stmt,
 	List *rte_list;
 	PlannedStmt *new_stmt;
 	Bitmapset *coord_only_rti = NULL;
+	StringInfoData buf;
+	uint32 format;
+	int raw_size;
+	int start_len;
 	Index rti;
 
 	new_stmt = palloc(sizeof(*new_stmt));
@@ -734,11 +789,6 @@ static void SerializePlanInfo(StringInfo msg, PlannedStmt *stmt,
 		++rti;
 	}
 
-	/* serialize range table */
-	begin_mem_toc_insert(msg, REMOTE_KEY_RTE_LIST);
-	saveNodeAndHook(msg, (Node*)rte_list, SerializePlanHook, context);
-	end_mem_toc_insert(msg, REMOTE_KEY_RTE_LIST);
-
 	/* modify RowMarks if relation is in coordinator only */
 	if (stmt->rowMarks != NIL)
 	{
@@ -759,13 +809,40 @@ static void SerializePlanInfo(StringInfo msg, PlannedStmt *stmt,
 		}
 	}
 
-	begin_mem_toc_insert(msg, REMOTE_KEY_PLAN_STMT);
-	saveNodeAndHook(msg, (Node*)new_stmt, SerializePlanHook, context);
-	end_mem_toc_insert(msg, REMOTE_KEY_PLAN_STMT);
+	start_len = msg->len;
+	format = CLUSTER_PLAN_FORMAT_VERSION;
+	begin_mem_toc_insert(msg, REMOTE_KEY_PLAN_FORMAT);
+	appendBinaryStringInfo(msg, (char*)&format, sizeof(format));
+	end_mem_toc_insert(msg, REMOTE_KEY_PLAN_FORMAT);
+
+	initStringInfo(&buf);
+	BeginSaveCatalogCache();
+	PG_TRY();
+	{
+		/* serialize range table */
+		saveNodeAndHook(&buf, (Node*)rte_list, SerializePlanHook, context);
+		raw_size = buf.len;
+		SerializePlanEntry(msg, REMOTE_KEY_RTE_LIST, &buf);
+
+		/* serialize plan */
+		resetStringInfo(&buf);
+		saveNodeAndHook(&buf, (Node*)new_stmt, SerializePlanHook, context);
+		raw_size += buf.len;
+		SerializePlanEntry(msg, REMOTE_KEY_PLAN_STMT, &buf);
+
+		begin_mem_toc_insert(msg, REMOTE_KEY_PARAM);
+		SaveParamList(msg, param);
+		end_mem_toc_insert(msg, REMOTE_KEY_PARAM);
+	}PG_CATCH();
+	{
+		EndSaveCatalogCache();
+		PG_RE_THROW();
+	}PG_END_TRY();
+	EndSaveCatalogCache();
+	pfree(buf.data);
 
-	begin_mem_toc_insert(msg, REMOTE_KEY_PARAM);
-	SaveParamList(msg, param);
-	end_mem_toc_insert(msg, REMOTE_KEY_PARAM);
+	elog(DEBUG1, "cluster plan serialized to %d bytes, range table and plan %d bytes before compress",
+		 msg->len - start_len, raw_size);
 
 	SerializeTransactionInfo(msg);
 
@@ -803,6 +880,110 @@ static void SerializeTransactionInfo(StringInfo msg)
 
 }
 
+/*
+ * append data to msg as a toc entry, data is compressed when it is large
+ */
+static void SerializePlanEntry(StringInfo msg, uint32 key, StringInfo data)
+{
+	ClusterPlanEntryHeader header;
+	int32 len = -1;
+
+	begin_mem_toc_insert(msg, key);
+	if (data->len >= CLUSTER_PLAN_COMPRESS_MIN_SIZE)
+	{
+		enlargeStringInfo(msg, sizeof(header) + PGLZ_MAX_OUTPUT(data->len));
+		len = pglz_compress(data->data,
+							data->len,
+							msg->data + msg->len + sizeof(header),
+							PGLZ_strategy_default);
+	}
+
+	if (len >= 0)
+	{
+		header.raw_size = data->len;
+		header.data_size = len;
+		memcpy(msg->data + msg->len, &header, sizeof(header));
+		msg->len += sizeof(header) + len;
+		msg->data[msg->len] = '\0';
+	}else
+	{
+		header.raw_size = 0;
+		header.data_size = data->len;
+		appendBinaryStringInfo(msg, (char*)&header, sizeof(header));
+		appendBinaryStringInfo(msg, data->data, data->len);
+	}
+	end_mem_toc_insert(msg, key);
+}
+
+/*
+ * find toc entry and decompress it if need,
+ * has_format is false for old format which not have entry header
+ */
+static bool RestorePlanEntry(StringInfo info, uint32 key, StringInfo buf, bool has_format)
+{
+	ClusterPlanEntryHeader header;
+
+	buf->data = mem_toc_lookup(info, key, &buf->len);
+	if (buf->data == NULL)
+		return false;
+
+	if (has_format)
+	{
+		if (buf->len < sizeof(header))
+			ereport(ERROR,
+					(errcode(ERRCODE_PROTOCOL_VIOLATION),
+					 errmsg("invalid cluster plan entry size %d", buf->len)));
+		memcpy(&header, buf->data, sizeof(header));
+		if (header.data_size < 0 ||
+			header.data_size > buf->len - sizeof(header))
+			ereport(ERROR,
+					(errcode(ERRCODE_PROTOCOL_VIOLATION),
+					 errmsg("invalid cluster plan entry size %d", header.data_size)));
+
+		if (header.raw_size > 0)
+		{
+			char *raw = palloc(header.raw_size + 1);
+			if (pglz_decompress(buf->data + sizeof(header),
+								header.data_size,
+								raw,
+								header.raw_size) != header.raw_size)
+				ereport(ERROR,
+						(errcode(ERRCODE_DATA_CORRUPTED),
+						 errmsg("compressed cluster plan is corrupted")));
+			raw[header.raw_size] = '\0';
+			buf->data = raw;
+			buf->len = header.raw_size;
+		}else
+		{
+			buf->data += sizeof(header);
+			buf->len = header.data_size;
+		}
+	}
+	buf->maxlen = buf->len;
+	buf->cursor = 0;
+
+	return true;
+}
+
+/* return 0 if not serialized by SerializePlanInfo */
+static uint32 RestorePlanFormat(StringInfo info)
+{
+	uint32 format;
+	char *ptr = mem_toc_lookup(info, REMOTE_KEY_PLAN_FORMAT, NULL);
+
+	if (ptr == NULL)
+		return 0;
+
+	memcpy(&format, ptr, sizeof(format));
+	if (format == 0 ||
+		format > CLUSTER_PLAN_FORMAT_VERSION)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("unsupported cluster plan format version %u", format)));
+
+	return format;
+}
+
 static bool SerializePlanHook(StringInfo buf, Node *node, void *context)
 {
 	AssertArg(buf && node);
@@ -1027,28 +1208,18 @@ static bool HaveModifyPlanWalker(Plan *plan, Node *GlobOrStmt, void *context)
 	return plan_tree_walker(plan, GlobOrStmt, HaveModifyPlanWalker, NULL);
 }
 
+/*
+ * relation is saved by name once per plan, later references of it are
+ * resolved by catalog reference cache of saveload
+ */
 static void SerializeRelationOid(StringInfo buf, Oid relid)
 {
-	Relation rel;
-	rel = relation_open(relid, NoLock);
-	save_namespace(buf, RelationGetNamespace(rel));
-	save_node_string(buf, RelationGetRelationName(rel));
-	relation_close(rel, NoLock);
+	save_oid_class_name(buf, relid);
 }
 
 static Oid RestoreRelationOid(StringInfo buf, bool missok)
 {
-	Oid oid = load_namespace_extend(buf, missok);
-	char *rel_name = load_node_string(buf, true);
-	if(OidIsValid(oid) && rel_name[0])
-		oid = get_relname_relid(rel_name, oid);
-	else
-		oid = InvalidOid;
-	if(!OidIsValid(oid) && !missok)
-		ereport(ERROR,
-				(errcode(ERRCODE_UNDEFINED_OBJECT),
-				errmsg("relation \"%s\" not exists", rel_name)));
-	return oid;
+	return load_oid_class_name(buf, missok);
 }
 
 static void SerializeCoordinatorInfo(StringInfo buf)
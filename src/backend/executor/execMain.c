@@ -66,6 +66,7 @@
 #include "executor/nodeReduceScan.h"
 #include "nodes/nodeFuncs.h"
 #include "pgxc/pgxc.h"
+#include "pgxc/repcache.h"
 #include "reduce/adb_reduce.h"
 #endif
 
@@ -828,6 +829,12 @@ InitPlan(QueryDesc *queryDesc, int eflags)
 	 */
 	ExecCheckRTPerms(rangeTable, true);
 
+#ifdef ADB
+	/* results of replicated tables written are dropped from cache */
+	if (!(eflags & EXEC_FLAG_EXPLAIN_ONLY))
+		RepCacheNoteModified(rangeTable);
+#endif
+
 	/*
 	 * initialize the node's execution state
 	 */
@@ -36,6 +36,9 @@
 #include "tcop/tcopprot.h"
 #include "utils/memutils.h"
 #include "utils/snapmgr.h"
+#ifdef ADB
+#include "executor/nodeClusterReduce.h"
+#endif /* ADB */
 
 /*
  * Magic numbers for parallel executor communication.  We use constants
@@ -200,6 +203,12 @@ ExecParallelEstimate(PlanState *planstate, ExecParallelEstimateContext *e)
 				ExecCustomScanEstimate((CustomScanState *) planstate,
 									   e->pcxt);
 				break;
+#ifdef ADB
+			case T_ClusterReduceState:
+				ExecClusterReduceEstimate((ClusterReduceState *) planstate,
+										  e->pcxt);
+				break;
+#endif /* ADB */
 			default:
 				break;
 		}
@@ -252,6 +261,12 @@ ExecParallelInitializeDSM(PlanState *planstate,
 				ExecCustomScanInitializeDSM((CustomScanState *) planstate,
 											d->pcxt);
 				break;
+#ifdef ADB
+			case T_ClusterReduceState:
+				ExecClusterReduceInitializeDSM((ClusterReduceState *) planstate,
+											   d->pcxt);
+				break;
+#endif /* ADB */
 			default:
 				break;
 		}
@@ -696,6 +711,12 @@ ExecParallelInitializeWorker(PlanState *planstate, shm_toc *toc)
 				ExecCustomScanInitializeWorker((CustomScanState *) planstate,
 											   toc);
 				break;
+#ifdef ADB
+			case T_ClusterReduceState:
+				ExecClusterReduceInitializeWorker((ClusterReduceState *) planstate,
+												  toc);
+				break;
+#endif /* ADB */
 			default:
 				break;
 		}
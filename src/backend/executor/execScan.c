@@ -22,6 +22,10 @@
 #include "miscadmin.h"
 #include "utils/memutils.h"
 
+#ifdef ADB
+#include "executor/clusterReceiver.h"
+#endif /* ADB */
+
 
 static bool tlist_matches_tupdesc(PlanState *ps, List *tlist, Index varno, TupleDesc tupdesc);
 
@@ -142,6 +146,10 @@ ExecScan(ScanState *node,
 	if (!qual && !projInfo)
 	{
 		ResetExprContext(econtext);
+#ifdef ADB
+		if (ClusterPlanShouldStop())
+			return ExecClearTuple(node->ss_ScanTupleSlot);
+#endif /* ADB */
 		return ExecScanFetch(node, accessMtd, recheckMtd);
 	}
 
@@ -177,6 +185,16 @@ ExecScan(ScanState *node,
 
 		CHECK_FOR_INTERRUPTS();
 
+#ifdef ADB
+		if (ClusterPlanShouldStop())
+		{
+			if (projInfo)
+				return ExecClearTuple(projInfo->pi_slot);
+			else
+				return ExecClearTuple(node->ss_ScanTupleSlot);
+		}
+#endif /* ADB */
+
 		slot = ExecScanFetch(node, accessMtd, recheckMtd);
 
 		/*
@@ -43,7 +43,13 @@ ClusterGatherState *ExecInitClusterGather(ClusterGather *node, EState *estate, i
 	if((flags & EXEC_FLAG_EXPLAIN_ONLY) == 0)
 		gatherstate->remote_running = GetPGconnAttatchCurrentInterXact(node->rnodes);
 
-	gatherstate->recv_state = createClusterRecvState((PlanState*)gatherstate, false);
+	/*
+	 * Received tuples may point into the libpq input buffer only when we are
+	 * the top plan node, the executor sends each of them to DestReceiver
+	 * before fetching next one. Any other parent may keep it, copy it.
+	 */
+	gatherstate->recv_state = createClusterRecvState((PlanState*)gatherstate,
+		estate->es_plannedstmt == NULL || estate->es_plannedstmt->planTree != (Plan*)node);
 
 	gatherstate->check_rep_processed = node->check_rep_processed;
 
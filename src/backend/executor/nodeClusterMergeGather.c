@@ -7,21 +7,38 @@
 #include "executor/execCluster.h"
 #include "executor/executor.h"
 #include "intercomm/inter-comm.h"
-#include "lib/binaryheap.h"
+#include "lib/losertree.h"
 #include "libpq/libpq-node.h"
 #include "libpq/libpq-fe.h"
+#include "utils/memutils.h"
 
 #include "executor/nodeClusterMergeGather.h"
 
+/* max count of tuples prefetched for each remote node */
+#define CMG_BATCH_TUPLES	64
+
+typedef struct CMGBatch
+{
+	MemoryContext	context;	/* memory of tuples, reset when all returned */
+	MinimalTuple	tuples[CMG_BATCH_TUPLES];
+	int				ntuples;	/* count of tuples in batch */
+	int				next;		/* index of next tuple to return */
+	bool			eof;		/* got executor end message */
+}CMGBatch;
+
 typedef struct CMGHookContext
 {
-	PlanState *ps;
-	TupleTableSlot *slot;
-	ClusterRecvState *state;
+	ClusterMergeGatherState *ps;
+	CMGBatch	   *batch;
+	int				want;		/* stop when batch have this many tuples */
 }CMGHookContext;
 
-static int cmg_heap_compare_slots(Datum a, Datum b, void *arg);
-static TupleTableSlot *cmg_get_remote_slot(PGconn *conn, TupleTableSlot *slot, ClusterMergeGatherState *ps);
+static int cmg_compare_inputs(int a, int b, void *arg);
+static void cmg_set_abbrev(ClusterMergeGatherState *node, int i);
+static void cmg_advance_first(ClusterMergeGatherState *node);
+static TupleTableSlot *cmg_get_remote_slot(ClusterMergeGatherState *node, int i);
+static void cmg_fetch_batch(ClusterMergeGatherState *node, int i);
+static void cmg_fill_batch(ClusterMergeGatherState *node, int i, int want, bool blocking);
 static bool cmg_pqexec_finish_hook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
 static bool cmg_pqexec_normal_hook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
 
@@ -53,6 +70,12 @@ ClusterMergeGatherState *ExecInitClusterMergeGather(ClusterMergeGather *node, ES
 		sortkey->ssup_nulls_first = node->nullsFirst[i];
 		sortkey->ssup_attno = node->sortColIdx[i];
 
+		/*
+		 * abbreviated key of first sort key is converted once for
+		 * each tuple of input, and reused in all comparisons of it
+		 */
+		sortkey->abbreviate = (i == 0);
+
 		PrepareSortSupportFromOrderingOp(node->sortOperators[i], sortkey);
 	}
 
@@ -60,13 +83,18 @@ ClusterMergeGatherState *ExecInitClusterMergeGather(ClusterMergeGather *node, ES
 	Assert(nremote > 0);
 	ps->nremote = nremote;
 
-	ps->binheap = binaryheap_allocate(nremote+1, cmg_heap_compare_slots, ps);
+	ps->tree = losertree_allocate(nremote+1, cmg_compare_inputs, ps);
+	ps->abbrevs = palloc0(sizeof(ps->abbrevs[0]) * (nremote+1));
 	ps->conns = palloc0(sizeof(ps->conns[0]) * nremote);
 	ps->slots = palloc0(sizeof(ps->slots[0]) * (nremote+1));
+	ps->batches = palloc0(sizeof(ps->batches[0]) * nremote);
 	for(i=0;i<nremote;++i)
 	{
 		ps->slots[i] = ExecAllocTableSlot(&estate->es_tupleTable);
 		ExecSetSlotDescriptor(ps->slots[i], ps->ps.ps_ResultTupleSlot->tts_tupleDescriptor);
+		ps->batches[i].context = AllocSetContextCreate(CurrentMemoryContext,
+													   "ClusterMergeGather batch",
+													   ALLOCSET_DEFAULT_SIZES);
 	}
 
 	outerPlanState(ps) = ExecStartClusterPlan(outerPlan(node)
@@ -95,64 +123,50 @@ TupleTableSlot *ExecClusterMergeGather(ClusterMergeGatherState *node)
 	ClusterGatherType gatherType;
 	int32	i;
 
-re_get_:
 	if(node->initialized == false)
 	{
 		result = ExecProcNode(outerPlanState(node));
 		if(!TupIsNull(result))
 		{
 			node->slots[node->nremote] = result;
-			binaryheap_add_unordered(node->binheap, Int32GetDatum(node->nremote));
+			cmg_set_abbrev(node, node->nremote);
+			losertree_add_unordered(node->tree, node->nremote);
 		}else
 		{
 			node->local_end = true;
 		}
 		for(i=0;i<node->nremote;++i)
 		{
-			result = cmg_get_remote_slot(node->conns[i], node->slots[i], node);
+			result = cmg_get_remote_slot(node, i);
 			if(!TupIsNull(result))
-				binaryheap_add_unordered(node->binheap, Int32GetDatum(i));
+			{
+				cmg_set_abbrev(node, i);
+				losertree_add_unordered(node->tree, i);
+			}
 		}
-		binaryheap_build(node->binheap);
+		losertree_build(node->tree);
 		node->initialized = true;
-	}else if (!binaryheap_empty(node->binheap))
+	}else if (!losertree_empty(node->tree))
 	{
-		i = DatumGetInt32(binaryheap_first(node->binheap));
-		if(i < node->nremote)
-		{
-			result = cmg_get_remote_slot(node->conns[i], node->slots[i], node);
-		}else
-		{
-			Assert(i == node->nremote);
-			result = ExecProcNode(outerPlanState(node));
-			node->slots[i] = result;
-		}
-		if(!TupIsNull(result))
-			binaryheap_replace_first(node->binheap, Int32GetDatum(i));
-		else
-			binaryheap_remove_first(node->binheap);
+		cmg_advance_first(node);
 	}
 
-	if(binaryheap_empty(node->binheap))
+	gatherType = ((ClusterMergeGather*)node->ps.plan)->gatherType;
+	while ((i = losertree_first(node->tree)) >= 0)
 	{
-		result = ExecClearTuple(node->ps.ps_ResultTupleSlot);
-	}else
-	{
-		gatherType = ((ClusterMergeGather*)node->ps.plan)->gatherType;
-		i = DatumGetInt32(binaryheap_first(node->binheap));
 		if(i == node->nremote)
 		{
-			if((gatherType & CLUSTER_GATHER_COORD) == 0)
-				goto re_get_;
+			if(gatherType & CLUSTER_GATHER_COORD)
+				return node->slots[i];
 		}else
 		{
-			if((gatherType & CLUSTER_GATHER_DATANODE) == 0)
-				goto re_get_;
+			if(gatherType & CLUSTER_GATHER_DATANODE)
+				return node->slots[i];
 		}
-		result = node->slots[i];
+		cmg_advance_first(node);
 	}
 
-	return result;
+	return ExecClearTuple(node->ps.ps_ResultTupleSlot);
 }
 
 void ExecFinishClusterMergeGather(ClusterMergeGatherState *node)
@@ -189,8 +203,15 @@ void ExecFinishClusterMergeGather(ClusterMergeGatherState *node)
 
 void ExecEndClusterMergeGather(ClusterMergeGatherState *node)
 {
+	int i;
+
 	ExecEndNode(outerPlanState(node));
 	freeClusterRecvState(node->recv_state);
+	for(i=0;i<node->nremote;++i)
+	{
+		ExecClearTuple(node->slots[i]);
+		MemoryContextDelete(node->batches[i].context);
+	}
 }
 
 void ExecReScanClusterMergeGather(ClusterMergeGatherState *node)
@@ -199,60 +220,189 @@ void ExecReScanClusterMergeGather(ClusterMergeGatherState *node)
 }
 
 /*
- * Compare the tuples in the two given slots.
+ * Compare the tuples of two given inputs.
  */
-static int32
-cmg_heap_compare_slots(Datum a, Datum b, void *arg)
+static int
+cmg_compare_inputs(int a, int b, void *arg)
 {
 	ClusterMergeGatherState *node = (ClusterMergeGatherState *) arg;
-	int32	slot1 = DatumGetInt32(a);
-	int32	slot2 = DatumGetInt32(b);
-
-	TupleTableSlot *s1 = node->slots[slot1];
-	TupleTableSlot *s2 = node->slots[slot2];
+	TupleTableSlot *s1 = node->slots[a];
+	TupleTableSlot *s2 = node->slots[b];
+	SortSupport	sortKey;
+	Datum		datum1,
+				datum2;
+	bool		isNull1,
+				isNull2;
 	int			nkey;
+	int			compare;
 
 	Assert(!TupIsNull(s1));
 	Assert(!TupIsNull(s2));
 
-	for (nkey = 0; nkey < node->nkeys; nkey++)
+	if (node->nkeys == 0)
+		return 0;
+
+	sortKey = node->sortkeys;
+	datum1 = slot_getattr(s1, sortKey->ssup_attno, &isNull1);
+	datum2 = slot_getattr(s2, sortKey->ssup_attno, &isNull2);
+	if (sortKey->abbrev_converter)
+	{
+		compare = ApplySortComparator(node->abbrevs[a], isNull1,
+									  node->abbrevs[b], isNull2,
+									  sortKey);
+		if (compare == 0)
+			compare = ApplySortAbbrevFullComparator(datum1, isNull1,
+													datum2, isNull2,
+													sortKey);
+	}else
 	{
-		SortSupport sortKey = node->sortkeys + nkey;
-		AttrNumber	attno = sortKey->ssup_attno;
-		Datum		datum1,
-					datum2;
-		bool		isNull1,
-					isNull2;
-		int			compare;
+		compare = ApplySortComparator(datum1, isNull1,
+									  datum2, isNull2,
+									  sortKey);
+	}
+	if (compare != 0)
+		return compare;
 
-		datum1 = slot_getattr(s1, attno, &isNull1);
-		datum2 = slot_getattr(s2, attno, &isNull2);
+	for (nkey = 1; nkey < node->nkeys; nkey++)
+	{
+		sortKey = node->sortkeys + nkey;
+		datum1 = slot_getattr(s1, sortKey->ssup_attno, &isNull1);
+		datum2 = slot_getattr(s2, sortKey->ssup_attno, &isNull2);
 
 		compare = ApplySortComparator(datum1, isNull1,
 									  datum2, isNull2,
 									  sortKey);
 		if (compare != 0)
-			return -compare;
+			return compare;
 	}
 	return 0;
 }
 
-static TupleTableSlot *cmg_get_remote_slot(PGconn *conn, TupleTableSlot *slot, ClusterMergeGatherState *ps)
+/*
+ * convert abbreviated key for new tuple of input
+ */
+static void
+cmg_set_abbrev(ClusterMergeGatherState *node, int i)
 {
-	CMGHookContext context;
-	context.ps = &ps->ps;
-	context.slot = slot;
-	context.state = ps->recv_state;
+	SortSupport	sortKey = node->sortkeys;
+	Datum		datum;
+	bool		isNull;
+
+	if (node->nkeys == 0 ||
+		sortKey->abbrev_converter == NULL)
+		return;
+
+	datum = slot_getattr(node->slots[i], sortKey->ssup_attno, &isNull);
+	if (!isNull)
+		node->abbrevs[i] = (*sortKey->abbrev_converter) (datum, sortKey);
+}
+
+/*
+ * advance first input of loser tree to it's next tuple
+ */
+static void
+cmg_advance_first(ClusterMergeGatherState *node)
+{
+	TupleTableSlot *result;
+	int				i = losertree_first(node->tree);
+
+	Assert(i >= 0);
+	if(i < node->nremote)
+	{
+		result = cmg_get_remote_slot(node, i);
+	}else
+	{
+		Assert(i == node->nremote);
+		result = ExecProcNode(outerPlanState(node));
+		node->slots[i] = result;
+	}
+
+	if(TupIsNull(result))
+	{
+		if (i == node->nremote)
+			node->local_end = true;
+		losertree_remove_first(node->tree);
+	}else
+	{
+		cmg_set_abbrev(node, i);
+		losertree_replace_first(node->tree);
+	}
+}
+
+/*
+ * store next prefetched tuple of remote into it's slot,
+ * fetch next batch if all tuples returned
+ */
+static TupleTableSlot *
+cmg_get_remote_slot(ClusterMergeGatherState *node, int i)
+{
+	CMGBatch	   *batch = &node->batches[i];
+	TupleTableSlot *slot = node->slots[i];
+
 	ExecClearTuple(slot);
-	PQNOneExecFinish(conn, cmg_pqexec_finish_hook, &context, true);
+	if (batch->next == batch->ntuples)
+	{
+		batch->next = batch->ntuples = 0;
+		MemoryContextReset(batch->context);
+		if (!batch->eof)
+			cmg_fetch_batch(node, i);
+	}
+
+	if (batch->next < batch->ntuples)
+		ExecStoreMinimalTuple(batch->tuples[batch->next++], slot, false);
+
 	return slot;
 }
 
+static void
+cmg_fetch_batch(ClusterMergeGatherState *node, int i)
+{
+	CMGBatch   *batch = &node->batches[i];
+	int			j;
+
+	Assert(batch->ntuples == 0);
+
+	/* first take tuples already received */
+	cmg_fill_batch(node, i, CMG_BATCH_TUPLES, false);
+	if (batch->ntuples > 0 || batch->eof)
+		return;
+
+	/*
+	 * we must wait this remote, before that, receive data of others
+	 * so they are not blocked by a full socket while we waiting
+	 */
+	for (j=0;j<node->nremote;++j)
+	{
+		CMGBatch *other = &node->batches[j];
+		if (j != i &&
+			other->eof == false &&
+			other->ntuples < CMG_BATCH_TUPLES)
+			cmg_fill_batch(node, j, CMG_BATCH_TUPLES, false);
+	}
+
+	cmg_fill_batch(node, i, 1, true);
+}
+
+static void
+cmg_fill_batch(ClusterMergeGatherState *node, int i, int want, bool blocking)
+{
+	CMGHookContext context;
+
+	Assert(want > node->batches[i].ntuples && want <= CMG_BATCH_TUPLES);
+
+	context.ps = node;
+	context.batch = &node->batches[i];
+	context.want = want;
+	PQNOneExecFinish(node->conns[i], cmg_pqexec_finish_hook, &context, blocking);
+}
+
 bool cmg_pqexec_finish_hook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...)
 {
 	va_list args;
 	const char *buf;
 	CMGHookContext *cmcontext;
+	CMGBatch *batch;
+	MinimalTuple tup;
 	int len;
 
 	switch(type)
@@ -261,21 +411,43 @@ bool cmg_pqexec_finish_hook(void *context, struct pg_conn *conn, PQNHookFuncType
 		return PQNEFHNormal(NULL, conn, type);
 	case PQNHFT_COPY_OUT_DATA:
 		cmcontext = context;
+		batch = cmcontext->batch;
 		va_start(args, type);
 		buf = va_arg(args, const char*);
 		len = va_arg(args, int);
-		cmcontext->state->base_slot = cmcontext->slot;
+		va_end(args);
 		if (buf[0] == CLUSTER_MSG_EXECUTOR_RUN_END)
 		{
-			va_end(args);
+			batch->eof = true;
 			return true;
 		}
-		if(clusterRecvTupleEx(cmcontext->state, buf, len, conn))
+		if (buf[0] == CLUSTER_MSG_TUPLE_DATA)
 		{
-			va_end(args);
-			return true;
+			/* copy tuple into batch directly */
+			uint32 t_len;
+			if (len <= sizeof(t_len))
+				ereport(ERROR, (errmsg("invalid tuple message length")));
+			memcpy(&t_len, buf+1, sizeof(t_len));
+			if (t_len > len-1)
+				ereport(ERROR, (errmsg("invalid tuple message length")));
+			tup = MemoryContextAlloc(batch->context, t_len);
+			memcpy(tup, buf+1, t_len);
+		}else
+		{
+			ClusterRecvState *state = cmcontext->ps->recv_state;
+			MemoryContext oldcontext;
+
+			state->base_slot = cmcontext->ps->ps.ps_ResultTupleSlot;
+			if(clusterRecvTupleEx(state, buf, len, conn) == false)
+				break;
+			oldcontext = MemoryContextSwitchTo(batch->context);
+			tup = ExecCopySlotMinimalTuple(state->base_slot);
+			MemoryContextSwitchTo(oldcontext);
+			ExecClearTuple(state->base_slot);
 		}
-		va_end(args);
+		batch->tuples[batch->ntuples++] = tup;
+		if (batch->ntuples >= cmcontext->want)
+			return true;
 		break;
 	case PQNHFT_COPY_IN_ONLY:
 		PQputCopyEnd(conn, NULL);
@@ -2,18 +2,27 @@
 #include "postgres.h"
 #include "miscadmin.h"
 
+#include "access/htup_details.h"
 #include "access/tuptypeconvert.h"
 #include "executor/executor.h"
+#include "executor/hashjoin.h"
 #include "executor/nodeClusterReduce.h"
 #include "executor/nodeCtescan.h"
+#include "executor/nodeHash.h"
 #include "executor/nodeMaterial.h"
 #include "executor/tuptable.h"
-#include "lib/binaryheap.h"
+#include "lib/bloomfilter.h"
+#include "lib/losertree.h"
 #include "nodes/execnodes.h"
 #include "nodes/nodeFuncs.h"
 #include "pgxc/pgxc.h"
 #include "reduce/adb_reduce.h"
+#include "storage/latch.h"
+#include "storage/shm_toc.h"
+#include "storage/spin.h"
 #include "utils/hsearch.h"
+#include "utils/memutils.h"
+#include "utils/timestamp.h"
 
 extern bool enable_cluster_plan;
 extern bool print_reduce_debug_log;
@@ -24,10 +33,32 @@ extern bool print_reduce_debug_log;
 #define PlanStateGetTargetNodes(state) \
 	PlanGetTargetNodes(((ClusterReduceState *) (state))->ps.plan)
 
+/*
+ * Runtime filter message, when parent HashJoin sends filter, first data
+ * message of each target node is its filter.
+ */
+#define REDUCE_FILTER_ALL			'a'		/* no filter, accept all rows */
+#define REDUCE_FILTER_BLOOM			'b'		/* followed by a bloom_filter */
+#define REDUCE_FILTER_WAIT_TIMEOUT	1000	/* max ms to wait remote filters */
+
+/*
+ * Shared state of parallel-aware ClusterReduce.  Each participant sends its
+ * own EOF to self reduce, the last finished one tells how many participants
+ * there are, see SendParallelEofToRemote.
+ */
+typedef struct ClusterReduceShared
+{
+	slock_t		mutex;
+	bool		launched;		/* is nparticipants known? */
+	int			nparticipants;	/* leader and launched workers */
+	int			nfinished;		/* participants which sent all rows */
+} ClusterReduceShared;
+
 static void ExecInitClusterReduceStateExtra(ClusterReduceState *crstate);
 static void PrepareForReScanClusterReduce(ClusterReduceState *node);
 static bool ExecConnectReduceWalker(PlanState *node, EState *estate);
-static int32 cmr_heap_compare_slots(Datum a, Datum b, void *arg);
+static int cmr_compare_inputs(int a, int b, void *arg);
+static void cmr_set_abbrev(ClusterReduceState *node, int i);
 static TupleTableSlot *GetSlotFromOuter(ClusterReduceState *node);
 static TupleTableSlot *GetMergeSlotFromOuter(ClusterReduceState *node, ReduceEntry entry);
 static TupleTableSlot *GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEntry entry);
@@ -39,6 +70,20 @@ static bool DriveCteScanState(CteScanState *node);
 static bool DriveMaterialState(MaterialState *node);
 static bool DriveClusterReduceWalker(PlanState *node);
 static bool IsThereClusterReduce(PlanState *node);
+static void ClusterReduceSetRemoteEof(ClusterReduceState *node, Oid eof_oid);
+static TupleTableSlot *GetSlotOrFilterFromRemote(ClusterReduceState *node, Oid *eof_oid);
+static void ClusterReduceRecvFilter(ClusterReduceState *node, ReduceEntry entry, TupleTableSlot *slot);
+static void ClusterReduceWaitFilter(ClusterReduceState *node);
+static List *ClusterReduceApplyFilter(ClusterReduceState *node, List *destOids);
+static void ClusterReduceSendEof(ClusterReduceState *node);
+static bool ClusterReduceLaunchedWalker(PlanState *node, int *nworkers_launched);
+static void ClusterReduceCountSend(ClusterReduceState *node, List *destOids, int len);
+static void ClusterReduceCountRecv(ClusterReduceState *node, Oid oid, TupleTableSlot *slot);
+
+/* is EXPLAIN ANALYZE collecting network statistics? */
+#define ClusterReduceNeedStats(node)	((node)->ps.instrument != NULL)
+#define ClusterReduceNeedTimer(node)	\
+	((node)->ps.instrument != NULL && (node)->ps.instrument->need_timer)
 
 static void
 ExecInitClusterReduceStateExtra(ClusterReduceState *crstate)
@@ -83,6 +128,10 @@ ExecInitClusterReduceStateExtra(ClusterReduceState *crstate)
 		entry->re_eof = false;
 		entry->re_slot = NULL;
 		entry->re_store = NULL;
+		entry->re_filter_wait = false;
+		entry->re_filter = NULL;
+		entry->re_send_tuples = entry->re_send_bytes = 0;
+		entry->re_recv_tuples = entry->re_recv_bytes = 0;
 		crstate->rdc_entrys[i] = entry;
 	}
 
@@ -96,7 +145,8 @@ ExecInitClusterReduceStateExtra(ClusterReduceState *crstate)
 			entry->re_slot = MakeSingleTupleTableSlot(slot->tts_tupleDescriptor);
 			entry->re_store = tuplestore_begin_heap(true, false, work_mem);
 		}
-		crstate->binheap = binaryheap_allocate(crstate->nrdcs, cmr_heap_compare_slots, crstate);
+		crstate->tree = losertree_allocate(crstate->nrdcs, cmr_compare_inputs, crstate);
+		crstate->abbrevs = palloc0(sizeof(Datum) * crstate->nrdcs);
 		crstate->initialized = false;
 	}
 }
@@ -116,6 +166,7 @@ ExecInitClusterReduce(ClusterReduce *node, EState *estate, int eflags)
 	crstate = makeNode(ClusterReduceState);
 	crstate->ps.plan = (Plan*)node;
 	crstate->ps.state = estate;
+	initStringInfo(&crstate->recv_buf);
 
 	/*
 	 * We must have a tuplestore buffering the subplan output to do backward
@@ -143,6 +194,12 @@ ExecInitClusterReduce(ClusterReduce *node, EState *estate, int eflags)
 	crstate->eof_network = false;
 	crstate->started = false;
 	crstate->tuplestorestate = NULL;
+	crstate->filter_hjstate = NULL;
+	crstate->filter_sent = false;
+	crstate->filter_waited = false;
+	crstate->nfilters_wait = 0;
+	crstate->filter_store = NULL;
+	crstate->pshared = NULL;
 
 	ExecInitResultTupleSlot(estate, &crstate->ps);
 	ExecAssignExprContext(estate, &crstate->ps);
@@ -168,13 +225,11 @@ ExecInitClusterReduce(ClusterReduce *node, EState *estate, int eflags)
 				sortKey->ssup_attno = node->sortColIdx[i];
 
 				/*
-				 * It isn't feasible to perform abbreviated key conversion, since
-				 * tuples are pulled into mergestate's binary heap as needed.  It
-				 * would likely be counter-productive to convert tuples into an
-				 * abbreviated representation as they're pulled up, so opt out of that
-				 * additional optimization entirely.
+				 * abbreviated key of first sort key is converted once for
+				 * each tuple pulled up into loser tree, and reused in all
+				 * comparisons of it
 				 */
-				sortKey->abbreviate = false;
+				sortKey->abbreviate = (i == 0);
 
 				PrepareSortSupportFromOrderingOp(node->sortOperators[i], sortKey);
 			}
@@ -236,6 +291,11 @@ GetSlotFromOuter(ClusterReduceState *node)
 	Assert(node && node->port);
 	port = node->port;
 	slot = node->ps.ps_ResultTupleSlot;
+
+	/* remote filters are needed before sending any row */
+	if (node->filter_hjstate && !node->filter_waited)
+		ClusterReduceWaitFilter(node);
+
 	while (!node->eof_underlying)
 	{
 		outerValid = false;
@@ -244,6 +304,7 @@ GetSlotFromOuter(ClusterReduceState *node)
 		if (!TupIsNull(outerslot))
 		{
 			econtext = node->ps.ps_ExprContext;
+			ResetExprContext(econtext);
 			econtext->ecxt_outertuple = outerslot;
 			for(;;)
 			{
@@ -272,20 +333,37 @@ GetSlotFromOuter(ClusterReduceState *node)
 				}
 			}
 
+			/* skip remote nodes which can not join this tuple */
+			if (destOids != NIL && node->filter_hjstate)
+				destOids = ClusterReduceApplyFilter(node, destOids);
+
 			/* Here we truly send tuple to remote plan nodes */
 			if(destOids != NIL)
 			{
+				instr_time	start_time;
+				instr_time	end_time;
+				int			len;
+
+				if (ClusterReduceNeedTimer(node))
+					INSTR_TIME_SET_CURRENT(start_time);
 				if(node->convert)
 				{
 					do_type_convert_slot_out(node->convert,
 											 outerslot,
 											 node->convert_slot,
 											 false);
-					SendSlotToRemote(port, destOids, node->convert_slot);
+					len = SendSlotToRemote(port, destOids, node->convert_slot);
 				}else
 				{
-					SendSlotToRemote(port, destOids, outerslot);
+					len = SendSlotToRemote(port, destOids, outerslot);
+				}
+				if (ClusterReduceNeedTimer(node))
+				{
+					INSTR_TIME_SET_CURRENT(end_time);
+					INSTR_TIME_ACCUM_DIFF(node->network_time, end_time, start_time);
 				}
+				if (ClusterReduceNeedStats(node))
+					ClusterReduceCountSend(node, destOids, len);
 				list_free(destOids);
 				destOids = NIL;
 			}
@@ -297,7 +375,7 @@ GetSlotFromOuter(ClusterReduceState *node)
 		} else
 		{
 			/* Here we send eof to remote plan nodes */
-			SendEofToRemote(port, PlanStateGetTargetNodes(node));
+			ClusterReduceSendEof(node);
 
 			node->eof_underlying = true;
 		}
@@ -311,8 +389,6 @@ ExecClusterReduce(ClusterReduceState *node)
 {
 	TupleTableSlot *slot;
 	RdcPort		   *port;
-	ReduceEntry		entry;
-	bool			found;
 	Oid				eof_oid;
 	EState		   *estate;
 	Tuplestorestate*tuplestorestate;
@@ -391,7 +467,9 @@ ExecClusterReduce(ClusterReduceState *node)
 			outerslot = ExecClusterMergeReduce(node);
 		else
 		{
-			while (!node->eof_underlying || !node->eof_network)
+			while (!node->eof_underlying ||
+				   !node->eof_network ||
+				   node->filter_store != NULL)
 			{
 				/* fetch tuple from outer node */
 				if (!node->eof_underlying)
@@ -401,37 +479,40 @@ ExecClusterReduce(ClusterReduceState *node)
 						break;
 				}
 
+				/* fetch tuple got while waiting remote filters */
+				if (node->filter_store != NULL)
+				{
+					outerslot = slot;
+					if (tuplestore_gettupleslot(node->filter_store, true, false, slot))
+						break;
+					tuplestore_end(node->filter_store);
+					node->filter_store = NULL;
+				}
+
 				/* fetch tuple from network */
 				if (!node->eof_network)
 				{
-					ExecClearTuple(slot);
-					eof_oid = InvalidOid;
+					instr_time	start_time;
+					instr_time	end_time;
+					bool		timing;
+
+					timing = node->eof_underlying && ClusterReduceNeedTimer(node);
+					if (timing)
+						INSTR_TIME_SET_CURRENT(start_time);
 					if (node->eof_underlying)
 						rdc_set_block(port);
 					else
 						(void) rdc_try_read_some(port);
 
-					if(node->convert)
-					{
-						GetSlotFromRemote(port, node->convert_slot, NULL, &eof_oid, &node->closed_remote);
-						outerslot = do_type_convert_slot_in(node->convert, node->convert_slot, slot, false);
-					}else
+					outerslot = GetSlotOrFilterFromRemote(node, &eof_oid);
+					if (timing)
 					{
-						outerslot = GetSlotFromRemote(port, slot, NULL, &eof_oid, &node->closed_remote);
+						INSTR_TIME_SET_CURRENT(end_time);
+						INSTR_TIME_ACCUM_DIFF(node->network_time, end_time, start_time);
 					}
-
 					if (OidIsValid(eof_oid))
-					{
-						found = false;
-						entry = hash_search(node->rdc_htab, &eof_oid, HASH_FIND, &found);
-						Assert(found);
-						if (!entry->re_eof)
-						{
-							entry->re_eof = true;
-							node->neofs++;
-						}
-						node->eof_network = (node->neofs == node->nrdcs - 1);
-					} else if (!TupIsNull(outerslot))
+						ClusterReduceSetRemoteEof(node, eof_oid);
+					else if (!TupIsNull(outerslot))
 						break;
 				}
 			}
@@ -512,6 +593,9 @@ GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEntry entry)
 	Oid					slot_oid;
 	Oid					eof_oid;
 	bool				found;
+	bool				timing;
+	instr_time			start_time;
+	instr_time			end_time;
 
 	Assert(node && node->port && node->nkeys > 0);
 
@@ -536,11 +620,14 @@ GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEntry entry)
 		return ExecClearTuple(cur_slot);
 
 	port = node->port;
+	timing = ClusterReduceNeedTimer(node);
 	while (!entry->re_eof)
 	{
 		ExecClearTuple(cur_slot);
 		slot_oid = InvalidOid;
 		eof_oid = InvalidOid;
+		if (timing)
+			INSTR_TIME_SET_CURRENT(start_time);
 		if (node->eof_underlying)
 			rdc_set_block(port);
 		else
@@ -548,11 +635,20 @@ GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEntry entry)
 
 		if(node->convert)
 		{
-			GetSlotFromRemote(port, node->convert_slot, &slot_oid, &eof_oid, &(node->closed_remote));
+			GetSlotFromRemote(port, node->convert_slot, &slot_oid, &eof_oid, &(node->closed_remote), &node->recv_buf);
+			if (ClusterReduceNeedStats(node) && OidIsValid(slot_oid))
+				ClusterReduceCountRecv(node, slot_oid, node->convert_slot);
 			outerslot = do_type_convert_slot_in(node->convert, node->convert_slot, cur_slot, true);
 		}else
 		{
-			outerslot = GetSlotFromRemote(port, cur_slot, &slot_oid, &eof_oid, &(node->closed_remote));
+			outerslot = GetSlotFromRemote(port, cur_slot, &slot_oid, &eof_oid, &(node->closed_remote), &node->recv_buf);
+			if (ClusterReduceNeedStats(node) && OidIsValid(slot_oid))
+				ClusterReduceCountRecv(node, slot_oid, outerslot);
+		}
+		if (timing)
+		{
+			INSTR_TIME_SET_CURRENT(end_time);
+			INSTR_TIME_ACCUM_DIFF(node->network_time, end_time, start_time);
 		}
 
 		if (OidIsValid(eof_oid))
@@ -579,7 +675,15 @@ GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEntry entry)
 		{
 			Assert(OidIsValid(slot_oid));
 			if (slot_oid == cur_oid)
+			{
+				/*
+				 * slot point to input buffer of port, but it kept in merge
+				 * until next tuple of this entry fetched, so copy it now
+				 */
+				if (!node->convert)
+					ExecMaterializeSlot(outerslot);
 				return outerslot;
+			}
 
 			found = false;
 			othr_entry = hash_search(node->rdc_htab, &slot_oid, HASH_FIND, &found);
@@ -597,21 +701,28 @@ GetMergeSlotFromRemote(ClusterReduceState *node, ReduceEntry entry)
 static TupleTableSlot *
 ExecClusterMergeReduce(ClusterReduceState *node)
 {
-	TupleTableSlot	   *result;
 	ReduceEntry			entry;
-	bool				found;
 	int					i;
 
 	Assert(node && node->nkeys > 0);
 	if (!node->initialized)
 	{
-		/* initialize local slot */
-		found = false;
-		entry = hash_search(node->rdc_htab, &PGXCNodeOid, HASH_FIND, &found);
-		Assert(found && !entry->re_eof);
-		entry->re_slot = GetMergeSlotFromOuter(node, entry);
-		if (!TupIsNull(entry->re_slot))
-			binaryheap_add_unordered(node->binheap, PointerGetDatum(entry));
+		/*
+		 * initialize local slot first, it send tuples of other nodes
+		 */
+		for (i = 0; i < node->nrdcs; i++)
+		{
+			entry = node->rdc_entrys[i];
+			if (entry->re_key != PGXCNodeOid)
+				continue;
+			Assert(!entry->re_eof);
+			entry->re_slot = GetMergeSlotFromOuter(node, entry);
+			if (!TupIsNull(entry->re_slot))
+			{
+				cmr_set_abbrev(node, i);
+				losertree_add_unordered(node->tree, i);
+			}
+		}
 
 		/* iniialize remote slot */
 		for (i = 0; i < node->nrdcs; i++)
@@ -621,74 +732,111 @@ ExecClusterMergeReduce(ClusterReduceState *node)
 				continue;
 			entry->re_slot = GetMergeSlotFromRemote(node, entry);
 			if (!TupIsNull(entry->re_slot))
-				binaryheap_add_unordered(node->binheap, PointerGetDatum(entry));
+			{
+				cmr_set_abbrev(node, i);
+				losertree_add_unordered(node->tree, i);
+			}
 		}
-		binaryheap_build(node->binheap);
+		losertree_build(node->tree);
 		node->initialized = true;
-	} else
+	} else if (!losertree_empty(node->tree))
 	{
-		entry = (ReduceEntry) DatumGetPointer(binaryheap_first(node->binheap));
+		i = losertree_first(node->tree);
+		entry = node->rdc_entrys[i];
 		if (entry->re_key == PGXCNodeOid)
 			entry->re_slot = GetMergeSlotFromOuter(node, entry);
 		else
 			entry->re_slot = GetMergeSlotFromRemote(node, entry);
 
 		if (!TupIsNull(entry->re_slot))
-			binaryheap_replace_first(node->binheap, PointerGetDatum(entry));
-		else
-			(void) binaryheap_remove_first(node->binheap);
+		{
+			cmr_set_abbrev(node, i);
+			losertree_replace_first(node->tree);
+		} else
+			losertree_remove_first(node->tree);
 	}
 
-	if (binaryheap_empty(node->binheap))
-	{
-		result = ExecClearTuple(node->ps.ps_ResultTupleSlot);
-	} else
-	{
-		entry = (ReduceEntry) DatumGetPointer(binaryheap_first(node->binheap));
-		result = entry->re_slot;
-	}
+	i = losertree_first(node->tree);
+	if (i < 0)
+		return ExecClearTuple(node->ps.ps_ResultTupleSlot);
 
-	return result;
+	return node->rdc_entrys[i]->re_slot;
 }
 
 /*
- * Compare the tuples in the two given slots.
+ * Compare the tuples of two given reduce entries.
  */
-static int32
-cmr_heap_compare_slots(Datum a, Datum b, void *arg)
+static int
+cmr_compare_inputs(int a, int b, void *arg)
 {
 	ClusterReduceState *node = (ClusterReduceState *) arg;
-	ReduceEntry			re1 = (ReduceEntry) PointerGetDatum(a);
-	ReduceEntry			re2 = (ReduceEntry) PointerGetDatum(b);
-	TupleTableSlot	   *s1 = re1->re_slot;
-	TupleTableSlot	   *s2 = re2->re_slot;
-	int			nkey;
+	TupleTableSlot	   *s1 = node->rdc_entrys[a]->re_slot;
+	TupleTableSlot	   *s2 = node->rdc_entrys[b]->re_slot;
+	SortSupport			sortKey;
+	Datum				datum1,
+						datum2;
+	bool				isNull1,
+						isNull2;
+	int					nkey;
+	int					compare;
 
 	Assert(!TupIsNull(s1));
 	Assert(!TupIsNull(s2));
 
-	for (nkey = 0; nkey < node->nkeys; nkey++)
+	sortKey = node->sortkeys;
+	datum1 = slot_getattr(s1, sortKey->ssup_attno, &isNull1);
+	datum2 = slot_getattr(s2, sortKey->ssup_attno, &isNull2);
+	if (sortKey->abbrev_converter)
+	{
+		compare = ApplySortComparator(node->abbrevs[a], isNull1,
+									  node->abbrevs[b], isNull2,
+									  sortKey);
+		if (compare == 0)
+			compare = ApplySortAbbrevFullComparator(datum1, isNull1,
+													datum2, isNull2,
+													sortKey);
+	} else
 	{
-		SortSupport sortKey = node->sortkeys + nkey;
-		AttrNumber	attno = sortKey->ssup_attno;
-		Datum		datum1,
-					datum2;
-		bool		isNull1,
-					isNull2;
-		int			compare;
+		compare = ApplySortComparator(datum1, isNull1,
+									  datum2, isNull2,
+									  sortKey);
+	}
+	if (compare != 0)
+		return compare;
 
-		datum1 = slot_getattr(s1, attno, &isNull1);
-		datum2 = slot_getattr(s2, attno, &isNull2);
+	for (nkey = 1; nkey < node->nkeys; nkey++)
+	{
+		sortKey = node->sortkeys + nkey;
+		datum1 = slot_getattr(s1, sortKey->ssup_attno, &isNull1);
+		datum2 = slot_getattr(s2, sortKey->ssup_attno, &isNull2);
 
 		compare = ApplySortComparator(datum1, isNull1,
 									  datum2, isNull2,
 									  sortKey);
 		if (compare != 0)
-			return -compare;
+			return compare;
 	}
 	return 0;
 }
 
+/*
+ * convert abbreviated key for new tuple of reduce entry
+ */
+static void
+cmr_set_abbrev(ClusterReduceState *node, int i)
+{
+	SortSupport	sortKey = node->sortkeys;
+	Datum		datum;
+	bool		isNull;
+
+	if (sortKey->abbrev_converter == NULL)
+		return;
+
+	datum = slot_getattr(node->rdc_entrys[i]->re_slot, sortKey->ssup_attno, &isNull);
+	if (!isNull)
+		node->abbrevs[i] = (*sortKey->abbrev_converter) (datum, sortKey);
+}
+
 static void
 ClusterReducePortCleanupCallback(void *arg)
 {
@@ -741,8 +889,11 @@ ExecEndClusterReduce(ClusterReduceState *node)
 				ExecDropSingleTupleTableSlot(re_slot);
 			if (re_store)
 				tuplestore_end(re_store);
+			if (node->rdc_entrys[i]->re_filter)
+				bloom_free(node->rdc_entrys[i]->re_filter);
 			node->rdc_entrys[i]->re_slot = NULL;
 			node->rdc_entrys[i]->re_store = NULL;
+			node->rdc_entrys[i]->re_filter = NULL;
 		}
 		pfree(node->rdc_entrys);
 		node->rdc_entrys = NULL;
@@ -759,6 +910,9 @@ ExecEndClusterReduce(ClusterReduceState *node)
 	if (node->tuplestorestate != NULL)
 		tuplestore_end(node->tuplestorestate);
 	node->tuplestorestate = NULL;
+	if (node->filter_store != NULL)
+		tuplestore_end(node->filter_store);
+	node->filter_store = NULL;
 
 	/* release convert */
 	if(node->convert)
@@ -766,6 +920,7 @@ ExecEndClusterReduce(ClusterReduceState *node)
 		ExecDropSingleTupleTableSlot(node->convert_slot);
 		free_type_convert(node->convert);
 	}
+	pfree(node->recv_buf.data);
 
 	ExecEndNode(outerPlanState(node));
 }
@@ -830,6 +985,12 @@ ExecReScanClusterReduce(ClusterReduceState *node)
 	if (!node->started)
 		return;
 
+	/* workers are gone, rows they sent can not be got again */
+	if (node->ps.plan->parallel_aware)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("parallel ClusterReduce not support rescan")));
+
 	ExecClearTuple(node->ps.ps_ResultTupleSlot);
 
 	if (node->eflags != 0)
@@ -897,7 +1058,7 @@ PrepareForReScanClusterReduce(ClusterReduceState *node)
 
 	if (node->nkeys > 0)
 	{
-		binaryheap_reset(node->binheap);
+		losertree_reset(node->tree);
 		node->initialized = false;
 	}
 
@@ -908,6 +1069,505 @@ PrepareForReScanClusterReduce(ClusterReduceState *node)
 	node->neofs = 0;
 }
 
+static void
+ClusterReduceSetRemoteEof(ClusterReduceState *node, Oid eof_oid)
+{
+	ReduceEntry		entry;
+	bool			found = false;
+
+	entry = hash_search(node->rdc_htab, &eof_oid, HASH_FIND, &found);
+	Assert(found);
+	if (!entry->re_eof)
+	{
+		entry->re_eof = true;
+		node->neofs++;
+	}
+	/* closed without sending filter */
+	if (entry->re_filter_wait)
+	{
+		entry->re_filter_wait = false;
+		node->nfilters_wait--;
+	}
+	node->eof_network = (node->neofs == node->nrdcs - 1);
+}
+
+/*
+ * GetSlotOrFilterFromRemote
+ *
+ * Like GetSlotFromRemote, but remote runtime filters are consumed here and
+ * returns an empty slot for them. Returns NULL if no whole message.
+ */
+static TupleTableSlot *
+GetSlotOrFilterFromRemote(ClusterReduceState *node, Oid *eof_oid)
+{
+	TupleTableSlot *slot;
+	TupleTableSlot *recv_slot;
+	ReduceEntry		entry;
+	Oid				slot_oid = InvalidOid;
+	bool			found;
+
+	*eof_oid = InvalidOid;
+	slot = ExecClearTuple(node->ps.ps_ResultTupleSlot);
+	recv_slot = GetSlotFromRemote(node->port,
+								  node->convert ? node->convert_slot : slot,
+								  &slot_oid,
+								  eof_oid,
+								  &node->closed_remote,
+								  &node->recv_buf);
+	if (recv_slot == NULL)
+		return NULL;
+
+	if (ClusterReduceNeedStats(node) && OidIsValid(slot_oid))
+		ClusterReduceCountRecv(node, slot_oid, recv_slot);
+
+	if (!TupIsNull(recv_slot) && node->nfilters_wait > 0)
+	{
+		entry = hash_search(node->rdc_htab, &slot_oid, HASH_FIND, &found);
+		Assert(found);
+		if (entry->re_filter_wait)
+		{
+			ClusterReduceRecvFilter(node, entry, recv_slot);
+			ExecClearTuple(recv_slot);
+			return slot;
+		}
+	}
+
+	if (node->convert)
+		return do_type_convert_slot_in(node->convert, recv_slot, slot, false);
+
+	return recv_slot;
+}
+
+static void
+ClusterReduceRecvFilter(ClusterReduceState *node, ReduceEntry entry, TupleTableSlot *slot)
+{
+	MinimalTuple	tup = slot->tts_mintuple;
+	const char	   *data;
+	Size			len;
+	MemoryContext	oldcontext;
+
+	Assert(tup && entry->re_filter_wait && entry->re_filter == NULL);
+	data = (const char *) tup + MINIMAL_TUPLE_DATA_OFFSET;
+	len = tup->t_len - MINIMAL_TUPLE_DATA_OFFSET;
+
+	if (len > 1 && data[0] == REDUCE_FILTER_BLOOM)
+	{
+		oldcontext = MemoryContextSwitchTo(node->ps.state->es_query_cxt);
+		entry->re_filter = bloom_restore(data + 1, len - 1);
+		MemoryContextSwitchTo(oldcontext);
+		if (entry->re_filter == NULL)
+			ereport(ERROR,
+					(errmsg("[PLAN %d] invalid runtime filter from node %u",
+							PlanNodeID(node->ps.plan), entry->re_key)));
+	} else if (len != 1 || data[0] != REDUCE_FILTER_ALL)
+	{
+		ereport(ERROR,
+				(errmsg("[PLAN %d] unexpected runtime filter message from node %u",
+						PlanNodeID(node->ps.plan), entry->re_key)));
+	}
+
+	entry->re_filter_wait = false;
+	node->nfilters_wait--;
+}
+
+/*
+ * ClusterReduceWaitFilter
+ *
+ * Wait for runtime filters of other target nodes, but not more than
+ * REDUCE_FILTER_WAIT_TIMEOUT: a node may not run its HashJoin until
+ * ClusterReduce driven at end, and rows sent to a node without filter
+ * are just not filtered. Tuples got meanwhile are saved in filter_store.
+ */
+static void
+ClusterReduceWaitFilter(ClusterReduceState *node)
+{
+	List		   *target = PlanStateGetTargetNodes(node);
+	TupleTableSlot *slot;
+	ReduceEntry		entry;
+	TimestampTz		start;
+	long			secs;
+	int				microsecs;
+	long			timeout;
+	Oid				eof_oid;
+	int				rc;
+	int				i;
+
+	Assert(node->filter_hjstate && !node->filter_waited);
+	node->filter_waited = true;
+
+	/* HashJoin did not build hash table, tell others accept all rows */
+	if (!node->filter_sent)
+		ExecClusterReduceSendFilter(node, NULL);
+
+	/*
+	 * Filters are sent to target nodes only, a node only sending rows sends
+	 * them unfiltered rather than waiting for filters never coming.
+	 */
+	if (!list_member_oid(target, PGXCNodeOid) || node->eof_network)
+		return;
+
+	for (i = 0; i < node->nrdcs; i++)
+	{
+		entry = node->rdc_entrys[i];
+		if (entry->re_key != PGXCNodeOid &&
+			!entry->re_eof &&
+			list_member_oid(target, entry->re_key))
+		{
+			entry->re_filter_wait = true;
+			node->nfilters_wait++;
+		}
+	}
+	if (node->nfilters_wait == 0)
+		return;
+
+	node->filter_store = tuplestore_begin_heap(false, false, work_mem);
+	start = GetCurrentTimestamp();
+	(void) rdc_try_read_some(node->port);
+	while (node->nfilters_wait > 0)
+	{
+		slot = GetSlotOrFilterFromRemote(node, &eof_oid);
+		if (slot == NULL)
+		{
+			TimestampDifference(start, GetCurrentTimestamp(), &secs, &microsecs);
+			timeout = REDUCE_FILTER_WAIT_TIMEOUT - (secs * 1000 + microsecs / 1000);
+			if (timeout <= 0)
+				break;
+
+			rc = WaitLatchOrSocket(MyLatch,
+								   WL_LATCH_SET | WL_SOCKET_READABLE | WL_TIMEOUT,
+								   RdcSocket(node->port),
+								   timeout);
+			if (rc & WL_LATCH_SET)
+				ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
+			(void) rdc_try_read_some(node->port);
+		} else if (OidIsValid(eof_oid))
+		{
+			ClusterReduceSetRemoteEof(node, eof_oid);
+		} else if (!TupIsNull(slot))
+		{
+			tuplestore_puttupleslot(node->filter_store, slot);
+		}
+	}
+
+	adb_elog(print_reduce_debug_log, LOG,
+		"ClusterReduce(%d) %d runtime filters not got in time",
+		PlanNodeID(node->ps.plan), node->nfilters_wait);
+}
+
+/*
+ * ClusterReduceApplyFilter
+ *
+ * Remove remote nodes from destOids which filter certainly reject the
+ * join key of current outer tuple.
+ */
+static List *
+ClusterReduceApplyFilter(ClusterReduceState *node, List *destOids)
+{
+	HashJoinState  *hjstate = node->filter_hjstate;
+	List		   *result;
+	ListCell	   *lc;
+	ReduceEntry		entry;
+	uint32			hashvalue;
+	Oid				oid;
+	bool			found;
+
+	/* parent HashJoin did not build hash table */
+	if (hjstate->hj_HashTable == NULL)
+		return destOids;
+
+	if (!ExecHashGetHashValue(hjstate->hj_HashTable,
+							  node->ps.ps_ExprContext,
+							  hjstate->hj_OuterHashKeys,
+							  true,		/* outer tuple */
+							  false,	/* parent is not fill outer */
+							  &hashvalue))
+	{
+		/* NULL join key never matched */
+		InstrCountFiltered1(node, list_length(destOids));
+		list_free(destOids);
+		return NIL;
+	}
+
+	result = NIL;
+	foreach (lc, destOids)
+	{
+		oid = lfirst_oid(lc);
+		entry = hash_search(node->rdc_htab, &oid, HASH_FIND, &found);
+		Assert(found);
+		if (entry->re_filter &&
+			bloom_lacks_hash(entry->re_filter, hashvalue))
+			continue;
+		result = lappend_oid(result, oid);
+	}
+	InstrCountFiltered1(node, list_length(destOids) - list_length(result));
+	list_free(destOids);
+
+	return result;
+}
+
+/*
+ * ExecClusterReduceUseFilter
+ *
+ * Called by HashJoin which outer is node, returns true if node will filter
+ * outer rows by bloom filter of hash table of other nodes. All nodes must
+ * make the same choice, so it only depends on plan.
+ */
+bool
+ExecClusterReduceUseFilter(PlanState *node, HashJoinState *hjstate)
+{
+	ClusterReduceState *crstate;
+
+	if (node == NULL || !IsA(node, ClusterReduceState))
+		return false;
+
+	/*
+	 * not support rescan and merge reduce, and parallel workers which all
+	 * would send a filter
+	 */
+	crstate = (ClusterReduceState *) node;
+	if (crstate->eflags != 0 ||
+		crstate->ps.plan->parallel_aware ||
+		((ClusterReduce *) crstate->ps.plan)->numCols > 0)
+		return false;
+
+	crstate->filter_hjstate = hjstate;
+	return true;
+}
+
+/*
+ * ExecClusterReduceSendFilter
+ *
+ * Send local filter to other target nodes, NULL filter means accept all.
+ */
+void
+ExecClusterReduceSendFilter(ClusterReduceState *node, bloom_filter *filter)
+{
+	List		   *dest_nodes;
+	ListCell	   *lc;
+	StringInfoData	buf;
+	Oid				oid;
+
+	AssertArg(node && IsA(node, ClusterReduceState));
+	Assert(node->filter_hjstate && node->port);
+	if (node->filter_sent)
+		return;
+	node->filter_sent = true;
+
+	/* only target nodes receive rows, nobody wait filter from us */
+	if (!list_member_oid(PlanStateGetTargetNodes(node), PGXCNodeOid))
+		return;
+
+	dest_nodes = NIL;
+	foreach (lc, PlanStateGetTargetNodes(node))
+	{
+		oid = lfirst_oid(lc);
+		if (oid != PGXCNodeOid &&
+			!list_member_oid(node->closed_remote, oid))
+			dest_nodes = lappend_oid(dest_nodes, oid);
+	}
+	if (dest_nodes == NIL)
+		return;
+
+	/* too much bits set, it can not reject many rows */
+	if (filter && bloom_prop_bits_set(filter) > 0.9)
+		filter = NULL;
+
+	initStringInfo(&buf);
+	if (filter)
+	{
+		appendStringInfoChar(&buf, REDUCE_FILTER_BLOOM);
+		appendBinaryStringInfo(&buf, (const char *) filter, bloom_size(filter));
+	} else
+	{
+		appendStringInfoChar(&buf, REDUCE_FILTER_ALL);
+	}
+	SendDataToRemote(node->port, dest_nodes, buf.data, buf.len);
+
+	adb_elog(print_reduce_debug_log, LOG,
+		"ClusterReduce(%d) send %s runtime filter of %d bytes",
+		PlanNodeID(node->ps.plan), filter ? "bloom" : "empty", buf.len);
+
+	pfree(buf.data);
+	list_free(dest_nodes);
+}
+
+/*
+ * ClusterReduceSendEof
+ *
+ * Tell self reduce all rows of outer are sent.
+ */
+static void
+ClusterReduceSendEof(ClusterReduceState *node)
+{
+	ClusterReduceShared *pshared = node->pshared;
+	int					nparticipants = 0;
+
+	if (pshared == NULL)
+	{
+		SendEofToRemote(node->port, PlanStateGetTargetNodes(node));
+		return;
+	}
+
+	SpinLockAcquire(&pshared->mutex);
+	pshared->nfinished++;
+	if (pshared->launched &&
+		pshared->nfinished == pshared->nparticipants)
+		nparticipants = pshared->nparticipants;
+	SpinLockRelease(&pshared->mutex);
+
+	SendParallelEofToRemote(node->port, PlanStateGetTargetNodes(node), nparticipants);
+}
+
+static void
+ClusterReduceCountSend(ClusterReduceState *node, List *destOids, int len)
+{
+	ListCell	   *lc;
+	ReduceEntry		entry;
+	Oid				oid;
+
+	foreach (lc, destOids)
+	{
+		oid = lfirst_oid(lc);
+		entry = hash_search(node->rdc_htab, &oid, HASH_FIND, NULL);
+		if (entry)
+		{
+			entry->re_send_tuples++;
+			entry->re_send_bytes += len;
+		}
+	}
+}
+
+static void
+ClusterReduceCountRecv(ClusterReduceState *node, Oid oid, TupleTableSlot *slot)
+{
+	ReduceEntry		entry;
+
+	if (TupIsNull(slot) || slot->tts_mintuple == NULL)
+		return;
+
+	entry = hash_search(node->rdc_htab, &oid, HASH_FIND, NULL);
+	if (entry)
+	{
+		entry->re_recv_tuples++;
+		entry->re_recv_bytes += slot->tts_mintuple->t_len - MINIMAL_TUPLE_DATA_OFFSET;
+	}
+}
+
+/*
+ * ExecClusterReduceGetInstrument
+ *
+ * Fill network statistics of ClusterReduce for EXPLAIN ANALYZE, the traffic
+ * with each other node of the reduce group is palloc'd in current memory
+ * context.
+ */
+void
+ExecClusterReduceGetInstrument(ClusterReduceState *node, ClusterInstrumentation *ci)
+{
+	ReduceEntry		entry;
+	int				i;
+
+	AssertArg(node && ci);
+	ci->network_time = INSTR_TIME_GET_DOUBLE(node->network_time);
+	ci->spill_bytes = node->port ? node->port->spill_bytes : 0;
+	ci->num_peers = 0;
+	ci->peers = NULL;
+	if (node->nrdcs <= 1)
+		return;
+
+	ci->peers = palloc0(sizeof(ci->peers[0]) * node->nrdcs);
+	for (i = 0; i < node->nrdcs; i++)
+	{
+		entry = node->rdc_entrys[i];
+		if (entry->re_key == PGXCNodeOid)
+			continue;
+		ci->peers[ci->num_peers].nodeOid = entry->re_key;
+		ci->peers[ci->num_peers].send_tuples = entry->re_send_tuples;
+		ci->peers[ci->num_peers].send_bytes = entry->re_send_bytes;
+		ci->peers[ci->num_peers].recv_tuples = entry->re_recv_tuples;
+		ci->peers[ci->num_peers].recv_bytes = entry->re_recv_bytes;
+		ci->num_peers++;
+	}
+}
+
+/* ----------------------------------------------------------------
+ *		ExecClusterReduceEstimate
+ *
+ *		estimates the space required to serialize ClusterReduce node.
+ * ----------------------------------------------------------------
+ */
+void
+ExecClusterReduceEstimate(ClusterReduceState *node, ParallelContext *pcxt)
+{
+	shm_toc_estimate_chunk(&pcxt->estimator, sizeof(ClusterReduceShared));
+	shm_toc_estimate_keys(&pcxt->estimator, 1);
+}
+
+/* ----------------------------------------------------------------
+ *		ExecClusterReduceInitializeDSM
+ *
+ *		Set up shared state of participants.
+ * ----------------------------------------------------------------
+ */
+void
+ExecClusterReduceInitializeDSM(ClusterReduceState *node, ParallelContext *pcxt)
+{
+	ClusterReduceShared *pshared;
+
+	pshared = shm_toc_allocate(pcxt->toc, sizeof(ClusterReduceShared));
+	SpinLockInit(&pshared->mutex);
+	pshared->launched = false;
+	pshared->nparticipants = pcxt->nworkers + 1;
+	pshared->nfinished = 0;
+	shm_toc_insert(pcxt->toc, node->ps.plan->plan_node_id, pshared);
+	node->pshared = pshared;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecClusterReduceInitializeWorker
+ *
+ *		Copy relevant information from TOC into planstate.
+ * ----------------------------------------------------------------
+ */
+void
+ExecClusterReduceInitializeWorker(ClusterReduceState *node, shm_toc *toc)
+{
+	node->pshared = shm_toc_lookup(toc, node->ps.plan->plan_node_id);
+}
+
+/*
+ * ExecClusterReduceWorkersLaunched
+ *
+ * Called by Gather and GatherMerge after workers launched, parallel-aware
+ * ClusterReduce below know how many participants send EOF now.
+ */
+void
+ExecClusterReduceWorkersLaunched(PlanState *node, int nworkers_launched)
+{
+	(void) ClusterReduceLaunchedWalker(node, &nworkers_launched);
+}
+
+static bool
+ClusterReduceLaunchedWalker(PlanState *node, int *nworkers_launched)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, ClusterReduceState) &&
+		((ClusterReduceState *) node)->pshared != NULL)
+	{
+		ClusterReduceShared *pshared = ((ClusterReduceState *) node)->pshared;
+
+		/* leader runs the plan too */
+		SpinLockAcquire(&pshared->mutex);
+		pshared->nparticipants = *nworkers_launched + 1;
+		pshared->launched = true;
+		SpinLockRelease(&pshared->mutex);
+	}
+
+	return planstate_tree_walker(node, ClusterReduceLaunchedWalker, nworkers_launched);
+}
+
 static bool
 ExecConnectReduceWalker(PlanState *node, EState *estate)
 {
@@ -40,6 +40,9 @@
 #include "miscadmin.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
+#ifdef ADB
+#include "executor/nodeClusterReduce.h"
+#endif /* ADB */
 
 
 static TupleTableSlot *gather_getnext(GatherState *gatherstate);
@@ -167,6 +170,9 @@ ExecGather(GatherState *node)
 			pcxt = node->pei->pcxt;
 			LaunchParallelWorkers(pcxt);
 			node->nworkers_launched = pcxt->nworkers_launched;
+#ifdef ADB
+			ExecClusterReduceWorkersLaunched(outerPlanState(node), node->nworkers_launched);
+#endif /* ADB */
 
 			/* Set up tuple queue readers to read the results. */
 			if (pcxt->nworkers_launched > 0)
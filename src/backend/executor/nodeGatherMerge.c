@@ -25,6 +25,9 @@
 #include "miscadmin.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
+#ifdef ADB
+#include "executor/nodeClusterReduce.h"
+#endif /* ADB */
 
 /*
  * Tuple array for each worker
@@ -197,6 +200,9 @@ ExecGatherMerge(GatherMergeState *node)
 			pcxt = node->pei->pcxt;
 			LaunchParallelWorkers(pcxt);
 			node->nworkers_launched = pcxt->nworkers_launched;
+#ifdef ADB
+			ExecClusterReduceWorkersLaunched(outerPlanState(node), node->nworkers_launched);
+#endif /* ADB */
 
 			/* Set up tuple queue readers to read the results. */
 			if (pcxt->nworkers_launched > 0)
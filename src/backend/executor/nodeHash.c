@@ -31,6 +31,9 @@
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#ifdef ADB
+#include "lib/bloomfilter.h"
+#endif /* ADB */
 #include "miscadmin.h"
 #include "utils/dynahash.h"
 #include "utils/memutils.h"
@@ -126,6 +129,10 @@ MultiExecHash(HashState *node)
 				ExecHashTableInsert(hashtable, slot, hashvalue);
 			}
 			hashtable->totalTuples += 1;
+#ifdef ADB
+			if (hashtable->bloom)
+				bloom_add_hash(hashtable->bloom, hashvalue);
+#endif /* ADB */
 		}
 	}
 
@@ -307,6 +314,9 @@ ExecHashTableCreate(Hash *node, List *hashOperators, bool keepNulls)
 	hashtable->spaceAllowedSkew =
 		hashtable->spaceAllowed * SKEW_WORK_MEM_PERCENT / 100;
 	hashtable->chunks = NULL;
+#ifdef ADB
+	hashtable->bloom = NULL;
+#endif /* ADB */
 
 #ifdef HJDEBUG
 	printf("Hashjoin %p: initial nbatch = %d, nbuckets = %d\n",
@@ -20,6 +20,11 @@
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#ifdef ADB
+#include "executor/nodeClusterReduce.h"
+#include "lib/bloomfilter.h"
+#include "optimizer/cost.h"
+#endif /* ADB */
 #include "miscadmin.h"
 #include "utils/memutils.h"
 
@@ -177,12 +182,41 @@ ExecHashJoin(HashJoinState *node)
 												node->hj_HashOperators,
 												HJ_FILL_INNER(node));
 				node->hj_HashTable = hashtable;
+#ifdef ADB
+				if (node->hj_ReduceFilter)
+				{
+					ClusterReduce  *reduce = (ClusterReduce *) outerNode->plan;
+					int				nnodes = list_length(reduce->reduce_oids);
+					MemoryContext	oldcxt = MemoryContextSwitchTo(hashtable->hashCxt);
+
+					/* same size as planner costed, see cost_reduce_filter */
+					hashtable->bloom = bloom_create(hashNode->ps.plan->plan_rows,
+													reduce_filter_max_size(nnodes),
+													0);
+					MemoryContextSwitchTo(oldcxt);
+
+					/*
+					 * Our filter and the ones received from other nodes
+					 * are taken from work_mem of the hash table.
+					 */
+					hashtable->spaceAllowed -= bloom_size(hashtable->bloom) * Max(nnodes, 1);
+				}
+#endif /* ADB */
 
 				/*
 				 * execute the Hash node, to build the hash table
 				 */
 				hashNode->hashtable = hashtable;
 				(void) MultiExecProcNode((PlanState *) hashNode);
+#ifdef ADB
+				/*
+				 * Send it before scanning outer relation, even if the hash
+				 * table is empty, other nodes are waiting for it.
+				 */
+				if (node->hj_ReduceFilter)
+					ExecClusterReduceSendFilter((ClusterReduceState *) outerNode,
+												hashtable->bloom);
+#endif /* ADB */
 
 				/*
 				 * If the inner relation is completely empty, and we're not
@@ -597,6 +631,13 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 	hjstate->hj_JoinState = HJ_BUILD_HASHTABLE;
 	hjstate->hj_MatchedOuter = false;
 	hjstate->hj_OuterNotEmpty = false;
+#ifdef ADB
+	hjstate->hj_ReduceFilter = false;
+	if (node->cluster_reduce_filter &&
+		(eflags & EXEC_FLAG_EXPLAIN_ONLY) == 0)
+		hjstate->hj_ReduceFilter = ExecClusterReduceUseFilter(outerPlanState(hjstate),
+															  hjstate);
+#endif /* ADB */
 
 	return hjstate;
 }
@@ -402,7 +402,14 @@ ExecInsert(ModifyTableState *mtstate,
 			ExecConstraints(resultRelInfo, slot, estate);
 
 #ifdef ADB
-		if (IsCnNode() && resultRemoteRel)
+		if (IsCnNode() && mtstate->mt_remote_insert)
+		{
+			/* sent to datanodes with the other rows, count it here */
+			ExecRemoteInsertRow(mtstate->mt_remote_insert, slot);
+			resultRemoteRel = NULL;
+			newId = InvalidOid;
+		}
+		else if (IsCnNode() && resultRemoteRel)
 		{
 			TupleTableSlot *saveSlot = NULL;
 
@@ -1985,6 +1992,12 @@ ExecModifyTable(ModifyTableState *node)
 	estate->es_result_remoterel = saved_resultRemoteRel;
 #endif
 
+#ifdef ADB
+	/* Send the rows buffered for datanodes */
+	if (node->mt_remote_insert)
+		ExecFinishRemoteInsert(node->mt_remote_insert);
+#endif
+
 	/*
 	 * We're done, but fire AFTER STATEMENT triggers before exiting.
 	 */
@@ -2525,6 +2538,10 @@ ExecInitModifyTable(ModifyTable *node, EState *estate, int eflags)
 	if (estate->es_trig_tuple_slot == NULL)
 		estate->es_trig_tuple_slot = ExecInitExtraTupleSlot(estate);
 
+#ifdef ADB
+	mtstate->mt_remote_insert = ExecInitRemoteInsert(mtstate);
+#endif
+
 	/*
 	 * Lastly, if this is not the primary (canSetTag) ModifyTable node, add it
 	 * to estate->es_auxmodifytables so that it will be run to completion by
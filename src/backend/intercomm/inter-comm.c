@@ -42,6 +42,8 @@ static int HandleSendBegin(NodeHandle *handle,
 						   GlobalTransactionId xid, TimestampTz timestamp,
 						   bool need_xact_block, bool *already_begin);
 static bool HandleFinishCommandHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
+static void HandleFinishPipelined(NodeHandle *handle);
+static bool HandleFinishPipelinedHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...);
 static int HandleCommandCompleteMsg(PGconn *conn);
 
 static PGcustumFuns CommandCustomFuncs = {
@@ -240,6 +242,13 @@ HandleGC(NodeHandle *handle)
 	if (handle)
 	{
 		handle->node_owner = NULL;
+		handle->node_pipelined = false;
+		/* a snapshot never acknowledged, don't trust the xids of the node */
+		if (handle->node_snapshot_sent != 0)
+		{
+			handle->node_snapshot = 0;
+			handle->node_snapshot_sent = 0;
+		}
 		PQNExecFinish_trouble(handle->node_conn);
 	}
 }
@@ -272,6 +281,12 @@ HandleListGC(List *handle_list)
 void
 HandleCacheOrGC(NodeHandle *handle)
 {
+	if (handle && handle->node_pipelined)
+	{
+		HandleFinishPipelined(handle);
+		return ;
+	}
+
 	if (!handle || !handle->node_owner)
 	{
 		HandleGC(handle);
@@ -298,6 +313,81 @@ HandleCacheOrGC(NodeHandle *handle)
 	}
 }
 
+/*
+ * HandleSetPipelined
+ *
+ * leave the insert just sent on NodeHandle running, it is finished by
+ * HandleCacheOrGC when the handle is used next time, at latest by
+ * FinishPipelinedNodeHandles at the end of the statement.
+ */
+void
+HandleSetPipelined(NodeHandle *handle)
+{
+	Assert(handle && handle->node_conn);
+	handle->node_owner = NULL;
+	handle->node_pipelined = true;
+}
+
+/*
+ * HandleListGCPipelined
+ *
+ * discard the result of pipelined inserts of "handle_list" without
+ * reporting their errors.  Used before rolling back, an error raised
+ * there would abort the abort and leave the transaction open on AGTM.
+ */
+void
+HandleListGCPipelined(const List *handle_list)
+{
+	NodeHandle	   *handle;
+	ListCell	   *lc_handle;
+
+	foreach (lc_handle, handle_list)
+	{
+		handle = (NodeHandle *) lfirst(lc_handle);
+		if (handle->node_pipelined)
+			HandleGC(handle);
+	}
+}
+
+/*
+ * HandleFinishPipelined
+ *
+ * wait for the pipelined insert of NodeHandle, report its error if any
+ */
+static void
+HandleFinishPipelined(NodeHandle *handle)
+{
+	Assert(handle && handle->node_conn);
+	handle->node_pipelined = false;
+	(void) PQNOneExecFinish(handle->node_conn, HandleFinishPipelinedHook, NULL, true);
+}
+
+static bool
+HandleFinishPipelinedHook(void *context, struct pg_conn *conn, PQNHookFuncType type, ...)
+{
+	va_list args;
+
+	switch(type)
+	{
+		case PQNHFT_ERROR:
+			return PQNEFHNormal(NULL, conn, type);
+		case PQNHFT_RESULT:
+			{
+				PGresult	   *res;
+
+				va_start(args, type);
+				res = va_arg(args, PGresult*);
+				if(res && PQresultStatus(res) == PGRES_FATAL_ERROR)
+					PQNReportResultError(res, conn, ERROR, true);
+				va_end(args);
+			}
+			break;
+		default:
+			break;
+	}
+	return false;
+}
+
 /*
  * HandleListCacheOrGC
  *
@@ -348,6 +438,65 @@ HandleBegin(InterXactState state, NodeHandle *handle,
 	return 0;
 }
 
+/*
+ * HandleListBegin
+ *
+ * send BEGIN message to every handle of "handle_list" before receiving
+ * any response, so the transaction starts on all nodes in one round trip
+ * rather than one per node.
+ *
+ * return NULL if OK
+ * return the first handle in trouble otherwise
+ */
+NodeHandle *
+HandleListBegin(InterXactState state, const List *handle_list,
+				GlobalTransactionId xid, TimestampTz timestamp,
+				bool need_xact_block)
+{
+	NodeHandle	   *handle;
+	NodeHandle	   *failed = NULL;
+	ListCell	   *lc_handle;
+	List		   *begin_list = NIL;
+	bool			already_begin;
+
+	/*
+	 * Cache or GC every handle before any BEGIN is sent, it may report an
+	 * error of a pipelined insert, and nodes which began already would not
+	 * be known to roll back then.
+	 */
+	HandleListCacheOrGC((List *) handle_list);
+
+	foreach (lc_handle, handle_list)
+	{
+		handle = (NodeHandle *) lfirst(lc_handle);
+
+		if (!HandleSendBegin(handle, xid, timestamp, need_xact_block, &already_begin))
+		{
+			failed = handle;
+			break;
+		}
+
+		if (!already_begin && need_xact_block)
+			begin_list = lappend(begin_list, handle);
+	}
+
+	/*
+	 * Receive all responses even if some node failed, the nodes which did
+	 * begin must be known to roll back.
+	 */
+	foreach (lc_handle, begin_list)
+	{
+		handle = (NodeHandle *) lfirst(lc_handle);
+		if (HandleFinishCommand(handle, TRANS_START_TAG))
+			InterXactSaveBeginNodes(state, handle->node_id);
+		else if (failed == NULL)
+			failed = handle;
+	}
+	list_free(begin_list);
+
+	return failed;
+}
+
 /*
  * HandleSendBegin
  *
@@ -509,7 +658,8 @@ HandleSendTimestamp(NodeHandle *handle, TimestampTz timestamp)
 /*
  * HandleSendSnapshot
  *
- * send global snapshot and don't wait response
+ * send global snapshot and don't wait response, the serial of its xids
+ * becomes handle->node_snapshot when the node completes a command
  *
  * return 0 if any trouble
  * return 1 if OK
@@ -519,6 +669,7 @@ HandleSendSnapshot(NodeHandle *handle, Snapshot snapshot)
 {
 	PGconn		   *conn;
 	StringInfoData	buf;
+	int64			sent_serial;
 
 	if (!snapshot)
 		return 1;
@@ -528,8 +679,13 @@ HandleSendSnapshot(NodeHandle *handle, Snapshot snapshot)
 	if (!PQsendQueryStart(conn))
 		return 0;
 
+	/* last snapshot sent was never acknowledged, the node may not have it */
+	if (handle->node_snapshot_sent != 0)
+		handle->node_snapshot = handle->node_snapshot_sent = 0;
+
 	initStringInfo(&buf);
-	InterXactSerializeSnapshot(&buf, snapshot);
+	sent_serial = handle->node_snapshot;
+	InterXactSerializeSnapshotTo(&buf, snapshot, &sent_serial);
 
 	/* construct the global snapshot message */
 	if (pqPutMsgStart('s', true, conn) < 0 ||
@@ -537,8 +693,10 @@ HandleSendSnapshot(NodeHandle *handle, Snapshot snapshot)
 		pqPutMsgEnd(conn) < 0)
 	{
 		pqHandleSendFailure(conn);
+		handle->node_snapshot = handle->node_snapshot_sent = 0;
 		return 0;
 	}
+	handle->node_snapshot_sent = sent_serial;
 
 	return 1;
 }
@@ -611,8 +769,10 @@ HandleSendQueryExtend(NodeHandle *handle,
 	/* cache or GC */
 	HandleCacheOrGC(handle);
 
-	paramTypeNames = (const char **) palloc0(nParams * sizeof(const char *));
-	for (i = 0; i < nParams; i++)
+	/* type names are only sent by Parse message */
+	if (command)
+		paramTypeNames = (const char **) palloc0(nParams * sizeof(const char *));
+	for (i = 0; command && i < nParams; i++)
 	{
 		/*
 		 * Parameters with no types are simply ignored.
@@ -642,7 +802,7 @@ HandleSendQueryExtend(NodeHandle *handle,
 		  						  resultFormats);
 
 	/* free resources */
-	for (i = 0; i < nParams; i++)
+	for (i = 0; command && i < nParams; i++)
 		pfree((void *) paramTypeNames[i]);
 	safe_pfree(paramTypeNames);
 
@@ -59,7 +59,6 @@ StartRemoteCopy(RemoteCopyState *node)
 	const char		   *copy_query;
 	const List		   *node_list;
 	bool				is_from;
-	bool				already_begin;
 	Snapshot			snap;
 	CommandId			cmid;
 	TimestampTz			timestamp;
@@ -90,13 +89,19 @@ StartRemoteCopy(RemoteCopyState *node)
 
 	PG_TRY();
 	{
+		/* Begin transaction on all remote nodes together */
+		handle = HandleListBegin(state, cur_handle->handles, gxid, timestamp, is_from);
+		if (handle)
+			ereport(ERROR,
+					(errcode(ERRCODE_INTERNAL_ERROR),
+					 errmsg("Fail to begin transaction"),
+					 errnode(NameStr(handle->node_name)),
+					 errdetail("%s", HandleGetError(handle))));
+
 		foreach (lc_handle, cur_handle->handles)
 		{
 			handle = (NodeHandle *) lfirst(lc_handle);
-			already_begin = false;
-
-			if (!HandleBegin(state, handle, gxid, timestamp, is_from, &already_begin) ||
-				!HandleStartRemoteCopy(handle, cmid, snap, copy_query))
+			if (!HandleStartRemoteCopy(handle, cmid, snap, copy_query))
 			{
 				ereport(ERROR,
 						(errcode(ERRCODE_INTERNAL_ERROR),
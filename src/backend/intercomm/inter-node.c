@@ -83,6 +83,36 @@ ResetNodeExecutor(void)
 	}
 }
 
+/*
+ * FinishPipelinedNodeHandles
+ *
+ * Wait for the pipelined inserts of each NodeHandle in NodeHandleCacheHash
+ * and report their errors.  It is called before the command tag of the
+ * statement is sent, so a failing insert is reported by itself.
+ */
+void
+FinishPipelinedNodeHandles(void)
+{
+	if (NodeHandleCacheHash != NULL)
+	{
+		HASH_SEQ_STATUS	status;
+		NodeHandle	   *handle;
+		List		   *handle_list = NIL;
+		ListCell	   *lc_handle;
+
+		hash_seq_init(&status, NodeHandleCacheHash);
+		while ((handle = (NodeHandle *) hash_seq_search(&status)) != NULL)
+		{
+			if (handle->node_pipelined)
+				handle_list = lappend(handle_list, handle);
+		}
+
+		foreach (lc_handle, handle_list)
+			HandleCacheOrGC((NodeHandle *) lfirst(lc_handle));
+		list_free(handle_list);
+	}
+}
+
 /*
  * InitializeNodeExecutor
  *
@@ -254,6 +284,9 @@ MakeNodeHandleEntry(Oid node_id, Name node_name, NodeType node_type,
 		handle->node_conn = NULL;
 		handle->node_context = NULL;
 		handle->node_owner = NULL;
+		handle->node_snapshot = 0;
+		handle->node_snapshot_sent = 0;
+		handle->node_pipelined = false;
 	}
 
 	if (node_primary)
@@ -411,6 +444,9 @@ HandleDetachPGconn(NodeHandle *handle)
 		HandleGC(handle);
 		handle->node_conn = NULL;
 		handle->node_context = NULL;
+		handle->node_snapshot = 0;
+		handle->node_snapshot_sent = 0;
+		handle->node_pipelined = false;
 	}
 }
 
@@ -486,6 +522,9 @@ GetPGconnAttatchToHandle(List *node_list, List *handle_list)
 						 		NameStr(handle->node_name)),
 						 errhint("%s", PQerrorMessage(conn))));
 			handle->node_conn = conn;
+			handle->node_snapshot = 0;
+			handle->node_snapshot_sent = 0;
+			handle->node_pipelined = false;
 			handle->node_conn->custom = handle;
 			handle->node_conn->funs = InterQueryCustomFuncs;
 		}
@@ -26,6 +26,7 @@
 #include "agtm/agtm.h"
 #include "catalog/pgxc_node.h"
 #include "commands/prepare.h"
+#include "commands/vacuum.h"
 #include "executor/clusterReceiver.h"
 #include "executor/executor.h"
 #include "executor/execCluster.h"
@@ -36,6 +37,7 @@
 #include "nodes/nodeFuncs.h"
 #include "optimizer/pgxcplan.h"
 #include "parser/parse_coerce.h"
+#include "parser/parsetree.h"
 #include "pgxc/locator.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
@@ -47,6 +49,7 @@
 #include "utils/snapmgr.h"
 
 #define REMOTE_FETCH_SIZE	64
+#define ANALYZE_REMOTE_OVERSAMPLE	1.2
 
 typedef struct RemoteQueryContext
 {
@@ -59,6 +62,7 @@ typedef struct RemoteQueryContext
 static List *RewriteExecNodes(RemoteQueryState *planstate, ExecNodes *exec_nodes);
 static TupleTableSlot *InterXactQuery(InterXactState state, RemoteQueryState *node, TupleTableSlot *destslot);
 static bool HandleStartRemoteQuery(NodeHandle *handle, RemoteQueryState *node);
+static bool RemoteQueryCanPipeline(RemoteQueryState *node, InterXactState state);
 static TupleTableSlot *RestoreRemoteSlot(const char *buf, int len, TupleTableSlot *slot, Oid node_id);
 static bool StoreRemoteSlot(RemoteQueryContext *context, TupleTableSlot *iterslot, TupleTableSlot *destslot);
 static bool HandleCopyOutData(RemoteQueryContext *context, PGconn *conn, const char *buf, int len);
@@ -70,7 +74,12 @@ static int HandleQueryCompleteMsg(PGconn *conn);
 static int ExtractProcessedNumber(const char *buf, int len, uint64 *nprocessed);
 static void deparseStringLiteral(StringInfo buf, const char *val);
 static void deparseCnAnalyzeSizeSql(StringInfo buf, Relation rel);
-static void deparseCnAnalyzeSampleSql(StringInfo buf, Relation rel, int targper);
+static void deparseCnAnalyzeSampleSql(StringInfo buf, Relation rel, double targper);
+static void deparseCnAnalyzeDistinctSql(StringInfo buf, Relation rel);
+static char *deparseRelationName(Relation rel);
+static List *GetAnalyzeNodeList(Relation relation);
+static RemoteQueryState *BeginAnalyzeRemoteQuery(Relation relation, List *dn_list, char *sql, EState **pestate);
+static void EndAnalyzeRemoteQuery(RemoteQueryState *rstate, EState *estate);
 
 static PGcustumFuns QueryCustomFuncs = {
 	HandleRowDescriptionMsg,
@@ -130,6 +139,46 @@ HandleInterUnknownMsg(PGconn *conn, char c, int msgLength)
 	return -1;
 }
 
+/*
+ * Get value of a Const or an external Param without building an ExprState,
+ * they are what a generic plan of a prepared statement routes by.
+ */
+static bool
+GetSimpleExprValue(Node *node, ExprContext *econtext, Datum *value, bool *isnull)
+{
+	if (IsA(node, Const))
+	{
+		*value = ((Const *) node)->constvalue;
+		*isnull = ((Const *) node)->constisnull;
+		return true;
+	}
+
+	if (IsA(node, Param) &&
+		((Param *) node)->paramkind == PARAM_EXTERN)
+	{
+		Param		   *param = (Param *) node;
+		ParamListInfo	params = econtext->ecxt_param_list_info;
+		ParamExternData *prm;
+
+		if (params == NULL ||
+			param->paramid <= 0 ||
+			param->paramid > params->numParams)
+			return false;
+
+		prm = &params->params[param->paramid - 1];
+		if (!OidIsValid(prm->ptype) && params->paramFetch != NULL)
+			(*params->paramFetch) (params, param->paramid);
+		if (prm->ptype != param->paramtype)
+			return false;
+
+		*value = prm->value;
+		*isnull = prm->isnull;
+		return true;
+	}
+
+	return false;
+}
+
 static List *
 RewriteExecNodes(RemoteQueryState *planstate, ExecNodes *exec_nodes)
 {
@@ -138,9 +187,9 @@ RewriteExecNodes(RemoteQueryState *planstate, ExecNodes *exec_nodes)
 	Datum			partvalue;
 	int				nelems, idx;
 	ListCell	   *lc;
-	Datum		   *en_expr_values;
-	bool		   *en_expr_nulls;
-	Oid			   *en_expr_types;
+	Datum			en_expr_values[FUNC_MAX_ARGS];
+	bool			en_expr_nulls[FUNC_MAX_ARGS];
+	Oid				en_expr_types[FUNC_MAX_ARGS];
 	Node		   *en_expr_node;
 	List		   *result = NIL;
 	RelationLocInfo*rel_loc = NULL;
@@ -150,7 +199,7 @@ RewriteExecNodes(RemoteQueryState *planstate, ExecNodes *exec_nodes)
 	if (!exec_nodes || !exec_nodes->en_expr)
 		return NIL;
 
-	rel_loc = GetRelationLocInfo(exec_nodes->en_relid);
+	rel_loc = GetRelationLocInfoCached(exec_nodes->en_relid);
 	Assert(rel_loc);
 
 	/*
@@ -161,10 +210,10 @@ RewriteExecNodes(RemoteQueryState *planstate, ExecNodes *exec_nodes)
 	Assert(!(exec_nodes->accesstype == RELATION_ACCESS_READ_FOR_UPDATE &&
 			IsRelationReplicated(rel_loc)));
 
+	/* one expression for each distribute column or function argument */
 	nelems = list_length(exec_nodes->en_expr);
-	en_expr_values = (Datum *) palloc0(sizeof(Datum) * nelems);
-	en_expr_nulls = (bool *) palloc0(sizeof(bool) * nelems);
-	en_expr_types = (Oid *) palloc0(sizeof(Oid) * nelems);
+	if (nelems > FUNC_MAX_ARGS)
+		elog(ERROR, "too many distribute expressions: %d", nelems);
 
 	if (IsRelationDistributedByUserDefined(rel_loc))
 	{
@@ -178,32 +227,41 @@ RewriteExecNodes(RemoteQueryState *planstate, ExecNodes *exec_nodes)
 	foreach (lc, exec_nodes->en_expr)
 	{
 		en_expr_node = (Node *)lfirst(lc);
-		if (IsRelationDistributedByUserDefined(rel_loc) && en_expr_node)
+		if (en_expr_node == NULL)
+		{
+			en_expr_values[idx] = (Datum)0;
+			en_expr_nulls[idx] = true;
+			en_expr_types[idx] = InvalidOid;
+			idx++;
+			continue;
+		}
+
+		en_expr_types[idx] = exprType(en_expr_node);
+		if (argtypes && argtypes[idx] != en_expr_types[idx])
 		{
 			en_expr_node = coerce_to_target_type(NULL, en_expr_node,
-												exprType(en_expr_node),
+												en_expr_types[idx],
 												argtypes[idx],
 												-1,
 												COERCION_IMPLICIT,
 												COERCE_IMPLICIT_CAST,
 												-1);
+			en_expr_types[idx] = exprType(en_expr_node);
 		}
-		if (en_expr_node)
+
+		if (!GetSimpleExprValue(en_expr_node,
+								planstate->ss.ps.ps_ExprContext,
+								&partvalue,
+								&isnull))
 		{
 			estate = ExecInitExpr((Expr*)en_expr_node, (PlanState *) planstate);
 			partvalue = ExecEvalExpr(estate,
 									 planstate->ss.ps.ps_ExprContext,
 									 &isnull,
 									 NULL);
-			en_expr_values[idx] = isnull ? (Datum)0 : partvalue;
-			en_expr_nulls[idx] = isnull;
-			en_expr_types[idx] = exprType(en_expr_node);
-		} else
-		{
-			en_expr_values[idx] = (Datum)0;
-			en_expr_nulls[idx] = true;
-			en_expr_types[idx] = InvalidOid;
 		}
+		en_expr_values[idx] = isnull ? (Datum)0 : partvalue;
+		en_expr_nulls[idx] = isnull;
 		idx++;
 	}
 
@@ -212,10 +270,6 @@ RewriteExecNodes(RemoteQueryState *planstate, ExecNodes *exec_nodes)
 
 	result = GetInvolvedNodes(rel_loc, nelems, en_expr_values, en_expr_nulls,
 							  en_expr_types, exec_nodes->accesstype);
-	pfree(en_expr_values);
-	pfree(en_expr_nulls);
-	pfree(en_expr_types);
-	FreeRelationLocInfo(rel_loc);
 
 	return result;
 }
@@ -232,7 +286,7 @@ GetRemoteNodeList(RemoteQueryState *planstate, ExecNodes *exec_nodes, RemoteQuer
 		else
 		if (OidIsValid(exec_nodes->en_relid))
 		{
-			RelationLocInfo	   *rel_loc = GetRelationLocInfo(exec_nodes->en_relid);
+			RelationLocInfo	   *rel_loc = GetRelationLocInfoCached(exec_nodes->en_relid);
 			Datum				value = (Datum)0;
 			bool				null = true;
 			Oid					type = InvalidOid;
@@ -260,8 +314,6 @@ GetRemoteNodeList(RemoteQueryState *planstate, ExecNodes *exec_nodes, RemoteQuer
 					node_list = list_copy(exec_nodes->nodeids);
 				}
 			}
-
-			FreeRelationLocInfo(rel_loc);
 		}
 		else
 		{
@@ -326,7 +378,77 @@ StartRemoteQuery(RemoteQueryState *node, TupleTableSlot *destslot)
 	node->cur_handles = list_copy(state->cur_handle->handles);
 	node->all_handles = list_concat_unique_ptr(node->all_handles, node->cur_handles);
 
-	return InterXactQuery(state, node, destslot);
+	destslot = InterXactQuery(state, node, destslot);
+
+	/*
+	 * Don't wait for a pipelined insert, the handle is not ours any more.
+	 * Its result is collected when the handle is used next time or before
+	 * the command tag of the statement is sent, whichever comes first.
+	 * Row count is only reported if the insert succeeded.
+	 */
+	if (RemoteQueryCanPipeline(node, state))
+	{
+		NodeHandle *handle = (NodeHandle *) linitial(node->cur_handles);
+
+		HandleSetPipelined(handle);
+		node->all_handles = list_delete_ptr(node->all_handles, handle);
+		list_free(node->cur_handles);
+		node->cur_handles = NIL;
+		node->rqs_processed = 1;
+	}
+
+	return destslot;
+}
+
+/*
+ * RemoteQueryCanPipeline
+ *
+ * Is the remote query an insert of exactly one row on one node, which the
+ * coordinator needs not wait for.  Batched inserts keep several datanodes
+ * busy at the same time then, e.g. inserts run by a function.  Error of
+ * such insert is reported when the node is used next time, at latest
+ * before the statement completes, so the statement always reports it.
+ */
+static bool
+RemoteQueryCanPipeline(RemoteQueryState *node, InterXactState state)
+{
+	RemoteQuery	   *step = (RemoteQuery *) node->ss.ps.plan;
+	Query		   *query = step->remote_query;
+	RangeTblEntry  *rte;
+	Relation		rel;
+	bool			result;
+
+	if (!pipeline_remote_insert ||
+		!state->need_xact_block ||
+		IsSubTransaction() ||
+		step->force_autocommit ||
+		step->read_only ||
+		step->cursor ||
+		step->base_tlist != NIL ||
+		step->has_row_marks ||
+		step->rq_params_internal ||
+		state->cur_handle->pr_handle != NULL ||
+		list_length(node->cur_handles) != 1)
+		return false;
+
+	/* INSERT ... VALUES of one row, no RETURNING, ON CONFLICT or WITH */
+	if (query == NULL ||
+		query->commandType != CMD_INSERT ||
+		!query->canSetTag ||
+		query->returningList != NIL ||
+		query->onConflict != NULL ||
+		query->cteList != NIL ||
+		query->jointree == NULL ||
+		query->jointree->fromlist != NIL)
+		return false;
+
+	/* triggers and rules may change the number of rows inserted */
+	rte = rt_fetch(query->resultRelation, query->rtable);
+	rel = relation_open(rte->relid, NoLock);
+	result = (rel->trigdesc == NULL && rel->rd_rules == NULL);
+	relation_close(rel, NoLock);
+
+	return result;
 }
 
 static TupleTableSlot *
@@ -337,7 +459,6 @@ InterXactQuery(InterXactState state, RemoteQueryState *node, TupleTableSlot *des
 	NodeHandle		   *pr_handle;
 	ListCell		   *lc_handle;
 	bool				need_xact_block;
-	bool				already_begin;
 	GlobalTransactionId	gxid;
 	TimestampTz			timestamp = GetCurrentTransactionStartTimestamp();
 
@@ -355,6 +476,15 @@ InterXactQuery(InterXactState state, RemoteQueryState *node, TupleTableSlot *des
 
 	PG_TRY();
 	{
+		/* Begin transaction on all remote nodes together */
+		handle = HandleListBegin(state, cur_handle->handles, gxid, timestamp, need_xact_block);
+		if (handle)
+			ereport(ERROR,
+					(errcode(ERRCODE_INTERNAL_ERROR),
+					 errmsg("Fail to begin transaction"),
+					 errnode(NameStr(handle->node_name)),
+					 errhint("%s", HandleGetError(handle))));
+
 		if (pr_handle)
 		{
 			Tuplestorestate	   *tuplestorestate = node->tuplestorestate;
@@ -362,8 +492,7 @@ InterXactQuery(InterXactState state, RemoteQueryState *node, TupleTableSlot *des
 
 			Assert(tuplestorestate);
 
-			if (!HandleBegin(state, pr_handle, gxid, timestamp, need_xact_block, &already_begin) ||
-				!HandleStartRemoteQuery(pr_handle, node))
+			if (!HandleStartRemoteQuery(pr_handle, node))
 			{
 				ereport(ERROR,
 						(errcode(ERRCODE_INTERNAL_ERROR),
@@ -394,8 +523,7 @@ InterXactQuery(InterXactState state, RemoteQueryState *node, TupleTableSlot *des
 			if (handle == pr_handle)
 				continue;
 
-			if (!HandleBegin(state, handle, gxid, timestamp, need_xact_block, &already_begin) ||
-				!HandleStartRemoteQuery(handle, node))
+			if (!HandleStartRemoteQuery(handle, node))
 			{
 				ereport(ERROR,
 						(errcode(ERRCODE_INTERNAL_ERROR),
@@ -910,6 +1038,13 @@ HandleQueryCompleteMsg(PGconn *conn)
 	handle = (NodeHandle *) conn->custom;
 	owner = handle->node_owner;
 
+	/* the node has set the snapshot sent with this command */
+	if (handle->node_snapshot_sent != 0)
+	{
+		handle->node_snapshot = handle->node_snapshot_sent;
+		handle->node_snapshot_sent = 0;
+	}
+
 	if (!owner)
 		return 0;
 
@@ -1010,70 +1145,82 @@ deparseStringLiteral(StringInfo buf, const char *val)
 	appendStringInfoChar(buf, '\'');
 }
 
-static void
-deparseCnAnalyzeSizeSql(StringInfo buf, Relation rel)
+static char *
+deparseRelationName(Relation rel)
 {
 	StringInfoData	namebuf;
 	char		   *nspname;
 	char		   *relname;
 
-	initStringInfo(&namebuf);
 	nspname = get_namespace_name(RelationGetNamespace(rel));
 	relname = RelationGetRelationName(rel);
 	initStringInfo(&namebuf);
 	appendStringInfo(&namebuf, "%s.%s",
 					 quote_identifier(nspname), quote_identifier(relname));
 
-	appendStringInfoString(buf, "SELECT pg_catalog.pg_relation_size(");
-	deparseStringLiteral(buf, namebuf.data);
-	appendStringInfo(buf, "::pg_catalog.regclass) / %d AS blocknum,"
-						  "count(1) as count FROM ONLY %s",
-						  BLCKSZ, namebuf.data);
-	pfree(namebuf.data);
+	return namebuf.data;
 }
 
-BlockNumber
-CnGetRelationNumberOfBlocks(Relation relation, uint64 *reltuples)
+/*
+ * Datanodes have been analyzed before coordinator (see vacuum_dn), so
+ * reltuples of datanode is fresh, we scale it by current relation size
+ * instead of counting all rows. Only count rows when datanode never
+ * analyzed.
+ */
+static void
+deparseCnAnalyzeSizeSql(StringInfo buf, Relation rel)
 {
-	List			   *dn_list;
-	RemoteQuery		   *rquery;
-	RemoteQueryState   *rstate;
-	RelationLocInfo	   *rloc;
-	ExecNodes		   *rnodes;
-	EState			   *estate;
-	TupleTableSlot	   *slot;
-	MemoryContext		oldcontext;
-	StringInfoData		sqlbuf;
-	Datum				value;
-	bool				isnull;
-	BlockNumber			totalpages;
-	uint64				totalrows;
-	int					tuplecnt;
+	StringInfoData	regclass;
+	char		   *relname;
 
-	/* Sancity check */
-	Assert(IsCnNode());
-	Assert(RelationGetLocInfo(relation));
+	relname = deparseRelationName(rel);
+	initStringInfo(&regclass);
+	deparseStringLiteral(&regclass, relname);
+	appendStringInfoString(&regclass, "::pg_catalog.regclass");
+
+	appendStringInfo(buf, "SELECT pg_catalog.pg_relation_size(%s) / %d AS blocknum,"
+						  "CASE WHEN c.relpages > 0 THEN "
+						  "pg_catalog.ceil(c.reltuples / c.relpages * "
+						  "(pg_catalog.pg_relation_size(%s) / %d))::pg_catalog.int8 "
+						  "ELSE (SELECT count(1) FROM ONLY %s) END AS count "
+						  "FROM pg_catalog.pg_class c WHERE c.oid = %s",
+						  regclass.data, BLCKSZ,
+						  regclass.data, BLCKSZ,
+						  relname, regclass.data);
+	pfree(regclass.data);
+	pfree(relname);
+}
 
-	rloc = RelationGetLocInfo(relation);
+/*
+ * Get datanodes to analyze, returns NIL if not any one
+ */
+static List *
+GetAnalyzeNodeList(Relation relation)
+{
+	RelationLocInfo	   *rloc = RelationGetLocInfo(relation);
 
-	/* Get involved datanodes */
 	if (list_length(rloc->nodeids) > 0)
 	{
 		if (IsRelationReplicated(rloc))
-			dn_list = GetPreferredRepNodes((const List *) rloc->nodeids);
-		else
-			dn_list = rloc->nodeids;
-	} else
-	{
-		dn_list = GetAllDnIDL(false);
+			return GetPreferredRepNodes((const List *) rloc->nodeids);
+		return rloc->nodeids;
 	}
 
-	if (list_length(dn_list) <= 0)
-		return 0;
+	return GetAllDnIDL(false);
+}
 
-	/* Construct analyze query */
-	initStringInfo(&sqlbuf);
-	deparseCnAnalyzeSizeSql(&sqlbuf, relation);
+/*
+ * Start analyze query on datanodes, caller fetch result from returned
+ * state and call EndAnalyzeRemoteQuery at end
+ */
+static RemoteQueryState *
+BeginAnalyzeRemoteQuery(Relation relation, List *dn_list, char *sql, EState **pestate)
+{
+	RemoteQuery		   *rquery;
+	ExecNodes		   *rnodes;
+	EState			   *estate;
+	RemoteQueryState   *rstate;
+	MemoryContext		oldcontext;
 
 	/* Build ExecNodes */
 	rnodes = MakeExecNodesByOids(RelationGetLocInfo(relation),
@@ -1084,7 +1231,7 @@ CnGetRelationNumberOfBlocks(Relation relation, uint64 *reltuples)
 	rquery = makeNode(RemoteQuery);
 	rquery->combine_type = COMBINE_TYPE_NONE;
 	rquery->exec_nodes = rnodes;
-	rquery->sql_statement = sqlbuf.data;
+	rquery->sql_statement = sql;
 	rquery->force_autocommit = true;
 	rquery->exec_type = EXEC_ON_DATANODES;
 
@@ -1095,6 +1242,46 @@ CnGetRelationNumberOfBlocks(Relation relation, uint64 *reltuples)
 	rstate = ExecInitRemoteQuery(rquery, estate, 0);
 	MemoryContextSwitchTo(oldcontext);
 
+	*pestate = estate;
+	return rstate;
+}
+
+static void
+EndAnalyzeRemoteQuery(RemoteQueryState *rstate, EState *estate)
+{
+	ExecEndRemoteQuery(rstate);
+	FreeExecutorState(estate);
+}
+
+BlockNumber
+CnGetRelationNumberOfBlocks(Relation relation, uint64 *reltuples)
+{
+	List			   *dn_list;
+	RemoteQueryState   *rstate;
+	EState			   *estate;
+	TupleTableSlot	   *slot;
+	StringInfoData		sqlbuf;
+	Datum				value;
+	bool				isnull;
+	BlockNumber			totalpages;
+	uint64				totalrows;
+	int					tuplecnt;
+
+	/* Sancity check */
+	Assert(IsCnNode());
+	Assert(RelationGetLocInfo(relation));
+
+	/* Get involved datanodes */
+	dn_list = GetAnalyzeNodeList(relation);
+	if (list_length(dn_list) <= 0)
+		return 0;
+
+	/* Construct analyze query */
+	initStringInfo(&sqlbuf);
+	deparseCnAnalyzeSizeSql(&sqlbuf, relation);
+
+	rstate = BeginAnalyzeRemoteQuery(relation, dn_list, sqlbuf.data, &estate);
+
 	totalpages = 0;
 	totalrows = 0;
 	tuplecnt = 0;
@@ -1124,9 +1311,7 @@ CnGetRelationNumberOfBlocks(Relation relation, uint64 *reltuples)
 			totalrows += DatumGetUInt64(value);
 	}
 
-	ExecEndRemoteQuery(rstate);
-
-	FreeExecutorState(estate);
+	EndAnalyzeRemoteQuery(rstate, estate);
 
 	if (reltuples)
 		*reltuples = totalrows;
@@ -1139,28 +1324,16 @@ CnGetRelationNumberOfBlocks(Relation relation, uint64 *reltuples)
 }
 
 static void
-deparseCnAnalyzeSampleSql(StringInfo buf, Relation rel, int targper)
+deparseCnAnalyzeSampleSql(StringInfo buf, Relation rel, double targper)
 {
-	StringInfoData	namebuf;
-	char		   *nspname;
-	char		   *relname;
-
-	if (targper < 0)
-		targper = 1;
-
-	initStringInfo(&namebuf);
-	nspname = get_namespace_name(RelationGetNamespace(rel));
-	relname = RelationGetRelationName(rel);
-	initStringInfo(&namebuf);
-	appendStringInfo(&namebuf, "%s.%s",
-					 quote_identifier(nspname), quote_identifier(relname));
+	char		   *relname = deparseRelationName(rel);
 
-	if (targper >= 100)
-		appendStringInfo(buf, "SELECT * FROM ONLY %s", namebuf.data);
+	if (targper >= 100.0)
+		appendStringInfo(buf, "SELECT * FROM ONLY %s", relname);
 	else
-		appendStringInfo(buf, "SELECT * FROM ONLY %s TABLESAMPLE SYSTEM(%d)",
-						 namebuf.data, targper);
-	pfree(namebuf.data);
+		appendStringInfo(buf, "SELECT * FROM ONLY %s TABLESAMPLE SYSTEM(%g)",
+						 relname, targper);
+	pfree(relname);
 }
 
 int
@@ -1169,49 +1342,38 @@ CnAcquireSampleRowsFunc(Relation relation, int elevel,
 						double *totalrows, double *totaldeadrows)
 {
 	List			   *dn_list;
-	RemoteQuery		   *rquery;
 	RemoteQueryState   *rstate;
-	ExecNodes		   *rnodes;
-	RelationLocInfo	   *rloc;
 	EState			   *estate;
 	TupleTableSlot	   *slot;
-	MemoryContext		oldcontext;
 	StringInfoData		sqlbuf;
 	HeapTuple			tuple;
 	ReservoirStateData	rs;
 	int					numrows = 0;	/* # rows now in reservoir */
 	double				samplerows = 0; /* total # rows collected */
 	double				rowstoskip = -1;	/* -1 means not set yet */
-	int					sampleper = 1;	/* 1% smaple rows */
+	double				sampleper = 1.0;	/* 1% smaple rows */
 
 	/* Sancity check */
 	Assert(IsCnNode());
 	Assert(RelationGetLocInfo(relation));
 
-	rloc = RelationGetLocInfo(relation);
-
 	/* Get involved datanodes */
-	if (list_length(rloc->nodeids) > 0)
-	{
-		if (IsRelationReplicated(rloc))
-			dn_list = GetPreferredRepNodes((const List *) rloc->nodeids);
-		else
-			dn_list = rloc->nodeids;
-	} else
-	{
-		dn_list = GetAllDnIDL(false);
-	}
-
+	dn_list = GetAnalyzeNodeList(relation);
 	if (list_length(dn_list) <= 0)
 		return 0;
 
-	/* Calculate sample percentage */
+	/*
+	 * Calculate sample percentage, all datanodes use same percentage, so
+	 * sample of each datanode is proportional to it's size. Sample a bit
+	 * more than targrows, because SYSTEM sampling is not exact, and the
+	 * reservoir below keeps targrows at most.
+	 */
 	if (*totalrows > 0)
 	{
 		if (*totalrows <= targrows)
-			sampleper = 100;
+			sampleper = 100.0;
 		else
-			sampleper = (int) floor(targrows / *totalrows * 100 + 0.5);
+			sampleper = Min(targrows * ANALYZE_REMOTE_OVERSAMPLE / *totalrows * 100.0, 100.0);
 	}
 
 	/* Prepare for sampling rows */
@@ -1221,25 +1383,7 @@ CnAcquireSampleRowsFunc(Relation relation, int elevel,
 	initStringInfo(&sqlbuf);
 	deparseCnAnalyzeSampleSql(&sqlbuf, relation, sampleper);
 
-	/* Build ExecNodes */
-	rnodes = MakeExecNodesByOids(RelationGetLocInfo(relation),
-								 dn_list,
-								 RELATION_ACCESS_READ);
-
-	/* Build up RemoteQuery */
-	rquery = makeNode(RemoteQuery);
-	rquery->combine_type = COMBINE_TYPE_NONE;
-	rquery->exec_nodes = rnodes;
-	rquery->sql_statement = sqlbuf.data;
-	rquery->force_autocommit = true;
-	rquery->exec_type = EXEC_ON_DATANODES;
-
-	/* Execute query on the data nodes */
-	estate = CreateExecutorState();
-	oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
-	estate->es_snapshot = GetActiveSnapshot();
-	rstate = ExecInitRemoteQuery(rquery, estate, 0);
-	MemoryContextSwitchTo(oldcontext);
+	rstate = BeginAnalyzeRemoteQuery(relation, dn_list, sqlbuf.data, &estate);
 
 	for (;;)
 	{
@@ -1299,9 +1443,7 @@ CnAcquireSampleRowsFunc(Relation relation, int elevel,
 		samplerows += 1;
 	}
 
-	ExecEndRemoteQuery(rstate);
-
-	FreeExecutorState(estate);
+	EndAnalyzeRemoteQuery(rstate, estate);
 
 	/* We assume that we have no dead tuple. */
 	*totaldeadrows = 0.0;
@@ -1327,3 +1469,190 @@ CnAcquireSampleRowsFunc(Relation relation, int elevel,
 
 	return numrows;
 }
+
+/*
+ * Number of distinct values of one column on datanodes, computed by the
+ * ANALYZE of each datanode
+ */
+typedef struct CnRemoteDistinct
+{
+	char	   *attname;
+	int			nnodes;			/* how many datanodes reported */
+	double		max_distinct;	/* max of datanodes */
+	double		sum_distinct;	/* sum of datanodes */
+} CnRemoteDistinct;
+
+static void
+deparseCnAnalyzeDistinctSql(StringInfo buf, Relation rel)
+{
+	char		   *relname = deparseRelationName(rel);
+
+	appendStringInfoString(buf, "SELECT a.attname::pg_catalog.text,"
+								"s.stadistinct::pg_catalog.float8,"
+								"c.reltuples::pg_catalog.float8 "
+								"FROM pg_catalog.pg_statistic s,"
+								"pg_catalog.pg_attribute a,"
+								"pg_catalog.pg_class c "
+								"WHERE c.oid = ");
+	deparseStringLiteral(buf, relname);
+	appendStringInfoString(buf, "::pg_catalog.regclass "
+								"AND s.starelid = c.oid AND NOT s.stainherit "
+								"AND a.attrelid = c.oid AND a.attnum = s.staattnum");
+	pfree(relname);
+}
+
+/*
+ * CnGetRemoteDistinct
+ *
+ * Collect n_distinct of all columns from datanodes, only one small row for
+ * each column of each datanode crosses network. Returns list of
+ * CnRemoteDistinct for CnMergeRemoteDistinct.
+ */
+List *
+CnGetRemoteDistinct(Relation relation)
+{
+	List			   *dn_list;
+	List			   *result = NIL;
+	ListCell		   *lc;
+	RemoteQueryState   *rstate;
+	EState			   *estate;
+	TupleTableSlot	   *slot;
+	StringInfoData		sqlbuf;
+	CnRemoteDistinct   *rd;
+	char			   *attname;
+	double				ndistinct;
+	double				reltuples;
+	Datum				value;
+	bool				isnull;
+
+	Assert(IsCnNode());
+	Assert(RelationGetLocInfo(relation));
+
+	dn_list = GetAnalyzeNodeList(relation);
+	if (list_length(dn_list) <= 0)
+		return NIL;
+
+	initStringInfo(&sqlbuf);
+	deparseCnAnalyzeDistinctSql(&sqlbuf, relation);
+
+	rstate = BeginAnalyzeRemoteQuery(relation, dn_list, sqlbuf.data, &estate);
+
+	for (;;)
+	{
+		ResetPerTupleExprContext(estate);
+
+		slot = ExecProcNode((PlanState *) rstate);
+		if (TupIsNull(slot))
+			break;
+
+		value = slot_getattr(slot, 1, &isnull);
+		if (isnull)
+			continue;
+		attname = TextDatumGetCString(value);
+
+		value = slot_getattr(slot, 2, &isnull);
+		ndistinct = isnull ? 0.0 : DatumGetFloat8(value);
+		value = slot_getattr(slot, 3, &isnull);
+		reltuples = isnull ? 0.0 : DatumGetFloat8(value);
+
+		/* negative stadistinct is fraction of rows */
+		if (ndistinct < 0.0)
+			ndistinct = -ndistinct * reltuples;
+
+		rd = NULL;
+		foreach (lc, result)
+		{
+			if (strcmp(((CnRemoteDistinct *) lfirst(lc))->attname, attname) == 0)
+			{
+				rd = lfirst(lc);
+				break;
+			}
+		}
+		if (rd == NULL)
+		{
+			rd = palloc0(sizeof(*rd));
+			rd->attname = pstrdup(attname);
+			result = lappend(result, rd);
+		}
+		pfree(attname);
+
+		rd->nnodes++;
+		rd->sum_distinct += ndistinct;
+		if (ndistinct > rd->max_distinct)
+			rd->max_distinct = ndistinct;
+	}
+
+	EndAnalyzeRemoteQuery(rstate, estate);
+
+	/* not all datanodes has statistics, we can not use sum of them */
+	foreach (lc, result)
+	{
+		rd = lfirst(lc);
+		if (rd->nnodes != list_length(dn_list))
+			rd->sum_distinct = -1.0;
+	}
+
+	return result;
+}
+
+/*
+ * CnMergeRemoteDistinct
+ *
+ * Correct n_distinct computed by coordinator's sample rows with datanodes.
+ * Values of the distribution column of a table distributed by value are
+ * disjoint between datanodes, so the number is the sum of datanodes, for
+ * other columns it is between max and sum of datanodes.
+ */
+void
+CnMergeRemoteDistinct(Relation relation, List *remote, VacAttrStats *stats, double totalrows)
+{
+	RelationLocInfo	   *rloc = RelationGetLocInfo(relation);
+	CnRemoteDistinct   *rd = NULL;
+	ListCell		   *lc;
+	double				ndistinct;
+
+	if (remote == NIL || !stats->stats_valid || totalrows <= 0)
+		return;
+
+	foreach (lc, remote)
+	{
+		if (strcmp(((CnRemoteDistinct *) lfirst(lc))->attname,
+				   NameStr(stats->attr->attname)) == 0)
+		{
+			rd = lfirst(lc);
+			break;
+		}
+	}
+	if (rd == NULL)
+		return;
+
+	ndistinct = stats->stadistinct;
+	if (ndistinct < 0.0)
+		ndistinct = -ndistinct * totalrows;
+
+	if (rloc &&
+		IsRelationDistributedByValue(rloc) &&
+		rloc->partAttrNum == stats->attr->attnum &&
+		rd->sum_distinct >= 0.0)
+	{
+		ndistinct = rd->sum_distinct;
+	} else
+	{
+		if (ndistinct < rd->max_distinct)
+			ndistinct = rd->max_distinct;
+		if (rd->sum_distinct >= 0.0 && ndistinct > rd->sum_distinct)
+			ndistinct = rd->sum_distinct;
+	}
+
+	if (ndistinct <= 0.0)
+		return;
+	if (ndistinct > totalrows)
+		ndistinct = totalrows;
+
+	/* same as compute_scalar_stats */
+	ndistinct = floor(ndistinct + 0.5);
+	if (ndistinct > 0.1 * totalrows)
+		stats->stadistinct = -(ndistinct / totalrows);
+	else
+		stats->stadistinct = ndistinct;
+}
@@ -27,6 +27,7 @@
 #include "datatype/timestamp.h"
 #include "intercomm/inter-comm.h"
 #include "libpq/libpq-fe.h"
+#include "miscadmin.h"
 #include "pgxc/execRemote.h"
 #include "pgxc/pgxc.h"
 #include "storage/ipc.h"
@@ -53,7 +54,16 @@ static InterXactStateData TopInterXactStateData = {
 	NULL						/* NodeMixHandle for the whole inter transaction block */
 };
 
+/* xids of the global snapshot serialized last, see InterXactSerializeSnapshotTo */
+static GlobalSnapshotXidsId SerializedXidsId;
+static TransactionId *SerializedXids = NULL;
+static int SerializedXcnt = 0;
+static int SerializedSubxcnt = 0;
+static bool SerializedSuboverflowed = false;
+static int SerializedXidsSize = 0;
+
 static void ResetInterXactState(InterXactState state);
+static int64 SerializedXidsSerial(Snapshot snapshot);
 static void InterXactTwoPhase(const char *gid, Oid *nodes, int nnodes, TwoPhaseState tp_state, bool missing_ok);
 static void InterXactTwoPhaseInternal(List *handle_list, char *command, const char *command_tag, bool no_error);
 
@@ -92,6 +102,9 @@ GetPGconnFromHandleList(List *handle_list)
 	foreach (lc_handle, handle_list)
 	{
 		handle = (NodeHandle *) lfirst(lc_handle);
+		/* caller sends its own messages, finish pipelined insert first */
+		if (handle->node_pipelined)
+			HandleCacheOrGC(handle);
 		conn_list = lappend(conn_list, handle->node_conn);
 	}
 
@@ -463,11 +476,28 @@ InterXactBeginNodes(InterXactState state, bool include_self, int *node_num)
  */
 void
 InterXactSerializeSnapshot(StringInfo buf, Snapshot snapshot)
+{
+	InterXactSerializeSnapshotTo(buf, snapshot, NULL);
+}
+
+/*
+ * InterXactSerializeSnapshotTo
+ *
+ * serialize snapshort for a node, the xids are left out when *sent_serial
+ * says the node has got them in an earlier snapshot, a read committed
+ * transaction sends the same xids for every statement while no transaction
+ * ended.  *sent_serial is set to the xids serialized.
+ */
+void
+InterXactSerializeSnapshotTo(StringInfo buf, Snapshot snapshot, int64 *sent_serial)
 {
 	uint32			nval;
+	int64			serial;
 	int				i;
 	AssertArg(buf && snapshot);
 
+	serial = SerializedXidsSerial(snapshot);
+
 	/* RecentGlobalXmin */
 	nval = htonl(RecentGlobalXmin);
 	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(TransactionId));
@@ -480,6 +510,28 @@ InterXactSerializeSnapshot(StringInfo buf, Snapshot snapshot)
 	/* curcid */
 	nval = htonl(snapshot->curcid);
 	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(CommandId));
+	/* identity of xids */
+	nval = htonl(SerializedXidsId.node);
+	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(Oid));
+	nval = htonl(SerializedXidsId.pid);
+	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(int32));
+	nval = htonl((uint32) (SerializedXidsId.start >> 32));
+	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(uint32));
+	nval = htonl((uint32) SerializedXidsId.start);
+	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(uint32));
+	nval = htonl((uint32) (serial >> 32));
+	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(uint32));
+	nval = htonl((uint32) serial);
+	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(uint32));
+
+	if (sent_serial != NULL && *sent_serial == serial)
+	{
+		/* xcnt only */
+		nval = htonl(GLOBAL_SNAPSHOT_SAME_XIDS);
+		appendBinaryStringInfo(buf, (const char *) &nval, sizeof(uint32));
+		return;
+	}
+
 	/* xcnt */
 	nval = htonl(snapshot->xcnt);
 	appendBinaryStringInfo(buf, (const char *) &nval, sizeof(uint32));
@@ -498,6 +550,58 @@ InterXactSerializeSnapshot(StringInfo buf, Snapshot snapshot)
 		nval = htonl(snapshot->subxip[i]);
 		appendBinaryStringInfo(buf, (const char *) &nval, sizeof(TransactionId));
 	}
+
+	if (sent_serial != NULL)
+		*sent_serial = serial;
+}
+
+/*
+ * serial of the xids of snapshot, a new one when they (or suboverflowed)
+ * are not the same as the xids serialized last
+ */
+static int64
+SerializedXidsSerial(Snapshot snapshot)
+{
+	int		nxids = snapshot->xcnt + snapshot->subxcnt;
+
+	if (SerializedXidsId.serial != 0 &&
+		SerializedXcnt == snapshot->xcnt &&
+		SerializedSubxcnt == snapshot->subxcnt &&
+		SerializedSuboverflowed == snapshot->suboverflowed &&
+		(snapshot->xcnt == 0 ||
+		 memcmp(SerializedXids, snapshot->xip,
+				snapshot->xcnt * sizeof(TransactionId)) == 0) &&
+		(snapshot->subxcnt == 0 ||
+		 memcmp(SerializedXids + snapshot->xcnt, snapshot->subxip,
+				snapshot->subxcnt * sizeof(TransactionId)) == 0))
+		return SerializedXidsId.serial;
+
+	/* forget old xids first, in case of error */
+	SerializedXcnt = SerializedSubxcnt = -1;
+	if (nxids > SerializedXidsSize)
+	{
+		if (SerializedXids)
+			pfree(SerializedXids);
+		SerializedXids = NULL;
+		SerializedXidsSize = 0;
+		SerializedXids = MemoryContextAlloc(TopMemoryContext,
+											nxids * sizeof(TransactionId));
+		SerializedXidsSize = nxids;
+	}
+	if (snapshot->xcnt > 0)
+		memcpy(SerializedXids, snapshot->xip,
+			   snapshot->xcnt * sizeof(TransactionId));
+	if (snapshot->subxcnt > 0)
+		memcpy(SerializedXids + snapshot->xcnt, snapshot->subxip,
+			   snapshot->subxcnt * sizeof(TransactionId));
+	SerializedXcnt = snapshot->xcnt;
+	SerializedSubxcnt = snapshot->subxcnt;
+	SerializedSuboverflowed = snapshot->suboverflowed;
+
+	SerializedXidsId.node = PGXCNodeOid;
+	SerializedXidsId.pid = MyProcPid;
+	SerializedXidsId.start = (int64) MyStartTime;
+	return ++SerializedXidsId.serial;
 }
 
 /*
@@ -585,7 +689,6 @@ InterXactUtility(InterXactState state, Snapshot snapshot,
 	NodeMixHandle	   *cur_handle;
 	NodeHandle		   *handle;
 	ListCell		   *lc_handle;
-	bool				already_begin;
 	bool				need_xact_block;
 
 	Assert(state);
@@ -604,12 +707,19 @@ InterXactUtility(InterXactState state, Snapshot snapshot,
 			gxid = GetCurrentTransactionIdIfAny();
 		timestamp = GetCurrentTransactionStartTimestamp();
 
+		/* Begin transaction on all remote nodes together */
+		handle = HandleListBegin(state, cur_handle->handles, gxid, timestamp, need_xact_block);
+		if (handle)
+			ereport(ERROR,
+					(errmsg("Fail to begin transaction"),
+					 errnode(NameStr(handle->node_name)),
+					 errdetail("%s", HandleGetError(handle))));
+
 		/* Send utility query to remote nodes */
 		foreach (lc_handle, cur_handle->handles)
 		{
 			handle = (NodeHandle *) lfirst(lc_handle);
-			if (!HandleBegin(state, handle, gxid, timestamp, need_xact_block, &already_begin) ||
-				!HandleSendQueryTree(handle, InvalidCommandId, snapshot, utility, utility_tree))
+			if (!HandleSendQueryTree(handle, InvalidCommandId, snapshot, utility, utility_tree))
 			{
 				ereport(ERROR,
 						(errmsg("Fail to send utility query to remote node."),
@@ -650,8 +760,6 @@ InterXactBegin(InterXactState state, const List *node_list)
 	InterXactState		new_state;
 	NodeMixHandle	   *cur_handle;
 	NodeHandle		   *handle;
-	ListCell		   *lc_handle;
-	bool				already_begin;
 	bool				need_xact_block;
 
 	new_state = MakeInterXactState2(state, node_list);
@@ -670,15 +778,12 @@ InterXactBegin(InterXactState state, const List *node_list)
 			gxid = GetCurrentTransactionIdIfAny();
 		timestamp = GetCurrentTransactionStartTimestamp();
 
-		foreach (lc_handle, cur_handle->handles)
-		{
-			handle = (NodeHandle *) lfirst(lc_handle);
-			if (!HandleBegin(state, handle, gxid, timestamp, need_xact_block, &already_begin))
-				ereport(ERROR,
-						(errmsg("Fail to begin transaction"),
-						 errnode(NameStr(handle->node_name)),
-						 errdetail("%s:", HandleGetError(handle))));
-		}
+		handle = HandleListBegin(state, cur_handle->handles, gxid, timestamp, need_xact_block);
+		if (handle)
+			ereport(ERROR,
+					(errmsg("Fail to begin transaction"),
+					 errnode(NameStr(handle->node_name)),
+					 errdetail("%s:", HandleGetError(handle))));
 	} PG_CATCH();
 	{
 		InterXactGCCurrent(new_state);
@@ -735,6 +840,7 @@ InterXactAbort(const char *gid, Oid *nodes, int nnodes, bool missing_ok, bool no
 			command = psprintf("ROLLBACK TRANSACTION;");
 			command_tag = TRANS_ROLLBACK_TAG;
 		}
+		HandleListGCPipelined(handle_list);
 		InterXactTwoPhaseInternal(handle_list, command, command_tag, true);
 		pfree(command);
 		list_free(handle_list);
@@ -781,6 +887,8 @@ InterXactTwoPhase(const char *gid, Oid *nodes, int nnodes, TwoPhaseState tp_stat
 				InterXactTwoPhaseInternal(handle_list, command, command_tag, false);
 				break;
 			case TP_ABORT:
+				/* errors of pipelined inserts are moot now */
+				HandleListGCPipelined(handle_list);
 				if (gid && gid[0])
 				{
 					command = psprintf("ROLLBACK PREPARED%s '%s';",
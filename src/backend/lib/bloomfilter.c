@@ -0,0 +1,195 @@
+/*-------------------------------------------------------------------------
+ *
+ * bloomfilter.c
+ *	  Bloom filter over 32 bit hash values
+ *
+ * A Bloom filter answers "certainly not in the set" or "maybe in the set"
+ * for an element, using a fixed size bitset.  Elements are given as 32 bit
+ * hash values that the caller computed already (e.g. hash join hash
+ * values), the K probe positions are derived from that value and a second
+ * hash of it (Kirsch and Mitzenmacher's double hashing).
+ *
+ * The bitset is sized for about 1% false positive rate, ten bits per
+ * element, limited to the caller's maximum size.
+ *
+ * IDENTIFICATION
+ *	  src/backend/lib/bloomfilter.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include <math.h>
+
+#include "access/hash.h"
+#include "lib/bloomfilter.h"
+
+#define BLOOM_BITS_PER_ELEM		10
+#define BLOOM_MIN_BITSET_BYTES	64
+#define BLOOM_MAX_BITSET_BYTES	((Size) 1 << 28)	/* 2^31 bits */
+#define BLOOM_MAX_HASH_FUNCS	10
+
+static Size bloom_bitset_bytes(double total_elems, Size max_size);
+
+/*
+ * Size of bitset in bytes, a power of 2
+ */
+static Size
+bloom_bitset_bytes(double total_elems, Size max_size)
+{
+	double		want;
+	Size		limit;
+	Size		bytes;
+
+	if (total_elems < 1.0)
+		total_elems = 1.0;
+	want = total_elems * BLOOM_BITS_PER_ELEM / BITS_PER_BYTE;
+
+	limit = BLOOM_MAX_BITSET_BYTES;
+	if (max_size > offsetof(bloom_filter, bf_bitset) &&
+		max_size - offsetof(bloom_filter, bf_bitset) < limit)
+		limit = max_size - offsetof(bloom_filter, bf_bitset);
+
+	bytes = BLOOM_MIN_BITSET_BYTES;
+	while (bytes < want && bytes * 2 <= limit)
+		bytes *= 2;
+
+	return bytes;
+}
+
+/*
+ * bloom_estimate_size
+ *
+ * Returns bloom_size() of a filter bloom_create would make.
+ */
+Size
+bloom_estimate_size(double total_elems, Size max_size)
+{
+	return offsetof(bloom_filter, bf_bitset) +
+		   bloom_bitset_bytes(total_elems, max_size);
+}
+
+/*
+ * bloom_create
+ *
+ * Create a empty Bloom filter for about total_elems elements, which size
+ * not larger than max_size bytes when possible.
+ */
+bloom_filter *
+bloom_create(double total_elems, Size max_size, uint32 seed)
+{
+	bloom_filter   *filter;
+	Size			bytes;
+	double			nhash;
+
+	bytes = bloom_bitset_bytes(total_elems, max_size);
+	filter = palloc0(offsetof(bloom_filter, bf_bitset) + bytes);
+	filter->bf_size = (uint32) (offsetof(bloom_filter, bf_bitset) + bytes);
+	filter->bf_mask = (uint32) (bytes * BITS_PER_BYTE - 1);
+	filter->bf_seed = seed;
+
+	/* optimal K is ln(2) * m / n */
+	nhash = rint(log(2.0) * bytes * BITS_PER_BYTE / Max(total_elems, 1.0));
+	filter->bf_nhash = (int32) Max(Min(nhash, BLOOM_MAX_HASH_FUNCS), 1);
+
+	return filter;
+}
+
+/*
+ * bloom_restore
+ *
+ * Make a copy of a filter from its flat representation, returns NULL if
+ * data is not a valid filter.
+ */
+bloom_filter *
+bloom_restore(const char *data, Size len)
+{
+	bloom_filter	header;
+	bloom_filter   *filter;
+	Size			bytes;
+
+	if (len <= offsetof(bloom_filter, bf_bitset))
+		return NULL;
+
+	memcpy(&header, data, offsetof(bloom_filter, bf_bitset));
+	bytes = len - offsetof(bloom_filter, bf_bitset);
+	if (header.bf_size != len ||
+		header.bf_nhash < 1 ||
+		header.bf_nhash > BLOOM_MAX_HASH_FUNCS ||
+		(Size) header.bf_mask + 1 != bytes * BITS_PER_BYTE ||
+		(header.bf_mask & (header.bf_mask + 1)) != 0)
+		return NULL;
+
+	filter = palloc(len);
+	memcpy(filter, data, len);
+
+	return filter;
+}
+
+void
+bloom_free(bloom_filter *filter)
+{
+	pfree(filter);
+}
+
+void
+bloom_add_hash(bloom_filter *filter, uint32 hashvalue)
+{
+	uint32		h2;
+	uint32		bit;
+	int			i;
+
+	h2 = DatumGetUInt32(hash_uint32(hashvalue ^ filter->bf_seed)) | 1;
+	for (i = 0; i < filter->bf_nhash; i++)
+	{
+		bit = (hashvalue + i * h2) & filter->bf_mask;
+		filter->bf_bitset[bit >> 3] |= (unsigned char) (1 << (bit & 7));
+	}
+}
+
+/*
+ * bloom_lacks_hash
+ *
+ * Returns true if hashvalue was certainly never added, false means maybe
+ * it was added.
+ */
+bool
+bloom_lacks_hash(bloom_filter *filter, uint32 hashvalue)
+{
+	uint32		h2;
+	uint32		bit;
+	int			i;
+
+	h2 = DatumGetUInt32(hash_uint32(hashvalue ^ filter->bf_seed)) | 1;
+	for (i = 0; i < filter->bf_nhash; i++)
+	{
+		bit = (hashvalue + i * h2) & filter->bf_mask;
+		if ((filter->bf_bitset[bit >> 3] & (1 << (bit & 7))) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * bloom_prop_bits_set
+ *
+ * Proportion of bits set, a filter close to 1.0 can not reject anything.
+ */
+double
+bloom_prop_bits_set(bloom_filter *filter)
+{
+	Size		bytes = filter->bf_size - offsetof(bloom_filter, bf_bitset);
+	uint64		bits_set = 0;
+	Size		i;
+	unsigned char b;
+
+	for (i = 0; i < bytes; i++)
+	{
+		for (b = filter->bf_bitset[i]; b; b &= b - 1)
+			bits_set++;
+	}
+
+	return (double) bits_set / ((double) bytes * BITS_PER_BYTE);
+}
@@ -0,0 +1,195 @@
+/*-------------------------------------------------------------------------
+ *
+ * losertree.c
+ *	  A tournament (loser) tree for k-way merge
+ *
+ * Compare with a binary heap, replacing the first input of a loser tree
+ * only need one comparison for each level of the tree (log2(k)), the
+ * heap need two. Inputs are stored as leaves of an implicit tree which
+ * have "size" leaves, leaf of input i at position size + i, internal
+ * node n has children 2n and 2n+1, and keep the loser of the match
+ * between them. The winner of whole tree kept in node 0.
+ *
+ * IDENTIFICATION
+ *	  src/backend/lib/losertree.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "lib/losertree.h"
+
+static int losertree_play(losertree *tree, int node);
+static inline bool losertree_beats(losertree *tree, int a, int b);
+
+/*
+ * losertree_allocate
+ *
+ * Returns a pointer to a newly-allocated tree for "size" inputs, all of
+ * inputs are exhausted until losertree_add_unordered called.
+ */
+losertree *
+losertree_allocate(int size, losertree_comparator compare, void *arg)
+{
+	losertree  *tree;
+
+	AssertArg(size > 0);
+
+	tree = (losertree *) palloc(offsetof(losertree, lt_nodes) + sizeof(int) * size);
+	tree->lt_size = size;
+	tree->lt_compare = compare;
+	tree->lt_arg = arg;
+	tree->lt_valid = (bool *) palloc(sizeof(bool) * size);
+	losertree_reset(tree);
+
+	return tree;
+}
+
+/*
+ * losertree_reset
+ *
+ * Mark all inputs exhausted
+ */
+void
+losertree_reset(losertree *tree)
+{
+	int			i;
+
+	for (i = 0; i < tree->lt_size; i++)
+	{
+		tree->lt_valid[i] = false;
+		tree->lt_nodes[i] = i;
+	}
+	tree->lt_built = true;
+}
+
+void
+losertree_free(losertree *tree)
+{
+	pfree(tree->lt_valid);
+	pfree(tree);
+}
+
+/*
+ * losertree_add_unordered
+ *
+ * Mark input valid, the tree is not valid until losertree_build called
+ */
+void
+losertree_add_unordered(losertree *tree, int input)
+{
+	AssertArg(input >= 0 && input < tree->lt_size);
+	tree->lt_valid[input] = true;
+	tree->lt_built = false;
+}
+
+/*
+ * losertree_build
+ *
+ * Play all matches of tree, O(n) comparisons
+ */
+void
+losertree_build(losertree *tree)
+{
+	tree->lt_nodes[0] = losertree_play(tree, 1);
+	tree->lt_built = true;
+}
+
+/*
+ * losertree_first
+ *
+ * Returns the input sorts first, or -1 when all inputs exhausted
+ */
+int
+losertree_first(losertree *tree)
+{
+	int			winner;
+
+	Assert(tree->lt_built);
+	winner = tree->lt_nodes[0];
+
+	return tree->lt_valid[winner] ? winner : -1;
+}
+
+/*
+ * losertree_remove_first
+ *
+ * The first input is exhausted, O(log n) comparisons
+ */
+void
+losertree_remove_first(losertree *tree)
+{
+	Assert(!losertree_empty(tree));
+	tree->lt_valid[tree->lt_nodes[0]] = false;
+	losertree_replace_first(tree);
+}
+
+/*
+ * losertree_replace_first
+ *
+ * The first input advanced to it's next value, O(log n) comparisons
+ */
+void
+losertree_replace_first(losertree *tree)
+{
+	int			winner = tree->lt_nodes[0];
+	int			node;
+	int			tmp;
+
+	Assert(tree->lt_built);
+
+	for (node = (tree->lt_size + winner) / 2; node > 0; node /= 2)
+	{
+		if (losertree_beats(tree, tree->lt_nodes[node], winner))
+		{
+			tmp = tree->lt_nodes[node];
+			tree->lt_nodes[node] = winner;
+			winner = tmp;
+		}
+	}
+	tree->lt_nodes[0] = winner;
+}
+
+/*
+ * play the match of node, save loser and return winner
+ */
+static int
+losertree_play(losertree *tree, int node)
+{
+	int			a,
+				b;
+
+	if (node >= tree->lt_size)
+		return node - tree->lt_size;
+
+	a = losertree_play(tree, node * 2);
+	b = losertree_play(tree, node * 2 + 1);
+	if (losertree_beats(tree, a, b))
+	{
+		tree->lt_nodes[node] = b;
+		return a;
+	}
+	tree->lt_nodes[node] = a;
+	return b;
+}
+
+/*
+ * return true if input a sorts before b, exhausted input sorts last and
+ * equal inputs sorts by index for stable result
+ */
+static inline bool
+losertree_beats(losertree *tree, int a, int b)
+{
+	int			compare;
+
+	if (!tree->lt_valid[a])
+		return false;
+	if (!tree->lt_valid[b])
+		return true;
+
+	compare = (*tree->lt_compare) (a, b, tree->lt_arg);
+	if (compare != 0)
+		return compare < 0;
+	return a < b;
+}
@@ -1,5 +1,7 @@
 #include "postgres.h"
 
+#include <arpa/inet.h>
+
 #include "access/htup_details.h"
 #include "access/subtrans.h"
 #include "access/transam.h"
@@ -310,23 +312,84 @@ agtm_GetTimestamptz(void)
 
 Snapshot
 agtm_GetGlobalSnapShot(Snapshot snapshot)
+{
+	uint64		commit_seq;
+
+	agtm_GetGlobalSnapShotIfChanged(snapshot, false, &commit_seq);
+	return snapshot;
+}
+
+/*
+ * get Snapshot info from AGTM and count of transactions ended on AGTM it
+ * reflects.  When only_changed and the count is still *commit_seq, AGTM
+ * sends nothing, snapshot is untouched and false is returned.
+ */
+bool
+agtm_GetGlobalSnapShotIfChanged(Snapshot snapshot, bool only_changed, uint64 *commit_seq)
 {
 	PGresult 	*res;
 	const char *str;
 	StringInfoData	buf;
+	StringInfoData	msg;
+	AGTM_MessageType msg_type;
+	int			result_type;
 	uint32 xcnt;
 	TimestampTz	globalXactStartTimestamp;
 
-	AssertArg(snapshot && snapshot->xip && snapshot->subxip);
+	AssertArg(snapshot && snapshot->xip && snapshot->subxip && commit_seq);
 
 	if(!IsUnderAGTM())
 		ereport(ERROR,
 			(errmsg("agtm_GetGlobalSnapShot function must under AGTM")));
 
-	agtm_send_message(AGTM_MSG_SNAPSHOT_GET, " ");
-	res = agtm_get_result(AGTM_MSG_SNAPSHOT_GET);
-	Assert(res);
-	agtm_use_result_type(res, &buf, AGTM_SNAPSHOT_GET_RESULT);
+	initStringInfo(&msg);
+	if (only_changed)
+	{
+		msg_type = AGTM_MSG_SNAPSHOT_GET_IF_CHANGED;
+		pq_sendint64(&msg, (int64) *commit_seq);
+	}else
+	{
+		msg_type = AGTM_MSG_SNAPSHOT_GET;
+	}
+
+	/*
+	 * Before transaction has a xid, AGTM backend of the session is not
+	 * needed, try the light service first.
+	 */
+	if (!TopXactBeginAGTM() &&
+		!TransactionIdIsValid(GetTopTransactionIdIfAny()) &&
+		agtm_light_request(msg_type, msg.data, msg.len, &buf))
+	{
+		res = NULL;
+	}else
+	{
+		agtm_send_message(msg_type, "%p%d", msg.data, msg.len);
+		res = agtm_get_result(msg_type);
+		Assert(res);
+		PG_TRY();
+		{
+			agtm_use_result_data(res, &buf);
+		} PG_CATCH();
+		{
+			PQclear(res);
+			PG_RE_THROW();
+		} PG_END_TRY();
+	}
+	pfree(msg.data);
+
+	result_type = pq_getmsgint(&buf, 4);
+	if (result_type == AGTM_SNAPSHOT_UNCHANGED_RESULT && only_changed)
+	{
+		agtm_use_result_end(res, &buf);
+		return false;
+	}
+	if (result_type != AGTM_SNAPSHOT_GET_RESULT)
+	{
+		PQclear(res);
+		ereport(ERROR, (errmsg("need AGTM message %s, but result %s"
+			, gtm_util_result_name(AGTM_SNAPSHOT_GET_RESULT)
+			, gtm_util_result_name((AGTM_ResultType)result_type))));
+	}
 
 	pq_copymsgbytes(&buf, (char*)&(globalXactStartTimestamp), sizeof(globalXactStartTimestamp));
 	SetCurrentTransactionStartTimestamp(globalXactStartTimestamp);
@@ -351,12 +414,13 @@ agtm_GetGlobalSnapShot(Snapshot snapshot)
 	pq_copymsgbytes(&buf, (char*)&(snapshot->curcid), sizeof(snapshot->curcid));
 	pq_copymsgbytes(&buf, (char*)&(snapshot->active_count), sizeof(snapshot->active_count));
 	pq_copymsgbytes(&buf, (char*)&(snapshot->regd_count), sizeof(snapshot->regd_count));
+	*commit_seq = (uint64) pq_getmsgint64(&buf);
 
 	agtm_use_result_end(res, &buf);
 
 	if (GetCurrentCommandId(false) > snapshot->curcid)
 		snapshot->curcid = GetCurrentCommandId(false);
-	return snapshot;
+	return true;
 }
 
 XidStatus
@@ -365,15 +429,24 @@ agtm_TransactionIdGetStatus(TransactionId xid, XLogRecPtr *lsn)
 	PGresult		*res;
 	StringInfoData	buf;
 	XidStatus		xid_status;
+	uint32			n32;
 
 	if(!IsUnderAGTM())
 		ereport(ERROR,
 			(errmsg("agtm_TransactionIdGetStatus function must under AGTM")));
 
-	agtm_send_message(AGTM_MSG_GET_XACT_STATUS, "%d%d", (int)xid, (int)sizeof(xid));
-	res = agtm_get_result(AGTM_MSG_GET_XACT_STATUS);
-	Assert(res);
-	agtm_use_result_type(res, &buf, AGTM_GET_XACT_STATUS_RESULT);
+	n32 = htonl((uint32) xid);
+	if (agtm_light_request(AGTM_MSG_GET_XACT_STATUS, (char*)&n32, sizeof(n32), &buf))
+	{
+		res = NULL;
+		agtm_check_result(&buf, AGTM_GET_XACT_STATUS_RESULT);
+	}else
+	{
+		agtm_send_message(AGTM_MSG_GET_XACT_STATUS, "%d%d", (int)xid, (int)sizeof(xid));
+		res = agtm_get_result(AGTM_MSG_GET_XACT_STATUS);
+		Assert(res);
+		agtm_use_result_type(res, &buf, AGTM_GET_XACT_STATUS_RESULT);
+	}
 	pq_copymsgbytes(&buf, (char*)&xid_status, sizeof(xid_status));
 	pq_copymsgbytes(&buf, (char*)lsn, sizeof(XLogRecPtr));
 
@@ -385,6 +458,57 @@ agtm_TransactionIdGetStatus(TransactionId xid, XLogRecPtr *lsn)
 	return xid_status;
 }
 
+/*
+ * get status of nxid transactions from AGTM in one round trip,
+ * nxid must not be greater than AGTM_XACT_STATUS_BATCH_MAX
+ */
+void
+agtm_TransactionIdsGetStatus(int nxid, const TransactionId *xids, XidStatus *status)
+{
+	PGresult		*res;
+	StringInfoData	buf;
+	StringInfoData	msg;
+	int				count;
+
+	AssertArg(nxid > 0 && nxid <= AGTM_XACT_STATUS_BATCH_MAX);
+	if(!IsUnderAGTM())
+		ereport(ERROR,
+			(errmsg("agtm_TransactionIdsGetStatus function must under AGTM")));
+
+	initStringInfo(&msg);
+	pq_sendint(&msg, nxid, 4);
+	pq_sendbytes(&msg, (char*)xids, sizeof(TransactionId) * nxid);
+	if (agtm_light_request(AGTM_MSG_GET_XACT_STATUS_BATCH, msg.data, msg.len, &buf))
+	{
+		res = NULL;
+		agtm_check_result(&buf, AGTM_GET_XACT_STATUS_BATCH_RESULT);
+	}else
+	{
+		agtm_send_message(AGTM_MSG_GET_XACT_STATUS_BATCH, "%d%d %p%d",
+						  nxid, 4,
+						  xids, (int)(sizeof(TransactionId) * nxid));
+		res = agtm_get_result(AGTM_MSG_GET_XACT_STATUS_BATCH);
+		Assert(res);
+		agtm_use_result_type(res, &buf, AGTM_GET_XACT_STATUS_BATCH_RESULT);
+	}
+	pfree(msg.data);
+
+	count = pq_getmsgint(&buf, 4);
+	if (count != nxid)
+	{
+		PQclear(res);
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("invalid message format from AGTM")));
+	}
+	pq_copymsgbytes(&buf, (char*)status, sizeof(XidStatus) * nxid);
+
+	ereport(DEBUG1,
+		(errmsg("get status of %d xids", nxid)));
+
+	agtm_use_result_end(res, &buf);
+}
+
 static void
 get_cluster_nextXids(TransactionId **xidarray,	/* output */
 					 TransactionId *max_cxid,	/* output */
@@ -681,6 +805,53 @@ agtm_GetSeqNextVal(const char *seqname, const char * database,	const char * sche
 			, AGTM_SEQUENCE_GET_NEXT_RESULT);
 }
 
+AGTM_Sequence
+agtm_GetSeqNextRange(const char *seqname, const char * database,
+			const char * schema, int64 count, AGTM_Sequence *last, int64 *increment)
+{
+	PGresult		*res;
+	StringInfoData	buf;
+	AGTM_Sequence	first;
+	int				seqNameSize;
+	int 			databaseSize;
+	int				schemaSize;
+
+	Assert(seqname != NULL && database != NULL && schema != NULL);
+
+	if(!IsUnderAGTM())
+		ereport(ERROR,
+			(errmsg("agtm_GetSeqNextRange function must under AGTM")));
+
+	if(seqname[0] == '\0' || database[0] == '\0' || schema[0] == '\0')
+		ereport(ERROR,
+			(errmsg("message type = (%s), parameter seqname is null",
+			gtm_util_message_name(AGTM_MSG_SEQUENCE_GET_RANGE))));
+
+	seqNameSize = strlen(seqname);
+	databaseSize = strlen(database);
+	schemaSize = strlen(schema);
+	agtm_send_message(AGTM_MSG_SEQUENCE_GET_RANGE,
+					"%d%d %p%d %d%d %p%d %d%d %p%d %p%d",
+					seqNameSize, 4,
+					seqname, seqNameSize,
+					databaseSize, 4,
+					database, databaseSize,
+					schemaSize, 4,
+					schema, schemaSize,
+					&count, (int)sizeof(count));
+
+	res = agtm_get_result(AGTM_MSG_SEQUENCE_GET_RANGE);
+	Assert(res);
+	agtm_use_result_type(res, &buf, AGTM_SEQUENCE_GET_RANGE_RESULT);
+	pq_copymsgbytes(&buf, (char*)&first, sizeof(first));
+	pq_copymsgbytes(&buf, (char*)last, sizeof(*last));
+	pq_copymsgbytes(&buf, (char*)increment, sizeof(*increment));
+
+	agtm_use_result_end(res, &buf);
+
+	return first;
+}
+
 AGTM_Sequence
 agtm_GetSeqCurrVal(const char *seqname, const char * database,	const char * schema)
 {
@@ -1,6 +1,11 @@
 #include "postgres.h"
 #include "miscadmin.h"
 
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
 #include "access/transam.h"
 #include "agtm/agtm.h"
 #include "agtm/agtm_client.h"
@@ -9,13 +14,16 @@
 #include "access/xact.h"
 #include "catalog/pg_type.h"
 #include "commands/dbcommands.h"
+#include "libpq/ip.h"
 #include "libpq/libpq-int.h"
 #include "libpq/pqformat.h"
 #include "mb/pg_wchar.h"
 #include "pgxc/pgxc.h"
 #include "utils/builtins.h"
 #include "utils/guc.h"
+#include "storage/latch.h"
 #include "utils/memutils.h"
+#include "utils/timestamp.h"
 
 /* Configuration variables */
 extern char				*AGtmHost;
@@ -24,6 +32,8 @@ extern int 				AGtmPort;
 #define AGTM_PORT		"agtm_port"
 #define InvalidAGtmPort	0
 
+int						agtm_light_port = 0;
+
 static AGTM_Conn		*agtm_conn = NULL;
 static char				*save_AGtmHost = NULL;
 static int				save_AGtmPort = 0;
@@ -39,7 +49,23 @@ static bool				IsDefaultAGtmPortSave = false;
 		}									\
 	} while(0)
 
+/* connection to AGTM light service, see agtm_light.c of AGTM */
+static pgsocket			agtm_light_sock = PGINVALID_SOCKET;
+static char			   *agtm_light_host = NULL;
+static int				agtm_light_conn_port = 0;
+static StringInfoData	agtm_light_buf = {NULL, 0, 0, 0};
+static TimestampTz		agtm_light_deadline = 0;	/* of current request */
+static TimestampTz		agtm_light_failed = 0;		/* last failure, 0 for none */
+
+/* milliseconds a request may take, and to wait before retry after failure */
+#define AGTM_LIGHT_TIMEOUT			5000
+#define AGTM_LIGHT_RETRY_INTERVAL	10000
+
 static void agtm_Connect(void);
+static bool agtm_light_connect(void);
+static bool agtm_light_wait(int event);
+static bool agtm_light_send(const char *data, int len);
+static bool agtm_light_recv(char *data, int len);
 
 static void
 agtm_Connect(void)
@@ -339,6 +365,283 @@ void agtm_use_result_end(PGresult *res, StringInfo buf)
 	PQclear(res);
 }
 
+static bool
+agtm_light_connect(void)
+{
+	struct addrinfo	hint;
+	struct addrinfo *addrs = NULL;
+	struct addrinfo *addr;
+	char			port_buf[10];
+	pgsocket		sock = PGINVALID_SOCKET;
+	int				on = 1;
+	int				rc;
+
+	MemSet(&hint, 0, sizeof(hint));
+	hint.ai_socktype = SOCK_STREAM;
+	hint.ai_family = AF_UNSPEC;
+	sprintf(port_buf, "%d", agtm_light_port);
+
+	rc = pg_getaddrinfo_all(AGtmHost, port_buf, &hint, &addrs);
+	if (rc != 0 || addrs == NULL)
+	{
+		ereport(DEBUG1,
+			(errmsg("could not translate AGTM host name \"%s\": %s",
+				AGtmHost, gai_strerror(rc))));
+		if (addrs)
+			pg_freeaddrinfo_all(hint.ai_family, addrs);
+		return false;
+	}
+
+	/* waiting for connection may be interrupted */
+	PG_TRY();
+	{
+		for (addr = addrs; addr != NULL; addr = addr->ai_next)
+		{
+			agtm_light_sock = socket(addr->ai_family, SOCK_STREAM, 0);
+			if (agtm_light_sock == PGINVALID_SOCKET)
+				continue;
+			if (!pg_set_noblock(agtm_light_sock))
+			{
+				agtm_light_close();
+				continue;
+			}
+			if (connect(agtm_light_sock, addr->ai_addr, addr->ai_addrlen) == 0)
+				break;
+			if (errno == EINPROGRESS || errno == EINTR)
+			{
+				int			optval = 0;
+				ACCEPT_TYPE_ARG3 optlen = sizeof(optval);
+
+				/* wait for connection, then check its result */
+				if (agtm_light_wait(WL_SOCKET_WRITEABLE) &&
+					getsockopt(agtm_light_sock, SOL_SOCKET, SO_ERROR,
+							   (char *) &optval, &optlen) == 0)
+				{
+					if (optval == 0)
+						break;
+					errno = optval;
+				}
+			}
+			agtm_light_close();
+		}
+	}PG_CATCH();
+	{
+		pg_freeaddrinfo_all(hint.ai_family, addrs);
+		PG_RE_THROW();
+	}PG_END_TRY();
+	pg_freeaddrinfo_all(hint.ai_family, addrs);
+	sock = agtm_light_sock;
+
+	if (sock == PGINVALID_SOCKET)
+	{
+		ereport(DEBUG1,
+			(errmsg("could not connect to AGTM light service(host=%s port=%d): %m",
+				AGtmHost, agtm_light_port)));
+		return false;
+	}
+#ifdef TCP_NODELAY
+	(void) setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char *) &on, sizeof(on));
+#endif
+
+	if (agtm_light_host)
+		pfree(agtm_light_host);
+	agtm_light_host = MemoryContextStrdup(TopMemoryContext, AGtmHost);
+	agtm_light_conn_port = agtm_light_port;
+
+	return true;
+}
+
+/*
+ * agtm_light_wait
+ *
+ * Wait for event of AGTM light service socket until deadline of current
+ * request.  Return false on timeout.  The socket is closed before pending
+ * interrupts are processed, a partly sent or received message must not
+ * be left on it.
+ */
+static bool
+agtm_light_wait(int event)
+{
+	long		secs;
+	int			microsecs;
+	long		timeout;
+	int			rc;
+
+	for (;;)
+	{
+		TimestampDifference(GetCurrentTimestamp(), agtm_light_deadline,
+							&secs, &microsecs);
+		timeout = secs * 1000 + microsecs / 1000;
+		if (timeout <= 0)
+			return false;
+
+		rc = WaitLatchOrSocket(MyLatch,
+							   WL_LATCH_SET | WL_POSTMASTER_DEATH | WL_TIMEOUT | event,
+							   agtm_light_sock,
+							   timeout);
+		if (rc & WL_POSTMASTER_DEATH)
+			return false;
+		if (rc & WL_LATCH_SET)
+		{
+			ResetLatch(MyLatch);
+			if (InterruptPending)
+			{
+				agtm_light_close();
+				CHECK_FOR_INTERRUPTS();
+				return false;
+			}
+		}
+		if (rc & event)
+			return true;
+	}
+}
+
+static bool
+agtm_light_send(const char *data, int len)
+{
+	int			rc;
+
+	while (len > 0)
+	{
+		rc = send(agtm_light_sock, data, len, 0);
+		if (rc < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if ((errno == EAGAIN || errno == EWOULDBLOCK) &&
+				agtm_light_wait(WL_SOCKET_WRITEABLE))
+				continue;
+			return false;
+		}
+		data += rc;
+		len -= rc;
+	}
+
+	return true;
+}
+
+static bool
+agtm_light_recv(char *data, int len)
+{
+	int			rc;
+
+	while (len > 0)
+	{
+		rc = recv(agtm_light_sock, data, len, 0);
+		if (rc < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if ((errno == EAGAIN || errno == EWOULDBLOCK) &&
+				agtm_light_wait(WL_SOCKET_READABLE))
+				continue;
+			return false;
+		}else if (rc == 0)
+		{
+			return false;
+		}
+		data += rc;
+		len -= rc;
+	}
+
+	return true;
+}
+
+void
+agtm_light_close(void)
+{
+	if (agtm_light_sock != PGINVALID_SOCKET)
+	{
+		closesocket(agtm_light_sock);
+		agtm_light_sock = PGINVALID_SOCKET;
+	}
+}
+
+/*
+ * agtm_light_request
+ *
+ * Send a message to AGTM light service and read it's result into buf, like
+ * agtm_use_result_data do.  The data of buf is valid until next request.
+ *
+ * Return false when the service is not configured or not usable, caller
+ * should send the message by normal AGTM connection.  The messages served
+ * are read only, so it is safe to send it again.  After a failure the
+ * service is not tried for AGTM_LIGHT_RETRY_INTERVAL milliseconds.
+ */
+bool
+agtm_light_request(AGTM_MessageType msg, const char *data, int len, StringInfo buf)
+{
+	TimestampTz	now;
+	uint32		n32;
+	int			result_len;
+
+	if (agtm_light_port == 0 || AGtmHost == NULL)
+		return false;
+
+	now = GetCurrentTimestamp();
+	if (agtm_light_failed != 0 &&
+		!TimestampDifferenceExceeds(agtm_light_failed, now,
+									AGTM_LIGHT_RETRY_INTERVAL))
+		return false;
+	agtm_light_deadline = TimestampTzPlusMilliseconds(now, AGTM_LIGHT_TIMEOUT);
+
+	if (agtm_light_sock != PGINVALID_SOCKET &&
+		(agtm_light_conn_port != agtm_light_port ||
+		 strcmp(agtm_light_host, AGtmHost) != 0))
+		agtm_light_close();
+
+	if (agtm_light_sock == PGINVALID_SOCKET &&
+		agtm_light_connect() == false)
+	{
+		agtm_light_failed = GetCurrentTimestamp();
+		return false;
+	}
+
+	if (agtm_light_buf.data == NULL)
+	{
+		MemoryContext oldctx = MemoryContextSwitchTo(TopMemoryContext);
+		initStringInfo(&agtm_light_buf);
+		MemoryContextSwitchTo(oldctx);
+	}
+
+	resetStringInfo(&agtm_light_buf);
+	n32 = htonl((uint32) (8 + len));
+	appendBinaryStringInfo(&agtm_light_buf, (char *) &n32, 4);
+	n32 = htonl((uint32) msg);
+	appendBinaryStringInfo(&agtm_light_buf, (char *) &n32, 4);
+	if (len > 0)
+		appendBinaryStringInfo(&agtm_light_buf, data, len);
+
+	if (!agtm_light_send(agtm_light_buf.data, agtm_light_buf.len) ||
+		!agtm_light_recv((char *) &n32, 4))
+		goto light_failed_;
+
+	result_len = (int) ntohl(n32) - 4;
+	if (result_len < 4)
+		goto light_failed_;
+
+	resetStringInfo(&agtm_light_buf);
+	enlargeStringInfo(&agtm_light_buf, result_len);
+	if (!agtm_light_recv(agtm_light_buf.data, result_len))
+		goto light_failed_;
+	agtm_light_buf.len = result_len;
+	agtm_light_buf.data[result_len] = '\0';
+
+	buf->data = agtm_light_buf.data;
+	buf->len = buf->maxlen = result_len;
+	buf->cursor = 0;
+	agtm_light_failed = 0;
+	return true;
+
+light_failed_:
+	ereport(DEBUG1,
+		(errmsg("AGTM light service(host=%s port=%d) failed, use AGTM connection",
+			AGtmHost, agtm_light_port)));
+	agtm_light_close();
+	agtm_light_failed = GetCurrentTimestamp();
+	return false;
+}
+
 /* GUC check hook for agtm_host */
 bool
 check_agtm_host(char **newval, void **extra, GucSource source)
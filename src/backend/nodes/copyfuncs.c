@@ -839,6 +839,7 @@ _copyHashJoin(const HashJoin *from)
 	COPY_NODE_FIELD(hashclauses);
 #ifdef ADB
 	COPY_SCALAR_FIELD(cluster_hashtable_first);
+	COPY_SCALAR_FIELD(cluster_reduce_filter);
 #endif /* ADB */
 
 	return newnode;
@@ -715,6 +715,39 @@ int32 execModuloValue(Datum datum, Oid typid, int right)
 	int32 i32;
 	int16 typlen;
 	bool boolValue;
+	int64 i64;
+
+	/*
+	 * integer types, hash values are, get same result as operator "%" and
+	 * cast to int4 without building an expression for every value
+	 */
+	if (right > 0)
+	{
+		boolValue = true;
+		switch(typid)
+		{
+			case BOOLOID:
+				i64 = DatumGetBool(datum) ? 1 : 0;
+				break;
+			case INT2OID:
+				i64 = DatumGetInt16(datum);
+				break;
+			case INT4OID:
+				i64 = DatumGetInt32(datum);
+				break;
+			case INT8OID:
+				i64 = DatumGetInt64(datum);
+				break;
+			default:
+				boolValue = false;
+				break;
+		}
+		if (boolValue)
+		{
+			i32 = (int32) (i64 % right);
+			return i32 < 0 ? -i32 : i32;
+		}
+	}
 
 	estate = CreateExecutorState();
 	old_context = MemoryContextSwitchTo(estate->es_query_cxt);
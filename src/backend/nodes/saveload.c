@@ -28,6 +28,8 @@
 #include "utils/builtins.h"
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
 #include "nodes/extensible.h"
 #include "nodes/replnodes.h"
 #include "commands/event_trigger.h"
@@ -39,6 +41,48 @@
 
 #define IS_OID_BUILTIN(oid_) (oid_ < FirstBootstrapObjectId)
 
+/*
+ * first byte of a saved catalog object, SAVE_CATALOG_REF only used when
+ * catalog reference cache is active, then followed by a varint index
+ */
+#define SAVE_CATALOG_REF		2
+
+typedef enum CatalogRefKind
+{
+	CATALOG_REF_NAMESPACE = 1,
+	CATALOG_REF_TYPE,
+	CATALOG_REF_COLLATION,
+	CATALOG_REF_PROC,
+	CATALOG_REF_OPERATOR,
+	CATALOG_REF_CLASS,
+	CATALOG_REF_CLASS_NAME,
+	CATALOG_REF_TS_CONFIG,
+	CATALOG_REF_AUTHID
+}CatalogRefKind;
+
+typedef struct CatalogRefKey
+{
+	CatalogRefKind	kind;
+	Oid				oid;
+}CatalogRefKey;
+
+typedef struct CatalogRefEntry
+{
+	CatalogRefKey	key;
+	uint32			index;
+}CatalogRefEntry;
+
+/* save side, map (kind, oid) to index */
+static MemoryContext save_catalog_context = NULL;
+static HTAB *save_catalog_htab = NULL;
+static uint32 save_catalog_count = 0;
+
+/* load side, map index to oid */
+static MemoryContext load_catalog_context = NULL;
+static Oid *load_catalog_oids = NULL;
+static uint32 load_catalog_count = 0;
+static uint32 load_catalog_max = 0;
+
 /* not support Node */
 #define NO_NODE_PlannerInfo
 #define NO_NODE_RelOptInfo
@@ -155,6 +199,110 @@ static void save_##type(StringInfo buf, const type *node			\
 			f(buf, (const t2*)node->m[i]);									\
 	}while(0);*/
 
+static void save_varint(StringInfo buf, uint32 val)
+{
+	while (val >= 0x80)
+	{
+		appendStringInfoCharMacro(buf, (char)((val & 0x7F) | 0x80));
+		val >>= 7;
+	}
+	appendStringInfoCharMacro(buf, (char)val);
+}
+
+static uint32 load_varint(StringInfo buf)
+{
+	uint32	val = 0;
+	int		shift = 0;
+	int		c;
+
+	do
+	{
+		if (shift > 28)
+			ereport(ERROR,
+					(errcode(ERRCODE_PROTOCOL_VIOLATION),
+					 errmsg("invalid varint in message")));
+		c = pq_getmsgbyte(buf);
+		val |= ((uint32)(c & 0x7F)) << shift;
+		shift += 7;
+	}while(c & 0x80);
+
+	return val;
+}
+
+void BeginSaveCatalogCache(void)
+{
+	HASHCTL ctl;
+
+	EndSaveCatalogCache();
+
+	save_catalog_context = AllocSetContextCreate(CurrentMemoryContext,
+												 "save catalog cache",
+												 ALLOCSET_SMALL_SIZES);
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(CatalogRefKey);
+	ctl.entrysize = sizeof(CatalogRefEntry);
+	ctl.hcxt = save_catalog_context;
+	save_catalog_htab = hash_create("save catalog cache",
+									64,
+									&ctl,
+									HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	save_catalog_count = 0;
+}
+
+void EndSaveCatalogCache(void)
+{
+	if (save_catalog_context)
+		MemoryContextDelete(save_catalog_context);
+	save_catalog_context = NULL;
+	save_catalog_htab = NULL;
+	save_catalog_count = 0;
+}
+
+/*
+ * when the object already saved in this message save a reference of it
+ * and return true
+ */
+static bool save_catalog_ref(StringInfo buf, CatalogRefKind kind, Oid oid)
+{
+	CatalogRefKey key;
+	CatalogRefEntry *entry;
+
+	if (save_catalog_htab == NULL)
+		return false;
+
+	MemSet(&key, 0, sizeof(key));
+	key.kind = kind;
+	key.oid = oid;
+	entry = hash_search(save_catalog_htab, &key, HASH_FIND, NULL);
+	if (entry == NULL)
+		return false;
+
+	pq_sendbyte(buf, SAVE_CATALOG_REF);
+	save_varint(buf, entry->index);
+	return true;
+}
+
+/*
+ * remember object saved by name, must call after all of it's
+ * dependent objects saved, same as load_catalog_remember
+ */
+static void save_catalog_remember(CatalogRefKind kind, Oid oid)
+{
+	CatalogRefKey key;
+	CatalogRefEntry *entry;
+	bool found;
+
+	if (save_catalog_htab == NULL)
+		return;
+
+	MemSet(&key, 0, sizeof(key));
+	key.kind = kind;
+	key.oid = oid;
+	entry = hash_search(save_catalog_htab, &key, HASH_ENTER, &found);
+	if (!found)
+		entry->index = save_catalog_count++;
+}
+
 void save_node_string(StringInfo buf, const char *str)
 {
 	int len = strlen(str);
@@ -186,7 +334,7 @@ void save_namespace(StringInfo buf, Oid nsp)
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&nsp, sizeof(nsp));
-	}else
+	}else if(!save_catalog_ref(buf, CATALOG_REF_NAMESPACE, nsp))
 	{
 		SAVE_BOOL(false);
 		/* search namespace*/
@@ -199,6 +347,7 @@ void save_namespace(StringInfo buf, Oid nsp)
 		/* save namespace and type name */
 		save_node_string(buf, NameStr(nspForm->nspname));
 		ReleaseSysCache(tup);
+		save_catalog_remember(CATALOG_REF_NAMESPACE, nsp);
 	}
 }
 
@@ -212,6 +361,8 @@ void save_oid_type(StringInfo buf, Oid typid)
 		SAVE_IS_NULL();
 		return;
 	}
+	if(save_catalog_ref(buf, CATALOG_REF_TYPE, typid))
+		return;
 	SAVE_IS_NOT_NULL();
 
 	/* get pg_type cache */
@@ -223,6 +374,7 @@ void save_oid_type(StringInfo buf, Oid typid)
 	save_namespace(buf, typ->typnamespace);
 	save_node_string(buf, NameStr(typ->typname));
 	ReleaseSysCache(type);
+	save_catalog_remember(CATALOG_REF_TYPE, typid);
 }
 
 void save_oid_collation(StringInfo buf, Oid collation)
@@ -234,7 +386,7 @@ void save_oid_collation(StringInfo buf, Oid collation)
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&collation, sizeof(collation));
-	}else
+	}else if(!save_catalog_ref(buf, CATALOG_REF_COLLATION, collation))
 	{
 		SAVE_BOOL(false);
 
@@ -250,6 +402,7 @@ void save_oid_collation(StringInfo buf, Oid collation)
 		pq_sendint(buf, form_collation->collencoding, sizeof(form_collation->collencoding));
 
 		ReleaseSysCache(tuple);
+		save_catalog_remember(CATALOG_REF_COLLATION, collation);
 	}
 }
 
@@ -264,7 +417,7 @@ void save_oid_proc(StringInfo buf, Oid proc)
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&proc, sizeof(proc));
-	}else
+	}else if(!save_catalog_ref(buf, CATALOG_REF_PROC, proc))
 	{
 		SAVE_BOOL(false);
 		proctup = SearchSysCache1(PROCOID, ObjectIdGetDatum(proc));
@@ -285,6 +438,7 @@ void save_oid_proc(StringInfo buf, Oid proc)
 		for(i=0;i<count;++i)
 			save_oid_type(buf, oidArray->values[i]);
 		ReleaseSysCache(proctup);
+		save_catalog_remember(CATALOG_REF_PROC, proc);
 	}
 }
 
@@ -296,7 +450,7 @@ void save_oid_operator(StringInfo buf, Oid op)
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&op, sizeof(op));
-	}else
+	}else if(!save_catalog_ref(buf, CATALOG_REF_OPERATOR, op))
 	{
 		SAVE_BOOL(false);
 		opertup = SearchSysCache1(OPEROID, ObjectIdGetDatum(op));
@@ -314,6 +468,7 @@ void save_oid_operator(StringInfo buf, Oid op)
 		save_oid_type(buf, operform->oprright);
 
 		ReleaseSysCache(opertup);
+		save_catalog_remember(CATALOG_REF_OPERATOR, op);
 	}
 }
 
@@ -325,7 +480,7 @@ void save_oid_class(StringInfo buf, Oid oid_rel)
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&oid_rel, sizeof(oid_rel));
-	}else
+	}else if(!save_catalog_ref(buf, CATALOG_REF_CLASS, oid_rel))
 	{
 		classtup = SearchSysCache1(RELOID, ObjectIdGetDatum(oid_rel));
 		if (!HeapTupleIsValid(classtup))
@@ -341,11 +496,35 @@ void save_oid_class(StringInfo buf, Oid oid_rel)
 			SAVE_BOOL(false);
 			save_namespace(buf, classform->relnamespace);
 			save_node_string(buf, NameStr(classform->relname));
+			save_catalog_remember(CATALOG_REF_CLASS, oid_rel);
 		}
 		ReleaseSysCache(classtup);
 	}
 }
 
+/*
+ * like save_oid_class, but always save relation by name, temporary table
+ * included, load it by load_oid_class_name
+ */
+void save_oid_class_name(StringInfo buf, Oid oid_rel)
+{
+	HeapTuple classtup;
+	Form_pg_class classform;
+
+	if(save_catalog_ref(buf, CATALOG_REF_CLASS_NAME, oid_rel))
+		return;
+
+	classtup = SearchSysCache1(RELOID, ObjectIdGetDatum(oid_rel));
+	if (!HeapTupleIsValid(classtup))
+		elog(ERROR, "could not open relation with OID %u", oid_rel);
+	classform = (Form_pg_class) GETSTRUCT(classtup);
+	SAVE_BOOL(false);
+	save_namespace(buf, classform->relnamespace);
+	save_node_string(buf, NameStr(classform->relname));
+	ReleaseSysCache(classtup);
+	save_catalog_remember(CATALOG_REF_CLASS_NAME, oid_rel);
+}
+
 void save_oid_list_class(struct StringInfoData *buf, List *list)
 {
 	ListCell *lc;
@@ -367,6 +546,8 @@ void save_oid_ts_config(struct StringInfoData *buf, Oid cfg)
 		pq_sendbytes(buf, (char*)&cfg, sizeof(cfg));
 		return;
 	}
+	if (save_catalog_ref(buf, CATALOG_REF_TS_CONFIG, cfg))
+		return;
 
 	/* not builtin */
 	SAVE_BOOL(false);
@@ -378,6 +559,7 @@ void save_oid_ts_config(struct StringInfoData *buf, Oid cfg)
 		save_namespace(buf, ts_config->cfgnamespace);
 		save_node_string(buf, NameStr(ts_config->cfgname));
 		ReleaseSysCache(tuple);
+		save_catalog_remember(CATALOG_REF_TS_CONFIG, cfg);
 	}else
 	{
 		ereport(ERROR, 
@@ -392,12 +574,13 @@ void save_oid_authid(struct StringInfoData *buf, Oid authid)
 	{
 		SAVE_BOOL(true);
 		pq_sendbytes(buf, (char*)&authid, sizeof(authid));
-	}else
+	}else if(!save_catalog_ref(buf, CATALOG_REF_AUTHID, authid))
 	{
 		char *name = GetUserNameFromId(authid, false);
 		SAVE_BOOL(false);
 		save_node_string(buf, name);
 		pfree(name);
+		save_catalog_remember(CATALOG_REF_AUTHID, authid);
 	}
 }
 
@@ -665,6 +848,55 @@ char * load_node_string(StringInfo buf, bool need_dup)
 	return str;
 }
 
+void BeginLoadCatalogCache(void)
+{
+	EndLoadCatalogCache();
+
+	load_catalog_context = AllocSetContextCreate(CurrentMemoryContext,
+												 "load catalog cache",
+												 ALLOCSET_SMALL_SIZES);
+	load_catalog_max = 64;
+	load_catalog_oids = MemoryContextAlloc(load_catalog_context,
+										   sizeof(Oid) * load_catalog_max);
+	load_catalog_count = 0;
+}
+
+void EndLoadCatalogCache(void)
+{
+	if (load_catalog_context)
+		MemoryContextDelete(load_catalog_context);
+	load_catalog_context = NULL;
+	load_catalog_oids = NULL;
+	load_catalog_count = load_catalog_max = 0;
+}
+
+static Oid load_catalog_ref(StringInfo buf)
+{
+	uint32 index = load_varint(buf);
+
+	if (load_catalog_oids == NULL ||
+		index >= load_catalog_count)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("invalid catalog reference %u in message", index)));
+
+	return load_catalog_oids[index];
+}
+
+static void load_catalog_remember(Oid oid)
+{
+	if (load_catalog_oids == NULL)
+		return;
+
+	if (load_catalog_count == load_catalog_max)
+	{
+		load_catalog_max *= 2;
+		load_catalog_oids = repalloc(load_catalog_oids,
+									 sizeof(Oid) * load_catalog_max);
+	}
+	load_catalog_oids[load_catalog_count++] = oid;
+}
+
 Bitmapset* load_Bitmapset(StringInfo buf)
 {
 	Bitmapset *node;
@@ -687,13 +919,18 @@ Oid load_namespace(StringInfo buf)
 Oid load_namespace_extend(struct StringInfoData *buf, bool missok)
 {
 	Oid oid;
-	if(LOAD_BOOL())
+	int flag = LOAD_BOOL();
+	if(flag == SAVE_CATALOG_REF)
+	{
+		oid = load_catalog_ref(buf);
+	}else if(flag)
 	{
 		pq_copymsgbytes(buf, (char*)&oid, sizeof(oid));
 	}else
 	{
 		const char *nsp_name = load_node_string(buf, false);
 		oid = LookupExplicitNamespace(nsp_name, missok);
+		load_catalog_remember(oid);
 	}
 	return oid;
 }
@@ -703,8 +940,11 @@ Oid load_oid_type(StringInfo buf)
 	const char *str_type;
 	HeapTuple tup;
 	Oid typid,namespaceId;
+	int flag = LOAD_IS_NULL();
 
-	if(LOAD_IS_NULL())
+	if(flag == SAVE_CATALOG_REF)
+		return load_catalog_ref(buf);
+	else if(flag)
 		return InvalidOid;
 
 	namespaceId = load_namespace(buf);
@@ -721,13 +961,18 @@ Oid load_oid_type(StringInfo buf)
 
 	typid = HeapTupleGetOid(tup);
 	ReleaseSysCache(tup);
+	load_catalog_remember(typid);
 	return typid;
 }
 
 Oid load_oid_collation(StringInfo buf)
 {
 	Oid oid;
-	if(LOAD_BOOL())
+	int flag = LOAD_BOOL();
+	if(flag == SAVE_CATALOG_REF)
+	{
+		oid = load_catalog_ref(buf);
+	}else if(flag)
 	{
 		pq_copymsgbytes(buf, (char*)&oid, sizeof(oid));
 	}else
@@ -754,6 +999,7 @@ Oid load_oid_collation(StringInfo buf)
 		}
 		oid = HeapTupleGetOid(tup);
 		ReleaseSysCache(tup);
+		load_catalog_remember(oid);
 	}
 	return oid;
 }
@@ -761,7 +1007,11 @@ Oid load_oid_collation(StringInfo buf)
 Oid load_oid_proc(StringInfo buf)
 {
 	Oid oid;
-	if(LOAD_BOOL())
+	int flag = LOAD_BOOL();
+	if(flag == SAVE_CATALOG_REF)
+	{
+		oid = load_catalog_ref(buf);
+	}else if(flag)
 	{
 		pq_copymsgbytes(buf, (char*)&oid, sizeof(oid));
 	}else
@@ -822,6 +1072,7 @@ Oid load_oid_proc(StringInfo buf)
 		if(args)
 			pfree(args);
 		pfree(vector);
+		load_catalog_remember(oid);
 	}
 	return oid;
 }
@@ -829,7 +1080,11 @@ Oid load_oid_proc(StringInfo buf)
 Oid load_oid_operator(StringInfo buf)
 {
 	Oid oid;
-	if(LOAD_BOOL())
+	int flag = LOAD_BOOL();
+	if(flag == SAVE_CATALOG_REF)
+	{
+		oid = load_catalog_ref(buf);
+	}else if(flag)
 	{
 		pq_copymsgbytes(buf, (char*)&oid, sizeof(oid));
 	}else
@@ -873,6 +1128,7 @@ Oid load_oid_operator(StringInfo buf)
 				,errhint("it result type %s", format_type_be(form_oper->oprresult))));
 		}
 		ReleaseSysCache(tup);
+		load_catalog_remember(oid);
 	}
 
 	return oid;
@@ -883,7 +1139,11 @@ Oid load_oid_class(StringInfo buf)
 	const char *relname;
 	Oid nsp;
 	Oid oid;
-	if(LOAD_BOOL())
+	int flag = LOAD_BOOL();
+	if(flag == SAVE_CATALOG_REF)
+	{
+		oid = load_catalog_ref(buf);
+	}else if(flag)
 	{
 		pq_copymsgbytes(buf, (char*)&oid, sizeof(oid));
 	}else
@@ -893,7 +1153,44 @@ Oid load_oid_class(StringInfo buf)
 		oid = get_relname_relid(relname, nsp);
 		if (!OidIsValid(oid))
 			elog(ERROR, "relation \"%s\" not exists in schema %u", relname, nsp);
+		load_catalog_remember(oid);
+	}
+	return oid;
+}
+
+/*
+ * load relation saved by save_oid_class_name, return InvalidOid
+ * when it not exists and missok is true
+ */
+Oid load_oid_class_name(StringInfo buf, bool missok)
+{
+	const char *relname;
+	Oid nsp;
+	Oid oid;
+
+	if(LOAD_BOOL() == SAVE_CATALOG_REF)
+	{
+		/* an earlier reference may have been missing ok */
+		oid = load_catalog_ref(buf);
+		if (!OidIsValid(oid) && !missok)
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_OBJECT),
+					 errmsg("referenced relation not exists")));
+		return oid;
 	}
+
+	nsp = load_namespace_extend(buf, missok);
+	relname = load_node_string(buf, false);
+	if (OidIsValid(nsp) && relname[0])
+		oid = get_relname_relid(relname, nsp);
+	else
+		oid = InvalidOid;
+	if (!OidIsValid(oid) && !missok)
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_OBJECT),
+				 errmsg("relation \"%s\" not exists", relname)));
+	load_catalog_remember(oid);
+
 	return oid;
 }
 
@@ -914,8 +1211,12 @@ Oid load_oid_ts_config(struct StringInfoData *buf)
 	char *tsname;
 	Oid nsp;
 	Oid result;
+	int flag = LOAD_BOOL();
 
-	if (LOAD_BOOL())
+	if (flag == SAVE_CATALOG_REF)
+	{
+		return load_catalog_ref(buf);
+	}else if (flag)
 	{
 		pq_copymsgbytes(buf, (char*)&result, sizeof(result));
 		return result;
@@ -931,6 +1232,7 @@ Oid load_oid_ts_config(struct StringInfoData *buf)
 					 errmsg("text search configuration \"%s\" does not exist", tsname),
 					 err_generic_string(PG_DIAG_SCHEMA_NAME, get_namespace_name(nsp))));
 		}
+		load_catalog_remember(result);
 	}
 
 	return result;
@@ -940,8 +1242,12 @@ Oid load_oid_authid(struct StringInfoData *buf)
 {
 	char *name;
 	Oid result;
+	int flag = LOAD_BOOL();
 
-	if (LOAD_BOOL())
+	if (flag == SAVE_CATALOG_REF)
+	{
+		result = load_catalog_ref(buf);
+	}else if (flag)
 	{
 		pq_copymsgbytes(buf, (char*)&result, sizeof(result));
 	}else
@@ -952,6 +1258,7 @@ Oid load_oid_authid(struct StringInfoData *buf)
 			ereport(ERROR,
 					(errcode(ERRCODE_UNDEFINED_OBJECT),
 					 errmsg("role \"%s\" does not exist", name)));
+		load_catalog_remember(result);
 	}
 	return result;
 }
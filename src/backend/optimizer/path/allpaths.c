@@ -49,6 +49,7 @@
 #include "optimizer/planmain.h"
 #include "optimizer/reduceinfo.h"
 #include "pgxc/pgxcnode.h"
+#include "pgxc/relstatcache.h"
 #endif /* ADB */
 
 /* results of subquery_is_pushdown_safe */
@@ -709,6 +710,7 @@ set_plain_rel_pathlist(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte)
 		List *base_clauses;
 		List *exclude = NIL;
 		RelationLocInfo *loc_info = rel->loc_info;
+		double skew;
 		if (IsLocatorDistributedByValue(loc_info->locatorType) ||
 			loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
 		{
@@ -717,6 +719,9 @@ set_plain_rel_pathlist(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte)
 		rinfo = MakeReduceInfoFromLocInfo(loc_info, exclude, rte->relid, rel->relid);
 		list_free(exclude);
 
+		/* rows of relation maybe not even in datanodes */
+		skew = RelStatCacheGetSkew(rte->relid, loc_info);
+
 		exec_param_clauses = NIL;
 		save_clauses = rel->baserestrictinfo;
 		if(root->must_replicate)
@@ -753,7 +758,7 @@ set_plain_rel_pathlist(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte)
 
 			set_path_reduce_info_worker(path, reduce_info_list);
 
-			cost_div(path, list_length(loc_info->nodeids));
+			cost_div_skew(path, list_length(loc_info->nodeids), skew);
 		}
 
 		if (exec_param_clauses)
@@ -774,7 +779,7 @@ set_plain_rel_pathlist(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte)
 			{
 				path = create_seqscan_path(root, rel, required_outer, 0);
 				set_path_reduce_info_worker(path, reduce_info_list);
-				cost_div(path, list_length(loc_info->nodeids));
+				cost_div_skew(path, list_length(loc_info->nodeids), skew);
 				path = (Path*)try_reducescan_path(root, rel, path->pathtarget, path, replicate, NULL, exec_param_clauses);
 				Assert(path);
 				rel->cluster_pathlist = list_make1(path);
@@ -796,7 +801,7 @@ set_plain_rel_pathlist(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte)
 
 					set_path_reduce_info_worker(path, reduce_info_list);
 
-					cost_div(path, list_length(loc_info->nodeids));
+					cost_div_skew(path, list_length(loc_info->nodeids), skew);
 					add_cluster_partial_path(rel, path);
 				}
 				rel->partial_pathlist = NIL;
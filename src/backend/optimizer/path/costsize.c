@@ -97,6 +97,7 @@
 #include "utils/spccache.h"
 #include "utils/tuplesort.h"
 #ifdef ADB
+#include "lib/bloomfilter.h"
 #include "optimizer/reduceinfo.h"
 #endif /* ABD */
 
@@ -144,6 +145,10 @@ bool		enable_remotegroup = true;
 bool		enable_remotesort = true;
 bool		enable_remotelimit = true;
 bool		enable_hashscan = true;
+bool		enable_skew_reduce = true;
+bool		enable_reduce_filter = true;
+bool		enable_parallel_reduce = true;
+bool		enable_remote_insert_copy = true;
 #endif
 
 typedef struct
@@ -5187,6 +5192,20 @@ void cost_div(Path *path, int n)
 		path->total_cost /= n;
 	}
 }
+
+/*
+ * like cost_div, but rows not even in nodes, the cluster runs as slow as
+ * the busiest node, skew is it's rows divide average rows
+ */
+void cost_div_skew(Path *path, int n, double skew)
+{
+	cost_div(path, n);
+	if (skew > 1.0 && n > 1)
+	{
+		path->startup_cost *= Min(skew, n);
+		path->total_cost *= Min(skew, n);
+	}
+}
 void cost_cluster_gather(ClusterGatherPath *path, RelOptInfo *baserel, ParamPathInfo *param_info, double *rows)
 {
 	Cost		startup_cost = 0;
@@ -5221,7 +5240,7 @@ cost_cluster_expr(Expr *expr, double tuples)
 }
 
 void
-cost_cluster_reduce(ClusterReducePath *path)
+cost_cluster_reduce(PlannerInfo *root, ClusterReducePath *path)
 {
 	Path		   *subpath = path->subpath;
 	ReduceInfo	   *reduce_to;
@@ -5238,6 +5257,7 @@ cost_cluster_reduce(ClusterReducePath *path)
 	double			src_rows, avg_rows;
 	double			src_pages;
 	double			reduce_scale = 0.0;
+	double			skew_freq = 0.0;
 	Cost			src_startup_cost,
 					src_total_cost;
 	Cost			sort_startup_cost,
@@ -5267,7 +5287,8 @@ cost_cluster_reduce(ClusterReducePath *path)
 		is_src_reduce_rep = true;
 	else
 	if (IsReduceInfoListByValue(reduce_from_list) ||
-		IsReduceInfoListRound(reduce_from_list))
+		IsReduceInfoListRound(reduce_from_list) ||
+		IsReduceInfoListSkew(reduce_from_list))
 		is_src_reduce_shard = true;
 	else
 	{
@@ -5326,7 +5347,8 @@ cost_cluster_reduce(ClusterReducePath *path)
 		}
 	} else
 	if (IsReduceInfoByValue(reduce_to) ||
-		IsReduceInfoRound(reduce_to))
+		IsReduceInfoRound(reduce_to) ||
+		IsReduceInfoSkew(reduce_to))
 	{
 		if (is_src_reduce_coord ||is_src_reduce_rep)
 		{
@@ -5340,6 +5362,13 @@ cost_cluster_reduce(ClusterReducePath *path)
 			reduce_scale = ((double) list_length(different) / src_num) +
 						   ((double) list_length(intersection) / src_num) * ((double) (dst_num - 1) / dst_num);
 		}
+
+		/* rows have skew value send to all nodes */
+		if (reduce_to->type == REDUCE_TYPE_SKEW_BROADCAST)
+		{
+			skew_freq = GetReduceSkewFrequency(root, reduce_to);
+			reduce_scale += skew_freq * (dst_num - 1);
+		}
 	} else
 		Assert(false);
 
@@ -5351,8 +5380,26 @@ cost_cluster_reduce(ClusterReducePath *path)
 	reduce_run_cost = src_pages * reduce_scale * reduce_page_cost + reduce_startup_cost;
 	reduce_run_cost += cost_cluster_expr(NULL, src_rows * reduce_scale);
 
-	/* Calculate the cost of sorting */
+	/*
+	 * Cluster runs as slow as the busiest node, rows of a skew value all
+	 * reduce to one node by hash. Without skew value, same as
+	 * GetSkewReduceValues found, hash is assumed even
+	 */
 	avg_rows = src_rows / dst_num;
+	if (reduce_to->type == REDUCE_TYPE_SKEW_BROADCAST)
+	{
+		avg_rows = src_rows * skew_freq + src_rows * (1.0 - skew_freq) / dst_num;
+	}else if (enable_skew_reduce &&
+			  reduce_to->type == REDUCE_TYPE_HASH &&
+			  list_length(reduce_to->params) == 1 &&
+			  dst_num > 1)
+	{
+		double max_freq = GetReduceMaxFrequency(root, linitial(reduce_to->params));
+		if (IsSkewReduceFrequency(max_freq, dst_num))
+			avg_rows = src_rows * max_freq + src_rows * (1.0 - max_freq) / dst_num;
+	}
+
+	/* Calculate the cost of sorting */
 	sort_startup_cost = sort_run_cost = 0.0;
 	if (path->path.pathkeys != NIL)
 	{
@@ -5383,4 +5430,79 @@ cost_cluster_reduce(ClusterReducePath *path)
 	list_free(src_nodes);
 	list_free(union_nodes);
 }
+
+/* runtime filters of a HashJoin get a quarter of work_mem */
+#define REDUCE_FILTER_WORK_MEM_FRACTION	4
+/* with less bits per element false positive rate is above 15% */
+#define REDUCE_FILTER_MIN_BITS_PER_ELEM	4.0
+
+/*
+ * reduce_filter_max_size
+ *	  Max bytes of the runtime bloom filter of one node.
+ *
+ * Each node keeps its own filter and the filters of other 'nnodes' - 1
+ * nodes, all of them get REDUCE_FILTER_WORK_MEM_FRACTION of work_mem.
+ */
+Size
+reduce_filter_max_size(int nnodes)
+{
+	return (Size) work_mem * 1024L / REDUCE_FILTER_WORK_MEM_FRACTION / Max(nnodes, 1);
+}
+
+/*
+ * cost_reduce_filter
+ *	  Determines the gain of runtime filter for a cluster HashJoin which
+ *	  outer is a ClusterReduce.
+ *
+ * Each node sends a bloom filter of its inner hash keys to other nodes, an
+ * outer row is sent to a remote node only when filter of that node may
+ * contain its key.
+ *
+ * 'outer_rows' and 'outer_width' are rows each node reduce for outer
+ * 'inner_rows' is rows each node insert into hash table
+ * 'match_frac' is fraction of outer rows having join partner
+ * 'nnodes' is number of nodes outer reduce to
+ *
+ * Returns saved cost minus extra cost, filter is worth it if positive.
+ */
+Cost
+cost_reduce_filter(double outer_rows, int outer_width, double inner_rows,
+				   double match_frac, int nnodes)
+{
+	double		filter_bytes;
+	double		bits_per_elem;
+	double		nhash;
+	double		false_rate;
+	double		remote_rows;
+	double		filtered_rows;
+	Cost		gain;
+	Cost		extra;
+
+	if (nnodes < 2 || outer_rows <= 0.0)
+		return 0.0;
+
+	inner_rows = clamp_row_est(inner_rows);
+	match_frac = Max(Min(match_frac, 1.0), 0.0);
+
+	/* same size as executor create, see bloom_create */
+	filter_bytes = (double) bloom_estimate_size(inner_rows, reduce_filter_max_size(nnodes));
+	bits_per_elem = filter_bytes * BITS_PER_BYTE / inner_rows;
+
+	/* does not fit in its share of work_mem, rejects too few rows */
+	if (bits_per_elem < REDUCE_FILTER_MIN_BITS_PER_ELEM)
+		return 0.0;
+	nhash = Max(Min(rint(log(2.0) * bits_per_elem), 10.0), 1.0);
+	false_rate = pow(1.0 - exp(-nhash / bits_per_elem), nhash);
+
+	/* rows to remote nodes which can not join and rejected by filter */
+	remote_rows = outer_rows * (nnodes - 1) / nnodes;
+	filtered_rows = remote_rows * (1.0 - match_frac) * (1.0 - false_rate);
+
+	gain = page_size(filtered_rows, outer_width) * reduce_page_cost +
+		   cpu_tuple_cost * filtered_rows;
+	extra = filter_bytes / BLCKSZ * (nnodes - 1) * reduce_page_cost +
+			cpu_operator_cost * (inner_rows + remote_rows);
+
+	return gain - extra;
+}
 #endif /* ADB */
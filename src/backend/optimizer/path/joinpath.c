@@ -23,6 +23,7 @@
 #include "optimizer/paths.h"
 
 #ifdef ADB
+#include "nodes/nodeFuncs.h"
 #include "optimizer/clauses.h"
 #include "optimizer/planmain.h"
 #include "optimizer/reduceinfo.h"
@@ -119,6 +120,10 @@ static bool get_cluster_join_exprs(RelOptInfo *outerrel, RelOptInfo *innerrel,
 								   List **outer_exprs, List **inner_exprs,
 								   List *restrictlist);
 static void try_partial_sort_path_for_join(PlannerInfo *root, RelOptInfo *rel, List *all_pathkeys);
+static bool try_skew_reduce_join(ClusterJoinContext *jcontext,
+								 List *outer_exprs, List *inner_exprs,
+								 List *outer_pathlist, List *inner_pathlist,
+								 List *storage, bool nestjoinOK);
 #endif /* ADB */
 
 /*
@@ -2542,6 +2547,14 @@ re_reduce_join_:
 									 REDUCE_TYPE_HASH,
 									 REDUCE_TYPE_MODULO,
 									 REDUCE_TYPE_NONE);
+				if (enable_skew_reduce)
+					tried_join |= try_skew_reduce_join(&jcontext,
+													   outer_exprs,
+													   inner_exprs,
+													   reduce_outer_pathlist,
+													   reduce_inner_pathlist,
+													   storage,
+													   nestjoinOK);
 			}
 			tried_join |= add_cluster_paths_to_joinrel_internal(&jcontext, outer_pathlist, inner_pathlist, nestjoinOK, false);
 			list_free(outer_pathlist);
@@ -2616,11 +2629,101 @@ re_reduce_join_:
 											  reduce_list, extra);
 			}
 
+			/* reduce outer rows in parallel workers to where inner rows are */
+			if (enable_parallel_reduce &&
+				(inner_path = get_cheapest_path_for_pathkeys(inner_pathlist, NIL, NULL, TOTAL_COST)) != NULL)
+			{
+				List *inner_reduce_list = get_reduce_info_list(inner_path);
+				List *need_reduce_list = NIL;
+				List *outer_pathlist;
+
+				foreach(lc1, create_outer_reduce_info_for_join(inner_reduce_list, outerrel, jointype, extra))
+				{
+					if (!IsReduceInfoCoordinator((ReduceInfo*)lfirst(lc1)))
+						need_reduce_list = lappend(need_reduce_list, lfirst(lc1));
+				}
+				outer_pathlist = reduce_paths_for_join(root, outerrel, outerrel->cluster_partial_pathlist, need_reduce_list);
+				foreach(lc1, outer_pathlist)
+				{
+					outer_path = lfirst(lc1);
+					set_all_join_inner_path(&jcontext, outer_path, inner_pathlist);
+					inner_path = get_cheapest_join_path(&jcontext, outer_path, TOTAL_COST, true, &reduce_list);
+					if (inner_path)
+						try_partial_hashjoin_path(root, joinrel,
+												  outer_path, inner_path,
+												  jcontext.hashclauses, jointype,
+												  reduce_list, extra);
+				}
+				list_free(outer_pathlist);
+				list_free(need_reduce_list);
+			}
+
 			list_free(inner_pathlist);
 		}
 	}
 }
 
+/*
+ * Reduce both sides for join, but rows having a most common value of the
+ * bigger side are not hashed to one node: the bigger side spreads them
+ * round robin and the smaller side replicates them to all nodes.
+ */
+static bool try_skew_reduce_join(ClusterJoinContext *jcontext,
+								 List *outer_exprs, List *inner_exprs,
+								 List *outer_pathlist, List *inner_pathlist,
+								 List *storage, bool nestjoinOK)
+{
+	PlannerInfo *root = jcontext->root;
+	ListCell   *lc_outer;
+	ListCell   *lc_inner;
+	List	   *outer_list;
+	List	   *inner_list;
+	ReduceInfo *outer_rinfo;
+	ReduceInfo *inner_rinfo;
+	Const	   *skew_values;
+	Expr	   *outer_expr;
+	Expr	   *inner_expr;
+	bool		big_outer;
+	bool		tried_join = false;
+
+	big_outer = (jcontext->outerrel->rows >= jcontext->innerrel->rows);
+
+	/* semi join can not replicate outer rows */
+	if (jcontext->jointype == JOIN_SEMI && big_outer == false)
+		return false;
+
+	forboth(lc_outer, outer_exprs, lc_inner, inner_exprs)
+	{
+		outer_expr = lfirst(lc_outer);
+		inner_expr = lfirst(lc_inner);
+		if (exprType((Node*)outer_expr) != exprType((Node*)inner_expr))
+			continue;
+
+		skew_values = GetSkewReduceValues(root,
+										  big_outer ? outer_expr : inner_expr,
+										  list_length(storage));
+		if (skew_values == NULL)
+			continue;
+
+		outer_rinfo = MakeSkewReduceInfo(storage, outer_expr, skew_values, !big_outer);
+		inner_rinfo = MakeSkewReduceInfo(storage, inner_expr, skew_values, big_outer);
+
+		outer_list = inner_list = NIL;
+		ReducePathListUsingReduceInfo(root, jcontext->outerrel, outer_pathlist,
+									  ReducePathSave2List, &outer_list, outer_rinfo);
+		ReducePathListUsingReduceInfo(root, jcontext->innerrel, inner_pathlist,
+									  ReducePathSave2List, &inner_list, inner_rinfo);
+		tried_join = add_cluster_paths_to_joinrel_internal(jcontext, outer_list, inner_list, nestjoinOK, false);
+		list_free(outer_list);
+		list_free(inner_list);
+
+		/* one skew key is enough */
+		break;
+	}
+
+	return tried_join;
+}
+
 static bool add_cluster_paths_to_joinrel_internal(ClusterJoinContext *jcontext,
 												  List *outer_pathlist,
 												  List *inner_pathlist,
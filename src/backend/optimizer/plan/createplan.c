@@ -4289,6 +4289,32 @@ create_hashjoin_plan(PlannerInfo *root,
 	 */
 	if (best_path->jpath.path.reduce_is_valid)
 		join_plan->cluster_hashtable_first = true;
+
+	/*
+	 * Outer rows which can not join any inner row of a node need not reduce
+	 * to that node, outer ClusterReduce can skip them by bloom filters of
+	 * hash tables of other nodes.
+	 */
+	if (join_plan->cluster_hashtable_first &&
+		enable_reduce_filter &&
+		IsA(outer_plan, ClusterReduce) &&
+		((ClusterReduce *) outer_plan)->numCols == 0 &&
+		(best_path->jpath.jointype == JOIN_INNER ||
+		 best_path->jpath.jointype == JOIN_SEMI ||
+		 best_path->jpath.jointype == JOIN_RIGHT))
+	{
+		Plan   *reduce_input = outerPlan(outer_plan);
+		double	match_frac = 1.0;
+
+		if (outer_plan->plan_rows > 0.0)
+			match_frac = best_path->jpath.path.rows / outer_plan->plan_rows;
+		if (cost_reduce_filter(reduce_input->plan_rows,
+							   reduce_input->plan_width,
+							   inner_plan->plan_rows,
+							   match_frac,
+							   list_length(((ClusterReduce *) outer_plan)->reduce_oids)) > 0.0)
+			join_plan->cluster_reduce_filter = true;
+	}
 #endif
 
 	copy_generic_path_info(&join_plan->join.plan, &best_path->jpath.path);
@@ -7116,7 +7142,7 @@ static bool find_cluster_reduce_expr(Path *path, List **pplist)
 				if(IsReduceInfoByValue(rinfo))
 				{
 					if (IsReduceInfoInOneNode(rinfo) ||
-						IsGroupingReduceExpr(path->pathtarget, rinfo))
+						IsGroupingReduceExpr(NULL, path->pathtarget, rinfo))
 						copy = true;
 				}else if(IsReduceInfoReplicated(rinfo) ||
 						IsReduceInfoCoordinator(rinfo) ||
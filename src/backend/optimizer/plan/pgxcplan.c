@@ -2148,7 +2148,8 @@ pgxc_set_en_expr(Oid tableoid, Index resultRelationIndex)
 	 * XXX Need further testing for replicated and round-robin tables
 	 */
 	if (rel_loc_info->locatorType == LOCATOR_TYPE_HASH ||
-		rel_loc_info->locatorType == LOCATOR_TYPE_MODULO)
+		rel_loc_info->locatorType == LOCATOR_TYPE_MODULO ||
+		rel_loc_info->locatorType == LOCATOR_TYPE_RANGE)
 	{
 		tp = SearchSysCache(ATTNUM,
 							ObjectIdGetDatum(tableoid),
@@ -221,6 +221,7 @@ static Path* reduce_to_relation_insert(PlannerInfo *root, Index rel_id, Path *pa
 static bool set_modifytable_path_reduceinfo(PlannerInfo *root, ModifyTablePath *modify);
 static bool is_remote_relation(PlannerInfo *root, Index relid);
 static bool modify_have_auxiliary(PlannerInfo *root, Index relid);
+static bool insert_values_by_copy(PlannerInfo *root);
 static Bitmapset *find_cte_planid(PlannerInfo *root, Bitmapset *bms);
 static int create_cluster_distinct_path(PlannerInfo *root, Path *subpath, void *context);
 static int create_cluster_grouping_path(PlannerInfo *root, Path *subpath, void *context);
@@ -238,6 +239,7 @@ static PathTarget* update_window_target(PathTarget *input_target,
 										WindowFuncLists *wflists,
 										WindowClause *wc);
 static bool rti_is_base_rel(PlannerInfo *root, Index rti);
+static Node *make_cluster_limit_count(Node *limitOffset, Node *limitCount);
 #endif
 
 
@@ -2365,6 +2367,7 @@ grouping_planner(PlannerInfo *root, bool inheritance_update,
 				!has_any_triggers(root, parse->resultRelation, CMD_INSERT) &&
 				!have_remote_query_path(path) &&
 				is_remote_relation(root, parse->resultRelation) &&
+				!insert_values_by_copy(root) &&
 				(path->rows >= 5.0 ||
 				 modify_have_auxiliary(root, parse->resultRelation)))
 			{
@@ -2456,24 +2459,39 @@ grouping_planner(PlannerInfo *root, bool inheritance_update,
 		}
 
 		have_gather = have_cluster_gather_path(path);
-		/* create limit path if we can */
+		/*
+		 * create limit path if we can, when have order by path is already
+		 * sorted, so Sort under the limit becomes a bounded sort
+		 */
 		if (planner_need_limit &&				/* need limit */
-			parse->sortClause == NULL &&		/* have no order by */
 			parse->commandType == CMD_SELECT &&	/* not a modify sql */
-			!have_gather &&						/* limit at datanode */
-			parse->limitOffset == NULL)			/* must have no offset */
+			!have_gather)						/* limit at datanode */
 		{
-			path = (Path*) create_limit_path(root, final_rel, path,
-												parse->limitOffset,
-												parse->limitCount,
-												offset_est,
-												count_est);
-			/*
-			 * when data is replicated or
-			 * only from one node, don't need create limit again */
 			if (IsReduceInfoListReplicated(reduce_info_list) ||
 				IsReduceInfoListInOneNode(reduce_info_list))
+			{
+				/*
+				 * when data is replicated or
+				 * only from one node, don't need create limit again */
+				path = (Path*) create_limit_path(root, final_rel, path,
+												 parse->limitOffset,
+												 parse->limitCount,
+												 offset_est,
+												 count_est);
 				created_limit = true;
+			}else
+			{
+				/* each datanode returns at most offset+count rows */
+				Node *limit_count = make_cluster_limit_count(parse->limitOffset,
+															 parse->limitCount);
+				if (limit_count != NULL)
+					path = (Path*) create_limit_path(root, final_rel, path,
+													 NULL,
+													 limit_count,
+													 0,
+													 (count_est > 0 && offset_est >= 0) ?
+														count_est + offset_est : count_est);
+			}
 		}
 
 		if (parse->commandType != CMD_SELECT && !inheritance_update)
@@ -4596,7 +4614,7 @@ create_grouping_paths(PlannerInfo *root,
 			if(have_cluster_subpath == false)
 				have_cluster_subpath = IsReduceInfoListByValue(get_reduce_info_list(path)) ||
 										IsReduceInfoListRound(get_reduce_info_list(path));
-			if(CanOnceGroupingClusterPath(target, path))
+			if(CanOnceGroupingClusterPath(root, target, path))
 			{
 				create_cluster_grouping_path(root, path, &gcontext);
 				if(tried_cluster_agg == false)
@@ -4703,7 +4721,7 @@ create_grouping_paths(PlannerInfo *root,
 			foreach(lc, input_rel->cluster_partial_pathlist)
 			{
 				subpath = lfirst(lc);
-				if(CanOnceGroupingClusterPath(target, subpath))
+				if(CanOnceGroupingClusterPath(root, target, subpath))
 					create_cluster_grouping_path(root, subpath, &gcontext);
 			}
 			if(gcontext.new_paths_list)
@@ -4734,6 +4752,7 @@ create_grouping_paths(PlannerInfo *root,
 			}else
 			{
 				List *storage_list;
+				List *parallel_path_list = NIL;
 				groupExprs = get_sortgrouplist_exprs(parse->groupClause, parse->targetList);
 				subpath = linitial(input_rel->cluster_partial_pathlist);
 				gcontext.partial_groups = get_number_of_groups(root, subpath->rows, NULL, NULL);
@@ -4762,6 +4781,30 @@ create_grouping_paths(PlannerInfo *root,
 				list_free(gcontext.new_paths_list);
 				gcontext.new_paths_list = NIL;
 
+				/* or reduce in parallel workers before gather */
+				if (enable_parallel_reduce && groupExprs)
+				{
+					foreach(lc, new_path_list)
+					{
+						subpath = lfirst(lc);
+						ReduceInfoListGetStorageAndExcludeOidList(get_reduce_info_list(subpath),
+																  &storage_list,
+																  NULL);
+						ReducePathByExpr((Expr*)groupExprs,
+										 root,
+										 grouped_rel,
+										 subpath,
+										 storage_list,
+										 NIL,
+										 ReducePathSave2List,
+										 &parallel_path_list,
+										 REDUCE_TYPE_HASH,
+										 REDUCE_TYPE_MODULO,
+										 REDUCE_TYPE_NONE);
+						list_free(storage_list);
+					}
+				}
+
 				/* step 3: gather */
 				ParallelGatherSubPathList(root, grouped_rel, new_path_list, ReducePathSave2List, (void*)&gcontext.new_paths_list);
 				list_free(new_path_list);
@@ -4791,6 +4834,13 @@ create_grouping_paths(PlannerInfo *root,
 					list_free(storage_list);
 				}
 				list_free(new_path_list);
+
+				/* step 5: gather rows reduced in parallel workers and final agg */
+				if (parallel_path_list)
+				{
+					ParallelGatherSubPathList(root, grouped_rel, parallel_path_list, create_cluster_grouping_path, &gcontext);
+					list_free(parallel_path_list);
+				}
 				add_cluster_path_list(grouped_rel, gcontext.new_paths_list, true);
 				gcontext.new_paths_list = NIL;
 			}
@@ -4902,7 +4952,7 @@ create_window_paths(PlannerInfo *root,
 
 		if (path == input_rel->cheapest_cluster_total_path ||
 			pathkeys_contained_in(root->window_pathkeys, path->pathkeys) ||
-			HaveOnceWindowAggClusterPath(activeWindows, tlist, path))
+			HaveOnceWindowAggClusterPath(root, activeWindows, tlist, path))
 			create_cluster_window_path(root,
 									   window_rel,
 									   path,
@@ -5067,7 +5117,7 @@ static void create_cluster_window_path(PlannerInfo *root,
 		if(PATH_REQ_OUTER(path))
 		{
 			coord_list = lappend(coord_list, wc);
-		}else if(CanOnceWindowAggClusterPath(wc, tlist, path))
+		}else if(CanOnceWindowAggClusterPath(root, wc, tlist, path))
 		{
 			context.window_pathkeys = make_pathkeys_for_window(root, wc, tlist);
 			context.new_path = NULL;
@@ -5418,7 +5468,7 @@ create_distinct_paths(PlannerInfo *root,
 			if (IsReduceInfoListCoordinator(reduce_list) ||
 				IsReduceInfoListReplicated(reduce_list) ||
 				IsReduceInfoListInOneNode(reduce_list) ||
-				CanOnceDistinctReduceInfoList(distinctExprs, reduce_list))
+				CanOnceDistinctReduceInfoList(root, distinctExprs, reduce_list))
 			{
 				create_cluster_distinct_path(root, path, &dcontext);
 			}
@@ -5461,7 +5511,7 @@ create_distinct_paths(PlannerInfo *root,
 				if (IsReduceInfoListCoordinator(reduce_list) ||
 					IsReduceInfoListReplicated(reduce_list) ||
 					IsReduceInfoListInOneNode(reduce_list) ||
-					CanOnceDistinctReduceInfoList(distinctExprs, reduce_list))
+					CanOnceDistinctReduceInfoList(root, distinctExprs, reduce_list))
 				{
 					create_cluster_distinct_path(root, path, &dcontext);
 				}
@@ -5529,7 +5579,7 @@ create_distinct_paths(PlannerInfo *root,
 			if (IsReduceInfoListCoordinator(reduce_list) ||
 				IsReduceInfoListReplicated(reduce_list) ||
 				IsReduceInfoListInOneNode(reduce_list) ||
-				CanOnceDistinctReduceInfoList(distinctExprs, reduce_list))
+				CanOnceDistinctReduceInfoList(root, distinctExprs, reduce_list))
 			{
 				create_cluster_distinct_path(root, path, &dcontext);
 			}
@@ -6850,6 +6900,7 @@ static Path* reduce_to_relation_insert(PlannerInfo *root, Index rel_id, Path *pa
 		path = create_cluster_reduce_path(root, path, list_make1(reduce_info), path->parent, NIL);
 	}else if(loc_info->locatorType == LOCATOR_TYPE_HASH ||
 			 loc_info->locatorType == LOCATOR_TYPE_MODULO ||
+			 loc_info->locatorType == LOCATOR_TYPE_RANGE ||
 			 loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
 	{
 		Expr *expr;
@@ -6861,15 +6912,22 @@ static Path* reduce_to_relation_insert(PlannerInfo *root, Index rel_id, Path *pa
 		if(loc_info->locatorType == LOCATOR_TYPE_HASH)
 		{
 			expr = list_nth(path->pathtarget->exprs, loc_info->partAttrNum - 1);
-			reduce_info = MakeHashReduceInfo(storage_nodes,
-											 NIL,
-											 expr);
+			if (IsRelationDistributedByBucket(loc_info))
+				reduce_info = MakeBucketReduceInfo(loc_info, NIL, expr);
+			else
+				reduce_info = MakeHashReduceInfo(storage_nodes,
+												 NIL,
+												 expr);
 		}else if(loc_info->locatorType == LOCATOR_TYPE_MODULO)
 		{
 			expr = list_nth(path->pathtarget->exprs, loc_info->partAttrNum - 1);
 			reduce_info = MakeModuloReduceInfo(storage_nodes,
 											   NIL,
 											   expr);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_RANGE)
+		{
+			expr = list_nth(path->pathtarget->exprs, loc_info->partAttrNum - 1);
+			reduce_info = MakeRangeReduceInfo(loc_info, NIL, expr);
 		}else if(loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
 		{
 			ListCell *lc;
@@ -7064,6 +7122,30 @@ static bool modify_have_auxiliary(PlannerInfo *root, Index relid)
 	return rte->param_new >= 0 || rte->param_old >= 0;
 }
 
+/*
+ * Rows of INSERT ... VALUES are already on coordinator, the executor sends
+ * them to their datanodes by COPY (see ExecInitRemoteInsert), that is
+ * cheaper than a cluster plan shipping them to a datanode for reduce.
+ */
+static bool insert_values_by_copy(PlannerInfo *root)
+{
+	Query *parse = root->parse;
+	RangeTblRef *rtr;
+
+	if (!enable_remote_insert_copy ||
+		parse->returningList != NIL ||
+		parse->onConflict != NULL ||
+		list_length(parse->jointree->fromlist) != 1 ||
+		modify_have_auxiliary(root, parse->resultRelation))
+		return false;
+
+	rtr = linitial(parse->jointree->fromlist);
+	if (!IsA(rtr, RangeTblRef))
+		return false;
+
+	return planner_rt_fetch(rtr->rtindex, root)->rtekind == RTE_VALUES;
+}
+
 static Bitmapset *find_cte_planid(PlannerInfo *root, Bitmapset *bms)
 {
 	ListCell *lc;
@@ -7251,4 +7333,37 @@ static bool rti_is_base_rel(PlannerInfo *root, Index rti)
 		   rte->relkind == RELKIND_RELATION;
 }
 
+/*
+ * make limit count for datanode, it is offset+count.
+ * return NULL if can not make it
+ */
+static Node *make_cluster_limit_count(Node *limitOffset, Node *limitCount)
+{
+	int64 offset;
+	int64 count;
+
+	if (limitCount == NULL)
+		return NULL;
+	if (limitOffset == NULL)
+		return limitCount;
+
+	if (!IsA(limitOffset, Const) ||
+		!IsA(limitCount, Const) ||
+		((Const*)limitCount)->constisnull)
+		return NULL;
+	if (((Const*)limitOffset)->constisnull)
+		return limitCount;
+
+	offset = DatumGetInt64(((Const*)limitOffset)->constvalue);
+	count = DatumGetInt64(((Const*)limitCount)->constvalue);
+	if (offset < 0 || count < 0)
+		return NULL;	/* let coordinator report error */
+	if (offset > PG_INT64_MAX - count)
+		return NULL;
+
+	return (Node*) makeConst(INT8OID, -1, InvalidOid, sizeof(int64),
+							 Int64GetDatum(offset + count), false,
+							 FLOAT8PASSBYVAL);
+}
+
 #endif /* ADB */
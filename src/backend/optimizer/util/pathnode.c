@@ -4079,15 +4079,37 @@ create_cluster_reduce_path(PlannerInfo *root,
 	crp->path.pathtype = T_ClusterReduce;
 	crp->path.reduce_info_list = rinfo_list;
 	crp->path.reduce_is_valid = true;
-	crp->path.parallel_safe = sub_path->parallel_safe;
-	crp->path.parallel_aware = sub_path->parallel_aware;
-	crp->path.parallel_workers = sub_path->parallel_workers;
 
-	/* ClusterReducePath or "ClusterMergeReducePath" */
-	if (pathkeys_contained_in(pathkeys, sub_path->pathkeys))
+	/*
+	 * Reduce of partial path is run by each parallel worker, workers of the
+	 * same node share rows got from other nodes, see ClusterReduceShared.
+	 * Reduce of whole path can not be run in parallel workers, every worker
+	 * would send all rows.
+	 */
+	if (sub_path->parallel_workers > 0)
+	{
+		Assert(sub_path->parallel_safe);
+		Assert(!IsReduceInfoListCoordinator(rinfo_list));
+		crp->path.parallel_safe = true;
+		crp->path.parallel_aware = true;
+		crp->path.parallel_workers = sub_path->parallel_workers;
+	}else
+	{
+		crp->path.parallel_safe = false;
+		crp->path.parallel_aware = false;
+		crp->path.parallel_workers = 0;
+	}
+
+	/*
+	 * ClusterReducePath or "ClusterMergeReducePath", rows of a node are
+	 * mixed from several parallel workers, they can not be merged.
+	 */
+	if (pathkeys == NIL ||
+		(crp->path.parallel_aware == false &&
+		 pathkeys_contained_in(pathkeys, sub_path->pathkeys)))
 	{
 		crp->path.pathkeys = pathkeys;
-		cost_cluster_reduce(crp);
+		cost_cluster_reduce(root, crp);
 
 		return (Path *) crp;
 	}
@@ -4107,7 +4129,7 @@ create_cluster_reduce_path(PlannerInfo *root,
 												 pathkeys,
 												 -1.0);
 		crp->path.pathkeys = pathkeys;
-		cost_cluster_reduce(crp);
+		cost_cluster_reduce(root, crp);
 
 		return (Path *) crp;
 	}
@@ -4120,7 +4142,7 @@ create_cluster_reduce_path(PlannerInfo *root,
 	 *			subpath
 	 */
 	crp->path.pathkeys = NIL;
-	cost_cluster_reduce(crp);
+	cost_cluster_reduce(root, crp);
 
 	return (Path *) create_sort_path(root,
 									 rel,
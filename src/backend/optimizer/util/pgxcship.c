@@ -44,6 +44,7 @@
 #include "commands/defrem.h"
 #include "intercomm/inter-node.h"
 #include "nodes/pg_list.h"
+#include "utils/datum.h"
 #include "utils/fmgroids.h"
 #endif
 /*
@@ -2094,6 +2095,9 @@ pgxc_check_index_shippability(RelationLocInfo *relLocInfo,
 
 			case LOCATOR_TYPE_HASH:
 			case LOCATOR_TYPE_MODULO:
+#ifdef ADB
+			case LOCATOR_TYPE_RANGE:
+#endif
 				/*
 				 * Unique indexes on Hash and Modulo tables are shippable if the
 				 * index expression contains all the distribution expressions of
@@ -2185,7 +2189,9 @@ pgxc_check_index_shippability(RelationLocInfo *relLocInfo,
 				break;
 #endif
 			/* Those types are not supported yet */
+#ifndef ADB
 			case LOCATOR_TYPE_RANGE:
+#endif
 			case LOCATOR_TYPE_NONE:
 			case LOCATOR_TYPE_DISTRIBUTED:
 			case LOCATOR_TYPE_CUSTOM:
@@ -2249,6 +2255,7 @@ pgxc_check_fk_shippability(RelationLocInfo *parentLocInfo,
 			break;
 #ifdef ADB
 		case LOCATOR_TYPE_USER_DEFINED:
+		case LOCATOR_TYPE_RANGE:
 #endif
 		case LOCATOR_TYPE_HASH:
 		case LOCATOR_TYPE_MODULO:
@@ -2291,6 +2298,27 @@ pgxc_check_fk_shippability(RelationLocInfo *parentLocInfo,
 				break;
 			}
 #ifdef ADB
+			/* Bucket and range tables need the same bucket or range map */
+			if (parentLocInfo->nbuckets != childLocInfo->nbuckets ||
+				(parentLocInfo->nbuckets > 0 &&
+				 memcmp(parentLocInfo->bucketMap, childLocInfo->bucketMap,
+						sizeof(Oid) * parentLocInfo->nbuckets) != 0))
+			{
+				result = false;
+				break;
+			}
+
+			/* and range tables the same bounds */
+			if (IsRelationDistributedByRange(parentLocInfo) &&
+				(parentLocInfo->rangeCollation != childLocInfo->rangeCollation ||
+				 (parentLocInfo->rangeBounds != (Datum) 0) != (childLocInfo->rangeBounds != (Datum) 0) ||
+				 (parentLocInfo->rangeBounds != (Datum) 0 &&
+				  !datumIsEqual(parentLocInfo->rangeBounds, childLocInfo->rangeBounds, false, -1))))
+			{
+				result = false;
+				break;
+			}
+
 			if (IsRelationDistributedByUserDefined(parentLocInfo))
 			{
 				List *childRefsDiff = NIL;
@@ -2360,7 +2388,9 @@ pgxc_check_fk_shippability(RelationLocInfo *parentLocInfo,
 			/* By being here, parent-child constraint can be shipped correctly */
 			break;
 
+#ifndef ADB
 		case LOCATOR_TYPE_RANGE:
+#endif
 		case LOCATOR_TYPE_NONE:
 		case LOCATOR_TYPE_DISTRIBUTED:
 		case LOCATOR_TYPE_CUSTOM:
@@ -45,6 +45,7 @@
 #include "utils/snapmgr.h"
 #ifdef ADB
 	#include "pgxc/pgxc.h"
+	#include "pgxc/relstatcache.h"
 #endif
 
 /* GUC parameter */
@@ -931,9 +932,10 @@ estimate_rel_size(Relation rel, int32 *attr_widths,
 				/*
 				 * Remote table does not store rows locally, so storage manager
 				 * does not know how many pages are there, we rely on relation
-				 * statistics.
+				 * statistics, or datanode size cache when it has.
 				 */
-				curpages = rel->rd_rel->relpages;
+				if (!RelStatCacheGetPages(rel, &curpages))
+					curpages = rel->rd_rel->relpages;
 			}
 			else
 #endif
@@ -4,6 +4,7 @@
 #include "catalog/namespace.h"
 #include "catalog/pg_namespace.h"
 #include "catalog/pg_operator.h"
+#include "catalog/pg_statistic.h"
 #include "catalog/pg_type.h"
 #include "catalog/pgxc_node.h"
 #include "nodes/makefuncs.h"
@@ -16,16 +17,20 @@
 #include "optimizer/var.h"
 #include "optimizer/paths.h"
 #include "optimizer/planmain.h"
+#include "optimizer/plancat.h"
 #include "optimizer/tlist.h"
 #include "parser/parser.h"
 #include "parser/parse_coerce.h"
 #include "parser/parse_oper.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
+#include "utils/datum.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
+#include "utils/selfuncs.h"
 #include "utils/syscache.h"
 #include "utils/typcache.h"
 
@@ -34,6 +39,7 @@
 #define MakeEmptyReduceInfo() palloc0(sizeof(ReduceInfo))
 static Param *makeReduceParam(Oid type, int paramid, int parammod, Oid collid);
 static oidvector *makeOidVector(List *list);
+static ArrayType *makeOidArray(const Oid *oids, int count);
 static Expr* makeReduceArrayRef(List *oid_list, Expr *modulo, bool try_const);
 static Node* ReduceParam2ExprMutator(Node *node, List *params);
 static int CompareOid(const void *a, const void *b);
@@ -42,6 +48,12 @@ static bool reduce_info_in_one_node_can_join(ReduceInfo *outer_info,
 											 List **new_reduce_list,
 											 JoinType jointype,
 											 bool *is_dummy);
+static bool reduce_param_can_join(Expr *left_param, Expr *right_param, List *restrictlist);
+static bool reduce_info_list_can_skew_join(List *outer_reduce_list,
+										   List *inner_reduce_list,
+										   List *restrictlist,
+										   JoinType jointype,
+										   List **new_reduce_list);
 
 ReduceInfo *MakeHashReduceInfo(const List *storage, const List *exclude, const Expr *param)
 {
@@ -71,6 +83,56 @@ ReduceInfo *MakeHashReduceInfo(const List *storage, const List *exclude, const E
 	return rinfo;
 }
 
+/*
+ * Make a hash ReduceInfo of a bucket table, the node of a row is
+ * bucket_map[abs(hash % nbuckets)], expr is the bucket map as an oid[] Const
+ * with lower bound 0
+ */
+ReduceInfo *MakeBucketReduceInfo(const RelationLocInfo *loc_info, const List *exclude, const Expr *param)
+{
+	ReduceInfo *rinfo;
+	AssertArg(IsRelationDistributedByBucket(loc_info));
+
+	rinfo = MakeHashReduceInfo(loc_info->nodeids, exclude, param);
+	rinfo->expr = (Expr*)makeConst(OIDARRAYOID,
+								   -1,
+								   InvalidOid,
+								   -1,
+								   PointerGetDatum(makeOidArray(loc_info->bucketMap,
+																loc_info->nbuckets)),
+								   false,
+								   false);
+
+	return rinfo;
+}
+
+/*
+ * Make a custom ReduceInfo of a range table, expr is the node index of
+ * range holding $1, see makeRangePartitionExpr
+ */
+ReduceInfo *MakeRangeReduceInfo(const RelationLocInfo *loc_info, const List *exclude, const Expr *param)
+{
+	ReduceInfo *rinfo;
+	Expr *value;
+	AssertArg(IsRelationDistributedByRange(loc_info) && param);
+	AssertArg(exclude == NIL || IsA(exclude, OidList));
+
+	value = (Expr*)makeReduceParam(exprType((Node*)param),
+								   1,
+								   exprTypmod((Node*)param),
+								   exprCollation((Node*)param));
+
+	rinfo = MakeEmptyReduceInfo();
+	rinfo->storage_nodes = list_copy(loc_info->nodeids);
+	rinfo->exclude_exec = list_copy(exclude);
+	rinfo->params = list_make1(copyObject(param));
+	rinfo->relids = pull_varnos((Node*)rinfo->params);
+	rinfo->expr = makeRangePartitionExpr((RelationLocInfo*)loc_info, value);
+	rinfo->type = REDUCE_TYPE_CUSTOM;
+
+	return rinfo;
+}
+
 ReduceInfo *MakeCustomReduceInfoByRel(const List *storage, const List *exclude,
 						const List *attnums, Oid funcid, Oid reloid, Index rel_index)
 {
@@ -208,6 +270,180 @@ ReduceInfo *MakeCoordinatorReduceInfo(void)
 	return rinfo;
 }
 
+/*
+ * Make a hash ReduceInfo, but rows have value in skew_values not reduce by
+ * hash value, they round robin to all nodes, or replicated to all nodes when
+ * broadcast is true. A spread path can only join with broadcast path which have
+ * same skew_values.
+ */
+ReduceInfo *MakeSkewReduceInfo(const List *storage, const Expr *param, Const *skew_values, bool broadcast)
+{
+	ReduceInfo *rinfo;
+	AssertArg(skew_values && IsA(skew_values, Const));
+
+	rinfo = MakeHashReduceInfo(storage, NIL, param);
+	rinfo->expr = (Expr*)skew_values;
+	rinfo->type = broadcast ? REDUCE_TYPE_SKEW_BROADCAST : REDUCE_TYPE_SKEW_SPREAD;
+
+	return rinfo;
+}
+
+/*
+ * Get most common values of expr which frequency is larger than
+ * 1/(2*nnodes), return an array Const or NULL if not found.
+ */
+Const *GetSkewReduceValues(PlannerInfo *root, Expr *expr, int nnodes)
+{
+	VariableStatData vardata;
+	TypeCacheEntry *typeCache;
+	Datum	   *values;
+	int			nvalues;
+	float4	   *numbers;
+	int			nnumbers;
+	int			n;
+	Oid			typoid;
+	Oid			arraytype;
+	Const	   *result = NULL;
+
+	if (nnodes < 2)
+		return NULL;
+
+	typoid = exprType((Node*)expr);
+	arraytype = get_array_type(typoid);
+	typeCache = lookup_type_cache(typoid, TYPECACHE_EQ_OPR|TYPECACHE_HASH_PROC);
+	if (!OidIsValid(arraytype) ||
+		!OidIsValid(typeCache->eq_opr) ||
+		!OidIsValid(typeCache->hash_proc))
+		return NULL;
+
+	examine_variable(root, (Node*)expr, 0, &vardata);
+	if (HeapTupleIsValid(vardata.statsTuple) &&
+		vardata.atttype == typoid &&
+		get_attstatsslot(vardata.statsTuple,
+						 vardata.atttype, vardata.atttypmod,
+						 STATISTIC_KIND_MCV, InvalidOid,
+						 NULL,
+						 &values, &nvalues,
+						 &numbers, &nnumbers))
+	{
+		/* most common values are sorted by frequency */
+		for (n = 0; n < nvalues && n < nnumbers; ++n)
+		{
+			if (!IsSkewReduceFrequency(numbers[n], nnodes))
+				break;
+		}
+
+		if (n > 0)
+		{
+			ArrayType *array = construct_array(values,
+											   n,
+											   typoid,
+											   typeCache->typlen,
+											   typeCache->typbyval,
+											   typeCache->typalign);
+			result = makeConst(arraytype,
+							   -1,
+							   exprCollation((Node*)expr),
+							   -1,
+							   PointerGetDatum(array),
+							   false,
+							   false);
+		}
+		free_attstatsslot(vardata.atttype, values, nvalues, numbers, nnumbers);
+	}
+	ReleaseVariableStats(vardata);
+
+	return result;
+}
+
+/*
+ * Get frequency of the most common value of expr,
+ * return 0.0 if don't known
+ */
+double GetReduceMaxFrequency(PlannerInfo *root, Expr *expr)
+{
+	VariableStatData vardata;
+	Datum	   *values;
+	int			nvalues;
+	float4	   *numbers;
+	int			nnumbers;
+	double		result = 0.0;
+
+	examine_variable(root, (Node*)expr, 0, &vardata);
+	if (HeapTupleIsValid(vardata.statsTuple) &&
+		get_attstatsslot(vardata.statsTuple,
+						 vardata.atttype, vardata.atttypmod,
+						 STATISTIC_KIND_MCV, InvalidOid,
+						 NULL,
+						 &values, &nvalues,
+						 &numbers, &nnumbers))
+	{
+		if (nnumbers > 0)
+			result = numbers[0];
+		free_attstatsslot(vardata.atttype, values, nvalues, numbers, nnumbers);
+	}
+	ReleaseVariableStats(vardata);
+
+	return result;
+}
+
+/*
+ * Get frequency of skew values in param of skew ReduceInfo
+ */
+double GetReduceSkewFrequency(PlannerInfo *root, ReduceInfo *reduce)
+{
+	VariableStatData vardata;
+	Datum	   *values;
+	int			nvalues;
+	float4	   *numbers;
+	int			nnumbers;
+	Datum	   *skew_values;
+	int			nskew;
+	int			i,j;
+	int16		typlen;
+	bool		typbyval;
+	char		typalign;
+	double		result = 0.0;
+	Expr	   *param;
+	Const	   *skew;
+
+	AssertArg(IsReduceInfoSkew(reduce) && list_length(reduce->params) == 1);
+	param = linitial(reduce->params);
+	skew = (Const*)reduce->expr;
+
+	examine_variable(root, (Node*)param, 0, &vardata);
+	if (HeapTupleIsValid(vardata.statsTuple) &&
+		vardata.atttype == exprType((Node*)param) &&
+		get_attstatsslot(vardata.statsTuple,
+						 vardata.atttype, vardata.atttypmod,
+						 STATISTIC_KIND_MCV, InvalidOid,
+						 NULL,
+						 &values, &nvalues,
+						 &numbers, &nnumbers))
+	{
+		get_typlenbyvalalign(vardata.atttype, &typlen, &typbyval, &typalign);
+		deconstruct_array(DatumGetArrayTypeP(skew->constvalue),
+						  vardata.atttype, typlen, typbyval, typalign,
+						  &skew_values, NULL, &nskew);
+		for (i = 0; i < nvalues && i < nnumbers; ++i)
+		{
+			for (j = 0; j < nskew; ++j)
+			{
+				if (datumIsEqual(values[i], skew_values[j], typbyval, typlen))
+				{
+					result += numbers[i];
+					break;
+				}
+			}
+		}
+		pfree(skew_values);
+		free_attstatsslot(vardata.atttype, values, nvalues, numbers, nnumbers);
+	}
+	ReleaseVariableStats(vardata);
+
+	return result;
+}
+
 ReduceInfo *MakeReduceInfoFromLocInfo(const RelationLocInfo *loc_info, const List *exclude, Oid reloid, Index relid)
 {
 	ReduceInfo *rinfo;
@@ -226,7 +462,10 @@ ReduceInfo *MakeReduceInfoFromLocInfo(const RelationLocInfo *loc_info, const Lis
 		if(loc_info->locatorType == LOCATOR_TYPE_HASH)
 		{
 			Var *var = makeVarByRel(loc_info->partAttrNum, reloid, relid);
-			rinfo = MakeHashReduceInfo(rnodes, exclude, (Expr*)var);
+			if (IsRelationDistributedByBucket(loc_info))
+				rinfo = MakeBucketReduceInfo(loc_info, exclude, (Expr*)var);
+			else
+				rinfo = MakeHashReduceInfo(rnodes, exclude, (Expr*)var);
 		}else if(loc_info->locatorType == LOCATOR_TYPE_USER_DEFINED)
 		{
 			rinfo = MakeCustomReduceInfoByRel(rnodes,
@@ -239,6 +478,10 @@ ReduceInfo *MakeReduceInfoFromLocInfo(const RelationLocInfo *loc_info, const Lis
 		{
 			Var *var = makeVarByRel(loc_info->partAttrNum, reloid, relid);
 			rinfo = MakeModuloReduceInfo(rnodes, exclude, (Expr*)var);
+		}else if(loc_info->locatorType == LOCATOR_TYPE_RANGE)
+		{
+			Var *var = makeVarByRel(loc_info->partAttrNum, reloid, relid);
+			rinfo = MakeRangeReduceInfo(loc_info, exclude, (Expr*)var);
 		}else
 		{
 			ereport(ERROR,
@@ -1026,6 +1269,20 @@ bool IsReduceInfoListCoordinator(List *list)
 	return false;
 }
 
+bool IsReduceInfoListSkew(List *list)
+{
+	ListCell *lc;
+	foreach(lc, list)
+	{
+		if(IsReduceInfoSkew((ReduceInfo*)lfirst(lc)))
+		{
+			Assert(list_length(list) == 1);
+			return true;
+		}
+	}
+	return false;
+}
+
 bool IsReduceInfoListInOneNode(List *list)
 {
 	ReduceInfo *info;
@@ -1300,6 +1557,30 @@ int ReduceInfoIncludeExpr(ReduceInfo *reduce, Expr *expr)
 	return -1;
 }
 
+/*
+ * like ReduceInfoIncludeExpr, but also match a param known equal
+ * to expr by equivalence class, e.g. "b.id" for "a.id" when query
+ * has "a.id = b.id". root can be NULL
+ */
+int ReduceInfoIncludeExprEC(PlannerInfo *root, ReduceInfo *reduce, Expr *expr)
+{
+	ListCell *lc;
+	int i;
+
+	i = ReduceInfoIncludeExpr(reduce, expr);
+	if (i >= 0 || root == NULL || root->eq_classes == NIL)
+		return i;
+
+	i = 0;
+	foreach(lc, reduce->params)
+	{
+		if (exprs_known_equal(root, lfirst(lc), (Node*)expr))
+			return i;
+		++i;
+	}
+	return -1;
+}
+
 bool ReduceInfoListIncludeExpr(List *reduceList, Expr *expr)
 {
 	ListCell *lc;
@@ -1396,7 +1677,7 @@ extern List* MakeVarList(const List *attnos, Index relid, const PathTarget *targ
 	return result;
 }
 
-bool IsGroupingReduceExpr(PathTarget *target, ReduceInfo *info)
+bool IsGroupingReduceExpr(PlannerInfo *root, PathTarget *target, ReduceInfo *info)
 {
 	Bitmapset *grouping;
 	ListCell *lc;
@@ -1421,7 +1702,7 @@ bool IsGroupingReduceExpr(PathTarget *target, ReduceInfo *info)
 			Expr *expr = lfirst(lc);
 			while(IsA(expr, RelabelType))
 				expr = ((RelabelType *) expr)->arg;
-			nth = ReduceInfoIncludeExpr(info, expr);
+			nth = ReduceInfoIncludeExprEC(root, info, expr);
 			if(nth >= 0)
 				grouping = bms_add_member(grouping, nth);
 		}
@@ -1504,13 +1785,6 @@ bool IsReduceInfoListCanUniqueJoin(List *reduce_list, List *restrictlist)
 
 bool IsReduceInfoCanInnerJoin(ReduceInfo *outer_rinfo, ReduceInfo *inner_rinfo, List *restrictlist)
 {
-	Expr *left_expr;
-	Expr *right_expr;
-	Expr *left_param;
-	Expr *right_param;
-	RestrictInfo *ri;
-	ListCell *lc;
-
 	AssertArg(outer_rinfo && inner_rinfo);
 
 	/* for now support only one distribute cloumn */
@@ -1528,8 +1802,19 @@ bool IsReduceInfoCanInnerJoin(ReduceInfo *outer_rinfo, ReduceInfo *inner_rinfo,
 
 	Assert(list_length(outer_rinfo->params) == 1);
 	Assert(list_length(outer_rinfo->params) == list_length(inner_rinfo->params));
-	left_param = linitial(outer_rinfo->params);
-	right_param = linitial(inner_rinfo->params);
+
+	return reduce_param_can_join(linitial(outer_rinfo->params),
+								 linitial(inner_rinfo->params),
+								 restrictlist);
+}
+
+/* is there a "left_param = right_param" expression in restrictlist */
+static bool reduce_param_can_join(Expr *left_param, Expr *right_param, List *restrictlist)
+{
+	Expr *left_expr;
+	Expr *right_expr;
+	RestrictInfo *ri;
+	ListCell *lc;
 
 	foreach(lc, restrictlist)
 	{
@@ -1695,12 +1980,69 @@ List *FindJoinEqualExprs(ReduceInfo *rinfo, List *restrictlist, RelOptInfo *inne
  * when can join return new ReduceInfo list,
  * else return NIL
  */
+/*
+ * spread side only can join broadcast side, and the broadcast side must not
+ * be preserved by outer join. Result rows are round robin in all nodes
+ */
+static bool reduce_info_list_can_skew_join(List *outer_reduce_list,
+										   List *inner_reduce_list,
+										   List *restrictlist,
+										   JoinType jointype,
+										   List **new_reduce_list)
+{
+	ReduceInfo *outer_rinfo;
+	ReduceInfo *inner_rinfo;
+
+	if (list_length(outer_reduce_list) != 1 ||
+		list_length(inner_reduce_list) != 1)
+		return false;
+	outer_rinfo = linitial(outer_reduce_list);
+	inner_rinfo = linitial(inner_reduce_list);
+
+	if (outer_rinfo->type == REDUCE_TYPE_SKEW_SPREAD &&
+		inner_rinfo->type == REDUCE_TYPE_SKEW_BROADCAST)
+	{
+		if (jointype != JOIN_INNER &&
+			jointype != JOIN_LEFT &&
+			jointype != JOIN_SEMI &&
+			jointype != JOIN_ANTI)
+			return false;
+	}else if (outer_rinfo->type == REDUCE_TYPE_SKEW_BROADCAST &&
+			  inner_rinfo->type == REDUCE_TYPE_SKEW_SPREAD)
+	{
+		if (jointype != JOIN_INNER &&
+			jointype != JOIN_RIGHT)
+			return false;
+	}else
+	{
+		return false;
+	}
+
+	if (!CompReduceInfo(outer_rinfo, inner_rinfo, REDUCE_MARK_STORAGE|REDUCE_MARK_EXPR) ||
+		!reduce_param_can_join(linitial(outer_rinfo->params),
+							   linitial(inner_rinfo->params),
+							   restrictlist))
+		return false;
+
+	if (new_reduce_list)
+		*new_reduce_list = list_make1(MakeRoundReduceInfo(outer_rinfo->storage_nodes));
+	return true;
+}
+
 bool reduce_info_list_can_join(List *outer_reduce_list,
 							   List *inner_reduce_list,
 							   List *restrictlist,
 							   JoinType jointype,
 							   List **new_reduce_list)
 {
+	if (IsReduceInfoListSkew(outer_reduce_list) ||
+		IsReduceInfoListSkew(inner_reduce_list))
+		return reduce_info_list_can_skew_join(outer_reduce_list,
+											  inner_reduce_list,
+											  restrictlist,
+											  jointype,
+											  new_reduce_list);
+
 	if(IsReduceInfoListCoordinator(outer_reduce_list))
 	{
 		/* coordinator always can join coordinator */
@@ -1950,7 +2292,7 @@ static bool reduce_info_in_one_node_can_join(ReduceInfo *outer_info,
 	return false;
 }
 
-bool CanOnceGroupingClusterPath(PathTarget *target, Path *path)
+bool CanOnceGroupingClusterPath(PlannerInfo *root, PathTarget *target, Path *path)
 {
 	List *list;
 	ListCell *lc;
@@ -1964,7 +2306,7 @@ bool CanOnceGroupingClusterPath(PathTarget *target, Path *path)
 		if (IsReduceInfoCoordinator(info)  ||
 			IsReduceInfoReplicated(info) ||
 			IsReduceInfoInOneNode(info)  ||
-			IsGroupingReduceExpr(target, info))
+			IsGroupingReduceExpr(root, target, info))
 		{
 			result = true;
 			break;
@@ -1974,18 +2316,18 @@ bool CanOnceGroupingClusterPath(PathTarget *target, Path *path)
 	return result;
 }
 
-bool CanOnceDistinctReduceInfoList(List *distinct, List *reduce_list)
+bool CanOnceDistinctReduceInfoList(PlannerInfo *root, List *distinct, List *reduce_list)
 {
 	ListCell *lc_reduce;
 	foreach(lc_reduce, reduce_list)
 	{
-		if(CanOnceDistinctReduceInfo(distinct, lfirst(lc_reduce)))
+		if(CanOnceDistinctReduceInfo(root, distinct, lfirst(lc_reduce)))
 			return true;
 	}
 	return false;
 }
 
-bool CanOnceDistinctReduceInfo(List *distinct, ReduceInfo *reduce_info)
+bool CanOnceDistinctReduceInfo(PlannerInfo *root, List *distinct, ReduceInfo *reduce_info)
 {
 	ListCell *lc_distinct;
 	ListCell *lc_param;
@@ -2001,7 +2343,9 @@ bool CanOnceDistinctReduceInfo(List *distinct, ReduceInfo *reduce_info)
 			Expr *expr = lfirst(lc_distinct);
 			while(IsA(expr, RelabelType))
 				expr = ((RelabelType *) expr)->arg;
-			if(equal(lfirst(lc_param), expr))
+			if(equal(lfirst(lc_param), expr) ||
+			   (root != NULL &&
+				exprs_known_equal(root, lfirst(lc_param), (Node*)expr)))
 				break;
 		}
 		if(lc_distinct == NULL)
@@ -2011,10 +2355,11 @@ bool CanOnceDistinctReduceInfo(List *distinct, ReduceInfo *reduce_info)
 	return true;
 }
 
-bool CanOnceWindowAggClusterPath(WindowClause *wclause, List *tlist, Path *path)
+bool CanOnceWindowAggClusterPath(PlannerInfo *root, WindowClause *wclause, List *tlist, Path *path)
 {
 	List *reduce_list;
 	ListCell *lc;
+	ListCell *lc_reduce;
 	Expr *expr;
 
 	reduce_list = get_reduce_info_list(path);
@@ -2031,19 +2376,22 @@ bool CanOnceWindowAggClusterPath(WindowClause *wclause, List *tlist, Path *path)
 		expr = (Expr*)get_sortgroupclause_expr(lfirst(lc), tlist);
 		while(IsA(expr, RelabelType))
 			expr = ((RelabelType *) expr)->arg;
-		if(ReduceInfoListIncludeExpr(reduce_list, expr))
-			return true;
+		foreach(lc_reduce, reduce_list)
+		{
+			if(ReduceInfoIncludeExprEC(root, lfirst(lc_reduce), expr) >= 0)
+				return true;
+		}
 	}
 
 	return false;
 }
 
-bool HaveOnceWindowAggClusterPath(List *wclauses, List *tlist, Path *path)
+bool HaveOnceWindowAggClusterPath(PlannerInfo *root, List *wclauses, List *tlist, Path *path)
 {
 	ListCell *lc;
 	foreach(lc, wclauses)
 	{
-		if(CanOnceWindowAggClusterPath(lfirst(lc), tlist, path))
+		if(CanOnceWindowAggClusterPath(root, lfirst(lc), tlist, path))
 			return true;
 	}
 
@@ -2070,6 +2418,35 @@ Expr *CreateExprUsingReduceInfo(ReduceInfo *reduce)
 	case REDUCE_TYPE_HASH:
 		Assert(list_length(reduce->params) == 1);
 		result = makeHashExpr(linitial(reduce->params));
+		if (reduce->expr != NULL)
+		{
+			/* bucket table, bucket_map[abs(hash % nbuckets)] */
+			ArrayType *map;
+			Oid *map_oids;
+			List *map_list = NIL;
+			int nbuckets;
+			int i;
+
+			Assert(IsA(reduce->expr, Const) &&
+				   ((Const*)reduce->expr)->consttype == OIDARRAYOID);
+			map = DatumGetArrayTypeP(((Const*)reduce->expr)->constvalue);
+			Assert(ARR_NDIM(map) == 1 && !ARR_HASNULL(map) &&
+				   ARR_ELEMTYPE(map) == OIDOID);
+			nbuckets = ARR_DIMS(map)[0];
+			map_oids = (Oid*)ARR_DATA_PTR(map);
+			for (i = 0; i < nbuckets; i++)
+				map_list = lappend_oid(map_list, map_oids[i]);
+
+			result = makeModuloExpr(result, nbuckets);
+			result = (Expr*) makeFuncExpr(F_INT4ABS,
+										  INT4OID,
+										  list_make1(result),
+										  InvalidOid, InvalidOid,
+										  COERCE_EXPLICIT_CALL);
+			result = makeReduceArrayRef(map_list, result, bms_is_empty(reduce->relids));
+			list_free(map_list);
+			break;
+		}
 		result = makeModuloExpr(result, list_length(reduce->storage_nodes));
 		Assert(exprType((Node*)result) == INT4OID);
 		result = (Expr*) makeFuncExpr(F_INT4ABS,
@@ -2114,6 +2491,52 @@ Expr *CreateExprUsingReduceInfo(ReduceInfo *reduce)
 									  COERCE_EXPLICIT_CALL);
 		result = makeReduceArrayRef(reduce->storage_nodes, result, bms_is_empty(reduce->relids));
 		break;
+	case REDUCE_TYPE_SKEW_SPREAD:
+	case REDUCE_TYPE_SKEW_BROADCAST:
+		{
+			/*
+			 * CASE WHEN param = ANY(skew_values)
+			 *   THEN round robin or all nodes
+			 *   ELSE hash reduce
+			 * END
+			 */
+			ReduceInfo hash_reduce;
+			CaseExpr *caseexpr = makeNode(CaseExpr);
+			CaseWhen *casewhen = makeNode(CaseWhen);
+			ScalarArrayOpExpr *saop = makeNode(ScalarArrayOpExpr);
+			OidVectorLoopExpr *ovl = makeNode(OidVectorLoopExpr);
+			Expr *param;
+			TypeCacheEntry *typeCache;
+
+			Assert(list_length(reduce->params) == 1 && IsA(reduce->expr, Const));
+			param = linitial(reduce->params);
+			typeCache = lookup_type_cache(exprType((Node*)param), TYPECACHE_EQ_OPR);
+			Assert(OidIsValid(typeCache->eq_opr));
+			saop->opno = typeCache->eq_opr;
+			saop->opfuncid = get_opcode(typeCache->eq_opr);
+			saop->useOr = true;
+			saop->inputcollid = exprCollation((Node*)param);
+			saop->args = list_make2(copyObject(param), copyObject(reduce->expr));
+			saop->location = -1;
+
+			ovl->signalRowMode = (reduce->type == REDUCE_TYPE_SKEW_SPREAD ? true:false);
+			ovl->vector = PointerGetDatum(makeOidVector(reduce->storage_nodes));
+
+			casewhen->expr = (Expr*)saop;
+			casewhen->result = (Expr*)ovl;
+			casewhen->location = -1;
+
+			hash_reduce = *reduce;
+			hash_reduce.type = REDUCE_TYPE_HASH;
+			hash_reduce.expr = NULL;	/* skew values, not a bucket map */
+			caseexpr->casetype = OIDOID;
+			caseexpr->casecollid = InvalidOid;
+			caseexpr->args = list_make1(casewhen);
+			caseexpr->defresult = CreateExprUsingReduceInfo(&hash_reduce);
+			caseexpr->location = -1;
+			result = (Expr*)caseexpr;
+		}
+		break;
 	case REDUCE_TYPE_REPLICATED:
 	case REDUCE_TYPE_ROUND:
 		{
@@ -2264,6 +2687,28 @@ static oidvector *makeOidVector(List *list)
 	return oids;
 }
 
+/*
+ * one dimension oid[] of oids, lower bound is 0
+ */
+static ArrayType *makeOidArray(const Oid *oids, int count)
+{
+	ArrayType *arr;
+	Datum *values;
+	int dims[1];
+	int lbs[1];
+	int i;
+
+	values = palloc(sizeof(Datum) * count);
+	for (i=0;i<count;++i)
+		values[i] = ObjectIdGetDatum(oids[i]);
+	dims[0] = count;
+	lbs[0] = 0;
+	arr = construct_md_array(values, NULL, 1, dims, lbs, OIDOID, sizeof(Oid), true, 'i');
+	pfree(values);
+
+	return arr;
+}
+
 /*
  * oid_list[modulo] expr
  */
@@ -2271,6 +2716,9 @@ static Expr* makeReduceArrayRef(List *oid_list, Expr *modulo, bool try_const)
 {
 	ArrayRef *aref;
 	CoalesceExpr *coalesce;
+	ListCell *lc;
+	Oid *oids;
+	int i;
 	if(try_const)
 	{
 		Node *node = eval_const_expressions(NULL, (Node*)modulo);
@@ -2324,13 +2772,18 @@ static Expr* makeReduceArrayRef(List *oid_list, Expr *modulo, bool try_const)
 	aref->refcollid = InvalidOid;
 	aref->refupperindexpr = list_make1(coalesce);
 	aref->reflowerindexpr = NIL;
+	oids = palloc(sizeof(Oid) * list_length(oid_list));
+	i = 0;
+	foreach(lc, oid_list)
+		oids[i++] = lfirst_oid(lc);
 	aref->refexpr = (Expr*)makeConst(OIDARRAYOID,
 									 -1,
 									 InvalidOid,
 									 -1,
-									 PointerGetDatum(makeOidVector(oid_list)),
+									 PointerGetDatum(makeOidArray(oids, i)),
 									 false,
 									 false);
+	pfree(oids);
 	aref->refassgnexpr = NULL;
 
 	return (Expr*)aref;
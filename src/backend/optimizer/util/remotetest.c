@@ -14,6 +14,7 @@
  */
 #include "postgres.h"
 
+#include "access/nbtree.h"
 #include "access/sysattr.h"
 #include "access/tuptypeconvert.h"
 #include "catalog/heap.h"
@@ -50,6 +51,7 @@
 #include "utils/rel.h"
 #include "utils/ruleutils.h"
 #include "utils/snapmgr.h"
+#include "utils/typcache.h"
 
 #define AUX_SCAN_INFO_SIZE_STEP		8
 
@@ -128,6 +130,9 @@ static Expr* makeInt4ArrayIn(Expr *l, Datum *values, int count);
 static Expr* makeInt4Const(int32 val);
 static Expr* makeNotNullTest(Expr *expr, bool isrow);
 static Expr* makePartitionExpr(RelationLocInfo *loc_info, Node *node);
+static Expr* makeBucketPartitionExpr(RelationLocInfo *loc_info, Expr *hash);
+static Expr* makeNodeIndexArrayRef(RelationLocInfo *loc_info, Expr *index);
+static bool makeRangeNodeConstraint(RelationLocInfo *loc_info, Expr *var, Oid node_oid, Expr **constraint);
 static List* make_new_qual_list(ModifyContext *context, Node *quals, bool need_eval_const);
 static Node* mutator_equal_expr(Node *node, ModifyContext *context);
 static void init_context_expr_if_need(ModifyContext *context);
@@ -336,13 +341,31 @@ List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, Relati
 		MemoryContextResetAndDeleteChildren(temp_mctx);
 		temp_constraints = list_copy(safe_constraints);
 
+		/* range table, node can only have rows of its own ranges */
+		if (IsRelationDistributedByRange(loc_info))
+		{
+			if (makeRangeNodeConstraint(loc_info,
+										(Expr*)makeVarByRel(loc_info->partAttrNum, loc_info->relid, varno),
+										node_oid,
+										&expr) == false)
+			{
+				/* node have no range */
+				++i;
+				continue;
+			}
+			if (expr)
+				temp_constraints = lappend(temp_constraints, expr);
+		}
+
 		/* make TABLE.XC_NODE_ID=id */
 		expr = makeInt4EQ((Expr*)makeVarByRel(XC_NodeIdAttributeNumber, loc_info->relid, varno),
 						  makeInt4Const(get_pgxc_node_id(node_oid)));
 		temp_constraints = lappend(temp_constraints, expr);
 
 		/* when not first remote node, partition key is not null */
-		if (i != 0 && null_test_list)
+		if (null_test_list &&
+			(loc_info->bucketMap != NULL ?
+			 node_oid != loc_info->bucketMap[0] : i != 0))
 		{
 			ListCell *lc2;
 			foreach(lc2, null_test_list)
@@ -445,6 +468,8 @@ static Expr* makePartitionExpr(RelationLocInfo *loc_info, Node *node)
 	case LOCATOR_TYPE_MODULO:
 		expr = (Expr*)node;
 		break;
+	case LOCATOR_TYPE_RANGE:
+		return makeRangePartitionExpr(loc_info, (Expr*)node);
 	case LOCATOR_TYPE_USER_DEFINED:
 		if(list_length(loc_info->funcAttrNums) != 1)
 		{
@@ -486,6 +511,9 @@ static Expr* makePartitionExpr(RelationLocInfo *loc_info, Node *node)
 		return NULL;
 	}
 
+	if (IsRelationDistributedByBucket(loc_info))
+		return makeBucketPartitionExpr(loc_info, expr);
+
 	expr = makeModuloExpr(expr, list_length(loc_info->nodeids));
 	expr = (Expr*)coerce_to_target_type(NULL,
 										(Node*)expr,
@@ -503,13 +531,224 @@ static Expr* makePartitionExpr(RelationLocInfo *loc_info, Node *node)
 								COERCE_EXPLICIT_CALL);
 
 	coalesce = makeNode(CoalesceExpr);
-	coalesce->coalescetype = INT4OID,
+	coalesce->coalescetype = INT4OID;
 	coalesce->coalescecollid = InvalidOid;
 	coalesce->args = list_make2(expr, makeInt4Const(0)); /* when null, first node */
 
 	return (Expr*)coalesce;
 }
 
+/*
+ * node index of a bucket table row, like
+ *   bucket_node_index[coalesce(abs(hash(column) % bucket_count), 0)]
+ * so it can be compared with node position in loc_info->nodeids
+ */
+static Expr* makeBucketPartitionExpr(RelationLocInfo *loc_info, Expr *hash)
+{
+	CoalesceExpr *coalesce;
+	Expr *expr;
+
+	expr = makeModuloExpr(hash, loc_info->nbuckets);
+	expr = (Expr*)makeFuncExpr(F_INT4ABS,
+								INT4OID,
+								list_make1(expr),
+								InvalidOid,
+								InvalidOid,
+								COERCE_EXPLICIT_CALL);
+	coalesce = makeNode(CoalesceExpr);
+	coalesce->coalescetype = INT4OID;
+	coalesce->coalescecollid = InvalidOid;
+	coalesce->args = list_make2(expr, makeInt4Const(0)); /* when null, bucket 0 */
+
+	return makeNodeIndexArrayRef(loc_info, (Expr*)coalesce);
+}
+
+/*
+ * node index of a range table row, like
+ *   range_node_index[coalesce(width_bucket(column, bounds), 0)]
+ */
+Expr* makeRangePartitionExpr(RelationLocInfo *loc_info, Expr *value)
+{
+	CoalesceExpr *coalesce;
+	Expr *expr;
+
+	if (loc_info->nbuckets <= 1)
+		return (Expr*)makeInt4Const(0);
+
+	expr = (Expr*)makeFuncExpr(F_WIDTH_BUCKET_ARRAY,
+							   INT4OID,
+							   list_make2(value,
+										  makeConst(get_array_type(ARR_ELEMTYPE(DatumGetArrayTypeP(loc_info->rangeBounds))),
+													-1,
+													InvalidOid,
+													-1,
+													loc_info->rangeBounds,
+													false,
+													false)),
+							   InvalidOid,
+							   loc_info->rangeCollation,
+							   COERCE_EXPLICIT_CALL);
+	coalesce = makeNode(CoalesceExpr);
+	coalesce->coalescetype = INT4OID;
+	coalesce->coalescecollid = InvalidOid;
+	coalesce->args = list_make2(expr, makeInt4Const(0)); /* when null, range 0 */
+
+	return makeNodeIndexArrayRef(loc_info, (Expr*)coalesce);
+}
+
+/*
+ * make "node_index_array[index]", node_index_array is position in
+ * loc_info->nodeids of each bucket or range
+ */
+static Expr* makeNodeIndexArrayRef(RelationLocInfo *loc_info, Expr *index)
+{
+	ArrayRef *aref;
+	ArrayType *arr;
+	Datum *values;
+	int dims[1];
+	int lbs[1];
+	int i;
+
+	values = palloc(sizeof(Datum) * loc_info->nbuckets);
+	for (i=0;i<loc_info->nbuckets;++i)
+	{
+		ListCell *lc;
+		int index = 0;
+		foreach(lc, loc_info->nodeids)
+		{
+			if (lfirst_oid(lc) == loc_info->bucketMap[i])
+				break;
+			++index;
+		}
+		Assert(lc != NULL);
+		values[i] = Int32GetDatum(index);
+	}
+	dims[0] = loc_info->nbuckets;
+	lbs[0] = 0;
+	arr = construct_md_array(values, NULL, 1, dims, lbs, INT4OID, sizeof(int32), true, 'i');
+	pfree(values);
+
+	aref = makeNode(ArrayRef);
+	aref->refarraytype = INT4ARRAYOID;
+	aref->refelemtype = INT4OID;
+	aref->reftypmod = -1;
+	aref->refcollid = InvalidOid;
+	aref->refupperindexpr = list_make1(index);
+	aref->reflowerindexpr = NIL;
+	aref->refexpr = (Expr*)makeConst(INT4ARRAYOID,
+									 -1,
+									 InvalidOid,
+									 -1,
+									 PointerGetDatum(arr),
+									 false,
+									 false);
+	aref->refassgnexpr = NULL;
+
+	return (Expr*)aref;
+}
+
+/*
+ * make constraint of rows in node of a range table, like
+ *   (var IS NULL OR var < b1) OR (var >= b3 AND var < b4)
+ * return false when node have no range, and *constraint is NULL
+ * when node have all ranges
+ */
+static bool makeRangeNodeConstraint(RelationLocInfo *loc_info, Expr *var, Oid node_oid, Expr **constraint)
+{
+	TypeCacheEntry *typentry;
+	ArrayType *bounds;
+	Datum *values;
+	List *args;
+	Expr *expr;
+	Oid elemtype;
+	Oid ge_opno;
+	Oid lt_opno;
+	int16 typlen;
+	bool typbyval;
+	char typalign;
+	int nvalues;
+	int lo;
+	int hi;
+	bool have_all;
+
+	*constraint = NULL;
+	if (loc_info->nbuckets <= 1)
+		return loc_info->bucketMap[0] == node_oid;
+
+	bounds = DatumGetArrayTypeP(loc_info->rangeBounds);
+	elemtype = ARR_ELEMTYPE(bounds);
+	typentry = lookup_type_cache(elemtype, TYPECACHE_BTREE_OPFAMILY);
+	if (!OidIsValid(typentry->btree_opf))
+		return true;
+	ge_opno = get_opfamily_member(typentry->btree_opf,
+								  typentry->btree_opintype,
+								  typentry->btree_opintype,
+								  BTGreaterEqualStrategyNumber);
+	lt_opno = get_opfamily_member(typentry->btree_opf,
+								  typentry->btree_opintype,
+								  typentry->btree_opintype,
+								  BTLessStrategyNumber);
+	if (!OidIsValid(ge_opno) || !OidIsValid(lt_opno))
+		return true;
+	if (exprType((Node*)var) != typentry->btree_opintype)
+		var = (Expr*)makeRelabelType(var,
+									 typentry->btree_opintype,
+									 -1,
+									 loc_info->rangeCollation,
+									 COERCE_IMPLICIT_CAST);
+
+	get_typlenbyvalalign(elemtype, &typlen, &typbyval, &typalign);
+	deconstruct_array(bounds, elemtype, typlen, typbyval, typalign,
+					  &values, NULL, &nvalues);
+	Assert(nvalues == loc_info->nbuckets - 1);
+
+	args = NIL;
+	have_all = true;
+	for (lo=0;lo<loc_info->nbuckets;lo=hi)
+	{
+		List *and_args = NIL;
+
+		/* adjacent ranges of same node as one */
+		for (hi=lo;hi<loc_info->nbuckets && loc_info->bucketMap[hi] == node_oid;++hi)
+			;
+		if (hi == lo)
+		{
+			have_all = false;
+			++hi;
+			continue;
+		}
+
+		/* rows of ranges [lo, hi) */
+		if (lo > 0)
+			and_args = lappend(and_args,
+							   make_opclause(ge_opno, BOOLOID, false, var,
+											 (Expr*)makeConst(typentry->btree_opintype, -1, loc_info->rangeCollation,
+															  typlen, values[lo-1], false, typbyval),
+											 InvalidOid, loc_info->rangeCollation));
+		if (hi < loc_info->nbuckets)
+			and_args = lappend(and_args,
+							   make_opclause(lt_opno, BOOLOID, false, var,
+											 (Expr*)makeConst(typentry->btree_opintype, -1, loc_info->rangeCollation,
+															  typlen, values[hi-1], false, typbyval),
+											 InvalidOid, loc_info->rangeCollation));
+		Assert(and_args != NIL);
+		expr = make_ands_explicit(and_args);
+		if (lo == 0)
+		{
+			NullTest *null_test = (NullTest*)makeNotNullTest(var, false);
+			null_test->nulltesttype = IS_NULL;
+			expr = make_orclause(list_make2(null_test, expr));
+		}
+		args = lappend(args, expr);
+	}
+
+	if (args == NIL)
+		return false;
+	if (!have_all)
+		*constraint = list_length(args) == 1 ? linitial(args) : make_orclause(args);
+	return true;
+}
+
 static List* make_new_qual_list(ModifyContext *context, Node *quals, bool need_eval_const)
 {
 	List *result;
@@ -59,6 +59,7 @@
 #include "intercomm/inter-comm.h"
 #include "optimizer/pgxcship.h"
 #include "pgxc/locator.h"
+#include "pgxc/nodemgr.h"
 #include "pgxc/pgxc.h"
 #include "optimizer/pgxcplan.h"
 #include "pgxc/execRemote.h"
@@ -68,6 +69,7 @@
 #include "parser/parser.h"
 #include "rewrite/rewriteManip.h"
 #include "utils/acl.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
@@ -188,7 +190,8 @@ addDefaultDistributeBy(CreateStmt *stmt)
 			distby->disttype = DISTTYPE_REPLICATION;
 			break;
 		case LOCATOR_TYPE_HASH:
-			distby->disttype = DISTTYPE_HASH;
+			distby->disttype = IsRelationDistributedByBucket(relloc) ?
+				DISTTYPE_BUCKET : DISTTYPE_HASH;
 			distby->colname = get_attname(relloc->relid, relloc->partAttrNum);
 			break;
 		case LOCATOR_TYPE_RROBIN:
@@ -239,6 +242,54 @@ addDefaultDistributeBy(CreateStmt *stmt)
 			}
 			break;
 		case LOCATOR_TYPE_RANGE:
+			{
+				Datum	   *bounds = NULL;
+				int			nbounds = 0;
+				int			i;
+
+				/* same bounds and nodes of ranges */
+				if (relloc->rangeBounds != (Datum) 0)
+				{
+					ArrayType  *arr = DatumGetArrayTypeP(relloc->rangeBounds);
+					int16		typlen;
+					bool		typbyval;
+					char		typalign;
+
+					get_typlenbyvalalign(ARR_ELEMTYPE(arr), &typlen, &typbyval, &typalign);
+					deconstruct_array(arr, ARR_ELEMTYPE(arr), typlen, typbyval, typalign,
+									  &bounds, NULL, &nbounds);
+				}
+
+				distby->disttype = DISTTYPE_RANGE;
+				distby->colname = get_attname(relloc->relid, relloc->partAttrNum);
+				for (i = 0; i < relloc->nbuckets; i++)
+				{
+					ColumnRef  *node = makeNode(ColumnRef);
+
+					node->fields = list_make1(makeString(get_pgxc_nodename(relloc->bucketMap[i])));
+					node->location = -1;
+					distby->funcargs = lappend(distby->funcargs, node);
+
+					if (i < nbounds)
+					{
+						ArrayType  *arr = DatumGetArrayTypeP(relloc->rangeBounds);
+						TypeCast   *bound = makeNode(TypeCast);
+						A_Const	   *value = makeNode(A_Const);
+						Oid			typoutput;
+						bool		typisvarlena;
+
+						getTypeOutputInfo(ARR_ELEMTYPE(arr), &typoutput, &typisvarlena);
+						value->val.type = T_String;
+						value->val.val.str = OidOutputFunctionCall(typoutput, bounds[i]);
+						value->location = -1;
+						bound->arg = (Node *) value;
+						bound->typeName = makeTypeNameFromOid(ARR_ELEMTYPE(arr), -1);
+						bound->location = -1;
+						distby->funcargs = lappend(distby->funcargs, bound);
+					}
+				}
+			}
+			break;
 		case LOCATOR_TYPE_CUSTOM:
 			/* not support yet */
 			break;
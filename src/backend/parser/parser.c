@@ -1689,6 +1689,31 @@ void transformDistributeBy(DistributeBy *dbstmt)
 
 			dbstmt->disttype = DISTTYPE_MODULO;
 			dbstmt->colname = strVal(linitial(((ColumnRef *)argnode)->fields));
+		} else if (strcasecmp(fname, "BUCKET") == 0)
+		{
+			if (list_length(funcargs) != 1 ||
+				IsA(argnode, ColumnRef) == false ||
+				list_length(((ColumnRef *)argnode)->fields) != 1)
+				ereport(ERROR,
+					(errcode(ERRCODE_SYNTAX_ERROR),
+					errmsg("Invalid distribution column specified for \"BUCKET\""),
+					errhint("Valid syntax input: BUCKET(column)")));
+
+			dbstmt->disttype = DISTTYPE_BUCKET;
+			dbstmt->colname = strVal(linitial(((ColumnRef *)argnode)->fields));
+		} else if (strcasecmp(fname, "RANGE") == 0)
+		{
+			if (IsA(argnode, ColumnRef) == false ||
+				list_length(((ColumnRef *)argnode)->fields) != 1)
+				ereport(ERROR,
+					(errcode(ERRCODE_SYNTAX_ERROR),
+					errmsg("Invalid distribution column specified for \"RANGE\""),
+					errhint("Valid syntax input: RANGE(column, [node,] bound, [node,] bound, ... [, node])")));
+
+			/* rest arguments are bounds and nodes of ranges */
+			dbstmt->disttype = DISTTYPE_RANGE;
+			dbstmt->colname = strVal(linitial(((ColumnRef *)argnode)->fields));
+			dbstmt->funcargs = list_copy_tail(funcargs, 1);
 		} else
 		{
 			/*
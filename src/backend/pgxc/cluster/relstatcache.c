@@ -0,0 +1,606 @@
+/*-------------------------------------------------------------------------
+ *
+ * relstatcache.c
+ *
+ *	  Coordinator shared memory cache of relation size on datanodes
+ *
+ * Coordinator does not store rows of distributed relations, the planner
+ * only know relpages/reltuples of last ANALYZE. This cache keeps number of
+ * blocks, live tuples and changed tuples since last ANALYZE of each
+ * datanode for relations the planner used.
+ *
+ * The planner never waits for datanodes. When it finds a relation not in
+ * cache, or information in cache is older than
+ * relstat_cache_refresh_interval, it marks the relation requested and
+ * starts a background worker for current database if not any running.
+ * The worker fetches all requested relations of the database from
+ * datanode pgstat by one query for a batch of relations, and exits when
+ * there is no more request.
+ *
+ * IDENTIFICATION
+ *	  src/backend/pgxc/cluster/relstatcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/heapam.h"
+#include "access/xact.h"
+#include "catalog/pg_class.h"
+#include "executor/executor.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "pgxc/execRemote.h"
+#include "pgxc/nodemgr.h"
+#include "pgxc/pgxc.h"
+#include "pgxc/pgxcnode.h"
+#include "pgxc/poolmgr.h"
+#include "pgxc/relstatcache.h"
+#include "postmaster/bgworker.h"
+#include "storage/ipc.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+#include "utils/timestamp.h"
+
+/* max relations refreshed by one remote query */
+#define RELSTAT_BATCH_SIZE			64
+
+/* consider worker lost when it does not exit after this many seconds */
+#define RELSTAT_WORKER_TIMEOUT		600
+
+typedef struct RelStatCacheKey
+{
+	Oid			dboid;
+	Oid			relid;
+} RelStatCacheKey;
+
+typedef struct RelStatCacheEntry
+{
+	RelStatCacheKey	key;
+	TimestampTz		update_time;	/* 0 for never filled */
+	bool			requested;		/* waiting for worker */
+	int				nnodes;
+	RelStatNodeInfo	nodes[FLEXIBLE_ARRAY_MEMBER];	/* MaxDataNodes */
+} RelStatCacheEntry;
+
+typedef struct RelStatCacheShared
+{
+	bool			worker_running;
+	Oid				worker_dboid;
+	TimestampTz		worker_start;
+} RelStatCacheShared;
+
+/* GUC parameters */
+int relstat_cache_size = 0;
+int relstat_cache_refresh_interval = 60;	/* seconds */
+
+static RelStatCacheShared *RelStatShared = NULL;
+static HTAB *RelStatHash = NULL;
+
+static Size RelStatCacheEntrySize(void);
+static bool RelStatWorkerRunning(TimestampTz now);
+static void RelStatCacheStartWorker(TimestampTz now);
+static void RelStatWorkerExit(int code, Datum arg);
+static int RelStatTakeRequests(Oid *relids, int max_rels);
+static void RelStatRefresh(Oid *relids, int nrels);
+static void RelStatRemoveEntry(Oid relid);
+
+static Size
+RelStatCacheEntrySize(void)
+{
+	return add_size(offsetof(RelStatCacheEntry, nodes),
+					mul_size(sizeof(RelStatNodeInfo), MaxDataNodes));
+}
+
+Size
+RelStatCacheShmemSize(void)
+{
+	Size		size;
+
+	size = MAXALIGN(sizeof(RelStatCacheShared));
+	if (relstat_cache_size > 0)
+		size = add_size(size, hash_estimate_size(relstat_cache_size,
+												 RelStatCacheEntrySize()));
+
+	return size;
+}
+
+void
+RelStatCacheShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+
+	RelStatShared = ShmemInitStruct("Relation Stat Cache",
+									sizeof(RelStatCacheShared),
+									&found);
+	if (!found)
+		MemSet(RelStatShared, 0, sizeof(RelStatCacheShared));
+
+	if (relstat_cache_size <= 0)
+		return;
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(RelStatCacheKey);
+	info.entrysize = RelStatCacheEntrySize();
+	RelStatHash = ShmemInitHash("Relation Stat Cache Hash",
+								relstat_cache_size,
+								relstat_cache_size,
+								&info,
+								HASH_ELEM | HASH_BLOBS | HASH_FIXED_SIZE);
+}
+
+/*
+ * RelStatCacheGetNodeStats
+ *
+ * Copy statistics of each datanode to nodes, which has MaxDataNodes
+ * elements at least, returns number of datanodes, 0 for unknown. Request
+ * a refresh when not in cache or too old.
+ */
+int
+RelStatCacheGetNodeStats(Oid relid, RelStatNodeInfo *nodes)
+{
+	RelStatCacheKey		key;
+	RelStatCacheEntry  *entry;
+	TimestampTz			now;
+	bool				found;
+	bool				need_request;
+	bool				need_worker;
+	int					nnodes = 0;
+
+	if (RelStatHash == NULL ||
+		relstat_cache_refresh_interval <= 0 ||
+		!IS_PGXC_COORDINATOR ||
+		!OidIsValid(MyDatabaseId))
+		return 0;
+
+	MemSet(&key, 0, sizeof(key));
+	key.dboid = MyDatabaseId;
+	key.relid = relid;
+	now = GetCurrentStatementStartTimestamp();
+
+	/*
+	 * Mostly the entry is fresh or already requested, a shared lock is
+	 * enough then.  Exclusive lock is taken only to set the request.
+	 */
+	LWLockAcquire(RelStatCacheLock, LW_SHARED);
+	entry = hash_search(RelStatHash, &key, HASH_FIND, NULL);
+	if (entry == NULL)
+	{
+		need_request = true;
+	}else
+	{
+		if (entry->update_time != 0)
+		{
+			nnodes = entry->nnodes;
+			memcpy(nodes, entry->nodes, sizeof(entry->nodes[0]) * nnodes);
+		}
+		need_request = !entry->requested &&
+					   (entry->update_time == 0 ||
+						TimestampDifferenceExceeds(entry->update_time,
+												   now,
+												   relstat_cache_refresh_interval * 1000));
+	}
+	/* requested, but worker could not be started last time */
+	need_worker = need_request ||
+				  (entry != NULL && entry->requested &&
+				   !RelStatWorkerRunning(now));
+	LWLockRelease(RelStatCacheLock);
+
+	if (need_request)
+	{
+		LWLockAcquire(RelStatCacheLock, LW_EXCLUSIVE);
+		entry = hash_search(RelStatHash, &key, HASH_ENTER_NULL, &found);
+		if (entry != NULL)
+		{
+			if (!found)
+			{
+				entry->update_time = 0;
+				entry->nnodes = 0;
+			}
+			entry->requested = true;
+		}else
+		{
+			/* cache full, don't start worker for nothing */
+			need_worker = false;
+		}
+		LWLockRelease(RelStatCacheLock);
+	}
+
+	if (need_worker)
+		RelStatCacheStartWorker(now);
+
+	return nnodes;
+}
+
+/*
+ * RelStatCacheGetPages
+ *
+ * Number of blocks of relation in all datanodes, for a replicated
+ * relation it is the biggest one of datanodes.
+ */
+bool
+RelStatCacheGetPages(Relation rel, BlockNumber *pages)
+{
+	RelationLocInfo	   *loc_info = RelationGetLocInfo(rel);
+	RelStatNodeInfo	   *nodes;
+	BlockNumber			result;
+	int					nnodes;
+	int					i;
+
+	if (loc_info == NULL || RelStatHash == NULL)
+		return false;
+
+	nodes = palloc(sizeof(RelStatNodeInfo) * MaxDataNodes);
+	nnodes = RelStatCacheGetNodeStats(RelationGetRelid(rel), nodes);
+
+	result = 0;
+	for (i=0;i<nnodes;++i)
+	{
+		if (IsRelationReplicated(loc_info))
+			result = Max(result, nodes[i].pages);
+		else
+			result += nodes[i].pages;
+	}
+	pfree(nodes);
+
+	if (nnodes == 0)
+		return false;
+
+	*pages = result;
+	return true;
+}
+
+/*
+ * RelStatCacheGetSkew
+ *
+ * Rows of the busiest datanode divide average rows of datanodes, 1.0 when
+ * rows are even or unknown.
+ */
+double
+RelStatCacheGetSkew(Oid relid, RelationLocInfo *loc_info)
+{
+	RelStatNodeInfo	   *nodes;
+	double				max_tuples;
+	double				sum_tuples;
+	double				skew;
+	int					nnodes;
+	int					i;
+
+	if (loc_info == NULL ||
+		RelStatHash == NULL ||
+		IsRelationReplicated(loc_info) ||
+		list_length(loc_info->nodeids) < 2)
+		return 1.0;
+
+	nodes = palloc(sizeof(RelStatNodeInfo) * MaxDataNodes);
+	nnodes = RelStatCacheGetNodeStats(relid, nodes);
+
+	max_tuples = sum_tuples = 0.0;
+	for (i=0;i<nnodes;++i)
+	{
+		if (!list_member_oid(loc_info->nodeids, nodes[i].nodeoid))
+			continue;
+		sum_tuples += nodes[i].live_tuples;
+		max_tuples = Max(max_tuples, nodes[i].live_tuples);
+	}
+	pfree(nodes);
+
+	if (sum_tuples <= 0.0)
+		return 1.0;
+
+	skew = max_tuples * list_length(loc_info->nodeids) / sum_tuples;
+	return Max(skew, 1.0);
+}
+
+/*
+ * RelStatWorkerRunning
+ *
+ * Is a worker running and not timed out, caller holds RelStatCacheLock.
+ */
+static bool
+RelStatWorkerRunning(TimestampTz now)
+{
+	return RelStatShared->worker_running &&
+		   !TimestampDifferenceExceeds(RelStatShared->worker_start,
+									   now,
+									   RELSTAT_WORKER_TIMEOUT * 1000);
+}
+
+static void
+RelStatCacheStartWorker(TimestampTz now)
+{
+	BackgroundWorker	worker;
+
+	LWLockAcquire(RelStatCacheLock, LW_EXCLUSIVE);
+	if (RelStatWorkerRunning(now))
+	{
+		LWLockRelease(RelStatCacheLock);
+		return;
+	}
+	RelStatShared->worker_running = true;
+	RelStatShared->worker_dboid = MyDatabaseId;
+	RelStatShared->worker_start = now;
+	LWLockRelease(RelStatCacheLock);
+
+	MemSet(&worker, 0, sizeof(worker));
+	snprintf(worker.bgw_name, BGW_MAXLEN, "relation stat cache worker");
+	worker.bgw_flags =
+		BGWORKER_SHMEM_ACCESS | BGWORKER_BACKEND_DATABASE_CONNECTION;
+	worker.bgw_start_time = BgWorkerStart_ConsistentState;
+	worker.bgw_restart_time = BGW_NEVER_RESTART;
+	worker.bgw_main = NULL;
+	sprintf(worker.bgw_library_name, "postgres");
+	sprintf(worker.bgw_function_name, "RelStatCacheWorkerMain");
+	worker.bgw_main_arg = ObjectIdGetDatum(MyDatabaseId);
+	worker.bgw_notify_pid = 0;
+
+	if (!RegisterDynamicBackgroundWorker(&worker, NULL))
+	{
+		/* no free slot, try again at next request */
+		LWLockAcquire(RelStatCacheLock, LW_EXCLUSIVE);
+		RelStatShared->worker_running = false;
+		LWLockRelease(RelStatCacheLock);
+	}
+}
+
+void
+RelStatCacheWorkerMain(Datum main_arg)
+{
+	Oid		dboid = DatumGetObjectId(main_arg);
+	Oid		relids[RELSTAT_BATCH_SIZE];
+	int		nrels;
+
+	on_shmem_exit(RelStatWorkerExit, 0);
+
+	BackgroundWorkerUnblockSignals();
+	BackgroundWorkerInitializeConnectionByOid(dboid, InvalidOid);
+
+	/* connect to pool manager for datanode connections */
+	SetCurrentStatementStartTimestamp();
+	StartTransactionCommand();
+	PoolManagerReconnect();
+	CommitTransactionCommand();
+	on_proc_exit(PGXCNodeCleanAndRelease, 0);
+
+	for (;;)
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		nrels = RelStatTakeRequests(relids, RELSTAT_BATCH_SIZE);
+		if (nrels == 0)
+			break;
+
+		SetCurrentStatementStartTimestamp();
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+		pgstat_report_activity(STATE_RUNNING, "refresh relation stat cache");
+
+		RelStatRefresh(relids, nrels);
+
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+		pgstat_report_activity(STATE_IDLE, NULL);
+	}
+
+	proc_exit(0);
+}
+
+static void
+RelStatWorkerExit(int code, Datum arg)
+{
+	LWLockAcquire(RelStatCacheLock, LW_EXCLUSIVE);
+	RelStatShared->worker_running = false;
+	LWLockRelease(RelStatCacheLock);
+}
+
+/*
+ * get requested relations of current database, and clear their requested
+ * mark
+ */
+static int
+RelStatTakeRequests(Oid *relids, int max_rels)
+{
+	HASH_SEQ_STATUS		status;
+	RelStatCacheEntry  *entry;
+	int					nrels = 0;
+
+	LWLockAcquire(RelStatCacheLock, LW_EXCLUSIVE);
+	hash_seq_init(&status, RelStatHash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (entry->key.dboid != MyDatabaseId ||
+			entry->requested == false)
+			continue;
+
+		entry->requested = false;
+		relids[nrels++] = entry->key.relid;
+		if (nrels >= max_rels)
+		{
+			hash_seq_term(&status);
+			break;
+		}
+	}
+	LWLockRelease(RelStatCacheLock);
+
+	return nrels;
+}
+
+static void
+RelStatRemoveEntry(Oid relid)
+{
+	RelStatCacheKey		key;
+
+	MemSet(&key, 0, sizeof(key));
+	key.dboid = MyDatabaseId;
+	key.relid = relid;
+
+	LWLockAcquire(RelStatCacheLock, LW_EXCLUSIVE);
+	hash_search(RelStatHash, &key, HASH_REMOVE, NULL);
+	LWLockRelease(RelStatCacheLock);
+}
+
+/*
+ * fetch statistics of relations from datanodes by one query, each
+ * datanode returns a row for each relation it has
+ */
+static void
+RelStatRefresh(Oid *relids, int nrels)
+{
+	RemoteQuery		   *rquery;
+	RemoteQueryState   *rstate;
+	ExecNodes		   *rnodes;
+	EState			   *estate;
+	TupleTableSlot	   *slot;
+	MemoryContext		oldcontext;
+	Relation			rel;
+	RelationLocInfo	   *loc_info;
+	RelStatNodeInfo	  **results;
+	RelStatNodeInfo	   *info;
+	RelStatCacheKey		key;
+	RelStatCacheEntry  *entry;
+	StringInfoData		sql;
+	ListCell		   *lc;
+	List			   *nodeids = NIL;
+	int				   *nresults;
+	char			   *relname;
+	Datum				value;
+	bool				isnull;
+	bool				first = true;
+	int					i;
+
+	initStringInfo(&sql);
+	appendStringInfo(&sql, "SELECT v.i,pg_catalog.current_setting('pgxc_node_name'),"
+						   "pg_catalog.pg_relation_size(v.r) / %d,"
+						   "pg_catalog.pg_stat_get_live_tuples(v.r),"
+						   "pg_catalog.pg_stat_get_mod_since_analyze(v.r) "
+						   "FROM (VALUES ", BLCKSZ);
+	for (i=0;i<nrels;++i)
+	{
+		rel = try_relation_open(relids[i], AccessShareLock);
+		if (rel == NULL)
+		{
+			RelStatRemoveEntry(relids[i]);
+			continue;
+		}
+		loc_info = RelationGetLocInfo(rel);
+		if (loc_info == NULL ||
+			rel->rd_rel->relkind != RELKIND_RELATION)
+		{
+			relation_close(rel, AccessShareLock);
+			RelStatRemoveEntry(relids[i]);
+			continue;
+		}
+
+		foreach (lc, loc_info->nodeids)
+			nodeids = list_append_unique_oid(nodeids, lfirst_oid(lc));
+
+		relname = quote_qualified_identifier(get_namespace_name(RelationGetNamespace(rel)),
+											 RelationGetRelationName(rel));
+		appendStringInfo(&sql, "%s(%d,pg_catalog.to_regclass(%s))",
+						 first ? "" : ",", i, quote_literal_cstr(relname));
+		first = false;
+		relation_close(rel, AccessShareLock);
+	}
+	appendStringInfoString(&sql, ") v(i,r) WHERE v.r IS NOT NULL");
+
+	if (nodeids == NIL)
+	{
+		pfree(sql.data);
+		return;
+	}
+
+	results = palloc0(sizeof(results[0]) * nrels);
+	nresults = palloc0(sizeof(nresults[0]) * nrels);
+
+	rnodes = makeNode(ExecNodes);
+	rnodes->accesstype = RELATION_ACCESS_READ;
+	rnodes->nodeids = nodeids;
+
+	rquery = makeNode(RemoteQuery);
+	rquery->combine_type = COMBINE_TYPE_NONE;
+	rquery->exec_nodes = rnodes;
+	rquery->sql_statement = sql.data;
+	rquery->force_autocommit = true;
+	rquery->exec_type = EXEC_ON_DATANODES;
+
+	estate = CreateExecutorState();
+	oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
+	estate->es_snapshot = GetActiveSnapshot();
+	rstate = ExecInitRemoteQuery(rquery, estate, 0);
+	MemoryContextSwitchTo(oldcontext);
+
+	for (;;)
+	{
+		ResetPerTupleExprContext(estate);
+
+		slot = ExecProcNode((PlanState *) rstate);
+		if (TupIsNull(slot))
+			break;
+
+		value = slot_getattr(slot, 1, &isnull);
+		if (isnull)
+			continue;
+		i = DatumGetInt32(value);
+		if (i < 0 || i >= nrels || nresults[i] >= MaxDataNodes)
+			continue;
+
+		if (results[i] == NULL)
+			results[i] = palloc0(sizeof(RelStatNodeInfo) * MaxDataNodes);
+		info = &results[i][nresults[i]];
+
+		value = slot_getattr(slot, 2, &isnull);
+		if (isnull)
+			continue;
+		info->nodeoid = get_pgxc_nodeoid(TextDatumGetCString(value));
+		if (!OidIsValid(info->nodeoid))
+			continue;
+
+		value = slot_getattr(slot, 3, &isnull);
+		info->pages = isnull ? 0 : (BlockNumber) DatumGetInt64(value);
+		value = slot_getattr(slot, 4, &isnull);
+		info->live_tuples = isnull ? 0.0 : (double) DatumGetInt64(value);
+		value = slot_getattr(slot, 5, &isnull);
+		info->mod_since_analyze = isnull ? 0.0 : (double) DatumGetInt64(value);
+
+		nresults[i]++;
+	}
+
+	ExecEndRemoteQuery(rstate);
+	FreeExecutorState(estate);
+
+	LWLockAcquire(RelStatCacheLock, LW_EXCLUSIVE);
+	for (i=0;i<nrels;++i)
+	{
+		if (results[i] == NULL)
+			continue;
+
+		MemSet(&key, 0, sizeof(key));
+		key.dboid = MyDatabaseId;
+		key.relid = relids[i];
+		entry = hash_search(RelStatHash, &key, HASH_FIND, NULL);
+		if (entry == NULL)
+			continue;
+
+		entry->nnodes = nresults[i];
+		memcpy(entry->nodes, results[i], sizeof(entry->nodes[0]) * nresults[i]);
+		entry->update_time = GetCurrentTimestamp();
+	}
+	LWLockRelease(RelStatCacheLock);
+
+	for (i=0;i<nrels;++i)
+	{
+		if (results[i])
+			pfree(results[i]);
+	}
+	pfree(results);
+	pfree(nresults);
+	pfree(sql.data);
+}
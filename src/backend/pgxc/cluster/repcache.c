@@ -0,0 +1,568 @@
+/*-------------------------------------------------------------------------
+ *
+ * repcache.c
+ *
+ *	  Coordinator cache of remote query results on replicated tables
+ *
+ * Queries looking up small replicated tables are shipped to a datanode
+ * every time, even though the rows rarely change.  Tables declared with
+ * reloption coordinator_cache = true are cached here: result of a remote
+ * SELECT reading only such tables is kept in backend memory, keyed by
+ * user, parameters and statement, and the next execution of the statement
+ * reads it from the cache without any datanode round trip.  This serves
+ * both lookup queries shipped as a whole and such tables scanned as input
+ * of a join on coordinator.
+ *
+ * Results are dropped by relcache invalidation of their tables.  DML does
+ * not invalidate relcache by itself, so a coordinator changing such a table
+ * invalidates it on commit, and has other coordinators join the transaction
+ * to do the same, see RepCacheInvalidateRelation.  Writes to these tables
+ * pay that, they are expected to be rare.
+ *
+ * Only statements with a fresh snapshot use the cache (not in REPEATABLE
+ * READ or SERIALIZABLE transactions, nor after current transaction changed
+ * a cached table), and only results of immutable queries are cached.
+ *
+ * IDENTIFICATION
+ *	  src/backend/pgxc/cluster/repcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/hash.h"
+#include "access/heapam.h"
+#include "access/htup_details.h"
+#include "access/xact.h"
+#include "catalog/pg_class.h"
+#include "executor/executor.h"
+#include "intercomm/inter-comm.h"
+#include "lib/ilist.h"
+#include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "pgxc/pgxc.h"
+#include "pgxc/repcache.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/tuplestore.h"
+
+typedef struct RepCacheKey
+{
+	Size		len;
+	char	   *data;			/* user, relations, parameters and statement */
+} RepCacheKey;
+
+typedef struct RepCacheEntry
+{
+	RepCacheKey		key;			/* hash key, must be first */
+	MemoryContext	context;		/* of key data, relids and tuples */
+	int				nrels;
+	Oid			   *relids;			/* relations the result comes from */
+	int				ntuples;
+	MinimalTuple   *tuples;
+	Size			size;
+	dlist_node		lru_node;		/* recently used first */
+} RepCacheEntry;
+
+/* result being received by a RemoteQueryState */
+typedef struct RepCacheScan
+{
+	MemoryContext	context;		/* becomes context of entry */
+	RepCacheKey		key;
+	int				nrels;
+	Oid			   *relids;
+	int				ntuples;
+	int				maxtuples;
+	MinimalTuple   *tuples;
+	Size			size;
+	uint64			generation;		/* RepCacheGeneration at start */
+} RepCacheScan;
+
+/* GUC parameter */
+int rep_cache_size = 0;		/* kB */
+
+static HTAB *RepCacheHash = NULL;
+static MemoryContext RepCacheContext = NULL;
+static dlist_head RepCacheLRU = DLIST_STATIC_INIT(RepCacheLRU);
+static Size RepCacheTotalSize = 0;
+/* increased by every invalidation */
+static uint64 RepCacheGeneration = 0;
+/* cached relations changed by current transaction */
+static List *RepCacheModified = NIL;
+
+static void RepCacheInitialize(void);
+static uint32 RepCacheKeyHash(const void *key, Size keysize);
+static int RepCacheKeyMatch(const void *key1, const void *key2, Size keysize);
+static bool RelationIsRepCached(Relation rel);
+static bool RepCacheCheckWalker(Node *node, List **relids);
+static void RepCacheStore(RepCacheScan *scan);
+static void RepCacheRemoveEntry(RepCacheEntry *entry);
+static void RepCacheRelCallback(Datum arg, Oid relid);
+static void RepCacheXactCallback(XactEvent event, void *arg);
+
+static void
+RepCacheInitialize(void)
+{
+	HASHCTL		info;
+
+	if (RepCacheHash != NULL)
+		return;
+
+	RepCacheContext = AllocSetContextCreate(CacheMemoryContext,
+											"RepCacheContext",
+											ALLOCSET_DEFAULT_SIZES);
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(RepCacheKey);
+	info.entrysize = sizeof(RepCacheEntry);
+	info.hash = RepCacheKeyHash;
+	info.match = RepCacheKeyMatch;
+	info.hcxt = RepCacheContext;
+	RepCacheHash = hash_create("Replicated Table Result Cache",
+							   64,
+							   &info,
+							   HASH_ELEM | HASH_FUNCTION | HASH_COMPARE | HASH_CONTEXT);
+
+	CacheRegisterRelcacheCallback(RepCacheRelCallback, (Datum) 0);
+	RegisterXactCallback(RepCacheXactCallback, NULL);
+}
+
+static uint32
+RepCacheKeyHash(const void *key, Size keysize)
+{
+	const RepCacheKey *k = (const RepCacheKey *) key;
+
+	return DatumGetUInt32(hash_any((const unsigned char *) k->data, (int) k->len));
+}
+
+static int
+RepCacheKeyMatch(const void *key1, const void *key2, Size keysize)
+{
+	const RepCacheKey *k1 = (const RepCacheKey *) key1;
+	const RepCacheKey *k2 = (const RepCacheKey *) key2;
+
+	if (k1->len != k2->len)
+		return 1;
+	return memcmp(k1->data, k2->data, k1->len);
+}
+
+static bool
+RelationIsRepCached(Relation rel)
+{
+	return RelationIsCoordinatorCached(rel) &&
+		   rel->rd_rel->relpersistence != RELPERSISTENCE_TEMP &&
+		   rel->rd_locator_info != NULL &&
+		   IsRelationReplicated(rel->rd_locator_info);
+}
+
+/*
+ * collect relations of a remote query to relids, returns true when any of
+ * them is not cached or the query has parameters of executor
+ */
+static bool
+RepCacheCheckWalker(Node *node, List **relids)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, RangeTblEntry))
+	{
+		RangeTblEntry  *rte = (RangeTblEntry *) node;
+		Relation		rel;
+		bool			cached;
+
+		if (rte->rtekind != RTE_RELATION)
+			return false;
+
+		rel = relation_open(rte->relid, NoLock);
+		cached = RelationIsRepCached(rel);
+		relation_close(rel, NoLock);
+		if (!cached)
+			return true;
+
+		*relids = list_append_unique_oid(*relids, rte->relid);
+		return false;
+	}
+
+	if (IsA(node, Param))
+		return ((Param *) node)->paramkind != PARAM_EXTERN;
+
+	if (IsA(node, Query))
+		return query_tree_walker((Query *) node,
+								 RepCacheCheckWalker,
+								 (void *) relids,
+								 QTW_EXAMINE_RTES);
+
+	return expression_tree_walker(node, RepCacheCheckWalker, (void *) relids);
+}
+
+/*
+ * RepCacheInitScan
+ *
+ * Called when a RemoteQueryState is initialized.  When result of the
+ * query is cached, puts it in tuplestore of node and marks the query done,
+ * otherwise starts collecting its result if it can be cached.
+ */
+void
+RepCacheInitScan(RemoteQueryState *node)
+{
+	RemoteQuery	   *rq = (RemoteQuery *) node->ss.ps.plan;
+	RepCacheScan   *scan;
+	RepCacheEntry  *entry;
+	RepCacheKey		key;
+	TupleTableSlot *slot;
+	StringInfoData	buf;
+	MemoryContext	context;
+	MemoryContext	oldcontext;
+	List		   *relids = NIL;
+	ListCell	   *lc;
+	uint64			generation;
+	Oid				userid;
+	Oid				relid;
+	int				i;
+
+	node->rep_cache = NULL;
+	node->rep_cache_status = REP_CACHE_NONE;
+
+	if (rep_cache_size <= 0 ||
+		!IsCoordMaster() ||
+		rq->remote_query == NULL ||
+		rq->remote_query->commandType != CMD_SELECT ||
+		rq->remote_query->hasModifyingCTE ||
+		rq->remote_query->rowMarks != NIL ||
+		rq->has_row_marks ||
+		rq->exec_type != EXEC_ON_DATANODES ||
+		rq->exec_direct_type != EXEC_DIRECT_NONE ||
+		rq->cursor != NULL ||
+		rq->rq_params_internal ||
+		IsolationUsesXactSnapshot() ||
+		RepCacheModified != NIL)
+		return;
+
+	if (RepCacheCheckWalker((Node *) rq->remote_query, &relids) ||
+		relids == NIL ||
+		contain_mutable_functions((Node *) rq->remote_query))
+	{
+		list_free(relids);
+		return;
+	}
+
+	RepCacheInitialize();
+
+	/*
+	 * Statement snapshot is taken right before executor starts.  Locks of
+	 * relations may be held since an earlier statement, get invalidations
+	 * of changes committed before it now; one seen during the scan may be
+	 * newer than the result, which is not stored then.
+	 */
+	generation = RepCacheGeneration;
+	AcceptInvalidationMessages();
+
+	initStringInfo(&buf);
+	userid = GetUserId();
+	appendBinaryStringInfo(&buf, (char *) &userid, sizeof(userid));
+	foreach (lc, relids)
+	{
+		relid = lfirst_oid(lc);
+		appendBinaryStringInfo(&buf, (char *) &relid, sizeof(relid));
+	}
+	appendBinaryStringInfo(&buf, (char *) &node->paramval_len, sizeof(node->paramval_len));
+	if (node->paramval_len > 0)
+		appendBinaryStringInfo(&buf, node->paramval_data, node->paramval_len);
+	appendStringInfoString(&buf, rq->sql_statement);
+	key.len = buf.len;
+	key.data = buf.data;
+
+	entry = (RepCacheEntry *) hash_search(RepCacheHash, &key, HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		slot = node->iterSlot;
+		for (i = 0; i < entry->ntuples; i++)
+		{
+			ExecStoreMinimalTuple(entry->tuples[i], slot, false);
+			slot->tts_xcnodeoid = InvalidOid;
+			tuplestore_put_remotetupleslot(node->tuplestorestate, slot);
+		}
+		ExecClearTuple(slot);
+		dlist_move_head(&RepCacheLRU, &entry->lru_node);
+
+		/* nothing to send, see RemoteQueryNext */
+		node->query_Done = true;
+		node->rep_cache_status = REP_CACHE_HIT;
+
+		pfree(buf.data);
+		list_free(relids);
+		return;
+	}
+
+	/* freed with executor until stored, see RepCacheStore */
+	context = AllocSetContextCreate(node->ss.ps.state->es_query_cxt,
+									"RepCacheEntry",
+									ALLOCSET_SMALL_SIZES);
+	oldcontext = MemoryContextSwitchTo(context);
+
+	scan = (RepCacheScan *) palloc0(sizeof(RepCacheScan));
+	scan->context = context;
+	scan->key.len = buf.len;
+	scan->key.data = (char *) palloc(buf.len);
+	memcpy(scan->key.data, buf.data, buf.len);
+	scan->nrels = list_length(relids);
+	scan->relids = (Oid *) palloc(sizeof(Oid) * scan->nrels);
+	i = 0;
+	foreach (lc, relids)
+		scan->relids[i++] = lfirst_oid(lc);
+	scan->maxtuples = 64;
+	scan->tuples = (MinimalTuple *) palloc(sizeof(MinimalTuple) * scan->maxtuples);
+	scan->generation = generation;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	pfree(buf.data);
+	list_free(relids);
+	node->rep_cache = scan;
+	node->rep_cache_status = REP_CACHE_MISS;
+}
+
+/*
+ * RepCacheCollect
+ *
+ * Keep a row of the result in node, an empty slot ends the result and it
+ * is stored in cache.
+ */
+void
+RepCacheCollect(RemoteQueryState *node, TupleTableSlot *slot)
+{
+	RepCacheScan   *scan = node->rep_cache;
+	MemoryContext	oldcontext;
+	MinimalTuple	tuple;
+
+	Assert(scan);
+	if (TupIsNull(slot))
+	{
+		node->rep_cache = NULL;
+		RepCacheStore(scan);
+		return;
+	}
+
+	if (node->ss.ps.state->es_direction != ForwardScanDirection)
+	{
+		RepCacheEndScan(node);
+		return;
+	}
+
+	oldcontext = MemoryContextSwitchTo(scan->context);
+
+	tuple = ExecCopySlotMinimalTuple(slot);
+	scan->size += tuple->t_len;
+	if (scan->ntuples >= scan->maxtuples)
+	{
+		scan->maxtuples *= 2;
+		scan->tuples = (MinimalTuple *) repalloc(scan->tuples,
+												 sizeof(MinimalTuple) * scan->maxtuples);
+	}
+	scan->tuples[scan->ntuples++] = tuple;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	/* too big to be cached */
+	if (scan->size > (Size) rep_cache_size * 1024)
+		RepCacheEndScan(node);
+}
+
+/*
+ * RepCacheEndScan
+ *
+ * Forget the result being collected, node is rescanned or ends before
+ * the result does.
+ */
+void
+RepCacheEndScan(RemoteQueryState *node)
+{
+	if (node->rep_cache == NULL)
+		return;
+
+	MemoryContextDelete(node->rep_cache->context);
+	node->rep_cache = NULL;
+}
+
+static void
+RepCacheStore(RepCacheScan *scan)
+{
+	RepCacheEntry  *entry;
+	Size			limit = (Size) rep_cache_size * 1024;
+	bool			found;
+
+	if (scan->generation != RepCacheGeneration ||
+		RepCacheModified != NIL ||
+		scan->size > limit)
+	{
+		MemoryContextDelete(scan->context);
+		return;
+	}
+
+	/* make room, least recently used first */
+	while (RepCacheTotalSize + scan->size > limit &&
+		   !dlist_is_empty(&RepCacheLRU))
+		RepCacheRemoveEntry(dlist_container(RepCacheEntry, lru_node,
+											dlist_tail_node(&RepCacheLRU)));
+
+	entry = (RepCacheEntry *) hash_search(RepCacheHash, &scan->key, HASH_ENTER, &found);
+	if (found)
+	{
+		/* stored by another scan of the statement */
+		MemoryContextDelete(scan->context);
+		return;
+	}
+
+	MemoryContextSetParent(scan->context, RepCacheContext);
+	entry->key = scan->key;
+	entry->context = scan->context;
+	entry->nrels = scan->nrels;
+	entry->relids = scan->relids;
+	entry->ntuples = scan->ntuples;
+	entry->tuples = scan->tuples;
+	entry->size = scan->size;
+	dlist_push_head(&RepCacheLRU, &entry->lru_node);
+	RepCacheTotalSize += entry->size;
+}
+
+static void
+RepCacheRemoveEntry(RepCacheEntry *entry)
+{
+	MemoryContext	context = entry->context;
+
+	dlist_delete(&entry->lru_node);
+	RepCacheTotalSize -= entry->size;
+	/* key data is in context */
+	hash_search(RepCacheHash, &entry->key, HASH_REMOVE, NULL);
+	MemoryContextDelete(context);
+}
+
+static void
+RepCacheRelCallback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS	status;
+	RepCacheEntry  *entry;
+	int				i;
+
+	RepCacheGeneration++;
+
+	hash_seq_init(&status, RepCacheHash);
+	while ((entry = (RepCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		for (i = 0; i < entry->nrels; i++)
+		{
+			if (!OidIsValid(relid) || entry->relids[i] == relid)
+			{
+				RepCacheRemoveEntry(entry);
+				break;
+			}
+		}
+	}
+}
+
+static void
+RepCacheXactCallback(XactEvent event, void *arg)
+{
+	switch (event)
+	{
+		case XACT_EVENT_COMMIT:
+		case XACT_EVENT_PARALLEL_COMMIT:
+		case XACT_EVENT_ABORT:
+		case XACT_EVENT_PARALLEL_ABORT:
+		case XACT_EVENT_PREPARE:
+			/* list is in TopTransactionContext */
+			RepCacheModified = NIL;
+			break;
+		default:
+			break;
+	}
+}
+
+/*
+ * RepCacheNoteModified
+ *
+ * Invalidate cached relations current statement writes.  SELECT FOR
+ * UPDATE/SHARE does that too, it requires UPDATE privilege like UPDATE.
+ */
+void
+RepCacheNoteModified(List *rangeTable)
+{
+	RangeTblEntry  *rte;
+	Relation		rel;
+	ListCell	   *lc;
+
+	if (!IsCoordMaster())
+		return;
+
+	foreach (lc, rangeTable)
+	{
+		rte = (RangeTblEntry *) lfirst(lc);
+		if (rte->rtekind != RTE_RELATION ||
+			(rte->requiredPerms & (ACL_INSERT | ACL_UPDATE | ACL_DELETE)) == 0)
+			continue;
+
+		rel = relation_open(rte->relid, NoLock);
+		if (RelationIsRepCached(rel))
+			RepCacheInvalidateRelation(rel);
+		relation_close(rel, NoLock);
+	}
+}
+
+/*
+ * RepCacheInvalidateRelation
+ *
+ * Have all coordinators drop cached results of rel when current
+ * transaction commits.  Other coordinators join the transaction for it,
+ * only the first change of rel in the transaction does that.
+ */
+void
+RepCacheInvalidateRelation(Relation rel)
+{
+	Oid				relid = RelationGetRelid(rel);
+	MemoryContext	oldcontext;
+	RemoteQuery	   *step;
+	char		   *relname;
+
+	RepCacheInitialize();
+	if (list_member_oid(RepCacheModified, relid))
+		return;
+
+	CacheInvalidateRelcache(rel);
+
+	/* relation OID may differ on other coordinators, pass its name */
+	relname = quote_qualified_identifier(get_namespace_name(RelationGetNamespace(rel)),
+										 RelationGetRelationName(rel));
+	step = makeNode(RemoteQuery);
+	step->combine_type = COMBINE_TYPE_SAME;
+	step->sql_statement = psprintf("SELECT pg_catalog.adb_rep_cache_invalidate(%s::pg_catalog.regclass)",
+								   quote_literal_cstr(relname));
+	step->exec_type = EXEC_ON_COORDS;
+	(void) ExecInterXactUtility(step, GetCurrentInterXactState());
+	pfree(step->sql_statement);
+	pfree(step);
+
+	oldcontext = MemoryContextSwitchTo(TopTransactionContext);
+	RepCacheModified = lappend_oid(RepCacheModified, relid);
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * adb_rep_cache_invalidate
+ *
+ * Drop cached results of a relation on this coordinator when current
+ * transaction commits, see RepCacheInvalidateRelation.
+ */
+Datum
+adb_rep_cache_invalidate(PG_FUNCTION_ARGS)
+{
+	CacheInvalidateRelcacheByRelid(PG_GETARG_OID(0));
+
+	PG_RETURN_VOID();
+}
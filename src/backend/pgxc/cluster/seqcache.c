@@ -0,0 +1,314 @@
+/*-------------------------------------------------------------------------
+ *
+ * seqcache.c
+ *
+ *	  Coordinator shared memory cache of sequence value ranges from AGTM
+ *
+ * Without this cache every backend of master coordinator asks AGTM for
+ * each CACHE values of a sequence, short sessions doing a few nextval
+ * make a AGTM round trip almost every time.  Here the coordinator reserves
+ * CACHE values of a sequence from AGTM at once, and all backends take
+ * values from the range by an atomic fetch-add under a shared lock.
+ * Sequences of CACHE 1 are not cached, their values keep increasing
+ * across coordinators.
+ *
+ * When half of current range is used, the backend taking the value at
+ * that point reserves next range from AGTM after it got its own value, so
+ * other backends keep going without waiting for AGTM.  Only when both
+ * ranges are used up a backend waits for AGTM.
+ *
+ * Like the backend local cache, values of the ranges are lost when the
+ * coordinator restarts, and values are not returned in order across
+ * backends.  setval() discards the ranges of all coordinators, ALTER
+ * SEQUENCE and DROP discard them on each coordinator running the command,
+ * a new relfilenode (e.g. TRUNCATE ... RESTART IDENTITY) discards them too.
+ *
+ * IDENTIFICATION
+ *	  src/backend/pgxc/cluster/seqcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/xact.h"
+#include "agtm/agtm.h"
+#include "commands/dbcommands.h"
+#include "intercomm/inter-comm.h"
+#include "miscadmin.h"
+#include "pgxc/pgxc.h"
+#include "pgxc/seqcache.h"
+#include "port/atomics.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/builtins.h"
+#include "utils/hsearch.h"
+#include "utils/lsyscache.h"
+#include "utils/rel.h"
+
+typedef struct SeqCacheKey
+{
+	Oid			dboid;
+	Oid			seqoid;
+} SeqCacheKey;
+
+typedef struct SeqCacheEntry
+{
+	SeqCacheKey		key;
+	Oid				filenode;		/* relfilenode ranges are reserved for */
+	int64			increment;
+	int64			first;			/* current range */
+	uint64			count;
+	pg_atomic_uint64 used;			/* values taken from current range */
+	int64			next_increment;	/* range reserved in advance */
+	int64			next_first;
+	uint64			next_count;		/* 0 for no next range */
+} SeqCacheEntry;
+
+/* GUC parameter */
+int seq_cache_size = 0;
+
+static HTAB *SeqCacheHash = NULL;
+
+static void SeqCacheResetEntry(SeqCacheEntry *entry, Oid filenode);
+static void SeqCacheReserve(Relation seqrel, SeqCacheKey *key, Oid filenode,
+							int64 cache);
+
+Size
+SeqCacheShmemSize(void)
+{
+	if (seq_cache_size <= 0)
+		return 0;
+
+	return hash_estimate_size(seq_cache_size, sizeof(SeqCacheEntry));
+}
+
+void
+SeqCacheShmemInit(void)
+{
+	HASHCTL		info;
+
+	if (seq_cache_size <= 0)
+		return;
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(SeqCacheKey);
+	info.entrysize = sizeof(SeqCacheEntry);
+	SeqCacheHash = ShmemInitHash("Sequence Range Cache Hash",
+								 seq_cache_size,
+								 seq_cache_size,
+								 &info,
+								 HASH_ELEM | HASH_BLOBS | HASH_FIXED_SIZE);
+}
+
+/*
+ * SeqCacheNextVal
+ *
+ * Get next value of a global sequence from shared ranges of "cache"
+ * values, returns false when cache is disabled or full or the sequence
+ * is CACHE 1, caller gets value from AGTM then.
+ */
+bool
+SeqCacheNextVal(Relation seqrel, int64 cache, int64 *result)
+{
+	SeqCacheKey		key;
+	SeqCacheEntry  *entry;
+	Oid				filenode = seqrel->rd_node.relNode;
+	uint64			idx;
+	bool			found;
+	bool			reserve_next;
+
+	if (SeqCacheHash == NULL || !IsCoordMaster() || cache <= 1)
+		return false;
+
+	MemSet(&key, 0, sizeof(key));
+	key.dboid = MyDatabaseId;
+	key.seqoid = RelationGetRelid(seqrel);
+
+	for (;;)
+	{
+		LWLockAcquire(SeqCacheLock, LW_SHARED);
+		entry = hash_search(SeqCacheHash, &key, HASH_FIND, NULL);
+		if (entry != NULL && entry->filenode == filenode)
+		{
+			idx = pg_atomic_fetch_add_u64(&entry->used, 1);
+			if (idx < entry->count)
+			{
+				*result = entry->first + (int64) idx * entry->increment;
+				/* only one backend takes the middle value of a range */
+				reserve_next = (idx == entry->count / 2 &&
+								entry->next_count == 0);
+				LWLockRelease(SeqCacheLock);
+
+				if (reserve_next)
+					SeqCacheReserve(seqrel, &key, filenode, cache);
+				return true;
+			}
+		}
+		LWLockRelease(SeqCacheLock);
+
+		/* current range used up, switch to next range if we have */
+		LWLockAcquire(SeqCacheLock, LW_EXCLUSIVE);
+		entry = hash_search(SeqCacheHash, &key, HASH_ENTER_NULL, &found);
+		if (entry == NULL)
+		{
+			LWLockRelease(SeqCacheLock);
+			return false;
+		}
+		if (!found || entry->filenode != filenode)
+			SeqCacheResetEntry(entry, filenode);
+
+		if (pg_atomic_read_u64(&entry->used) < entry->count)
+		{
+			/* other backend switched it */
+			LWLockRelease(SeqCacheLock);
+			continue;
+		}
+		if (entry->next_count > 0)
+		{
+			entry->increment = entry->next_increment;
+			entry->first = entry->next_first;
+			entry->count = entry->next_count;
+			entry->next_count = 0;
+			pg_atomic_write_u64(&entry->used, 0);
+			LWLockRelease(SeqCacheLock);
+			continue;
+		}
+		LWLockRelease(SeqCacheLock);
+
+		SeqCacheReserve(seqrel, &key, filenode, cache);
+	}
+}
+
+/*
+ * SeqCacheInvalidate
+ *
+ * Discard the ranges of a sequence on this coordinator, values of them are
+ * never used.
+ */
+void
+SeqCacheInvalidate(Oid seqoid)
+{
+	SeqCacheKey		key;
+
+	if (SeqCacheHash == NULL)
+		return;
+
+	MemSet(&key, 0, sizeof(key));
+	key.dboid = MyDatabaseId;
+	key.seqoid = seqoid;
+
+	LWLockAcquire(SeqCacheLock, LW_EXCLUSIVE);
+	hash_search(SeqCacheHash, &key, HASH_REMOVE, NULL);
+	LWLockRelease(SeqCacheLock);
+}
+
+/*
+ * SeqCacheInvalidateAll
+ *
+ * Like SeqCacheInvalidate, but on all coordinators.  Caller has changed
+ * the sequence on AGTM already, ranges reserved from now on have values
+ * of the new state.
+ */
+void
+SeqCacheInvalidateAll(Relation seqrel)
+{
+	RemoteQuery	   *step;
+	char		   *seqname;
+
+	SeqCacheInvalidate(RelationGetRelid(seqrel));
+
+	if (!IsCoordMaster())
+		return;
+
+	/* sequence OID may differ on other coordinators, pass its name */
+	seqname = quote_qualified_identifier(get_namespace_name(RelationGetNamespace(seqrel)),
+										 RelationGetRelationName(seqrel));
+	step = makeNode(RemoteQuery);
+	step->combine_type = COMBINE_TYPE_SAME;
+	step->sql_statement = psprintf("SELECT pg_catalog.adb_seq_cache_invalidate(%s::pg_catalog.regclass)",
+								   quote_literal_cstr(seqname));
+	step->exec_type = EXEC_ON_COORDS;
+	(void) ExecInterXactUtility(step, GetCurrentInterXactState());
+	pfree(step->sql_statement);
+	pfree(step);
+}
+
+/*
+ * adb_seq_cache_invalidate
+ *
+ * Discard the ranges of a sequence on this coordinator, see
+ * SeqCacheInvalidateAll.
+ */
+Datum
+adb_seq_cache_invalidate(PG_FUNCTION_ARGS)
+{
+	SeqCacheInvalidate(PG_GETARG_OID(0));
+
+	PG_RETURN_VOID();
+}
+
+static void
+SeqCacheResetEntry(SeqCacheEntry *entry, Oid filenode)
+{
+	entry->filenode = filenode;
+	entry->increment = 1;
+	entry->first = 0;
+	entry->count = 0;
+	pg_atomic_init_u64(&entry->used, 0);
+	entry->next_increment = 1;
+	entry->next_first = 0;
+	entry->next_count = 0;
+}
+
+/*
+ * reserve a range from AGTM, it becomes current range when that is used
+ * up, otherwise next range.  When other backend has reserved one too,
+ * values of ours are lost, sequences may have gaps anyway.
+ */
+static void
+SeqCacheReserve(Relation seqrel, SeqCacheKey *key, Oid filenode, int64 cache)
+{
+	SeqCacheEntry  *entry;
+	char		   *databaseName;
+	char		   *schemaName;
+	int64			first;
+	int64			last;
+	int64			increment;
+	uint64			count;
+
+	databaseName = get_database_name(seqrel->rd_node.dbNode);
+	schemaName = get_namespace_name(RelationGetNamespace(seqrel));
+
+	first = agtm_GetSeqNextRange(RelationGetRelationName(seqrel),
+								 databaseName,
+								 schemaName,
+								 cache,
+								 &last,
+								 &increment);
+
+	pfree(databaseName);
+	pfree(schemaName);
+
+	Assert(increment != 0);
+	count = (uint64) ((last - first) / increment) + 1;
+
+	LWLockAcquire(SeqCacheLock, LW_EXCLUSIVE);
+	entry = hash_search(SeqCacheHash, key, HASH_FIND, NULL);
+	if (entry != NULL && entry->filenode == filenode)
+	{
+		if (pg_atomic_read_u64(&entry->used) >= entry->count)
+		{
+			entry->increment = increment;
+			entry->first = first;
+			entry->count = count;
+			pg_atomic_write_u64(&entry->used, 0);
+		}else if (entry->next_count == 0)
+		{
+			entry->next_increment = increment;
+			entry->next_first = first;
+			entry->next_count = count;
+		}
+	}
+	LWLockRelease(SeqCacheLock);
+}
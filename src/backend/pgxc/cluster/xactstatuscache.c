@@ -0,0 +1,214 @@
+/*-------------------------------------------------------------------------
+ *
+ * xactstatuscache.c
+ *
+ *	  Shared memory cache of global transaction status resolved by AGTM
+ *
+ * A transaction committed in local clog but still running in the global
+ * snapshot (e.g. a 2PC transaction committed on this node and not yet on
+ * AGTM) has to be resolved by AGTM.  Before this cache every backend did
+ * that for every such xid by refreshing its GTM snapshot, and did it again
+ * on the next tuple without hint bits.
+ *
+ * Here the status of the xid is asked from AGTM together with the other
+ * locally committed xids of the same GTM snapshot in one request, and the
+ * committed or aborted ones are kept in shared memory, where every backend
+ * of the node finds them.  Those statuses never change, so entries are
+ * only removed when their xid precedes the xmin of the GTM snapshot, no
+ * snapshot sees them as running any more then.
+ *
+ * IDENTIFICATION
+ *	  src/backend/pgxc/cluster/xactstatuscache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/transam.h"
+#include "agtm/agtm.h"
+#include "pgxc/xactstatuscache.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/hsearch.h"
+
+/*
+ * Remove old entries at least every so many xids, even though the cache is
+ * not full, so no entry lives long enough to meet its xid again after a
+ * wraparound.
+ */
+#define XACT_STATUS_PRUNE_DISTANCE	(1 << 20)
+
+typedef struct XactStatusCacheEntry
+{
+	TransactionId	xid;			/* hash key, must be first */
+	XidStatus		status;			/* committed or aborted */
+} XactStatusCacheEntry;
+
+typedef struct XactStatusCacheHeader
+{
+	TransactionId	prune_xmin;		/* horizon of last prune */
+} XactStatusCacheHeader;
+
+/* GUC parameter */
+int xact_status_cache_size = 4096;
+
+static XactStatusCacheHeader *XactStatusCacheHdr = NULL;
+static HTAB *XactStatusCacheHash = NULL;
+
+static void XactStatusCacheStore(int nxid, TransactionId *xids,
+								 XidStatus *status, TransactionId horizon);
+static void XactStatusCachePrune(TransactionId horizon);
+
+Size
+XactStatusCacheShmemSize(void)
+{
+	if (xact_status_cache_size <= 0)
+		return 0;
+
+	return add_size(MAXALIGN(sizeof(XactStatusCacheHeader)),
+					hash_estimate_size(xact_status_cache_size,
+									   sizeof(XactStatusCacheEntry)));
+}
+
+void
+XactStatusCacheShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+
+	if (xact_status_cache_size <= 0)
+		return;
+
+	XactStatusCacheHdr = ShmemInitStruct("Transaction Status Cache Header",
+										 sizeof(XactStatusCacheHeader),
+										 &found);
+	if (!found)
+		XactStatusCacheHdr->prune_xmin = InvalidTransactionId;
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(TransactionId);
+	info.entrysize = sizeof(XactStatusCacheEntry);
+	XactStatusCacheHash = ShmemInitHash("Transaction Status Cache Hash",
+										xact_status_cache_size,
+										xact_status_cache_size,
+										&info,
+										HASH_ELEM | HASH_BLOBS | HASH_FIXED_SIZE);
+}
+
+/*
+ * XactStatusCacheCompleted
+ *
+ * Is the xid in gtm_snapshot known to be committed or aborted on AGTM.
+ * Caller must be under AGTM and have seen xid committed in local clog,
+ * returns false when cache is disabled or AGTM still runs the xid.
+ */
+bool
+XactStatusCacheCompleted(TransactionId xid, Snapshot gtm_snapshot)
+{
+	TransactionId			xids[AGTM_XACT_STATUS_BATCH_MAX];
+	XidStatus				status[AGTM_XACT_STATUS_BATCH_MAX];
+	XactStatusCacheEntry   *entry;
+	TransactionId			next_xid;
+	TransactionId			candidate;
+	int						nxid;
+	int						i;
+
+	if (XactStatusCacheHash == NULL)
+		return false;
+
+	LWLockAcquire(XactStatusCacheLock, LW_SHARED);
+	entry = hash_search(XactStatusCacheHash, &xid, HASH_FIND, NULL);
+	LWLockRelease(XactStatusCacheLock);
+	if (entry != NULL)
+		return true;
+
+	/*
+	 * Other locally committed xids of the snapshot are likely checked soon,
+	 * ask AGTM for them too.  Only xids this node has assigned have status
+	 * in local clog.
+	 */
+	xids[0] = xid;
+	nxid = 1;
+	next_xid = ReadNewTransactionId();
+	LWLockAcquire(XactStatusCacheLock, LW_SHARED);
+	for (i = 0; i < gtm_snapshot->xcnt && nxid < AGTM_XACT_STATUS_BATCH_MAX; i++)
+	{
+		candidate = gtm_snapshot->xip[i];
+		if (TransactionIdEquals(candidate, xid) ||
+			!TransactionIdIsNormal(candidate) ||
+			!TransactionIdPrecedes(candidate, next_xid) ||
+			hash_search(XactStatusCacheHash, &candidate, HASH_FIND, NULL) != NULL)
+			continue;
+		xids[nxid++] = candidate;
+	}
+	LWLockRelease(XactStatusCacheLock);
+
+	/* clog lookups may read pages, don't hold the lock for them */
+	for (i = 1; i < nxid;)
+	{
+		if (TransactionLogFetch(xids[i]) == TRANSACTION_STATUS_COMMITTED)
+			++i;
+		else
+			xids[i] = xids[--nxid];
+	}
+
+	agtm_TransactionIdsGetStatus(nxid, xids, status);
+	XactStatusCacheStore(nxid, xids, status, gtm_snapshot->xmin);
+
+	return status[0] == TRANSACTION_STATUS_COMMITTED ||
+		   status[0] == TRANSACTION_STATUS_ABORTED;
+}
+
+static void
+XactStatusCacheStore(int nxid, TransactionId *xids, XidStatus *status,
+					 TransactionId horizon)
+{
+	XactStatusCacheEntry   *entry;
+	int						i;
+
+	LWLockAcquire(XactStatusCacheLock, LW_EXCLUSIVE);
+
+	if (!TransactionIdIsValid(XactStatusCacheHdr->prune_xmin) ||
+		TransactionIdPrecedes(XactStatusCacheHdr->prune_xmin, horizon - XACT_STATUS_PRUNE_DISTANCE))
+		XactStatusCachePrune(horizon);
+
+	for (i = 0; i < nxid; i++)
+	{
+		if (status[i] != TRANSACTION_STATUS_COMMITTED &&
+			status[i] != TRANSACTION_STATUS_ABORTED)
+			continue;
+
+		entry = hash_search(XactStatusCacheHash, &xids[i], HASH_ENTER_NULL, NULL);
+		if (entry == NULL)
+		{
+			/* full, make room and try again once */
+			XactStatusCachePrune(horizon);
+			entry = hash_search(XactStatusCacheHash, &xids[i], HASH_ENTER_NULL, NULL);
+			if (entry == NULL)
+				break;
+		}
+		entry->status = status[i];
+	}
+
+	LWLockRelease(XactStatusCacheLock);
+}
+
+/* remove entries of xid preceding horizon, caller holds exclusive lock */
+static void
+XactStatusCachePrune(TransactionId horizon)
+{
+	HASH_SEQ_STATUS			status;
+	XactStatusCacheEntry   *entry;
+
+	if (!TransactionIdIsNormal(horizon))
+		return;
+
+	hash_seq_init(&status, XactStatusCacheHash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (TransactionIdPrecedes(entry->xid, horizon))
+			hash_search(XactStatusCacheHash, &entry->xid, HASH_REMOVE, NULL);
+	}
+	XactStatusCacheHdr->prune_xmin = horizon;
+}
@@ -28,6 +28,7 @@
 #include "access/skey.h"
 #include "access/sysattr.h"
 #include "access/transam.h"
+#include "access/xact.h"
 #include "catalog/namespace.h"
 #include "catalog/indexing.h"
 #include "catalog/pg_type.h"
@@ -39,17 +40,22 @@
 #include "nodes/nodes.h"
 #include "nodes/nodeFuncs.h"
 #include "nodes/pg_list.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/catcache.h"
 #include "utils/datum.h"
 #include "utils/fmgroids.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/relcache.h"
 #include "utils/syscache.h"
 #include "utils/tqual.h"
 #include "optimizer/clauses.h"
 #include "optimizer/paths.h"
+#include "optimizer/plancat.h"
 #include "parser/parse_coerce.h"
 #include "pgxc/nodemgr.h"
 #include "pgxc/locator.h"
@@ -90,12 +96,28 @@ typedef struct CreateReduceExprContext
 	Index newRelid;
 } CreateReduceExprContext;
 
+typedef struct LocInfoCacheEntry
+{
+	Oid				relid;			/* hash key, must be first */
+	bool			valid;
+	RelationLocInfo *rel_loc;		/* NULL for relation without locator */
+} LocInfoCacheEntry;
+
 static Expr *pgxc_find_distcol_expr(Index varno, AttrNumber attrNum, Node *quals);
+static List *get_nodeids_from_range(RelationLocInfo *rel_loc_info, Datum value, bool isnull,
+									Oid type, RelationAccessType accessType);
+static List *pgxc_find_range_nodes(RelationLocInfo *rel_loc_info, Index varno, Node *quals);
+static void LocInfoCacheRelCallback(Datum arg, Oid relid);
+static void LocInfoCacheXactCallback(XactEvent event, void *arg);
 
 Oid		primary_data_node = InvalidOid;
 int		num_preferred_data_nodes = 0;
 Oid		preferred_data_node[MAX_PREFERRED_NODES];
 
+static HTAB *LocInfoCacheHash = NULL;
+/* locator info of invalidated entries, may be in use until end of transaction */
+static List *LocInfoCacheRetired = NIL;
+
 /*
  * GetPreferredRepNodeIds
  * Pick any Datanode from given list, however fetch a preferred node first.
@@ -130,6 +152,71 @@ get_nodeid_from_modulo(int modulo, List *nodeids)
 	return list_nth_oid(nodeids, modulo);
 }
 
+/*
+ * pgxc_find_range_nodes - nodes of a range table may have rows of quals
+ *
+ * Nodes whose ranges are refuted by quals are excluded, returns NIL when
+ * nothing can be excluded.
+ */
+static List *
+pgxc_find_range_nodes(RelationLocInfo *rel_loc_info, Index varno, Node *quals)
+{
+	List   *nodes;
+
+	if (quals == NULL || rel_loc_info->nbuckets <= 1)
+		return NIL;
+
+	nodes = relation_remote_by_constraints_base(NULL, quals, rel_loc_info, varno);
+	if (list_length(nodes) >= list_length(rel_loc_info->nodeids))
+	{
+		list_free(nodes);
+		return NIL;
+	}
+	return nodes;
+}
+
+/*
+ * get_nodeids_from_range - determine nodes of a range table by a value
+ *
+ * A NULL value is inserted to the node of first range, but means any node
+ * for other access.
+ */
+static List *
+get_nodeids_from_range(RelationLocInfo *rel_loc_info, Datum value, bool isnull,
+					   Oid type, RelationAccessType accessType)
+{
+	int		range;
+
+	if (isnull && accessType != RELATION_ACCESS_INSERT)
+		return list_copy(rel_loc_info->nodeids);
+
+	if (!isnull && rel_loc_info->nbuckets > 1 &&
+		type != ARR_ELEMTYPE(DatumGetArrayTypeP(rel_loc_info->rangeBounds)))
+	{
+		if (accessType == RELATION_ACCESS_INSERT)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATATYPE_MISMATCH),
+					 errmsg("value of type %s does not match range distribution column",
+							format_type_be(type))));
+		return list_copy(rel_loc_info->nodeids);
+	}
+
+	range = GetRangeIndex(rel_loc_info, value, isnull);
+	return list_make1_oid(rel_loc_info->bucketMap[range]);
+}
+
+/*
+ * get_nodeid_from_bucket - determine node of a bucket table by bucket map
+ */
+static Oid
+get_nodeid_from_bucket(int bucket, RelationLocInfo *rel_loc_info)
+{
+	if (bucket < 0 || bucket >= rel_loc_info->nbuckets)
+		ereport(ERROR, (errmsg("Bucket value out of range\n")));
+
+	return rel_loc_info->bucketMap[bucket];
+}
+
 
 /*
  * GetRelationDistribColumn
@@ -249,6 +336,193 @@ GetRoundRobinNodeId(Oid relid)
 	return ret_node;
 }
 
+static int
+bucket_node_cmp(const void *a, const void *b)
+{
+	Oid			oa = *((const Oid *) a);
+	Oid			ob = *((const Oid *) b);
+
+	if (oa < ob)
+		return -1;
+	if (oa > ob)
+		return 1;
+	return 0;
+}
+
+/*
+ * MakeBucketMap
+ *
+ * Assign each of nbuckets hash buckets to one of the given nodes, so that
+ * every node gets nbuckets/numnodes buckets (the first nbuckets%numnodes
+ * nodes in Oid order one more).  If oldmap is given, a bucket stays on its
+ * old node as long as that node is still in the list and does not exceed
+ * its share, only the other buckets move.  The result only depends on the
+ * arguments, not on the order of nodes, so it can be computed again by
+ * redistribution to find the moved buckets.
+ */
+Oid *
+MakeBucketMap(int nbuckets, const Oid *oldmap, const Oid *nodes_in, int numnodes)
+{
+	Oid		   *map;
+	Oid		   *nodes;
+	int		   *count;
+	int			bucket;
+	int			i;
+
+	if (nbuckets <= 0 || numnodes <= 0)
+		return NULL;
+
+	nodes = palloc(sizeof(Oid) * numnodes);
+	memcpy(nodes, nodes_in, sizeof(Oid) * numnodes);
+	qsort(nodes, numnodes, sizeof(Oid), bucket_node_cmp);
+
+	map = palloc(sizeof(Oid) * nbuckets);
+	count = palloc0(sizeof(int) * numnodes);
+
+#define BUCKET_QUOTA(n) (nbuckets / numnodes + ((n) < nbuckets % numnodes ? 1 : 0))
+
+	for (bucket = 0; bucket < nbuckets; bucket++)
+	{
+		map[bucket] = InvalidOid;
+		if (oldmap == NULL)
+			continue;
+
+		for (i = 0; i < numnodes; i++)
+		{
+			if (nodes[i] == oldmap[bucket])
+				break;
+		}
+		if (i < numnodes && count[i] < BUCKET_QUOTA(i))
+		{
+			map[bucket] = nodes[i];
+			count[i]++;
+		}
+	}
+
+	/* give the orphan buckets to the nodes under their share */
+	i = 0;
+	for (bucket = 0; bucket < nbuckets; bucket++)
+	{
+		if (OidIsValid(map[bucket]))
+			continue;
+		while (count[i] >= BUCKET_QUOTA(i))
+			i++;
+		Assert(i < numnodes);
+		map[bucket] = nodes[i];
+		count[i]++;
+	}
+
+#undef BUCKET_QUOTA
+
+	pfree(count);
+	pfree(nodes);
+	return map;
+}
+
+/*
+ * MakeRangeMap
+ *
+ * Assign each of nranges ranges of a range table to one of the given nodes.
+ * rangenodes, if not NIL, is the node Oid wanted by each range.  Otherwise
+ * a range stays on its node in oldmap if it is still in the list, and the
+ * other ranges go to the node of the previous range, so ranges of a deleted
+ * node are merged with their neighbour.  Without any of them ranges are
+ * spread on nodes in Oid order.
+ */
+Oid *
+MakeRangeMap(int nranges, List *rangenodes, const Oid *oldmap,
+			 const Oid *nodes_in, int numnodes)
+{
+	Oid		   *map;
+	Oid		   *nodes;
+	int			range;
+	int			i;
+
+	if (nranges <= 0 || numnodes <= 0)
+		return NULL;
+	Assert(rangenodes == NIL || list_length(rangenodes) == nranges);
+
+	nodes = palloc(sizeof(Oid) * numnodes);
+	memcpy(nodes, nodes_in, sizeof(Oid) * numnodes);
+	qsort(nodes, numnodes, sizeof(Oid), bucket_node_cmp);
+
+	map = palloc(sizeof(Oid) * nranges);
+	for (range = 0; range < nranges; range++)
+	{
+		Oid		wanted;
+
+		if (rangenodes != NIL)
+			wanted = list_nth_oid(rangenodes, range);
+		else if (oldmap != NULL)
+			wanted = oldmap[range];
+		else
+			wanted = nodes[range % numnodes];
+
+		map[range] = InvalidOid;
+		for (i = 0; i < numnodes; i++)
+		{
+			if (nodes[i] == wanted)
+			{
+				map[range] = wanted;
+				break;
+			}
+		}
+
+		if (!OidIsValid(map[range]) && rangenodes != NIL)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_TABLE_DEFINITION),
+					 errmsg("node \"%s\" of range %d is not in the node list of table",
+							get_pgxc_nodename(wanted), range + 1)));
+	}
+
+	/* ranges of a node not in list go to a neighbour range */
+	for (range = 0; range < nranges; range++)
+	{
+		if (OidIsValid(map[range]))
+			continue;
+		if (range > 0)
+		{
+			map[range] = map[range - 1];
+			continue;
+		}
+		for (i = 1; i < nranges; i++)
+		{
+			if (OidIsValid(map[i]))
+				break;
+		}
+		map[range] = (i < nranges ? map[i] : nodes[0]);
+	}
+
+	pfree(nodes);
+	return map;
+}
+
+/*
+ * GetRangeIndex
+ *
+ * Get the index of range holding value in a range table, NULL goes to the
+ * first range.  The value must be of the distribution column type.
+ */
+int
+GetRangeIndex(RelationLocInfo *locInfo, Datum value, bool isnull)
+{
+	int			range;
+
+	Assert(IsRelationDistributedByRange(locInfo));
+	if (isnull || locInfo->nbuckets <= 1)
+		return 0;
+
+	/* width_bucket gives the number of bounds less than or equal to value */
+	range = DatumGetInt32(OidFunctionCall2Coll(F_WIDTH_BUCKET_ARRAY,
+											   locInfo->rangeCollation,
+											   value,
+											   locInfo->rangeBounds));
+	if (range < 0 || range >= locInfo->nbuckets)
+		ereport(ERROR, (errmsg("Range index out of range\n")));
+
+	return range;
+}
+
 /*
  * IsTableDistOnPrimary
  * Does the table distribution list include the primary node?
@@ -299,6 +573,21 @@ IsLocatorInfoEqual(RelationLocInfo *locInfo1,
 	if (!equal(locInfo1->funcAttrNums, locInfo2->funcAttrNums))
 		return false;
 
+	/* Same bucket map? */
+	if (locInfo1->nbuckets != locInfo2->nbuckets)
+		return false;
+	if (locInfo1->nbuckets > 0 &&
+		memcmp(locInfo1->bucketMap, locInfo2->bucketMap,
+			   sizeof(Oid) * locInfo1->nbuckets) != 0)
+		return false;
+
+	/* Same range bounds? */
+	if ((locInfo1->rangeBounds == (Datum) 0) != (locInfo2->rangeBounds == (Datum) 0))
+		return false;
+	if (locInfo1->rangeBounds != (Datum) 0 &&
+		!datumIsEqual(locInfo1->rangeBounds, locInfo2->rangeBounds, false, -1))
+		return false;
+
 	/* Everything is equal */
 	return true;
 }
@@ -312,7 +601,9 @@ ExecNodes *MakeExecNodesByOids(RelationLocInfo *loc_info, List *oids, RelationAc
 
 	exec_nodes = makeNode(ExecNodes);
 	exec_nodes->accesstype = accesstype;
-	exec_nodes->baselocatortype = loc_info->locatorType;
+	exec_nodes->baselocatortype = (IsRelationDistributedByBucket(loc_info) ||
+								   IsRelationDistributedByRange(loc_info)) ?
+		LOCATOR_TYPE_DISTRIBUTED : loc_info->locatorType;
 	//exec_nodes->en_relid = loc_info->relid;
 	exec_nodes->en_funcid = loc_info->funcid;
 	foreach(lc, oids)
@@ -357,6 +648,14 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 	exec_nodes->baselocatortype = rel_loc_info->locatorType;
 	exec_nodes->accesstype = accessType;
 
+	/*
+	 * Rows of two bucket or range tables are not co-located by equal values
+	 * unless their maps are the same, don't let FQS merge them by value.
+	 */
+	if (IsRelationDistributedByBucket(rel_loc_info) ||
+		IsRelationDistributedByRange(rel_loc_info))
+		exec_nodes->baselocatortype = LOCATOR_TYPE_DISTRIBUTED;
+
 	switch (rel_loc_info->locatorType)
 	{
 		case LOCATOR_TYPE_REPLICATED:
@@ -409,6 +708,8 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 											  InvalidOid);
 						modulo = execModuloValue(Int32GetDatum(hashVal),
 												 INT4OID,
+												 IsRelationDistributedByBucket(rel_loc_info) ?
+												 rel_loc_info->nbuckets :
 												 list_length(rel_loc_info->nodeids));
 					}else
 					{
@@ -417,7 +718,10 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 												list_length(rel_loc_info->nodeids));
 					}
 				}
-				exec_nodes->nodeids = list_make1_oid(get_nodeid_from_modulo(modulo, rel_loc_info->nodeids));
+				if (IsRelationDistributedByBucket(rel_loc_info))
+					exec_nodes->nodeids = list_make1_oid(get_nodeid_from_bucket(modulo, rel_loc_info));
+				else
+					exec_nodes->nodeids = list_make1_oid(get_nodeid_from_modulo(modulo, rel_loc_info->nodeids));
 			}
 			break;
 
@@ -487,7 +791,14 @@ GetRelationNodes(RelationLocInfo *rel_loc_info,
 			}
 			break;
 
-			/* PGXCTODO case LOCATOR_TYPE_RANGE: */
+		case LOCATOR_TYPE_RANGE:
+			exec_nodes->nodeids = get_nodeids_from_range(rel_loc_info,
+														 dist_col_values[0],
+														 dist_col_nulls[0],
+														 dist_col_types[0],
+														 accessType);
+			break;
+
 			/* PGXCTODO case LOCATOR_TYPE_CUSTOM: */
 		default:
 			ereport(ERROR, (errmsg("Error: no such supported locator type: %c\n",
@@ -586,6 +897,20 @@ GetRelationNodesByQuals(Oid reloid, Index varno, Node *quals,
 								  &distcol_isnull,
 								  &distcol_type,
 								  relaccess);
+
+	/* No equal value of range table, try prune ranges by quals */
+	if (exec_nodes &&
+		distcol_type == InvalidOid &&
+		relaccess != RELATION_ACCESS_INSERT &&
+		IsRelationDistributedByRange(rel_loc_info))
+	{
+		List *range_nodes = pgxc_find_range_nodes(rel_loc_info, varno, quals);
+		if (range_nodes != NIL)
+		{
+			list_free(exec_nodes->nodeids);
+			exec_nodes->nodeids = range_nodes;
+		}
+	}
 	return exec_nodes;
 }
 
@@ -841,6 +1166,66 @@ RelationIdBuildLocator(Oid relid)
 
 	relationLocInfo->funcid = InvalidOid;
 	relationLocInfo->funcAttrNums = NIL;
+	relationLocInfo->nbuckets = 0;
+	relationLocInfo->bucketMap = NULL;
+	relationLocInfo->rangeBounds = (Datum) 0;
+	relationLocInfo->rangeCollation = InvalidOid;
+	if ((relationLocInfo->locatorType == LOCATOR_TYPE_HASH &&
+		 pgxc_class->pchashalgorithm == LOCATOR_HASH_BUCKET) ||
+		relationLocInfo->locatorType == LOCATOR_TYPE_RANGE)
+	{
+		Datum		mapDatum;
+		bool		isnull;
+		ArrayType  *map;
+		int16	   *indexes;
+		int			nbuckets;
+
+		mapDatum = heap_getattr(htup, Anum_pgxc_class_pcbucketmap,
+								RelationGetDescr(pcrel), &isnull);
+		if (!isnull)
+		{
+			/* the map is stored as index of node in nodeoids */
+			map = DatumGetArrayTypeP(mapDatum);
+			nbuckets = ArrayGetNItems(ARR_NDIM(map), ARR_DIMS(map));
+			indexes = (int16 *) ARR_DATA_PTR(map);
+			relationLocInfo->nbuckets = nbuckets;
+			relationLocInfo->bucketMap = palloc(sizeof(Oid) * nbuckets);
+			for (j = 0; j < nbuckets; j++)
+			{
+				if (indexes[j] < 0 || indexes[j] >= pgxc_class->nodeoids.dim1)
+					elog(ERROR, "invalid bucket map of relation %u", relid);
+				relationLocInfo->bucketMap[j] = pgxc_class->nodeoids.values[indexes[j]];
+			}
+		}
+	}
+	if (relationLocInfo->locatorType == LOCATOR_TYPE_RANGE)
+	{
+		Datum		boundsDatum;
+		bool		isnull;
+		Oid			typid;
+		int32		typmod;
+
+		if (relationLocInfo->nbuckets == 0)
+			elog(ERROR, "invalid range map of relation %u", relid);
+
+		boundsDatum = heap_getattr(htup, Anum_pgxc_class_pcrangebounds,
+								   RelationGetDescr(pcrel), &isnull);
+		if (isnull)
+		{
+			if (relationLocInfo->nbuckets != 1)
+				elog(ERROR, "invalid range bounds of relation %u", relid);
+		} else
+		{
+			ArrayType  *bounds = DatumGetArrayTypePCopy(boundsDatum);
+
+			if (ArrayGetNItems(ARR_NDIM(bounds), ARR_DIMS(bounds)) !=
+				relationLocInfo->nbuckets - 1)
+				elog(ERROR, "invalid range bounds of relation %u", relid);
+			relationLocInfo->rangeBounds = PointerGetDatum(bounds);
+		}
+		get_atttypetypmodcoll(relid, relationLocInfo->partAttrNum,
+							  &typid, &typmod, &relationLocInfo->rangeCollation);
+	}
 	if (relationLocInfo->locatorType == LOCATOR_TYPE_USER_DEFINED)
 	{
 		Datum funcidDatum;
@@ -922,6 +1307,16 @@ CopyRelationLocInfo(RelationLocInfo *srcInfo)
 	destInfo->nodeids = list_copy(srcInfo->nodeids);
 	destInfo->funcid = srcInfo->funcid;
 	destInfo->funcAttrNums = list_copy(srcInfo->funcAttrNums);
+	destInfo->nbuckets = srcInfo->nbuckets;
+	if (srcInfo->bucketMap)
+	{
+		destInfo->bucketMap = palloc(sizeof(Oid) * srcInfo->nbuckets);
+		memcpy(destInfo->bucketMap, srcInfo->bucketMap,
+			   sizeof(Oid) * srcInfo->nbuckets);
+	}
+	if (srcInfo->rangeBounds != (Datum) 0)
+		destInfo->rangeBounds = datumCopy(srcInfo->rangeBounds, false, -1);
+	destInfo->rangeCollation = srcInfo->rangeCollation;
 
 	/* Note: for roundrobin, we use the relcache entry */
 	return destInfo;
@@ -939,10 +1334,105 @@ FreeRelationLocInfo(RelationLocInfo *relationLocInfo)
 	{
 		list_free(relationLocInfo->nodeids);
 		list_free(relationLocInfo->funcAttrNums);
+		if (relationLocInfo->bucketMap)
+			pfree(relationLocInfo->bucketMap);
+		if (relationLocInfo->rangeBounds != (Datum) 0)
+			pfree(DatumGetPointer(relationLocInfo->rangeBounds));
 		pfree(relationLocInfo);
 	}
 }
 
+/*
+ * GetRelationLocInfoCached
+ * Returns the locator information for relation like GetRelationLocInfo,
+ * but from a backend local cache.  It is for routing remote queries on
+ * every execution, where opening the relation and copying its locator info
+ * (bucket map of a bucket table too) cost more than the routing itself.
+ *
+ * Caller must hold a lock on the relation, so invalidation messages of it
+ * are processed.  The result belongs to the cache, don't modify or free it,
+ * it is valid until end of transaction.
+ */
+RelationLocInfo *
+GetRelationLocInfoCached(Oid relid)
+{
+	LocInfoCacheEntry  *entry;
+	RelationLocInfo	   *rel_loc;
+	MemoryContext		oldcontext;
+	bool				found;
+
+	if (LocInfoCacheHash == NULL)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(LocInfoCacheEntry);
+		LocInfoCacheHash = hash_create("Locator Info Cache", 64, &ctl,
+									   HASH_ELEM | HASH_BLOBS);
+
+		CacheRegisterRelcacheCallback(LocInfoCacheRelCallback, (Datum) 0);
+		RegisterXactCallback(LocInfoCacheXactCallback, NULL);
+	}
+
+	entry = hash_search(LocInfoCacheHash, &relid, HASH_FIND, NULL);
+	if (entry != NULL && entry->valid)
+		return entry->rel_loc;
+
+	/* opening relation may invalidate entries, search again after it */
+	rel_loc = GetRelationLocInfo(relid);
+
+	oldcontext = MemoryContextSwitchTo(CacheMemoryContext);
+	entry = hash_search(LocInfoCacheHash, &relid, HASH_ENTER, &found);
+	if (found && entry->rel_loc != NULL)
+		LocInfoCacheRetired = lappend(LocInfoCacheRetired, entry->rel_loc);
+	entry->rel_loc = rel_loc ? CopyRelationLocInfo(rel_loc) : NULL;
+	entry->valid = true;
+	MemoryContextSwitchTo(oldcontext);
+
+	if (rel_loc)
+		FreeRelationLocInfo(rel_loc);
+
+	return entry->rel_loc;
+}
+
+static void
+LocInfoCacheRelCallback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS		status;
+	LocInfoCacheEntry  *entry;
+
+	if (OidIsValid(relid))
+	{
+		entry = hash_search(LocInfoCacheHash, &relid, HASH_FIND, NULL);
+		if (entry != NULL)
+			entry->valid = false;
+		return;
+	}
+
+	hash_seq_init(&status, LocInfoCacheHash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+		entry->valid = false;
+}
+
+static void
+LocInfoCacheXactCallback(XactEvent event, void *arg)
+{
+	ListCell		   *lc;
+
+	if (event != XACT_EVENT_COMMIT &&
+		event != XACT_EVENT_ABORT &&
+		event != XACT_EVENT_PARALLEL_COMMIT &&
+		event != XACT_EVENT_PARALLEL_ABORT &&
+		event != XACT_EVENT_PREPARE)
+		return;
+
+	foreach (lc, LocInfoCacheRetired)
+		FreeRelationLocInfo(lfirst(lc));
+	list_free(LocInfoCacheRetired);
+	LocInfoCacheRetired = NIL;
+}
+
 /*
  * FreeExecNodes
  * Free the contents of the ExecNodes expression
@@ -1121,11 +1611,16 @@ GetInvolvedNodes(RelationLocInfo *rel_loc,
 					if(rel_loc->locatorType == LOCATOR_TYPE_HASH)
 					{
 						int32 hashVal = execHashValue(dist_values[0], dist_types[0], InvalidOid);
-						modulo = execModuloValue(Int32GetDatum(hashVal), INT4OID, nnodes);
+						modulo = execModuloValue(Int32GetDatum(hashVal), INT4OID,
+												 IsRelationDistributedByBucket(rel_loc) ?
+												 rel_loc->nbuckets : nnodes);
 					}else
 						modulo = execModuloValue(dist_values[0], dist_types[0], nnodes);
 				}
-				node_list = list_make1_oid(list_nth_oid(rel_loc->nodeids, modulo));
+				if (IsRelationDistributedByBucket(rel_loc))
+					node_list = list_make1_oid(get_nodeid_from_bucket(modulo, rel_loc));
+				else
+					node_list = list_make1_oid(list_nth_oid(rel_loc->nodeids, modulo));
 			}
 			break;
 
@@ -1195,7 +1690,14 @@ GetInvolvedNodes(RelationLocInfo *rel_loc,
 			}
 			break;
 
-			/* TODO case LOCATOR_TYPE_RANGE: */
+		case LOCATOR_TYPE_RANGE:
+			node_list = get_nodeids_from_range(rel_loc,
+											   dist_values[0],
+											   dist_nulls[0],
+											   dist_types[0],
+											   accessType);
+			break;
+
 			/* TODO case LOCATOR_TYPE_CUSTOM: */
 		default:
 			ereport(ERROR,
@@ -1276,6 +1778,16 @@ GetInvolvedNodesByQuals(Oid reloid, Index varno, Node *quals, RelationAccessType
 		distcol_type = InvalidOid;
 	}
 
+	/* No equal value of range table, try prune ranges by quals */
+	if (distcol_type == InvalidOid &&
+		relaccess != RELATION_ACCESS_INSERT &&
+		IsRelationDistributedByRange(rel_loc))
+	{
+		List *range_nodes = pgxc_find_range_nodes(rel_loc, varno, quals);
+		if (range_nodes != NIL)
+			return range_nodes;
+	}
+
 	return GetInvolvedNodes(rel_loc, 1, &distcol_value,
 							&distcol_isnull, &distcol_type, relaccess);
 }
@@ -21,14 +21,20 @@
 #include "catalog/pg_type.h"
 #include "catalog/pgxc_node.h"
 #include "commands/tablecmds.h"
+#include "pgstat.h"
 #include "pgxc/copyops.h"
 #include "pgxc/execRemote.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/redistrib.h"
 #include "pgxc/remotecopy.h"
+#include "storage/lmgr.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/datum.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/snapmgr.h"
+#include "utils/typcache.h"
 #ifdef ADB
 #include "intercomm/inter-comm.h"
 #endif
@@ -41,11 +47,18 @@
 /* Functions used for the execution of redistribution commands */
 static void distrib_execute_query(char *sql, bool is_temp, ExecNodes *exec_nodes);
 static void distrib_execute_command(RedistribState *distribState, RedistribCommand *command);
-static void distrib_copy_to(RedistribState *distribState);
-static void distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes);
+static void distrib_copy_to(RedistribState *distribState, ExecNodes *exec_nodes,
+							const char *condition);
+static void distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes,
+							  RelationLocInfo *locInfo);
+static void distrib_report_moved(int64 tuples, int64 bytes);
 static void distrib_truncate(RedistribState *distribState, ExecNodes *exec_nodes);
 static void distrib_reindex(RedistribState *distribState, ExecNodes *exec_nodes);
 static void distrib_delete_hash(RedistribState *distribState, ExecNodes *exec_nodes);
+static void distrib_delete_where(RedistribState *distribState, ExecNodes *exec_nodes,
+								 const char *condition);
+static char *distrib_bucket_condition(Relation rel, List *buckets);
+static char *distrib_range_condition(Relation rel, RelationLocInfo *locInfo, Oid nodeOid);
 
 /* Functions used to build the command list */
 static void pgxc_redist_build_entry(RedistribState *distribState,
@@ -57,14 +70,38 @@ static void pgxc_redist_build_replicate(RedistribState *distribState,
 static void pgxc_redist_build_replicate_to_distrib(RedistribState *distribState,
 								RelationLocInfo *oldLocInfo,
 								RelationLocInfo *newLocInfo);
+static void pgxc_redist_build_bucket(RedistribState *distribState,
+								RelationLocInfo *oldLocInfo,
+								RelationLocInfo *newLocInfo);
 
+static void pgxc_redist_build_range(RedistribState *distribState,
+								RelationLocInfo *oldLocInfo,
+								RelationLocInfo *newLocInfo);
+static void pgxc_redist_add_moved_rows(RedistribState *distribState, const char *condition,
+									   List *buckets, List *srcNodeIds, List *dstNodeIds);
 static void pgxc_redist_build_default(RedistribState *distribState);
 static void pgxc_redist_add_reindex(RedistribState *distribState);
+static void pgxc_redist_lock_coordinators(Oid relid);
+/* GUC parameter */
+int redistrib_bucket_batch_size = 256;
 
 
 /*
  * PGXCRedistribTable
- * Execute redistribution operations after catalog update
+ * Execute redistribution operations before or after catalog update.
+ *
+ * ALTER TABLE holds ExclusiveLock while data is moved, so the table stays
+ * readable.  Once the operations to do before catalog update are done, the
+ * lock is upgraded to AccessExclusiveLock on this and all other coordinators
+ * for the final phase that swaps the locator in catalogs and moves what has
+ * to be moved after it, so no reader plans with the old locator and runs
+ * with a snapshot seeing the new data placement.  Progress is reported in
+ * pg_stat_progress_redistribute.
+ *
+ * The upgrade can deadlock with a transaction that read the table and then
+ * waits for a lock ExclusiveLock conflicts with, an INSERT for example.  On
+ * one coordinator the deadlock detector aborts one of them, a wait spanning
+ * coordinators is not detected, set lock_timeout to bound it.
  */
 void
 PGXCRedistribTable(RedistribState *distribState, RedistribCatalog type)
@@ -72,13 +109,30 @@ PGXCRedistribTable(RedistribState *distribState, RedistribCatalog type)
 	ListCell *item;
 
 	/* Nothing to do if no redistribution operation */
-	if (!distribState)
+	if (!distribState || distribState->commands == NIL)
 		return;
 
 	/* Nothing to do if on remote node */
 	if (!IsCoordMaster())
 		return;
 
+	if (IsCommandTypePreUpdate(type))
+	{
+		int64	buckets_total = 0;
+
+		foreach(item, distribState->commands)
+		{
+			RedistribCommand *command = (RedistribCommand *)lfirst(item);
+
+			if (command->type == DISTRIB_COPY_FROM)
+				buckets_total += list_length(command->buckets);
+		}
+		pgstat_progress_start_command(PROGRESS_COMMAND_REDISTRIBUTE,
+									  distribState->relid);
+		pgstat_progress_update_param(PROGRESS_REDISTRIB_BUCKETS_TOTAL,
+									 buckets_total);
+	}
+
 	/* Execute each command if necessary */
 	foreach(item, distribState->commands)
 	{
@@ -95,6 +149,20 @@ PGXCRedistribTable(RedistribState *distribState, RedistribCatalog type)
 		/* Now enter in execution list */
 		distrib_execute_command(distribState, command);
 	}
+
+	if (IsCommandTypePreUpdate(type))
+	{
+		/* Final phase, wait for readers of the old locator */
+		pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+									 PROGRESS_REDISTRIB_PHASE_WAIT_LOCK);
+		LockRelationOid(distribState->relid, AccessExclusiveLock);
+		pgxc_redist_lock_coordinators(distribState->relid);
+		pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+									 PROGRESS_REDISTRIB_PHASE_UPDATE_CATALOG);
+	}
+
+	if (IsCommandTypePostUpdate(type))
+		pgstat_progress_end_command();
 }
 
 
@@ -131,6 +199,12 @@ pgxc_redist_build_entry(RedistribState *distribState,
 	if (IsLocatorInfoEqual(oldLocInfo, newLocInfo))
 		return;
 
+	/* Evaluate cases for bucket tables whose bucket map is changed */
+	pgxc_redist_build_bucket(distribState, oldLocInfo, newLocInfo);
+
+	/* Evaluate cases for range tables whose ranges are changed */
+	pgxc_redist_build_range(distribState, oldLocInfo, newLocInfo);
+
 	/* Evaluate cases for replicated tables */
 	pgxc_redist_build_replicate(distribState, oldLocInfo, newLocInfo);
 
@@ -144,6 +218,189 @@ pgxc_redist_build_entry(RedistribState *distribState,
 }
 
 
+/*
+ * pgxc_redist_build_bucket
+ * Build redistribution command list for a table distributed by hash buckets
+ * that keeps the same distribution column and number of buckets.  Only the
+ * rows of the buckets whose node changed in the bucket map are moved:
+ * COPY TO and DELETE of those buckets on the nodes they leave, then COPY FROM
+ * to the nodes receiving them.  Other rows stay in place, so no TRUNCATE and
+ * no REINDEX are necessary.
+ *
+ * Buckets are moved in batches of redistrib_bucket_batch_size, so that the
+ * tuplestore only holds the rows of one batch.  COPY FROM uses the new bucket
+ * map, all the batches are moved before catalog update while the table is
+ * still readable.
+ */
+static void
+pgxc_redist_build_bucket(RedistribState *distribState,
+						 RelationLocInfo *oldLocInfo,
+						 RelationLocInfo *newLocInfo)
+{
+	Relation	rel;
+	List	   *buckets = NIL;
+	List	   *srcNodeIds = NIL;
+	List	   *dstNodeIds = NIL;
+	int			bucket;
+
+	/* If a command list has already been built, nothing to do */
+	if (list_length(distribState->commands) != 0)
+		return;
+
+	if (!IsRelationDistributedByBucket(oldLocInfo) ||
+		!IsRelationDistributedByBucket(newLocInfo) ||
+		oldLocInfo->partAttrNum != newLocInfo->partAttrNum ||
+		oldLocInfo->nbuckets != newLocInfo->nbuckets)
+		return;
+
+	rel = relation_open(distribState->relid, NoLock);
+
+	for (bucket = 0; bucket < newLocInfo->nbuckets; bucket++)
+	{
+		if (oldLocInfo->bucketMap[bucket] == newLocInfo->bucketMap[bucket])
+			continue;
+		buckets = lappend_int(buckets, bucket);
+		srcNodeIds = list_append_unique_oid(srcNodeIds, oldLocInfo->bucketMap[bucket]);
+		dstNodeIds = list_append_unique_oid(dstNodeIds, newLocInfo->bucketMap[bucket]);
+
+		if (list_length(buckets) >= redistrib_bucket_batch_size)
+		{
+			pgxc_redist_add_moved_rows(distribState,
+									   distrib_bucket_condition(rel, buckets),
+									   buckets, srcNodeIds, dstNodeIds);
+			buckets = srcNodeIds = dstNodeIds = NIL;
+		}
+	}
+
+	if (buckets != NIL)
+		pgxc_redist_add_moved_rows(distribState,
+								   distrib_bucket_condition(rel, buckets),
+								   buckets, srcNodeIds, dstNodeIds);
+	relation_close(rel, NoLock);
+
+	/* Fallback to default if no bucket moves, should not happen */
+	if (distribState->commands == NIL)
+		return;
+
+	distribState->newLocInfo = CopyRelationLocInfo(newLocInfo);
+}
+
+
+/*
+ * pgxc_redist_build_range
+ * Build redistribution command list for a table distributed by range that
+ * keeps the same distribution column, ranges may be moved to other nodes,
+ * split or merged.  Each node moves out the rows that are not in its own
+ * ranges of the new locator, other rows stay in place.  As for bucket
+ * tables everything is moved before catalog update.
+ */
+static void
+pgxc_redist_build_range(RedistribState *distribState,
+						RelationLocInfo *oldLocInfo,
+						RelationLocInfo *newLocInfo)
+{
+	Relation	rel;
+	List	   *dstNodeIds = NIL;
+	ListCell   *lc;
+	bool		sameBounds;
+	int			range;
+
+	/* If a command list has already been built, nothing to do */
+	if (list_length(distribState->commands) != 0)
+		return;
+
+	if (!IsRelationDistributedByRange(oldLocInfo) ||
+		!IsRelationDistributedByRange(newLocInfo) ||
+		oldLocInfo->partAttrNum != newLocInfo->partAttrNum ||
+		oldLocInfo->bucketMap == NULL ||
+		newLocInfo->bucketMap == NULL)
+		return;
+
+	sameBounds = (oldLocInfo->nbuckets == newLocInfo->nbuckets &&
+				  oldLocInfo->rangeCollation == newLocInfo->rangeCollation &&
+				  (oldLocInfo->rangeBounds == (Datum) 0 ||
+				   datumIsEqual(oldLocInfo->rangeBounds, newLocInfo->rangeBounds,
+								false, -1)));
+	for (range = 0; range < newLocInfo->nbuckets; range++)
+		dstNodeIds = list_append_unique_oid(dstNodeIds, newLocInfo->bucketMap[range]);
+
+	rel = relation_open(distribState->relid, NoLock);
+	foreach(lc, oldLocInfo->nodeids)
+	{
+		Oid			nodeOid = lfirst_oid(lc);
+		bool		hasRows = false;
+		bool		moved = !sameBounds;
+		char	   *cond;
+		char	   *moveCond;
+
+		for (range = 0; range < oldLocInfo->nbuckets; range++)
+		{
+			if (oldLocInfo->bucketMap[range] != nodeOid)
+				continue;
+			hasRows = true;
+			if (sameBounds && newLocInfo->bucketMap[range] != nodeOid)
+				moved = true;
+		}
+		if (!hasRows || !moved)
+			continue;
+
+		/* rows not in ranges of this node of the new locator */
+		cond = distrib_range_condition(rel, newLocInfo, nodeOid);
+		if (cond == NULL)
+			continue;
+		moveCond = psprintf("(%s) IS NOT TRUE", cond);
+		pfree(cond);
+
+		pgxc_redist_add_moved_rows(distribState, moveCond, NIL,
+								   list_make1_oid(nodeOid),
+								   list_difference_oid(dstNodeIds, list_make1_oid(nodeOid)));
+	}
+	relation_close(rel, NoLock);
+
+	/* Fallback to default if no range moves */
+	if (distribState->commands == NIL)
+		return;
+
+	distribState->newLocInfo = CopyRelationLocInfo(newLocInfo);
+}
+
+
+/*
+ * pgxc_redist_add_moved_rows
+ * Add the commands moving the rows matching condition from srcNodeIds to
+ * dstNodeIds, for one batch of buckets of a bucket table or the ranges
+ * leaving a node of a range table
+ */
+static void
+pgxc_redist_add_moved_rows(RedistribState *distribState, const char *condition,
+						   List *buckets, List *srcNodeIds, List *dstNodeIds)
+{
+	ExecNodes  *execNodes;
+	RedistribCommand *command;
+
+	/* Fetch the moved rows */
+	execNodes = makeNode(ExecNodes);
+	execNodes->nodeids = list_copy(srcNodeIds);
+	command = makeRedistribCommand(DISTRIB_COPY_BUCKETS, CATALOG_UPDATE_BEFORE, execNodes);
+	command->condition = pstrdup(condition);
+	distribState->commands = lappend(distribState->commands, command);
+
+	/* Then remove them from the nodes they leave */
+	execNodes = makeNode(ExecNodes);
+	execNodes->nodeids = srcNodeIds;
+	command = makeRedistribCommand(DISTRIB_DELETE_BUCKETS, CATALOG_UPDATE_BEFORE, execNodes);
+	command->condition = pstrdup(condition);
+	distribState->commands = lappend(distribState->commands, command);
+
+	/* And COPY them to their new nodes using the new locator */
+	execNodes = makeNode(ExecNodes);
+	execNodes->nodeids = dstNodeIds;
+	command = makeRedistribCommand(DISTRIB_COPY_FROM, CATALOG_UPDATE_BEFORE, execNodes);
+	command->buckets = buckets;
+	distribState->commands = lappend(distribState->commands, command);
+}
+
+
 /*
  * pgxc_redist_build_replicate_to_distrib
  * Build redistribution command list from replicated to distributed
@@ -166,6 +423,11 @@ pgxc_redist_build_replicate_to_distrib(RedistribState *distribState,
 		!IsRelationDistributedByValue(newLocInfo))
 		return;
 
+	/* DELETE by hash modulo does not know bucket or range maps, use default */
+	if (IsRelationDistributedByBucket(newLocInfo) ||
+		IsRelationDistributedByRange(newLocInfo))
+		return;
+
 	/* Get the list of nodes that are added to the relation */
 	removedNodeIds = list_difference_oid(oldLocInfo->nodeids, newLocInfo->nodeids);
 
@@ -352,19 +614,47 @@ distrib_execute_command(RedistribState *distribState, RedistribCommand *command)
 	switch (command->type)
 	{
 		case DISTRIB_COPY_TO:
-			distrib_copy_to(distribState);
+			pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+										 PROGRESS_REDISTRIB_PHASE_COPY_TO);
+			distrib_copy_to(distribState, NULL, NULL);
+			break;
+		case DISTRIB_COPY_BUCKETS:
+			pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+										 PROGRESS_REDISTRIB_PHASE_COPY_TO);
+			distrib_copy_to(distribState, command->execNodes, command->condition);
+			break;
+		case DISTRIB_DELETE_BUCKETS:
+			pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+										 PROGRESS_REDISTRIB_PHASE_DELETE);
+			distrib_delete_where(distribState, command->execNodes, command->condition);
 			break;
 		case DISTRIB_COPY_FROM:
-			distrib_copy_from(distribState, command->execNodes);
+			pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+										 PROGRESS_REDISTRIB_PHASE_COPY_FROM);
+			/* Moved rows are sent by the new locator before catalog update */
+			distrib_copy_from(distribState, command->execNodes,
+							  distribState->newLocInfo);
+			if (command->buckets)
+			{
+				distribState->bucketsMoved += list_length(command->buckets);
+				pgstat_progress_update_param(PROGRESS_REDISTRIB_BUCKETS_MOVED,
+											 distribState->bucketsMoved);
+			}
 			break;
 		case DISTRIB_TRUNCATE:
+			pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+										 PROGRESS_REDISTRIB_PHASE_TRUNCATE);
 			distrib_truncate(distribState, command->execNodes);
 			break;
 		case DISTRIB_REINDEX:
+			pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+										 PROGRESS_REDISTRIB_PHASE_REINDEX);
 			distrib_reindex(distribState, command->execNodes);
 			break;
 		case DISTRIB_DELETE_HASH:
 		case DISTRIB_DELETE_MODULO:
+			pgstat_progress_update_param(PROGRESS_REDISTRIB_PHASE,
+										 PROGRESS_REDISTRIB_PHASE_DELETE);
 			distrib_delete_hash(distribState, command->execNodes);
 			break;
 		case DISTRIB_NONE:
@@ -381,9 +671,12 @@ distrib_execute_command(RedistribState *distribState, RedistribCommand *command)
  * a COPY FROM operation is always done on nodes determined by the locator data
  * in catalogs, explaining why this cannot be done on a subset of nodes. It also
  * insures that no read operations are done on nodes where data is not yet located.
+ * When condition is given, only the moved rows matching it are copied from
+ * the nodes in exec_nodes.
  */
 static void
-distrib_copy_to(RedistribState *distribState)
+distrib_copy_to(RedistribState *distribState, ExecNodes *exec_nodes,
+				const char *condition)
 {
 	Oid			relOid = distribState->relid;
 	Relation	rel;
@@ -409,6 +702,34 @@ distrib_copy_to(RedistribState *distribState)
 	RemoteCopyGetRelationLoc(copyState, rel, NIL);
 	RemoteCopyBuildStatement(copyState, rel, options, NIL, NIL);
 
+	if (condition != NULL)
+	{
+		StringInfoData	query;
+		char		   *relname;
+
+		/*
+		 * Turn "COPY rel TO STDOUT ..." into a COPY of the moved rows, the
+		 * relation name is the one RemoteCopyBuildStatement put at the head
+		 * of the statement.
+		 */
+		if (rel->rd_backend == MyBackendId)
+			relname = pstrdup(quote_identifier(RelationGetRelationName(rel)));
+		else
+			relname = quote_qualified_identifier(get_namespace_name(RelationGetNamespace(rel)),
+												 RelationGetRelationName(rel));
+		initStringInfo(&query);
+		appendStringInfo(&query, "COPY (SELECT * FROM %s WHERE %s)%s",
+						 relname, condition,
+						 copyState->query_buf.data + strlen("COPY ") + strlen(relname));
+		pfree(copyState->query_buf.data);
+		copyState->query_buf = query;
+		pfree(relname);
+
+		Assert(exec_nodes && exec_nodes->nodeids != NIL);
+		list_free(copyState->exec_nodes->nodeids);
+		copyState->exec_nodes->nodeids = list_copy(exec_nodes->nodeids);
+	}
+
 	/* Inform client of operation being done */
 	ereport(DEBUG1,
 			(errmsg("Copying data for relation \"%s.%s\"",
@@ -418,6 +739,13 @@ distrib_copy_to(RedistribState *distribState)
 	/* Begin the COPY process */
 	StartRemoteCopy(copyState);
 
+	/* Rows of the previous batch of buckets are not necessary anymore */
+	if (distribState->store)
+	{
+		tuplestore_end(distribState->store);
+		distribState->store = NULL;
+	}
+
 	/* Create tuplestore storage */
 	store = tuplestore_begin_heap(true, false, work_mem);
 
@@ -443,9 +771,11 @@ distrib_copy_to(RedistribState *distribState)
  * PGXCDistribTableCopyFrom
  * Execute commands related to COPY FROM
  * Redistribute all the data of table with a COPY FROM from given tuplestore.
+ * Rows are routed with locInfo if given, else with the locator in catalogs.
  */
 static void
-distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes)
+distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes,
+				  RelationLocInfo *locInfo)
 {
 	Oid					relOid = distribState->relid;
 	Tuplestorestate	   *store = distribState->store;
@@ -464,6 +794,8 @@ distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes)
 	bool				need_free;
 	List			   *nodes;
 	StringInfoData		line_buf;
+	int64				ntuples = 0;
+	int64				nbytes = 0;
 
 	/* Nothing to do if on remote node */
 	if (!IsCoordMaster())
@@ -489,7 +821,13 @@ distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes)
 	 * use the list of nodes that has been calculated there.
 	 * It might be possible that this COPY is done only on a portion of nodes.
 	 */
-	if (exec_nodes && exec_nodes->nodeids != NIL)
+	if (locInfo)
+	{
+		FreeRelationLocInfo(copyState->rel_loc);
+		copyState->rel_loc = CopyRelationLocInfo(locInfo);
+		if (exec_nodes && exec_nodes->nodeids != NIL)
+			copyState->exec_nodes->nodeids = list_copy(exec_nodes->nodeids);
+	} else if (exec_nodes && exec_nodes->nodeids != NIL)
 	{
 		copyState->exec_nodes->nodeids = list_copy(exec_nodes->nodeids);
 		copyState->rel_loc->nodeids = list_copy(exec_nodes->nodeids);
@@ -587,7 +925,17 @@ distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes)
 
 		/* Clean up */
 		list_free(nodes);
+
+		/* Report progress once in a while */
+		ntuples++;
+		nbytes += line_buf.len;
+		if ((ntuples & 1023) == 0)
+			distrib_report_moved(distribState->tuplesMoved + ntuples,
+								 distribState->bytesMoved + nbytes);
 	}
+	distribState->tuplesMoved += ntuples;
+	distribState->bytesMoved += nbytes;
+	distrib_report_moved(distribState->tuplesMoved, distribState->bytesMoved);
 
 	pfree(line_buf.data);
 	ExecDropSingleTupleTableSlot(slot);
@@ -600,6 +948,23 @@ distrib_copy_from(RedistribState *distribState, ExecNodes *exec_nodes)
 }
 
 
+/*
+ * distrib_report_moved
+ * Report the number of tuples and bytes sent by COPY FROM
+ */
+static void
+distrib_report_moved(int64 tuples, int64 bytes)
+{
+	const int	index[] = {PROGRESS_REDISTRIB_TUPLES_MOVED,
+						   PROGRESS_REDISTRIB_BYTES_MOVED};
+	int64		val[2];
+
+	val[0] = tuples;
+	val[1] = bytes;
+	pgstat_progress_update_multi_param(2, index, val);
+}
+
+
 /*
  * distrib_truncate
  * Truncate all the data of specified table.
@@ -825,6 +1190,197 @@ distrib_delete_hash(RedistribState *distribState, ExecNodes *exec_nodes)
 }
 
 
+/*
+ * distrib_delete_where
+ * Delete the moved rows matching condition, on the nodes they move out of.
+ * Each node only has rows of its own buckets or ranges, so the same query is
+ * sent to all of them.
+ */
+static void
+distrib_delete_where(RedistribState *distribState, ExecNodes *exec_nodes,
+					 const char *condition)
+{
+	Relation	rel;
+	StringInfo	buf;
+	Oid			relOid = distribState->relid;
+
+	/* Nothing to do if on remote node */
+	if (!IsCoordMaster())
+		return;
+
+	/* A sufficient lock level needs to be taken at a higher level */
+	rel = relation_open(relOid, NoLock);
+
+	/* Inform client of operation being done */
+	ereport(DEBUG1,
+			(errmsg("Deleting moved rows of relation \"%s.%s\"",
+					get_namespace_name(RelationGetNamespace(rel)),
+					RelationGetRelationName(rel))));
+
+	/* Build query */
+	buf = makeStringInfo();
+	appendStringInfo(buf, "DELETE FROM %s WHERE %s",
+					 quote_qualified_identifier(get_namespace_name(RelationGetNamespace(rel)),
+												RelationGetRelationName(rel)),
+					 condition);
+
+	/* Lock is maintained until transaction commits */
+	relation_close(rel, NoLock);
+
+	/* Execute the query */
+	distrib_execute_query(buf->data, IsTempTable(relOid), exec_nodes);
+
+	/* Clean buffers */
+	pfree(buf->data);
+	pfree(buf);
+}
+
+
+/*
+ * distrib_bucket_condition
+ * Build the WHERE condition matching rows of the given hash buckets of a
+ * bucket table, "abs(hash_func(dist_col) % nbuckets) = ANY (buckets)".
+ * It must give the same bucket as GetRelationNodes, so the hash function
+ * is the one of the type cache, enum values are hashed as name, and NULL
+ * values belong to bucket 0.
+ */
+static char *
+distrib_bucket_condition(Relation rel, List *buckets)
+{
+	RelationLocInfo *locinfo = RelationGetLocInfo(rel);
+	Form_pg_attribute attr;
+	TypeCacheEntry *typeCache;
+	StringInfoData buf;
+	const char *colname;
+	char	   *colexpr;
+	char	   *funcname;
+	Oid			typid;
+	ListCell   *lc;
+
+	Assert(locinfo && IsRelationDistributedByBucket(locinfo));
+	attr = RelationGetDescr(rel)->attrs[locinfo->partAttrNum - 1];
+	colname = quote_identifier(NameStr(attr->attname));
+	typid = attr->atttypid;
+	if (type_is_enum(typid))
+	{
+		colexpr = psprintf("%s::pg_catalog.text::pg_catalog.name", colname);
+		typid = NAMEOID;
+	} else
+	{
+		colexpr = pstrdup(colname);
+	}
+
+	typeCache = lookup_type_cache(typid, TYPECACHE_HASH_PROC);
+	if (!OidIsValid(typeCache->hash_proc))
+		ereport(ERROR,
+				(errcode(ERRCODE_UNDEFINED_FUNCTION),
+				 errmsg("could not identify a hash function for type %s",
+						format_type_be(typid))));
+	funcname = quote_qualified_identifier(get_namespace_name(get_func_namespace(typeCache->hash_proc)),
+										  get_func_name(typeCache->hash_proc));
+
+	initStringInfo(&buf);
+	if (list_member_int(buckets, 0))
+		appendStringInfo(&buf, "%s IS NULL OR ", colname);
+	appendStringInfo(&buf, "pg_catalog.abs(%s(%s) %% %d) = ANY ('{",
+					 funcname, colexpr, locinfo->nbuckets);
+	foreach(lc, buckets)
+	{
+		if (lc != list_head(buckets))
+			appendStringInfoChar(&buf, ',');
+		appendStringInfo(&buf, "%d", lfirst_int(lc));
+	}
+	appendStringInfoString(&buf, "}'::pg_catalog.int4[])");
+
+	pfree(colexpr);
+	pfree(funcname);
+	return buf.data;
+}
+
+
+/*
+ * distrib_range_condition
+ * Build the WHERE condition matching rows of the ranges of a node in a range
+ * locator, like "col IS NULL OR col < b1 OR (col >= b3 AND col < b4)".  It must
+ * give the same range as GetRangeIndex, bounds are compared in the collation
+ * of the column.  Returns NULL when the node has all the ranges.
+ */
+static char *
+distrib_range_condition(Relation rel, RelationLocInfo *locInfo, Oid nodeOid)
+{
+	Form_pg_attribute attr;
+	StringInfoData buf;
+	const char *colname;
+	char	   *typname;
+	Datum	   *bounds = NULL;
+	int			nbounds = 0;
+	Oid			typoutput;
+	bool		typisvarlena;
+	int			lo, hi;
+
+	Assert(IsRelationDistributedByRange(locInfo));
+	attr = RelationGetDescr(rel)->attrs[locInfo->partAttrNum - 1];
+	colname = quote_identifier(NameStr(attr->attname));
+	typname = format_type_be_qualified(attr->atttypid);
+	getTypeOutputInfo(attr->atttypid, &typoutput, &typisvarlena);
+
+	if (locInfo->rangeBounds != (Datum) 0)
+	{
+		ArrayType  *arr = DatumGetArrayTypeP(locInfo->rangeBounds);
+		int16		typlen;
+		bool		typbyval;
+		char		typalign;
+
+		get_typlenbyvalalign(ARR_ELEMTYPE(arr), &typlen, &typbyval, &typalign);
+		deconstruct_array(arr, ARR_ELEMTYPE(arr), typlen, typbyval, typalign,
+						  &bounds, NULL, &nbounds);
+	}
+	Assert(nbounds == locInfo->nbuckets - 1);
+
+	initStringInfo(&buf);
+	for (lo = 0; lo < locInfo->nbuckets; lo = hi)
+	{
+		/* adjacent ranges of the node as one */
+		for (hi = lo; hi < locInfo->nbuckets && locInfo->bucketMap[hi] == nodeOid; hi++)
+			;
+		if (hi == lo)
+		{
+			hi++;
+			continue;
+		}
+		if (lo == 0 && hi == locInfo->nbuckets)
+		{
+			pfree(buf.data);
+			return NULL;
+		}
+
+		if (buf.len > 0)
+			appendStringInfoString(&buf, " OR ");
+		if (lo == 0)
+			appendStringInfo(&buf, "%s IS NULL OR ", colname);
+		appendStringInfoChar(&buf, '(');
+		if (lo > 0)
+			appendStringInfo(&buf, "%s >= %s::%s", colname,
+							 quote_literal_cstr(OidOutputFunctionCall(typoutput, bounds[lo - 1])),
+							 typname);
+		if (lo > 0 && hi < locInfo->nbuckets)
+			appendStringInfoString(&buf, " AND ");
+		if (hi < locInfo->nbuckets)
+			appendStringInfo(&buf, "%s < %s::%s", colname,
+							 quote_literal_cstr(OidOutputFunctionCall(typoutput, bounds[hi - 1])),
+							 typname);
+		appendStringInfoChar(&buf, ')');
+	}
+
+	/* The node has no range */
+	if (buf.len == 0)
+		appendStringInfoString(&buf, "false");
+
+	pfree(typname);
+	return buf.data;
+}
+
+
 /*
  * makeRedistribState
  * Build a distribution state operator
@@ -836,6 +1392,10 @@ makeRedistribState(Oid relOid)
 	res->relid = relOid;
 	res->commands = NIL;
 	res->store = NULL;
+	res->newLocInfo = NULL;
+	res->bucketsMoved = 0;
+	res->tuplesMoved = 0;
+	res->bytesMoved = 0;
 	return res;
 }
 
@@ -859,6 +1419,8 @@ FreeRedistribState(RedistribState *state)
 		list_free(state->commands);
 	if (state->store)
 		tuplestore_clear(state->store);
+	if (state->newLocInfo)
+		FreeRelationLocInfo(state->newLocInfo);
 }
 
 /*
@@ -890,9 +1452,38 @@ FreeRedistribCommand(RedistribCommand *command)
 
 	if (nodes)
 		FreeExecNodes(&nodes);
+	list_free(command->buckets);
+	if (command->condition)
+		pfree(command->condition);
 	pfree(command);
 }
 
+/*
+ * pgxc_redist_lock_coordinators
+ * Take AccessExclusiveLock of relation on other coordinators, it is held
+ * until the end of transaction like the local one.
+ */
+static void
+pgxc_redist_lock_coordinators(Oid relid)
+{
+	RemoteQuery *step;
+
+	/* temporary table is not known by other coordinators */
+	if (get_rel_persistence(relid) == RELPERSISTENCE_TEMP)
+		return;
+
+	step = makeNode(RemoteQuery);
+	step->combine_type = COMBINE_TYPE_SAME;
+	step->sql_statement = psprintf("LOCK TABLE ONLY %s IN ACCESS EXCLUSIVE MODE",
+								   quote_qualified_identifier(get_namespace_name(get_rel_namespace(relid)),
+															  get_rel_name(relid)));
+	step->force_autocommit = false;
+	step->exec_type = EXEC_ON_COORDS;
+	(void) ExecInterXactUtility(step, GetCurrentInterXactState());
+	pfree(step->sql_statement);
+	pfree(step);
+}
+
 /*
  * distrib_execute_query
  * Execute single raw query on given list of nodes
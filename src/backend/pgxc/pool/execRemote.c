@@ -35,6 +35,7 @@
 #include "libpq/libpq.h"
 #include "nodes/nodes.h"
 #include "nodes/nodeFuncs.h"
+#include "optimizer/cost.h"
 #include "optimizer/var.h"
 #include "parser/parse_coerce.h"
 #include "parser/parse_type.h"
@@ -45,6 +46,7 @@
 #include "pgxc/nodemgr.h"
 #include "pgxc/pgxc.h"
 #include "pgxc/poolmgr.h"
+#include "pgxc/repcache.h"
 #include "pgxc/xc_maintenance_mode.h"
 #include "storage/ipc.h"
 #include "utils/builtins.h"
@@ -52,6 +54,7 @@
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/ps_status.h"
+#include "utils/rel.h"
 #include "utils/snapmgr.h"
 #include "utils/tuplesort.h"
 #ifdef ADB
@@ -65,6 +68,29 @@
  * unique key should be prohibited (true) or allowed (false)
  */
 bool RequirePKeyForRepTab = true;
+bool pipeline_remote_insert = false;
+
+/*
+ * Rows of a multi-row remote INSERT are grouped by target datanode and sent
+ * to the datanodes by COPY, instead of one remote INSERT for each row.  See
+ * ExecInitRemoteInsert.
+ */
+typedef struct RemoteInsertState
+{
+	RemoteCopyState	   *copy_state;		/* COPY statement and locator */
+	TupleDesc			tupdesc;
+	int					nnodes;
+	Oid				   *nodes;			/* datanodes of relation */
+	StringInfoData	   *node_bufs;		/* COPY rows for each of nodes */
+	Size				buffered;		/* total length of node_bufs */
+	StringInfoData		line_buf;
+	MemoryContext		row_context;
+} RemoteInsertState;
+
+/* rows buffered before they are sent */
+#define REMOTE_INSERT_BUFFER_SIZE	(8 * 1024 * 1024)
+
+static void RemoteInsertFlush(RemoteInsertState *state);
 
 typedef struct
 {
@@ -363,6 +389,9 @@ ExecInitRemoteQuery(RemoteQuery *node, EState *estate, int eflags)
 		rqstate->rqs_cmd_id = GetCurrentCommandId(false);
 	}
 
+	if (!(eflags & EXEC_FLAG_EXPLAIN_ONLY))
+		RepCacheInitScan(rqstate);
+
 	return rqstate;
 }
 
@@ -475,6 +504,9 @@ RemoteQueryNext(ScanState *scan_node)
 		node->eof_underlying = TupIsNull(scanslot);
 	}
 
+	if (node->rep_cache)
+		RepCacheCollect(node, scanslot);
+
 	/*
 	 * Now we know the query is successful. Fire AFTER STATEMENT triggers. Make
 	 * sure this is the last iteration of the query. If an FQS query has
@@ -610,6 +642,9 @@ ExecEndRemoteQuery(RemoteQueryState *node)
 #endif
 	}
 
+	/* result not completed is not cached */
+	RepCacheEndScan(node);
+
 	/*
 	 * Clean up parameters if they were set
 	 */
@@ -868,6 +903,9 @@ ExecRemoteQueryReScan(RemoteQueryState *node, ExprContext *exprCtxt)
 	 */
 	ExecClearTuple(node->ss.ps.ps_ResultTupleSlot);
 
+	/* rows are read again, result is not complete */
+	RepCacheEndScan(node);
+
 	if (!node->tuplestorestate)
 		return;
 
@@ -1044,6 +1082,222 @@ ExecProcNodeDMLInXC(EState *estate,
 	return returningResultSlot;
 }
 
+/*
+ * ExecInitRemoteInsert
+ *
+ * Make state to send the rows of a remote INSERT by COPY, returns NULL when
+ * they must be sent by ExecProcNodeDMLInXC one by one: when the INSERT
+ * returns anything of the rows, the relation has triggers or OIDs, or only
+ * a row is expected.
+ *
+ * Each datanode gets its rows as one COPY chunk when the statement ends or
+ * REMOTE_INSERT_BUFFER_SIZE is reached, datanodes load them concurrently.
+ */
+RemoteInsertState *
+ExecInitRemoteInsert(ModifyTableState *mtstate)
+{
+	ModifyTable		   *node = (ModifyTable *) mtstate->ps.plan;
+	ResultRelInfo	   *resultRelInfo = mtstate->resultRelInfo;
+	Relation			rel = resultRelInfo->ri_RelationDesc;
+	RemoteInsertState  *state;
+	RemoteCopyOptions  *options;
+	RemoteCopyState	   *copy_state;
+	ListCell		   *lc;
+	int					i;
+
+	if (!enable_remote_insert_copy ||
+		!IsCnNode() ||
+		mtstate->operation != CMD_INSERT ||
+		mtstate->mt_nplans != 1 ||
+		mtstate->mt_remoterels[0] == NULL ||
+		mtstate->mt_plans[0]->plan->plan_rows < 2.0 ||
+		node->returningLists != NIL ||
+		node->onConflictAction != ONCONFLICT_NONE ||
+		resultRelInfo->ri_TrigDesc != NULL ||
+		resultRelInfo->ri_projectTuplestore != NULL ||
+		rel->rd_rel->relhasoids)
+		return NULL;
+
+	copy_state = (RemoteCopyState *) palloc0(sizeof(RemoteCopyState));
+	copy_state->is_from = true;
+	RemoteCopyGetRelationLoc(copy_state, rel, NIL);
+	if (copy_state->rel_loc == NULL)
+	{
+		pfree(copy_state);
+		return NULL;
+	}
+
+	/* All the fields are separated by tabs, see CopyOps_BuildOneRowTo */
+	options = makeRemoteCopyOptions();
+	options->rco_delim = palloc(2);
+	options->rco_delim[0] = COPYOPS_DELIMITER;
+	options->rco_delim[1] = '\0';
+	RemoteCopyBuildStatement(copy_state, rel, options, NIL, NIL);
+	FreeRemoteCopyOptions(options);
+
+	state = (RemoteInsertState *) palloc0(sizeof(RemoteInsertState));
+	state->copy_state = copy_state;
+	state->tupdesc = RelationGetDescr(rel);
+	state->nnodes = list_length(copy_state->rel_loc->nodeids);
+	state->nodes = (Oid *) palloc(sizeof(Oid) * state->nnodes);
+	state->node_bufs = (StringInfoData *) palloc(sizeof(StringInfoData) * state->nnodes);
+	i = 0;
+	foreach (lc, copy_state->rel_loc->nodeids)
+	{
+		state->nodes[i] = lfirst_oid(lc);
+		initStringInfo(&state->node_bufs[i]);
+		i++;
+	}
+	initStringInfo(&state->line_buf);
+	state->row_context = AllocSetContextCreate(CurrentMemoryContext,
+											   "RemoteInsertRow",
+											   ALLOCSET_DEFAULT_SIZES);
+
+	return state;
+}
+
+/*
+ * ExecRemoteInsertRow
+ *
+ * Add the row of slot to the COPY data of its datanodes.
+ */
+void
+ExecRemoteInsertRow(RemoteInsertState *state, TupleTableSlot *slot)
+{
+	RelationLocInfo	   *rel_loc = state->copy_state->rel_loc;
+	Form_pg_attribute  *attr = state->tupdesc->attrs;
+	MemoryContext		oldcontext;
+	Datum			   *dist_col_values;
+	bool			   *dist_col_is_nulls;
+	Oid				   *dist_col_types;
+	Datum				dist_col_value = (Datum) 0;
+	bool				dist_col_is_null = true;
+	Oid					dist_col_type = UNKNOWNOID;
+	int					nelems = 1;
+	AttrNumber			attnum;
+	List			   *nodes;
+	ListCell		   *lc;
+	int					i;
+
+	/* Make sure the tuple is fully deconstructed */
+	slot_getallattrs(slot);
+
+	oldcontext = MemoryContextSwitchTo(state->row_context);
+
+	CopyOps_BuildOneRowTo(state->tupdesc, slot->tts_values, slot->tts_isnull,
+						  &state->line_buf);
+
+	if (IsRelationDistributedByValue(rel_loc))
+	{
+		attnum = rel_loc->partAttrNum;
+		dist_col_values = &slot->tts_values[attnum - 1];
+		dist_col_is_nulls = &slot->tts_isnull[attnum - 1];
+		dist_col_types = &attr[attnum - 1]->atttypid;
+	} else
+	if (IsRelationDistributedByUserDefined(rel_loc))
+	{
+		Assert(OidIsValid(rel_loc->funcid));
+		Assert(rel_loc->funcAttrNums);
+		nelems = list_length(rel_loc->funcAttrNums);
+		dist_col_values = (Datum *) palloc(sizeof(Datum) * nelems);
+		dist_col_is_nulls = (bool *) palloc(sizeof(bool) * nelems);
+		dist_col_types = (Oid *) palloc(sizeof(Oid) * nelems);
+		i = 0;
+		foreach (lc, rel_loc->funcAttrNums)
+		{
+			attnum = (AttrNumber) lfirst_int(lc);
+			dist_col_values[i] = slot->tts_values[attnum - 1];
+			dist_col_is_nulls[i] = slot->tts_isnull[attnum - 1];
+			dist_col_types[i] = attr[attnum - 1]->atttypid;
+			i++;
+		}
+	} else
+	{
+		dist_col_values = &dist_col_value;
+		dist_col_is_nulls = &dist_col_is_null;
+		dist_col_types = &dist_col_type;
+	}
+
+	nodes = GetInvolvedNodes(rel_loc, nelems,
+							 dist_col_values,
+							 dist_col_is_nulls,
+							 dist_col_types,
+							 RELATION_ACCESS_INSERT);
+
+	MemoryContextSwitchTo(oldcontext);
+
+	foreach (lc, nodes)
+	{
+		for (i = 0; i < state->nnodes; i++)
+		{
+			if (state->nodes[i] == lfirst_oid(lc))
+				break;
+		}
+		if (i >= state->nnodes)
+			elog(ERROR, "datanode %u is not a node of relation", lfirst_oid(lc));
+
+		appendBinaryStringInfo(&state->node_bufs[i],
+							   state->line_buf.data,
+							   state->line_buf.len);
+		state->buffered += state->line_buf.len;
+	}
+
+	MemoryContextReset(state->row_context);
+
+	if (state->buffered >= REMOTE_INSERT_BUFFER_SIZE)
+		RemoteInsertFlush(state);
+}
+
+/*
+ * ExecFinishRemoteInsert
+ *
+ * Send buffered rows, called when the subplan is done.
+ */
+void
+ExecFinishRemoteInsert(RemoteInsertState *state)
+{
+	RemoteInsertFlush(state);
+}
+
+/* one COPY for the datanodes having rows, each gets its rows in one message */
+static void
+RemoteInsertFlush(RemoteInsertState *state)
+{
+	RemoteCopyState	   *copy_state = state->copy_state;
+	List			   *node_list = NIL;
+	List			   *target;
+	int					i;
+
+	if (state->buffered == 0)
+		return;
+
+	for (i = 0; i < state->nnodes; i++)
+	{
+		if (state->node_bufs[i].len > 0)
+			node_list = lappend_oid(node_list, state->nodes[i]);
+	}
+
+	copy_state->exec_nodes->nodeids = node_list;
+	StartRemoteCopy(copy_state);
+
+	for (i = 0; i < state->nnodes; i++)
+	{
+		if (state->node_bufs[i].len == 0)
+			continue;
+
+		target = list_make1_oid(state->nodes[i]);
+		DoRemoteCopyFrom(copy_state, &state->node_bufs[i], target);
+		list_free(target);
+		resetStringInfo(&state->node_bufs[i]);
+	}
+
+	EndRemoteCopy(copy_state);
+
+	copy_state->exec_nodes->nodeids = NIL;
+	list_free(node_list);
+	state->buffered = 0;
+}
+
 /*
  * set_dbcleanup_callback:
  * Register a callback function which does some non-critical cleanup tasks
@@ -17,6 +17,12 @@
 #include "miscadmin.h"
 #include "libpq/pqsignal.h"
 #include "access/parallel.h"
+#ifdef AGTM
+#include "agtm/agtm_light.h"
+#endif /* AGTM */
+#ifdef ADB
+#include "pgxc/relstatcache.h"
+#endif /* ADB */
 #include "postmaster/bgworker_internals.h"
 #include "postmaster/postmaster.h"
 #include "storage/barrier.h"
@@ -108,6 +114,16 @@ static const struct
 	{
 		"ParallelWorkerMain", ParallelWorkerMain
 	}
+#ifdef ADB
+	,{
+		"RelStatCacheWorkerMain", RelStatCacheWorkerMain
+	}
+#endif /* ADB */
+#ifdef AGTM
+	,{
+		"AGtmLightMain", AGtmLightMain
+	}
+#endif /* AGTM */
 };
 
 /* Private functions. */
@@ -761,7 +777,13 @@ RegisterBackgroundWorker(BackgroundWorker *worker)
 		ereport(DEBUG1,
 		 (errmsg("registering background worker \"%s\"", worker->bgw_name)));
 
+#ifdef AGTM
+	/* internal workers are registered by postmaster itself */
+	if (!process_shared_preload_libraries_in_progress &&
+		strcmp(worker->bgw_library_name, "postgres") != 0)
+#else
 	if (!process_shared_preload_libraries_in_progress)
+#endif /* AGTM */
 	{
 		if (!IsUnderPostmaster)
 			ereport(LOG,
@@ -143,6 +143,9 @@
 #if defined(ADBMGRD)
 #include "postmaster/adbmonitor.h"
 #endif /* ADBMGRD */
+#ifdef AGTM
+#include "agtm/agtm_light.h"
+#endif /* AGTM */
 
 /*
  * Possible types of a backend. Beyond being the possible bkend_type values in
@@ -1084,6 +1087,11 @@ PostmasterMain(int argc, char *argv[])
 	 */
 	process_shared_preload_libraries();
 
+#ifdef AGTM
+	/* snapshot and xid status service for all coordinators and datanodes */
+	AGtmLightRegister();
+#endif /* AGTM */
+
 	/*
 	 * Now that loadable modules have had their chance to register background
 	 * workers, calculate MaxBackends.
@@ -605,33 +605,101 @@ SendEofToRemote(RdcPort *port, List *dest_nodes)
 	RdcEndStatus(port) |= RDC_END_EOF;
 }
 
+/*
+ * SendParallelEofToRemote
+ *
+ * Send EOF of one participant of a plan node run by parallel workers, self
+ * reduce sends EOF to remote after got it from all nparticipants, which is
+ * told by the last finished participant, others tell 0.
+ */
 void
+SendParallelEofToRemote(RdcPort *port, List *dest_nodes, int nparticipants)
+{
+	StringInfo	msg;
+	int			num;
+	ListCell   *lc;
+
+	AssertArg(port && dest_nodes);
+	Assert(nparticipants >= 0);
+
+	msg = RdcMsgBuf(port);
+	resetStringInfo(msg);
+	rdc_beginmessage(msg, MSG_EOF);
+	num = list_length(dest_nodes);
+	rdc_sendint(msg, num, sizeof(num));
+	foreach (lc, dest_nodes)
+		rdc_sendRdcPortID(msg, lfirst_oid(lc));
+	rdc_sendint(msg, nparticipants, sizeof(nparticipants));
+	rdc_endmessage(port, msg);
+
+	if (rdc_flush(port) == EOF)
+		ereport(ERROR,
+				(errmsg("fail to send EOF message to remote"),
+				 errdetail("%s", RdcError(port))));
+
+	adb_elog(print_reduce_debug_log, LOG,
+		"Backend send EOF message of" PLAN_PORT_PRINT_FORMAT
+		" with %d participants", RdcSelfID(port), nparticipants);
+
+	port->send_num++;
+	RdcEndStatus(port) |= RDC_END_EOF;
+}
+
+/*
+ * SendSlotToRemote
+ *
+ * Returns number of bytes sent to each remote plan node.
+ */
+int
 SendSlotToRemote(RdcPort *port, List *dest_nodes, TupleTableSlot *slot)
 {
-	StringInfo		msg;
-	ListCell	   *lc;
-	int				num;
 	MinimalTuple	tup;
-	char		   *tupbody;
-	unsigned int	tupbodylen;
 	bool			need_free_tuple;
+	int				datalen;
 
 	AssertArg(port);
 	if (!dest_nodes)
-		return ;
+		return 0;
 
 	AssertArg(slot);
 
 	tup = fetch_slot_message(slot, &need_free_tuple);
 	/* the part of the MinimalTuple we'll write: */
-	tupbody = (char *) tup + MINIMAL_TUPLE_DATA_OFFSET;
-	tupbodylen = tup->t_len - MINIMAL_TUPLE_DATA_OFFSET;
+	datalen = tup->t_len - MINIMAL_TUPLE_DATA_OFFSET;
+	SendDataToRemote(port, dest_nodes,
+					 (const char *) tup + MINIMAL_TUPLE_DATA_OFFSET,
+					 datalen);
+
+	if (need_free_tuple)
+		pfree(tup);
+
+	return datalen;
+}
+
+/*
+ * SendDataToRemote
+ *
+ * Send data to remote plan nodes like a tuple body, the remote got it by
+ * GetSlotFromRemote as a MinimalTuple which body is the data.
+ */
+void
+SendDataToRemote(RdcPort *port, List *dest_nodes, const char *data, int datalen)
+{
+	StringInfo		msg;
+	ListCell	   *lc;
+	int				num;
+
+	AssertArg(port);
+	AssertArg(data && datalen > 0);
+	if (!dest_nodes)
+		return ;
+
 	msg = RdcMsgBuf(port);
 
 	resetStringInfo(msg);
 	rdc_beginmessage(msg, MSG_P2R_DATA);
-	rdc_sendint(msg, tupbodylen, sizeof(tupbodylen));
-	rdc_sendbytes(msg, (const char * ) tupbody, tupbodylen);
+	rdc_sendint(msg, datalen, sizeof(datalen));
+	rdc_sendbytes(msg, data, datalen);
 	num = list_length(dest_nodes);
 	rdc_sendint(msg, num, sizeof(num));
 	foreach (lc, dest_nodes)
@@ -643,16 +711,20 @@ SendSlotToRemote(RdcPort *port, List *dest_nodes, TupleTableSlot *slot)
 				(errmsg("fail to send tuple to remote"),
 				 errdetail("%s", RdcError(port))));
 
-	if (need_free_tuple)
-		pfree(tup);
-
 	port->send_num++;
 }
 
+/*
+ * GetSlotFromRemote
+ *
+ * If tup_buf is NULL the tuple is palloc'd in slot's memory context,
+ * otherwise the slot points into the input buffer of port (or tup_buf)
+ * and is only valid until next message read from port.
+ */
 TupleTableSlot *
 GetSlotFromRemote(RdcPort *port, TupleTableSlot *slot,
 				  Oid *slot_oid, Oid *eof_oid,
-				  List **closed_remote)
+				  List **closed_remote, StringInfo tup_buf)
 {
 	StringInfo	msg;
 	int			msg_type;
@@ -695,13 +767,35 @@ GetSlotFromRemote(RdcPort *port, TupleTableSlot *slot,
 				rdc_getmsgend(msg);
 
 				tuplen = msg_len + MINIMAL_TUPLE_DATA_OFFSET;
+				if (slot_oid)
+					*slot_oid = (Oid) rid;
+
+				if (tup_buf)
+				{
+					/*
+					 * Message type, length and reduce id in front of data
+					 * are consumed, so MinimalTuple header can be built in
+					 * place when it is aligned.
+					 */
+					tuple = (MinimalTuple) (data - MINIMAL_TUPLE_DATA_OFFSET);
+					if ((char *) tuple < msg->data ||
+						(char *) tuple != (char *) MAXALIGN(tuple))
+					{
+						resetStringInfo(tup_buf);
+						enlargeStringInfo(tup_buf, tuplen);
+						tuple = (MinimalTuple) tup_buf->data;
+						tupbody = (char *) tuple + MINIMAL_TUPLE_DATA_OFFSET;
+						memcpy(tupbody, data, msg_len);
+					}
+					tuple->t_len = tuplen;
+					return ExecStoreMinimalTuple(tuple, slot, false);
+				}
+
 				tuple = (MinimalTuple) MemoryContextAlloc(slot->tts_mcxt, tuplen);
 				tupbody = (char *) tuple + MINIMAL_TUPLE_DATA_OFFSET;
 				tuple->t_len = tuplen;
 				memcpy(tupbody, data, msg_len);
 
-				if (slot_oid)
-					*slot_oid = (Oid) rid;
 				return ExecStoreMinimalTuple(tuple, slot, true);
 			}
 		case MSG_EOF:
@@ -725,6 +819,14 @@ GetSlotFromRemote(RdcPort *port, TupleTableSlot *slot,
 					*eof_oid = (Oid) rid;
 			}
 			break;
+		case MSG_R2P_STAT:
+			{
+				/* self reduce tells its statistics before the last EOF */
+				rid = rdc_getmsgRdcPortID(msg);
+				port->spill_bytes = (uint64) rdc_getmsgint64(msg);
+				rdc_getmsgend(msg);
+			}
+			break;
 		default:
 			ereport(ERROR,
 					(errmsg("unexpected message type '%d' from self reduce",
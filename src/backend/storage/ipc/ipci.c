@@ -48,6 +48,9 @@
 #include "pgxc/nodemgr.h"
 #include "pgxc/pause.h"
 #include "pgxc/pgxc.h"
+#include "pgxc/relstatcache.h"
+#include "pgxc/seqcache.h"
+#include "pgxc/xactstatuscache.h"
 #endif
 #if defined(ADBMGRD)
 #include "postmaster/adbmonitor.h"
@@ -150,7 +153,12 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		size = add_size(size, AsyncShmemSize());
 #ifdef ADB
 		if (IS_PGXC_COORDINATOR)
+		{
 			size = add_size(size, ClusterLockShmemSize());
+			size = add_size(size, RelStatCacheShmemSize());
+			size = add_size(size, SeqCacheShmemSize());
+		}
+		size = add_size(size, XactStatusCacheShmemSize());
 #endif
 
 #if defined(ADBMGRD)
@@ -264,7 +272,12 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 
 #ifdef ADB
 	if (IS_PGXC_COORDINATOR)
+	{
 		ClusterLockShmemInit();
+		RelStatCacheShmemInit();
+		SeqCacheShmemInit();
+	}
+	XactStatusCacheShmemInit();
 #endif
 
 	/*
@@ -123,6 +123,14 @@ typedef struct ProcArrayStruct
 	/* oldest catalog xmin of any replication slot */
 	TransactionId replication_slot_catalog_xmin;
 
+#ifdef AGTM
+	/*
+	 * Count of transactions with xid removed from the array, a snapshot
+	 * taken after reading it is still valid as long as it is not changed.
+	 */
+	pg_atomic_uint64 commitSeq;
+#endif
+
 	/* indexes into allPgXact[], has PROCARRAY_MAXPROCS entries */
 	int			pgprocnos[FLEXIBLE_ARRAY_MEMBER];
 } ProcArrayStruct;
@@ -280,6 +288,9 @@ CreateSharedProcArray(void)
 		procArray->lastOverflowedXid = InvalidTransactionId;
 		procArray->replication_slot_xmin = InvalidTransactionId;
 		procArray->replication_slot_catalog_xmin = InvalidTransactionId;
+#ifdef AGTM
+		pg_atomic_init_u64(&procArray->commitSeq, 0);
+#endif
 	}
 
 	allProcs = ProcGlobal->allProcs;
@@ -390,6 +401,9 @@ ProcArrayRemove(PGPROC *proc, TransactionId latestXid)
 		if (TransactionIdPrecedes(ShmemVariableCache->latestCompletedXid,
 								  latestXid))
 			ShmemVariableCache->latestCompletedXid = latestXid;
+#ifdef AGTM
+		pg_atomic_fetch_add_u64(&procArray->commitSeq, 1);
+#endif
 	}
 	else
 	{
@@ -518,6 +532,9 @@ ProcArrayEndTransactionInternal(PGPROC *proc, PGXACT *pgxact,
 	if (TransactionIdPrecedes(ShmemVariableCache->latestCompletedXid,
 							  latestXid))
 		ShmemVariableCache->latestCompletedXid = latestXid;
+#ifdef AGTM
+	pg_atomic_fetch_add_u64(&procArray->commitSeq, 1);
+#endif
 }
 
 /*
@@ -4308,6 +4325,21 @@ ProcUnassignedXids(int nxids, TransactionId *xids)
 }
 #endif
 
+#ifdef AGTM
+/*
+ * ProcArrayGetCommitSeq
+ *		Get count of transactions ended with xid.
+ *
+ * Read it before taking a snapshot, when it is not changed later no xid
+ * of the snapshot has ended, so the snapshot can be used again.
+ */
+uint64
+ProcArrayGetCommitSeq(void)
+{
+	return pg_atomic_read_u64(&procArray->commitSeq);
+}
+#endif /* AGTM */
+
 #ifdef ADB
 #define SNAPSHOT_ENLARGE_STEP 32
 void EnlargeSnapshotXip(Snapshot snapshot, uint32 need_size)
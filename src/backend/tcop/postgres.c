@@ -4608,6 +4608,9 @@ PostgresMain(int argc, char *argv[],
 		 */
 		ReduceCleanup();
 
+		/* Don't check stop message of cluster plan any more */
+		clusterRecvResetStopCheck();
+
 		/* Mark transaction abort with error */
 		MarkCurrentTransactionErrorAborted();
 #endif
@@ -26,6 +26,7 @@
 #include "utils/snapmgr.h"
 #ifdef ADB
 #include "access/relscan.h"
+#include "intercomm/inter-node.h"
 #include "optimizer/pgxcplan.h"
 #include "pgxc/execRemote.h"
 #include "pgxc/pgxc.h"
@@ -894,6 +895,15 @@ PortalRun(Portal portal, long count, bool isTopLevel,
 				result = false; /* keep compiler quiet */
 				break;
 		}
+
+#ifdef ADB
+		/*
+		 * Collect the results of pipelined remote inserts before the caller
+		 * sends the command tag, a failing insert must report its error.
+		 */
+		if (IsCnNode())
+			FinishPipelinedNodeHandles();
+#endif
 	}
 	PG_CATCH();
 	{
@@ -565,6 +565,10 @@ pg_stat_get_progress_info(PG_FUNCTION_ARGS)
 	/* Translate command name into command type code. */
 	if (pg_strcasecmp(cmd, "VACUUM") == 0)
 		cmdtype = PROGRESS_COMMAND_VACUUM;
+#ifdef ADB
+	else if (pg_strcasecmp(cmd, "REDISTRIBUTE") == 0)
+		cmdtype = PROGRESS_COMMAND_REDISTRIBUTE;
+#endif
 	else
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -6599,6 +6599,10 @@ get_utility_query_def(Query *query, deparse_context *context)
 					appendStringInfo(buf, " DISTRIBUTE BY HASH(%s)", stmt->distributeby->colname);
 					break;
 
+				case DISTTYPE_BUCKET:
+					appendStringInfo(buf, " DISTRIBUTE BY BUCKET(%s)", stmt->distributeby->colname);
+					break;
+
 				case DISTTYPE_ROUNDROBIN:
 					appendStringInfo(buf, " DISTRIBUTE BY ROUNDROBIN");
 					break;
@@ -6607,6 +6611,48 @@ get_utility_query_def(Query *query, deparse_context *context)
 					appendStringInfo(buf, " DISTRIBUTE BY MODULO(%s)", stmt->distributeby->colname);
 					break;
 
+				case DISTTYPE_RANGE:
+					{
+						ListCell   *lc;
+
+						appendStringInfo(buf, " DISTRIBUTE BY RANGE(%s",
+										 quote_identifier(stmt->distributeby->colname));
+						/* node names and bound literals as given */
+						foreach(lc, stmt->distributeby->funcargs)
+						{
+							Node	   *arg = lfirst(lc);
+
+							appendStringInfoString(buf, ", ");
+							if (IsA(arg, ColumnRef))
+								appendStringInfoString(buf,
+									quote_identifier(strVal(llast(((ColumnRef *) arg)->fields))));
+							else if (IsA(arg, TypeCast) &&
+									 IsA(((TypeCast *) arg)->arg, A_Const) &&
+									 IsA(&((A_Const *) ((TypeCast *) arg)->arg)->val, String))
+							{
+								TypeCast   *tc = (TypeCast *) arg;
+
+								simple_quote_literal(buf, strVal(&((A_Const *) tc->arg)->val));
+								appendStringInfo(buf, "::%s", TypeNameToString(tc->typeName));
+							}
+							else if (IsA(arg, A_Const) &&
+									 IsA(&((A_Const *) arg)->val, String))
+								simple_quote_literal(buf, strVal(&((A_Const *) arg)->val));
+							else if (IsA(arg, A_Const) &&
+									 IsA(&((A_Const *) arg)->val, Integer))
+								appendStringInfo(buf, "%ld", intVal(&((A_Const *) arg)->val));
+							else if (IsA(arg, A_Const) &&
+									 IsA(&((A_Const *) arg)->val, Float))
+								appendStringInfoString(buf, strVal(&((A_Const *) arg)->val));
+							else
+								ereport(ERROR,
+										(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+										 errmsg("unsupported range bound expression")));
+						}
+						appendStringInfoChar(buf, ')');
+					}
+					break;
+
 				default:
 					ereport(ERROR, (errcode(ERRCODE_SYNTAX_ERROR),
 								errmsg("Invalid distribution type")));
@@ -88,6 +88,7 @@
 #include "utils/xml.h"
 
 #ifdef ADB
+#include "agtm/agtm_client.h"
 #include "commands/tablecmds.h"
 #include "nodes/nodes.h"
 #include "optimizer/pgxcship.h"
@@ -98,12 +99,20 @@
 #include "pgxc/pgxc.h"
 #include "pgxc/pgxcnode.h"
 #include "pgxc/poolmgr.h"
+#include "pgxc/redistrib.h"
+#include "pgxc/relstatcache.h"
+#include "pgxc/repcache.h"
+#include "pgxc/seqcache.h"
+#include "pgxc/xactstatuscache.h"
 #include "pgxc/xc_maintenance_mode.h"
 #include "optimizer/pgxcplan.h"
 #endif
 #if defined(ADBMGRD)
 #include "postmaster/adbmonitor.h"
 #endif /* ADBMGRD */
+#ifdef AGTM
+#include "agtm/agtm_light.h"
+#endif /* AGTM */
 
 
 #ifndef PG_KRB_SRVTAB
@@ -1306,6 +1315,33 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_skew_reduce", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of skew aware hash reduce for join."),
+			NULL
+		},
+		&enable_skew_reduce,
+		true,
+		NULL, NULL, NULL
+	},
+	{
+		{"enable_reduce_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of runtime bloom filter across cluster reduce for hash join."),
+			NULL
+		},
+		&enable_reduce_filter,
+		true,
+		NULL, NULL, NULL
+	},
+	{
+		{"enable_parallel_reduce", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of cluster reduce in parallel workers."),
+			NULL
+		},
+		&enable_parallel_reduce,
+		true,
+		NULL, NULL, NULL
+	},
 #endif
 	{
 		{"debug_print_rewritten", PGC_USERSET, LOGGING_WHAT,
@@ -1897,6 +1933,15 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_remote_insert_copy", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables sending rows of a multi-row remote INSERT to datanodes by COPY."),
+			NULL
+		},
+		&enable_remote_insert_copy,
+		true,
+		NULL, NULL, NULL
+	},
 	{
 		{"pgxc_enable_remote_query", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable the planner's use of remote query"),
@@ -1944,6 +1989,16 @@ static struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"reuse_global_snapshot", PGC_USERSET, GTM,
+			gettext_noop("Reuses the last AGTM snapshot of a transaction when no transaction ended since."),
+			NULL
+		},
+		&reuse_global_snapshot,
+		true,
+		NULL, NULL, NULL
+	},
+
 #if 0
 	{
 		{"gtm_backup_barrier", PGC_SUSET, QUERY_TUNING_METHOD,
@@ -2006,6 +2061,17 @@ static struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"pipeline_remote_insert", PGC_USERSET, XC_HOUSEKEEPING_OPTIONS,
+			gettext_noop("Doesn't wait for single row inserts shipped to one datanode."),
+			gettext_noop("Error of such insert is reported by a later statement "
+						 "of the transaction or by its commit.")
+		},
+		&pipeline_remote_insert,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"debug_enable_satisfy_mvcc", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Turn on HeapTupleSatisfiesMVCC always return true."),
@@ -3307,6 +3373,16 @@ static struct config_int ConfigureNamesInt[] =
 		check_agtm_port, NULL, NULL
 	},
 
+	{
+		{"agtm_light_port", PGC_SIGHUP, GTM,
+			gettext_noop("Port of AGTM snapshot and xid status service."),
+			gettext_noop("Zero gets them by the normal AGTM connection.")
+		},
+		&agtm_light_port,
+		0, 0, 65535,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"max_datanodes", PGC_POSTMASTER, DATA_NODES,
 			gettext_noop("Maximum number of Datanodes in the cluster."),
@@ -3328,6 +3404,68 @@ static struct config_int ConfigureNamesInt[] =
 		16, 2, 65535,
 		NULL, NULL, NULL
 	},
+
+	{
+		{"relstat_cache_size", PGC_POSTMASTER, DATA_NODES,
+			gettext_noop("Maximum number of relations in datanode size cache of coordinator."),
+			gettext_noop("Zero disables the cache.")
+		},
+		&relstat_cache_size,
+		0, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"relstat_cache_refresh_interval", PGC_SIGHUP, DATA_NODES,
+			gettext_noop("Time between refreshes of datanode size cache of coordinator."),
+			gettext_noop("Zero disables the use of cache."),
+			GUC_UNIT_S
+		},
+		&relstat_cache_refresh_interval,
+		60, 0, INT_MAX / 1000,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"seq_cache_size", PGC_POSTMASTER, DATA_NODES,
+			gettext_noop("Maximum number of sequences in shared sequence range cache of coordinator."),
+			gettext_noop("Zero disables the cache.")
+		},
+		&seq_cache_size,
+		0, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"xact_status_cache_size", PGC_POSTMASTER, DATA_NODES,
+			gettext_noop("Maximum number of global transaction status resolved by AGTM in shared cache."),
+			gettext_noop("Zero disables the cache.")
+		},
+		&xact_status_cache_size,
+		4096, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"rep_cache_size", PGC_USERSET, DATA_NODES,
+			gettext_noop("Sets the maximum memory of a session for results cached from replicated tables."),
+			gettext_noop("Only tables with coordinator_cache option are cached. Zero disables the cache."),
+			GUC_UNIT_KB
+		},
+		&rep_cache_size,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"redistrib_bucket_batch_size", PGC_USERSET, DATA_NODES,
+			gettext_noop("Number of hash buckets moved together by table redistribution."),
+			NULL
+		},
+		&redistrib_bucket_batch_size,
+		256, 1, HASH_SIZE,
+		NULL, NULL, NULL
+	},
 	{
 		{"pgxcnode_cancel_delay", PGC_USERSET, DATA_NODES,
 			gettext_noop("Cancel deay dulation at the coordinator."),
@@ -3384,6 +3522,26 @@ static struct config_int ConfigureNamesInt[] =
 		0, 0, 65535,
 		NULL, NULL, NULL
 	},
+
+	{
+		{"agtm_light_port", PGC_POSTMASTER, CONN_AUTH_SETTINGS,
+			gettext_noop("Sets the TCP port of snapshot and xid status service."),
+			gettext_noop("Zero disables the service.")
+		},
+		&agtm_light_port,
+		0, 0, 65535,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"agtm_light_max_clients", PGC_POSTMASTER, CONN_AUTH_SETTINGS,
+			gettext_noop("Sets the maximum number of snapshot and xid status service clients."),
+			NULL
+		},
+		&agtm_light_max_clients,
+		1000, 1, MAX_BACKENDS,
+		NULL, NULL, NULL
+	},
 #endif /* AGTM */
 
 	/* End-of-list marker */
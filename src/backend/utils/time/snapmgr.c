@@ -160,6 +160,18 @@ static Snapshot HistoricSnapshot = NULL;
 static Snapshot GlobalSnapshot = NULL;
 static bool GlobalSnapshotSet = false;
 static Snapshot RecentGTMSnapshot = NULL;
+
+/* xids of GlobalSnapshot belong to, see InterXactSerializeSnapshot */
+static GlobalSnapshotXidsId GlobalSnapshotXids;
+static bool GlobalSnapshotXidsValid = false;
+
+/* last AGTM snapshot of master coordinator, see GetAGTMSnapshot */
+static Snapshot LastAGTMSnapshot = NULL;
+static uint64 LastAGTMSnapshotSeq = 0;
+static LocalTransactionId LastAGTMSnapshotLxid = InvalidLocalTransactionId;
+
+/* GUC parameter */
+bool reuse_global_snapshot = true;
 #endif
 
 /*
@@ -236,6 +248,9 @@ static void FreeSnapshot(Snapshot snapshot);
 static void SnapshotResetXmin(void);
 #ifdef ADB
 static Snapshot CopyGlobalSnapshot(Snapshot snapshot);
+static Snapshot CopyGlobalSnapshotFrom(Snapshot snapshot, Snapshot src);
+static Snapshot GetAGTMSnapshot(Snapshot snapshot);
+static Snapshot MallocGlobalSnapshot(void);
 static void CreateRecentGTMSnapshot(void);
 #endif
 
@@ -2244,6 +2259,7 @@ OutputGlobalSnapshot(Snapshot snapshot)
 void
 SetGlobalSnapshot(StringInfo input_message)
 {
+	GlobalSnapshotXidsId xids_id;
 	uint32			xcnt;
 	int32			subxcnt;
 	int32			maxsubxcnt;
@@ -2268,37 +2284,60 @@ SetGlobalSnapshot(StringInfo input_message)
 	GlobalSnapshot->xmax = pq_getmsgint(input_message, sizeof(TransactionId));
 	/* curcid */
 	GlobalSnapshot->curcid = pq_getmsgint(input_message, sizeof(CommandId));
+	/* identity of xids */
+	xids_id.node = pq_getmsgint(input_message, sizeof(Oid));
+	xids_id.pid = pq_getmsgint(input_message, sizeof(int32));
+	xids_id.start = pq_getmsgint64(input_message);
+	xids_id.serial = pq_getmsgint64(input_message);
 	/* xcnt */
 	xcnt = pq_getmsgint(input_message, sizeof(uint32));
-	/* xip */
-	EnlargeSnapshotXip(GlobalSnapshot, xcnt);
-	for (i = 0; i < xcnt; i++)
-		GlobalSnapshot->xip[i] = pq_getmsgint(input_message, sizeof(TransactionId));
-	GlobalSnapshot->xcnt = xcnt;
-	/* subxcnt */
-	subxcnt = pq_getmsgint(input_message, sizeof(int32));
-	/* subxip */
-	if (subxcnt > 0)
+	if (xcnt == GLOBAL_SNAPSHOT_SAME_XIDS)
 	{
-		maxsubxcnt = GetMaxSnapshotSubxidCount();
-		if (subxcnt > maxsubxcnt)
-		{
-			subxcnt = maxsubxcnt;
-			suboverflowed = true;
-		}
-		if (GlobalSnapshot->subxip == NULL)
+		/* sender knows we have the xids already */
+		if (!GlobalSnapshotXidsValid ||
+			GlobalSnapshotXids.node != xids_id.node ||
+			GlobalSnapshotXids.pid != xids_id.pid ||
+			GlobalSnapshotXids.start != xids_id.start ||
+			GlobalSnapshotXids.serial != xids_id.serial)
+			ereport(ERROR,
+					(errcode(ERRCODE_PROTOCOL_VIOLATION),
+					 errmsg("xids of global snapshot %u/%d/" INT64_FORMAT " not found",
+							xids_id.node, xids_id.pid, xids_id.serial)));
+	}else
+	{
+		GlobalSnapshotXidsValid = false;
+		/* xip */
+		EnlargeSnapshotXip(GlobalSnapshot, xcnt);
+		for (i = 0; i < xcnt; i++)
+			GlobalSnapshot->xip[i] = pq_getmsgint(input_message, sizeof(TransactionId));
+		GlobalSnapshot->xcnt = xcnt;
+		/* subxcnt */
+		subxcnt = pq_getmsgint(input_message, sizeof(int32));
+		/* subxip */
+		if (subxcnt > 0)
 		{
-			subxip = (TransactionId *) malloc(maxsubxcnt * sizeof(TransactionId));
-			if (subxip == NULL)
-				ereport(ERROR,
-						(errcode(ERRCODE_OUT_OF_MEMORY),
-					  errmsg("Fail to malloc %d subxip of \"GlobalSnapshot\"", maxsubxcnt)));
-			GlobalSnapshot->subxip = subxip;
+			maxsubxcnt = GetMaxSnapshotSubxidCount();
+			if (subxcnt > maxsubxcnt)
+			{
+				subxcnt = maxsubxcnt;
+				suboverflowed = true;
+			}
+			if (GlobalSnapshot->subxip == NULL)
+			{
+				subxip = (TransactionId *) malloc(maxsubxcnt * sizeof(TransactionId));
+				if (subxip == NULL)
+					ereport(ERROR,
+							(errcode(ERRCODE_OUT_OF_MEMORY),
+						  errmsg("Fail to malloc %d subxip of \"GlobalSnapshot\"", maxsubxcnt)));
+				GlobalSnapshot->subxip = subxip;
+			}
+			GlobalSnapshot->subxcnt = subxcnt;
+			GlobalSnapshot->suboverflowed = suboverflowed;
+			for (i = 0; i < subxcnt; i++)
+					GlobalSnapshot->subxip[i] = pq_getmsgint(input_message, sizeof(TransactionId));
 		}
-		GlobalSnapshot->subxcnt = subxcnt;
-		GlobalSnapshot->suboverflowed = suboverflowed;
-		for (i = 0; i < subxcnt; i++)
-				GlobalSnapshot->subxip[i] = pq_getmsgint(input_message, sizeof(TransactionId));
+		GlobalSnapshotXids = xids_id;
+		GlobalSnapshotXidsValid = true;
 	}
 
 	GlobalSnapshotSet = true;
@@ -2322,22 +2361,71 @@ UnsetGlobalSnapshot(void)
 static Snapshot
 CopyGlobalSnapshot(Snapshot snapshot)
 {
-	Assert(snapshot && snapshot->xip && snapshot->subxip);
 	Assert(GlobalSnapshotSet);
 	Assert(GlobalSnapshot);
 
-	snapshot->xmin = GlobalSnapshot->xmin;
-	snapshot->xmax = GlobalSnapshot->xmax;
-	snapshot->curcid = GlobalSnapshot->curcid;
-	EnlargeSnapshotXip(snapshot, GlobalSnapshot->xcnt);
-	memcpy(snapshot->xip, GlobalSnapshot->xip,
-		GlobalSnapshot->xcnt * sizeof(TransactionId));
-	snapshot->xcnt = GlobalSnapshot->xcnt;
-	Assert(GlobalSnapshot->subxcnt <= GetMaxSnapshotSubxidCount());
-	snapshot->subxcnt = GlobalSnapshot->subxcnt;
-	snapshot->suboverflowed = GlobalSnapshot->suboverflowed;
-	memcpy(snapshot->subxip, GlobalSnapshot->subxip,
-		GlobalSnapshot->subxcnt * sizeof(TransactionId));
+	return CopyGlobalSnapshotFrom(snapshot, GlobalSnapshot);
+}
+
+static Snapshot
+CopyGlobalSnapshotFrom(Snapshot snapshot, Snapshot src)
+{
+	Assert(snapshot && snapshot->xip && snapshot->subxip);
+	Assert(src);
+
+	snapshot->xmin = src->xmin;
+	snapshot->xmax = src->xmax;
+	snapshot->curcid = src->curcid;
+	EnlargeSnapshotXip(snapshot, src->xcnt);
+	memcpy(snapshot->xip, src->xip,
+		src->xcnt * sizeof(TransactionId));
+	snapshot->xcnt = src->xcnt;
+	Assert(src->subxcnt <= GetMaxSnapshotSubxidCount());
+	snapshot->subxcnt = src->subxcnt;
+	snapshot->suboverflowed = src->suboverflowed;
+	memcpy(snapshot->subxip, src->subxip,
+		src->subxcnt * sizeof(TransactionId));
+	return snapshot;
+}
+
+/*
+ * Master-Coordinator get snapshot from AGTM.
+ *
+ * Read committed transactions take a snapshot for every statement.  When
+ * no transaction ended on AGTM since the last snapshot of this transaction
+ * was taken, that snapshot is still the same, AGTM only says so and it is
+ * used again.  It is not reused by the next transaction, whose start
+ * timestamp comes with a new snapshot.
+ */
+static Snapshot
+GetAGTMSnapshot(Snapshot snapshot)
+{
+	uint64		commit_seq;
+
+	if (reuse_global_snapshot &&
+		LastAGTMSnapshot != NULL &&
+		LocalTransactionIdIsValid(MyProc->lxid) &&
+		LastAGTMSnapshotLxid == MyProc->lxid)
+	{
+		commit_seq = LastAGTMSnapshotSeq;
+		if (!agtm_GetGlobalSnapShotIfChanged(snapshot, true, &commit_seq))
+			return CopyGlobalSnapshotFrom(snapshot, LastAGTMSnapshot);
+	}else
+	{
+		agtm_GetGlobalSnapShotIfChanged(snapshot, false, &commit_seq);
+	}
+
+	if (reuse_global_snapshot)
+	{
+		/* forget old one first, in case of error */
+		LastAGTMSnapshotLxid = InvalidLocalTransactionId;
+		if (LastAGTMSnapshot == NULL)
+			LastAGTMSnapshot = MallocGlobalSnapshot();
+		CopyGlobalSnapshotFrom(LastAGTMSnapshot, snapshot);
+		LastAGTMSnapshotSeq = commit_seq;
+		LastAGTMSnapshotLxid = MyProc->lxid;
+	}
+
 	return snapshot;
 }
 
@@ -2352,10 +2440,7 @@ GetGlobalSnapshot(Snapshot snapshot)
 
 	if (IsCoordMaster())
 	{
-		/*
-	 	 * Master-Coordinator get snapshot from AGTM.
-	 	 */
-		snap = agtm_GetGlobalSnapShot(snapshot);
+		snap = GetAGTMSnapshot(snapshot);
 	} else if (GlobalSnapshot == NULL ||
 		GlobalSnapshotSet == false ||
 		IsAnyAutoVacuumProcess())
@@ -2397,33 +2482,39 @@ GetGlobalSnapshot(Snapshot snapshot)
 	return snap;
 }
 
-static void CreateRecentGTMSnapshot(void)
+static Snapshot MallocGlobalSnapshot(void)
 {
-	if (RecentGTMSnapshot == NULL)
+	Snapshot volatile snapshot;
+
+	snapshot = (Snapshot) malloc(sizeof(*snapshot));
+	if (snapshot == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+			  errmsg("Fail to memory alloc global snapshot")));
+	memset(snapshot, 0, sizeof(*snapshot));
+
+	PG_TRY();
 	{
-		RecentGTMSnapshot = (Snapshot) malloc(sizeof(*RecentGTMSnapshot));
-		if (RecentGTMSnapshot == NULL)
+		EnlargeSnapshotXip(snapshot, GetMaxSnapshotXidCount());
+		snapshot->subxip = malloc(GetMaxSnapshotSubxidCount() * sizeof(TransactionId));
+		if (snapshot->subxip == NULL)
 			ereport(ERROR,
 					(errcode(ERRCODE_OUT_OF_MEMORY),
-				  errmsg("Fail to memory alloc \"RecentGTMSnapshot\"")));
-		memset(RecentGTMSnapshot, 0, sizeof(*RecentGTMSnapshot));
+					errmsg("fail to malloc global snapshot")));
+	}PG_CATCH();
+	{
+		free(snapshot->xip);
+		free(snapshot);
+		PG_RE_THROW();
+	}PG_END_TRY();
 
-		PG_TRY();
-		{
-			EnlargeSnapshotXip(RecentGTMSnapshot, GetMaxSnapshotXidCount());
-			RecentGTMSnapshot->subxip = malloc(GetMaxSnapshotSubxidCount() * sizeof(TransactionId));
-			if (RecentGTMSnapshot->subxip == NULL)
-				ereport(ERROR,
-						(errcode(ERRCODE_OUT_OF_MEMORY),
-						errmsg("fail to malloc RecentGTMSnapshot")));
-		}PG_CATCH();
-		{
-			free(RecentGTMSnapshot->xip);
-			free(RecentGTMSnapshot);
-			RecentGTMSnapshot = NULL;
-			PG_RE_THROW();
-		}PG_END_TRY();
-	}
+	return snapshot;
+}
+
+static void CreateRecentGTMSnapshot(void)
+{
+	if (RecentGTMSnapshot == NULL)
+		RecentGTMSnapshot = MallocGlobalSnapshot();
 }
 
 Snapshot GetRecentGTMSnapshot(bool refurbish)
@@ -20,6 +20,7 @@
 #include "utils/memutils.h"		/* for MemoryContext */
 
 static int  HandlePlanMsg(RdcPort *work_port, PlanPort *pln_port);
+static bool PlanEofIsComplete(StringInfo msg, int msg_len, PlanPort *pln_port);
 static void HandleRdcMsg(RdcPort *rdc_port, List **pln_nodes);
 static void HandleReadFromRdc(RdcPort *port, List **pln_nodes);
 static void HandleWriteToRdc(RdcPort *port);
@@ -29,6 +30,7 @@ static bool WritePlanEndToPlanHook(const char *data, int datalen, void *context)
 static bool SendPlanMsgToPlan(PlanPort *pln_port, char msg_type, RdcPortId rdc_id, const char *data, int datalen);
 static bool SendPlanDataToPlan(PlanPort *pln_port, RdcPortId rdc_id, const char *data, int datalen);
 static bool SendPlanEofToPlan(PlanPort *pln_port, RdcPortId rdc_id, bool error_if_exists);
+static bool SendPlanStatToPlan(PlanPort *pln_port);
 static bool SendPlanCloseToPlan(PlanPort *pln_port, RdcPortId rdc_id);
 static bool SendPlanRejectToPlan(PlanPort *pln_port, RdcPortId rdc_id);
 static int  SendPlanDataToRdc(StringInfo msg, PlanPort *pln_port);
@@ -141,6 +143,7 @@ HandlePlanMsg(RdcPort *work_port, PlanPort *pln_port)
 	char			msg_type;
 	int				msg_len;
 	int				sv_cursor;
+	int				msg_end;
 	int				res = 0;
 
 	Assert(RdcPeerID(work_port) == PlanID(pln_port));
@@ -194,14 +197,26 @@ HandlePlanMsg(RdcPort *work_port, PlanPort *pln_port)
 						 "recv EOF message from" RDC_PORT_PRINT_FORMAT,
 						 RDC_PORT_PRINT_VALUE(work_port));
 
+					/*
+					 * EOF of a plan node run by parallel workers is sent
+					 * to other reduce after all workers sent it.
+					 */
+					msg_end = msg->cursor + msg_len;
+					if (!PlanEofIsComplete(msg, msg_len, pln_port))
+					{
+						msg->cursor = msg_end;
+						break;
+					}
+
 					/* msg contains the target nodes(number and RdcPortIds) */
-					if (SendPlanEofToRdc(msg, pln_port))
+					res = SendPlanEofToRdc(msg, pln_port);
+					msg->cursor = msg_end;
+					if (res)
 					{
 						/*
 						 * flush to other reduce would block,
 						 * and we try to read from plan next time.
 						 */
-						res = 1;
 						quit = true;	/* break while */
 					}
 				}
@@ -226,7 +241,11 @@ HandlePlanMsg(RdcPort *work_port, PlanPort *pln_port)
 					quit = true;	/* break while */
 					res = EOF;
 
-					(void) SendPlanCloseToRdc(msg, pln_port);
+					/* other workers of the plan node may still send data */
+					if (PlanWorkNum(pln_port) == 0)
+						(void) SendPlanCloseToRdc(msg, pln_port);
+					else
+						msg->cursor += msg_len;
 				}
 				break;
 			case MSG_PLAN_REJECT:
@@ -264,6 +283,38 @@ HandlePlanMsg(RdcPort *work_port, PlanPort *pln_port)
 	return res;
 }
 
+/*
+ * PlanEofIsComplete
+ *
+ * A plan node run by parallel workers sends EOF message from each worker,
+ * the last finished one appends the number of workers and others append 0.
+ * Message of a plan node without parallel workers has nothing appended.
+ *
+ * Returns true if EOF messages of all workers are got, the cursor of msg
+ * is not moved.
+ */
+static bool
+PlanEofIsComplete(StringInfo msg, int msg_len, PlanPort *pln_port)
+{
+	int			sv_cursor = msg->cursor;
+	int			num;
+	int			nworkers = 1;
+
+	num = rdc_getmsgint(msg, sizeof(num));
+	while (num-- > 0)
+		(void) rdc_getmsgRdcPortID(msg);
+	if (msg->cursor < sv_cursor + msg_len)
+		nworkers = rdc_getmsgint(msg, sizeof(nworkers));
+	msg->cursor = sv_cursor;
+
+	pln_port->pln_eof_num++;
+	if (nworkers > 0)
+		pln_port->pln_eof_need = nworkers;
+
+	return pln_port->pln_eof_need > 0 &&
+		   pln_port->pln_eof_num >= pln_port->pln_eof_need;
+}
+
 /*
  * HandleReadFromPlan
  *
@@ -430,6 +481,7 @@ WritePlanEndToPlanHook(const char *data, int datalen, void *context)
 			appendBinaryStringInfo(buf2, data, datalen);
 			wrk_port = RdcNext(wrk_port);
 		}
+		appendBinaryStringInfo(&(pln_port->end_msgs), data, datalen);
 
 		is_plan_end = true;
 	}
@@ -749,9 +801,36 @@ SendPlanEofToPlan(PlanPort *pln_port, RdcPortId rdc_id, bool error_if_exists)
 	} else
 		pln_port->rdc_eofs[pln_port->eof_num++] = rdc_id;
 
+	/* plan node stops reading after the last EOF, so tell statistics now */
+	if (pln_port->eof_num == pln_port->rdc_num - 1)
+		(void) SendPlanStatToPlan(pln_port);
+
 	return SendPlanMsgToPlan(pln_port, MSG_EOF, rdc_id, NULL, 0);
 }
 
+/*
+ * SendPlanStatToPlan
+ *
+ * send statistics of PlanPort to plan node for EXPLAIN ANALYZE.
+ */
+static bool
+SendPlanStatToPlan(PlanPort *pln_port)
+{
+	StringInfoData	buf;
+	uint64			spill;
+	bool			res;
+
+	Assert(pln_port);
+	spill = pln_port->rdcstore ? pln_port->rdcstore->totalSpill : 0;
+
+	initStringInfo(&buf);
+	rdc_sendint64(&buf, (int64) spill);
+	res = SendPlanMsgToPlan(pln_port, MSG_R2P_STAT, MyReduceId, buf.data, buf.len);
+	pfree(buf.data);
+
+	return res;
+}
+
 /*
  * SendPlanCloseToPlan
  *
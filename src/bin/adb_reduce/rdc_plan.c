@@ -52,6 +52,9 @@ plan_newport(RdcPortId pln_id)
 	pln_port->send_to_pln = 0;
 	pln_port->rdcstore = rdcstore_begin(sflags, work_mem, "PLAN", pln_id,
 										MyProcPid, MyBossPid, MyStartTime);
+	pln_port->pln_eof_num = 0;
+	pln_port->pln_eof_need = 0;
+	initStringInfo(&(pln_port->end_msgs));
 	pln_port->rdc_num = rdc_num;
 	pln_port->eof_num = 0;
 	for (i = 0; i < rdc_num; i++)
@@ -79,6 +82,8 @@ plan_freeport(PlanPort *pln_port)
 		rdcstore_end(pln_port->rdcstore);
 		pfree(pln_port->msg_buf.data);
 		pln_port->msg_buf.data = NULL;
+		pfree(pln_port->end_msgs.data);
+		pln_port->end_msgs.data = NULL;
 		safe_pfree(pln_port);
 	}
 }
@@ -183,5 +188,17 @@ AddNewPlanPort(List **pln_nodes, RdcPort *new_port)
 			RdcNext(work_port) = new_port;
 		}
 		pln_port->work_num++;
+
+		/*
+		 * A parallel worker may connect after EOF messages of other reduce
+		 * were sent to its siblings, send them to it too.
+		 */
+		if (pln_port->end_msgs.len > 0)
+		{
+			appendBinaryStringInfo(RdcOutBuf2(new_port),
+								   pln_port->end_msgs.data,
+								   pln_port->end_msgs.len);
+			RdcWaitEvents(new_port) |= WT_SOCK_WRITEABLE;
+		}
 	}
 }
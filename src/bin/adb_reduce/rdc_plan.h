@@ -27,6 +27,10 @@ struct PlanPort
 	uint64				dscd_from_rdc;	/* number of slot discarded from other reduce */
 	uint64				recv_from_rdc;	/* number of slot received from other reduce */
 	uint64				send_to_pln;	/* number of slot sent to plan node */
+	int					pln_eof_num;	/* number of EOF message got from parallel workers */
+	int					pln_eof_need;	/* number of parallel workers sending EOF, 0 if unknown yet */
+	StringInfoData		end_msgs;		/* EOF and CLOSE messages sent to workers, replayed
+										   to the worker connected late */
 	int					rdc_num;		/* number of reduce group */
 	int					eof_num;		/* number of EOF message got from other reduce */
 	RdcPortId			rdc_eofs[1];	/* array of RdcPortId which already send EOF message */
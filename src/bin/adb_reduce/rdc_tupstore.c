@@ -179,6 +179,7 @@ rdcstore_begin_common(int sflags, int maxKBytes, char *purpose, int nodeId,
 	USEMEM(state, GetMemoryChunkSpace(state->purpose));
 
 	state->totalRead = state->totalWrite = 0;
+	state->totalSpill = 0;
 	return state;
 }
 
@@ -536,6 +537,7 @@ rdcWriteTuple(RSstate *state, void *tup)
 					 			rdData->len) != (size_t) rdData->len)
 			elog(ERROR, "write tuple data failed");
 
+	state->totalSpill += sizeof(rdData->len) + rdData->len;
 	FREEMEM(state, RDC_GET_DATA_MEM(rdData));
 
 	/* free tuple memory */
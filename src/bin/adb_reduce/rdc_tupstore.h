@@ -102,6 +102,7 @@ typedef struct ReduceStorestate
 	/* statistics */
 	unsigned long	totalWrite;
 	unsigned long	totalRead;
+	uint64			totalSpill;		/* bytes written to temp file */
 } RSstate;
 
 #define RSstateInMemMode(state)		(((RSstate *)(state))->sflags & RS_FLAG_ONLY_MEMORY)
@@ -65,6 +65,23 @@
 #include "fe_utils/string_utils.h"
 
 
+#ifdef ADB
+/*
+ * Arguments of DISTRIBUTE BY RANGE of a table: its node names in range order
+ * with the bounds between them, NULL if the table is not distributed by range
+ */
+#define PGXC_RANGE_ARGS_QUERY \
+	"(SELECT string_agg(r.arg, ', ' ORDER BY r.ord) FROM (" \
+	"SELECT 2 * m.ord AS ord, quote_ident(n.node_name::text) AS arg " \
+	"FROM pgxc_class v, unnest(v.pcbucketmap) WITH ORDINALITY m(idx, ord), pgxc_node n " \
+	"WHERE v.pcrelid = c.oid AND v.pclocatortype = 'G' AND n.oid = v.nodeoids[m.idx] " \
+	"UNION ALL " \
+	"SELECT 2 * b.ord + 1, quote_literal(b.val) || '::' || format_type(a.atttypid, a.atttypmod) " \
+	"FROM pgxc_class v JOIN pg_attribute a ON a.attrelid = v.pcrelid AND a.attnum = v.pcattnum, " \
+	"unnest(v.pcrangebounds::text::text[]) WITH ORDINALITY b(val, ord) " \
+	"WHERE v.pcrelid = c.oid AND v.pclocatortype = 'G') r) AS pgxcrangeargs, "
+#endif
+
 typedef struct
 {
 	const char *descr;			/* comment for an object */
@@ -5380,7 +5397,9 @@ getTables(Archive *fout, int *numTables)
 #ifdef ADB
 	int 		i_pgxclocatortype;
 	int 		i_pgxcattnum;
+	int 		i_pgxchashalgorithm;
 	int 		i_pgxc_node_names;
+	int 		i_pgxcrangeargs;
 #endif
 	int			i_reltablespace;
 	int			i_reloptions;
@@ -5460,7 +5479,9 @@ getTables(Archive *fout, int *numTables)
 #ifdef ADB
 						  "(SELECT pclocatortype from pgxc_class v where v.pcrelid = c.oid) AS pgxclocatortype,"
 						  "(SELECT pcattnum from pgxc_class v where v.pcrelid = c.oid) AS pgxcattnum,"
+						  "(SELECT pchashalgorithm from pgxc_class v where v.pcrelid = c.oid) AS pgxchashalgorithm,"
 						  "(SELECT '\"' || string_agg(node_name,'\",\"') || '\"' AS pgxc_node_names from pgxc_node n where n.oid in (select unnest(nodeoids) from pgxc_class v where v.pcrelid=c.oid) ) , "
+						  PGXC_RANGE_ARGS_QUERY
 #endif
 						  "array_remove(array_remove(c.reloptions,'check_option=local'),'check_option=cascaded') AS reloptions, "
 						  "CASE WHEN 'check_option=local' = ANY (c.reloptions) THEN 'LOCAL'::text "
@@ -5542,7 +5563,9 @@ getTables(Archive *fout, int *numTables)
 #ifdef ADB
 						  "(SELECT pclocatortype from pgxc_class v where v.pcrelid = c.oid) AS pgxclocatortype,"
 						  "(SELECT pcattnum from pgxc_class v where v.pcrelid = c.oid) AS pgxcattnum,"
+						  "(SELECT pchashalgorithm from pgxc_class v where v.pcrelid = c.oid) AS pgxchashalgorithm,"
 						  "(SELECT '\"' || string_agg(node_name,'\",\"') || '\"' AS pgxc_node_names from pgxc_node n where n.oid in (select unnest(nodeoids) from pgxc_class v where v.pcrelid=c.oid) ) , "
+						  PGXC_RANGE_ARGS_QUERY
 #endif
 
 						  "array_remove(array_remove(c.reloptions,'check_option=local'),'check_option=cascaded') AS reloptions, "
@@ -5594,7 +5617,9 @@ getTables(Archive *fout, int *numTables)
 #ifdef ADB
 						  "(SELECT pclocatortype from pgxc_class v where v.pcrelid = c.oid) AS pgxclocatortype,"
 						  "(SELECT pcattnum from pgxc_class v where v.pcrelid = c.oid) AS pgxcattnum,"
+						  "(SELECT pchashalgorithm from pgxc_class v where v.pcrelid = c.oid) AS pgxchashalgorithm,"
 						  "(SELECT '\"' || string_agg(node_name,'\",\"') || '\"' AS pgxc_node_names from pgxc_node n where n.oid in (select unnest(nodeoids) from pgxc_class v where v.pcrelid=c.oid) ) , "
+						  PGXC_RANGE_ARGS_QUERY
 #endif
 						  "array_remove(array_remove(c.reloptions,'check_option=local'),'check_option=cascaded') AS reloptions, "
 						  "CASE WHEN 'check_option=local' = ANY (c.reloptions) THEN 'LOCAL'::text "
@@ -5646,7 +5671,9 @@ getTables(Archive *fout, int *numTables)
 #ifdef ADB
 						  "(SELECT pclocatortype from pgxc_class v where v.pcrelid = c.oid) AS pgxclocatortype,"
 						  "(SELECT pcattnum from pgxc_class v where v.pcrelid = c.oid) AS pgxcattnum,"
+						  "(SELECT pchashalgorithm from pgxc_class v where v.pcrelid = c.oid) AS pgxchashalgorithm,"
 						  "(SELECT '\"' || string_agg(node_name,'\",\"') || '\"' AS pgxc_node_names from pgxc_node n where n.oid in (select unnest(nodeoids) from pgxc_class v where v.pcrelid=c.oid) ) , "
+						  PGXC_RANGE_ARGS_QUERY
 #endif
 
 
@@ -6081,7 +6108,9 @@ getTables(Archive *fout, int *numTables)
 #ifdef ADB
 	i_pgxclocatortype = PQfnumber(res, "pgxclocatortype");
 	i_pgxcattnum = PQfnumber(res, "pgxcattnum");
+	i_pgxchashalgorithm = PQfnumber(res, "pgxchashalgorithm");
 	i_pgxc_node_names = PQfnumber(res, "pgxc_node_names");
+	i_pgxcrangeargs = PQfnumber(res, "pgxcrangeargs");
 #endif
 
 	i_reltablespace = PQfnumber(res, "reltablespace");
@@ -6159,13 +6188,19 @@ getTables(Archive *fout, int *numTables)
 		{
 			tblinfo[i].pgxclocatortype = 'E';
 			tblinfo[i].pgxcattnum = 0;
+			tblinfo[i].pgxchashalgorithm = 0;
 		}
 		else
 		{
 			tblinfo[i].pgxclocatortype = *(PQgetvalue(res, i, i_pgxclocatortype));
 			tblinfo[i].pgxcattnum = atoi(PQgetvalue(res, i, i_pgxcattnum));
+			tblinfo[i].pgxchashalgorithm = atoi(PQgetvalue(res, i, i_pgxchashalgorithm));
 		}
 		tblinfo[i].pgxc_node_names = pg_strdup(PQgetvalue(res, i, i_pgxc_node_names));
+		if (PQgetisnull(res, i, i_pgxcrangeargs))
+			tblinfo[i].pgxcrangeargs = NULL;
+		else
+			tblinfo[i].pgxcrangeargs = pg_strdup(PQgetvalue(res, i, i_pgxcrangeargs));
 #endif
 
 
@@ -15523,11 +15558,12 @@ dumpTableSchema(Archive *fout, TableInfo *tbinfo)
 			{
 				appendPQExpBuffer(q, "\nDISTRIBUTE BY REPLICATION");
 			}
-			/* H: DISTRIBUTE BY HASH  */
+			/* H: DISTRIBUTE BY HASH or BUCKET (hash algorithm 2) */
 			else if (tbinfo->pgxclocatortype == 'H')
 			{
 				int hashkey = tbinfo->pgxcattnum;
-				appendPQExpBuffer(q, "\nDISTRIBUTE BY HASH (%s)",
+				appendPQExpBuffer(q, "\nDISTRIBUTE BY %s (%s)",
+					tbinfo->pgxchashalgorithm == 2 ? "BUCKET" : "HASH",
 					fmtId(tbinfo->attnames[hashkey - 1]));
 			}
 			else if (tbinfo->pgxclocatortype == 'M')
@@ -15536,6 +15572,15 @@ dumpTableSchema(Archive *fout, TableInfo *tbinfo)
 				appendPQExpBuffer(q, "\nDISTRIBUTE BY MODULO (%s)",
 				fmtId(tbinfo->attnames[hashkey - 1]));
 			}
+			/* G: DISTRIBUTE BY RANGE with its nodes and bounds */
+			else if (tbinfo->pgxclocatortype == 'G')
+			{
+				int rangekey = tbinfo->pgxcattnum;
+				appendPQExpBuffer(q, "\nDISTRIBUTE BY RANGE (%s%s%s)",
+					fmtId(tbinfo->attnames[rangekey - 1]),
+					tbinfo->pgxcrangeargs ? ", " : "",
+					tbinfo->pgxcrangeargs ? tbinfo->pgxcrangeargs : "");
+			}
 		}
 		if (include_nodes &&
 			tbinfo->pgxc_node_names != NULL &&
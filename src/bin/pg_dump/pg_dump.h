@@ -292,7 +292,9 @@ typedef struct _tableInfo
 		/* PGXC table locator Data */
 		char		pgxclocatortype;	/* Type of PGXC table locator */
 		int 		pgxcattnum; 	/* Number of the attribute the table is partitioned with */
+		int 		pgxchashalgorithm;	/* Hash algorithm of hash distributed table */
 		char		*pgxc_node_names;	/* List of node names where this table is distributed */
+		char		*pgxcrangeargs;	/* Nodes and bounds of range distributed table */
 #endif
 
 	/*
@@ -27,9 +27,11 @@
 #ifdef ADB
 #define LOCATOR_TYPE_REPLICATED 'R'
 #define LOCATOR_TYPE_HASH 'H'
+#define LOCATOR_TYPE_RANGE 'G'
 #define LOCATOR_TYPE_RROBIN 'N'
 #define LOCATOR_TYPE_MODULO 'M'
 #define LOCATOR_TYPE_USER_DEFINED 'U'
+#define LOCATOR_HASH_BUCKET 2
 #endif
 
 
@@ -2693,10 +2695,14 @@ describeOneTableDetails(const char *schemaname,
 						"		  WHEN '%c' THEN \n"
 						"		   'REPLICATION' \n"
 						"		  WHEN '%c' THEN \n"
-						"		   'HASH' || '(' || a.attname || ')' \n"
+						"		   CASE pchashalgorithm WHEN %d THEN 'BUCKET' ELSE 'HASH' END \n"
+						"		   || '(' || a.attname || ')' \n"
 						"		  WHEN '%c' THEN \n"
 						"		   'MODULO' || '(' || a.attname || ')' \n"
 						"		  WHEN '%c' THEN \n"
+						"		   'RANGE' || '(' || a.attname || ') ' \n"
+						"		   || coalesce(pcrangebounds::pg_catalog.text, '{}') \n"
+						"		  WHEN '%c' THEN \n"
 						"		   (SELECT proname FROM pg_catalog.pg_proc WHERE oid = pcfuncid) || '(' || \n"
 						"		   array_to_string(ARRAY \n"
 						"						   (SELECT attname \n"
@@ -2730,7 +2736,9 @@ describeOneTableDetails(const char *schemaname,
 					, LOCATOR_TYPE_RROBIN
 					, LOCATOR_TYPE_REPLICATED
 					, LOCATOR_TYPE_HASH
+					, LOCATOR_HASH_BUCKET
 					, LOCATOR_TYPE_MODULO
+					, LOCATOR_TYPE_RANGE
 					, LOCATOR_TYPE_USER_DEFINED
 					, oid
 					, oid
@@ -45,12 +45,19 @@ extern TransactionId agtm_GetGlobalTransactionId(bool isSubXact);
  * get Snapshot info from AGTM
  */
 extern Snapshot agtm_GetGlobalSnapShot(Snapshot snapshot);
+extern bool agtm_GetGlobalSnapShotIfChanged(Snapshot snapshot, bool only_changed,
+											uint64 *commit_seq);
 
 /*
  * get transaction status from AGTM by transaction ID.
  */
 extern XidStatus agtm_TransactionIdGetStatus(TransactionId xid, XLogRecPtr *lsn);
 
+/*
+ * get status of a list of transactions from AGTM.
+ */
+extern void agtm_TransactionIdsGetStatus(int nxid, const TransactionId *xids, XidStatus *status);
+
 /*
  * synchronize transaction ID with AGTM.
  */
@@ -110,6 +117,12 @@ extern void agtm_RenameSeuqneceByDataBase(const char * oldDatabase,
  */
 extern AGTM_Sequence agtm_GetSeqNextVal(const char *seqname, const char * database,	const char * schema);
 
+/*
+ * reserve count values of Sequence from AGTM, returns first value
+ */
+extern AGTM_Sequence agtm_GetSeqNextRange(const char *seqname, const char * database,
+			const char * schema, int64 count, AGTM_Sequence *last, int64 *increment);
+
 /*
  * get current Sequence from AGTM
  */
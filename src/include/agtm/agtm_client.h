@@ -45,4 +45,9 @@ extern StringInfo agtm_use_result_type(const struct pg_result *res, StringInfo b
 extern void agtm_check_result(StringInfo buf, AGTM_ResultType type);
 extern void agtm_use_result_end(struct pg_result *res, StringInfo buf);
 
+/* AGTM light service for snapshot and xid status */
+extern int agtm_light_port;
+extern bool agtm_light_request(AGTM_MessageType msg, const char *data, int len, StringInfo buf);
+extern void agtm_light_close(void);
+
 #endif
@@ -0,0 +1,30 @@
+/*-------------------------------------------------------------------------
+ *
+ * agtm_light.h
+ *
+ *	  Definitions for the event-driven AGTM snapshot and xid status service
+ *
+ * Portions Copyright (c) 2016, ASIAINFO BDX ADB Group
+ *
+ * src/include/agtm/agtm_light.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef AGTM_LIGHT_H
+#define AGTM_LIGHT_H
+
+#include "postgres.h"
+#include "agtm/agtm_msg.h"
+
+/* largest request accepted by the service, a full xid status batch */
+#define AGTM_LIGHT_MAX_REQUEST	((int) (12 + sizeof(TransactionId) * AGTM_XACT_STATUS_BATCH_MAX))
+
+/* GUC parameters */
+extern int agtm_light_port;
+extern int agtm_light_max_clients;
+
+extern void AGtmLightRegister(void);
+extern void AGtmLightMain(Datum main_arg);
+
+#endif /* AGTM_LIGHT_H */
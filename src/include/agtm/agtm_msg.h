@@ -25,7 +25,9 @@ typedef enum AGTM_MessageType
 	AGTM_MSG_GET_TIMESTAMP,
 	AGTM_MSG_GXID_LIST,
 	AGTM_MSG_SNAPSHOT_GET,		/* Get a global snapshot */
+	AGTM_MSG_SNAPSHOT_GET_IF_CHANGED,	/* Get it unless no xact ended since */
 	AGTM_MSG_GET_XACT_STATUS,	/* Get transaction status by xid */
+	AGTM_MSG_GET_XACT_STATUS_BATCH,	/* Get status of a list of xids */
 	AGTM_MSG_SYNC_XID,			/* Sync XID with AGTM */
 	AGTM_MSG_SEQUENCE_INIT,
 	AGTM_MSG_SEQUENCE_ALTER,
@@ -34,6 +36,7 @@ typedef enum AGTM_MessageType
 	AGTM_MSG_SEQUENCE_RENAME,
 	AGTM_MSG_SEQUENCE_RENAME_BYDB,
 	AGTM_MSG_SEQUENCE_GET_NEXT,	/* Get the next sequence value of sequence */
+	AGTM_MSG_SEQUENCE_GET_RANGE,	/* Reserve a range of sequence values */
 	AGTM_MSG_SEQUENCE_GET_CUR,
 	AGTM_MSG_SEQUENCE_GET_LAST,	/* Get the last sequence value of sequence */
 	AGTM_MSG_SEQUENCE_SET_VAL,	/* Set values for sequence */
@@ -53,7 +56,9 @@ typedef enum AGTM_ResultType
 	AGTM_GET_TIMESTAMP_RESULT,
 	AGTM_GXID_LIST_RESULT,
 	AGTM_SNAPSHOT_GET_RESULT,
+	AGTM_SNAPSHOT_UNCHANGED_RESULT,
 	AGTM_GET_XACT_STATUS_RESULT,
+	AGTM_GET_XACT_STATUS_BATCH_RESULT,
 	AGTM_SYNC_XID_RESULT,
 	AGTM_MSG_SEQUENCE_INIT_RESULT,
 	AGTM_MSG_SEQUENCE_ALTER_RESULT,
@@ -62,6 +67,7 @@ typedef enum AGTM_ResultType
 	AGTM_MSG_SEQUENCE_RENAME_RESULT,
 	AGTM_MSG_SEQUENCE_RENAME_BYDB_RESULT,
 	AGTM_SEQUENCE_GET_NEXT_RESULT,
+	AGTM_SEQUENCE_GET_RANGE_RESULT,
 	AGTM_MSG_SEQUENCE_GET_CUR_RESULT,
 	AGTM_SEQUENCE_GET_LAST_RESULT,
 	AGTM_SEQUENCE_SET_VAL_RESULT,
@@ -70,6 +76,9 @@ typedef enum AGTM_ResultType
 } AGTM_ResultType;
 #define AGTM_RESULT_TYPE_COUNT (AGTM_COMPLETE_RESULT+1)
 
+/* max count of xids in one AGTM_MSG_GET_XACT_STATUS_BATCH message */
+#define AGTM_XACT_STATUS_BATCH_MAX	256
+
 typedef enum AgtmNodeTag
 {
 	T_AgtmInvalid = 0,
@@ -20,6 +20,12 @@
 
 StringInfo ProcessNextSeqCommand(StringInfo message, StringInfo output);
 
+/*
+ *  reserve a range of values for the shared sequence cache of a coordinator,
+ *  responds first value, last value and increment of the range
+ */
+StringInfo ProcessNextSeqRangeCommand(StringInfo message, StringInfo output);
+
 /*
  *  select currval('seq1') will call this fucntion.function currval('sequence') called
  *  must after nextval('sequence') called and in the same session .otherwise function
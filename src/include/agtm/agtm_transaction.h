@@ -23,8 +23,10 @@ StringInfo ProcessGetGXIDCommand(StringInfo message, StringInfo output);
 StringInfo ProcessGetTimestamp(StringInfo message, StringInfo output);
 
 StringInfo ProcessGetSnapshot(StringInfo message, StringInfo output);
+StringInfo ProcessGetSnapshotIfChanged(StringInfo message, StringInfo output);
 
 StringInfo ProcessGetXactStatus(StringInfo message, StringInfo output);
+StringInfo ProcessGetXactStatusBatch(StringInfo message, StringInfo output);
 
 StringInfo ProcessSyncXID(StringInfo message, StringInfo output);
 
@@ -1131,7 +1131,7 @@ extern int	fdatasync(int fildes);
 #define NON_EXEC_STATIC static
 #endif
 
-#if defined(ADB) || defined(ADBMGRD)
+#if defined(ADB) || defined(ADBMGRD) || defined(AGTM)
 #define AGTM_DBNAME "postgres"
 #define AGTM_USER "postgres"
 #endif
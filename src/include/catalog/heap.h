@@ -152,7 +152,9 @@ extern void GetRelationDistributionItems(Oid relid,
 				AttrNumber *attnum,
 				Oid *funcid,
 				int *numatts,
-				int16 **attnums);
+				int16 **attnums,
+				Datum *rangebounds,
+				List **rangenodes);
 
 extern Oid *GetRelationDistributionNodes(PGXCSubCluster *subcluster, int *numnodes);
 
@@ -5583,6 +5583,11 @@ DESCR("show current nextXid");
 DATA(insert OID = 3376 ( sync_local_xid	 PGNSP PGUID 12 10 100 0 0 f f f f t t s s 0 0 2249 "" "{28,28}" "{o,o}" "{local,agtm}" _null_ _null_ sync_local_xid _null_ _null_ _null_ ));
 DESCR("synchronize the local next XID with AGTM");
 
+DATA(insert OID = 3377 ( adb_rep_cache_invalidate	PGNSP PGUID 12 1 0 0 0 f f f f t f v u 1 0 2278 "2205" _null_ _null_ _null_ _null_ _null_ adb_rep_cache_invalidate _null_ _null_ _null_ ));
+DESCR("drop cached results of a replicated table on coordinator at commit");
+DATA(insert OID = 3378 ( adb_seq_cache_invalidate	PGNSP PGUID 12 1 0 0 0 f f f f t f v u 1 0 2278 "2205" _null_ _null_ _null_ _null_ _null_ adb_seq_cache_invalidate _null_ _null_ _null_ ));
+DESCR("discard sequence value ranges cached on coordinator");
+
 #endif /* ADB */
 
 #ifdef ADBMGRD
@@ -67,6 +67,7 @@ DECLARE_TOAST(pg_shseclabel, 4060, 4061);
 DECLARE_TOAST(adb_ha_sync_log, 9006, 9007);
 #define AdbHaSyncLogToastTable 9006
 #define AdbHaSyncLogToastIndex 9007
+DECLARE_TOAST(pgxc_class, 9021, 9022);
 #endif
 
 #endif   /* TOASTING_H */
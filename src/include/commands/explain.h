@@ -34,6 +34,7 @@ typedef struct ExplainState
 	bool		buffers;		/* print buffer usage */
 #ifdef ADB
 	bool		nodes;			/* print nodes in RemoteQuery node */
+	bool		node_stats;		/* print statistics of each datanode */
 	bool		num_nodes;		/* print number of nodes in RemoteQuery node */
 	bool		plan_id;		/* print plan node id */
 	bool		isTopLive;		/* is top live query */
@@ -76,6 +76,10 @@ extern Datum lastval(PG_FUNCTION_ARGS);
 
 extern Datum pg_sequence_parameters(PG_FUNCTION_ARGS);
 
+#ifdef AGTM
+extern int64 nextval_range(Oid relid, int64 count, int64 *last, int64 *increment);
+#endif
+
 #ifdef ADB
 typedef enum
 {
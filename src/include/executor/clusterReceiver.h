@@ -16,6 +16,19 @@
 
 struct pg_conn;
 
+/*
+ * Scan nodes of datanode check "copy end" message from coordinator every
+ * CLUSTER_STOP_CHECK_INTERVAL tuples, and return no more tuple when got it
+ */
+#define CLUSTER_STOP_CHECK_INTERVAL	4096
+extern PGDLLIMPORT bool ClusterPlanStopCheck;
+extern PGDLLIMPORT bool ClusterPlanStopped;
+extern PGDLLIMPORT int ClusterStopCheckCountdown;
+#define ClusterPlanShouldStop()											\
+	(ClusterPlanStopCheck &&											\
+	 (ClusterPlanStopped ||												\
+	  (--ClusterStopCheckCountdown <= 0 && ClusterCheckStopMessage())))
+
 typedef struct ClusterRecvState
 {
 	TupleTableSlot *base_slot;
@@ -24,6 +37,8 @@ typedef struct ClusterRecvState
 	PlanState *ps;
 	bool convert_slot_is_single;
 	bool slot_need_copy_datum;
+	bool slot_need_copy;		/* consumer keep tuple after next receive */
+	StringInfoData recv_buf;	/* for not aligned tuple when no copy */
 }ClusterRecvState;
 
 extern DestReceiver *createClusterReceiver(void);
@@ -31,6 +46,9 @@ extern ClusterRecvState *createClusterRecvState(PlanState *ps, bool need_copy);
 extern void freeClusterRecvState(ClusterRecvState *state);
 extern bool clusterRecvSetCheckEndMsg(DestReceiver *r, bool check);
 extern void clusterRecvSetTopPlanState(DestReceiver *r, PlanState *ps);
+extern bool ClusterCheckStopMessage(void);
+extern void clusterRecvStartStopCheck(bool enable);
+extern void clusterRecvResetStopCheck(void);
 extern bool clusterRecvRdcListenPort(struct pg_conn *conn, const char *msg, int len, int *port);
 extern bool clusterRecvTuple(TupleTableSlot *slot, const char *msg, int len,
 							 PlanState *ps, struct pg_conn *conn);
@@ -46,6 +64,7 @@ extern TupleDesc restore_slot_head_message_str(StringInfo buf);
 extern void serialize_slot_message(StringInfo buf, TupleTableSlot *slot, char msg_type);
 extern MinimalTuple fetch_slot_message(TupleTableSlot *slot, bool *need_free_tup);
 extern TupleTableSlot* restore_slot_message(const char *msg, int len, TupleTableSlot *slot);
+extern TupleTableSlot* restore_slot_message_nocopy(const char *msg, int len, TupleTableSlot *slot, StringInfo buf);
 extern void serialize_processed_message(StringInfo buf, uint64 processed);
 extern uint64 restore_processed_message(const char *msg, int len);
 
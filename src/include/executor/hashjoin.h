@@ -186,6 +186,11 @@ typedef struct HashJoinTableData
 
 	/* used for dense allocation of tuples (into linked chunks) */
 	HashMemoryChunk chunks;		/* one list for the whole batch */
+
+#ifdef ADB
+	/* bloom filter of all inner hash values, or NULL */
+	struct bloom_filter *bloom;
+#endif
 }	HashJoinTableData;
 
 #endif   /* HASHJOIN_H */
@@ -70,10 +70,25 @@ typedef struct WorkerInstrumentation
 } WorkerInstrumentation;
 
 #ifdef ADB
+/* traffic of a ClusterReduce with one other node */
+typedef struct ReducePeerInstrumentation
+{
+	Oid			nodeOid;
+	uint64		send_tuples;
+	uint64		send_bytes;
+	uint64		recv_tuples;
+	uint64		recv_bytes;
+}ReducePeerInstrumentation;
+
 typedef struct ClusterInstrumentation
 {
 	Oid			nodeOid;
 	int			num_workers;
+	long		space_used;		/* peak memory in kB of Sort or Hash, 0 if none */
+	double		network_time;	/* seconds ClusterReduce blocked on network */
+	uint64		spill_bytes;	/* bytes adb_reduce spilled for ClusterReduce */
+	int			num_peers;		/* length of peers */
+	ReducePeerInstrumentation *peers;
 	Instrumentation	instrument[1];	/* num_workers+1, 0 for node */
 }ClusterInstrumentation;
 #endif /* ADB */
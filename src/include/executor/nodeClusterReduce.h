@@ -1,6 +1,8 @@
 #ifndef NODE_CLUSTER_REDUCE_H
 #define NODE_CLUSTER_REDUCE_H
 
+#include "access/parallel.h"
+
 extern ClusterReduceState *ExecInitClusterReduce(ClusterReduce *node, EState *estate, int eflags);
 extern TupleTableSlot *ExecClusterReduce(ClusterReduceState *node);
 extern void ExecEndClusterReduce(ClusterReduceState *node);
@@ -9,5 +11,17 @@ extern void ExecClusterReduceRestrPos(ClusterReduceState *node);
 extern void ExecConnectReduce(PlanState *node);
 extern void ExecReScanClusterReduce(ClusterReduceState *node);
 extern void TopDownDriveClusterReduce(PlanState *node);
+extern void ExecClusterReduceGetInstrument(ClusterReduceState *node, ClusterInstrumentation *ci);
+
+/* parallel scan support */
+extern void ExecClusterReduceEstimate(ClusterReduceState *node, ParallelContext *pcxt);
+extern void ExecClusterReduceInitializeDSM(ClusterReduceState *node, ParallelContext *pcxt);
+extern void ExecClusterReduceInitializeWorker(ClusterReduceState *node, shm_toc *toc);
+extern void ExecClusterReduceWorkersLaunched(PlanState *node, int nworkers_launched);
+
+/* runtime filter of parent HashJoin */
+struct bloom_filter;
+extern bool ExecClusterReduceUseFilter(PlanState *node, HashJoinState *hjstate);
+extern void ExecClusterReduceSendFilter(ClusterReduceState *node, struct bloom_filter *filter);
 
 #endif /* NODE_CLUSTER_REDUCE_H */
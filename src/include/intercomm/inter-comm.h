@@ -49,6 +49,8 @@ extern void HandleGC(NodeHandle *handle);
 extern void HandleListGC(List *handle_list);
 extern void HandleCacheOrGC(NodeHandle *handle);
 extern void HandleListCacheOrGC(List *handle_list);
+extern void HandleSetPipelined(NodeHandle *handle);
+extern void HandleListGCPipelined(const List *handle_list);
 extern bool HandleListFinishCommand(const List *handle_list, const char *commandTag);
 extern bool HandleFinishCommand(NodeHandle *handle, const char *commandTag);
 extern int HandleBegin(InterXactState state,
@@ -57,6 +59,11 @@ extern int HandleBegin(InterXactState state,
 					   TimestampTz timestamp,
 					   bool need_xact_block,
 					   bool *already_begin);
+extern NodeHandle *HandleListBegin(InterXactState state,
+								   const List *handle_list,
+								   GlobalTransactionId xid,
+								   TimestampTz timestamp,
+								   bool need_xact_block);
 extern int HandleSendCID(NodeHandle *handle, CommandId cid);
 extern int HandleSendGXID(NodeHandle *handle, GlobalTransactionId xid);
 extern int HandleSendTimestamp(NodeHandle *handle, TimestampTz timestamp);
@@ -120,6 +127,7 @@ extern void InterXactSetXID(InterXactState state, TransactionId xid);
 extern void InterXactSaveBeginNodes(InterXactState state, Oid node);
 extern Oid *InterXactBeginNodes(InterXactState state, bool include_self, int *node_num);
 extern void InterXactSerializeSnapshot(StringInfo buf, Snapshot snapshot);
+extern void InterXactSerializeSnapshotTo(StringInfo buf, Snapshot snapshot, int64 *sent_serial);
 extern void InterXactGCCurrent(InterXactState state);
 extern void InterXactGCAll(InterXactState state);
 extern void InterXactCacheCurrent(InterXactState state);
@@ -151,6 +159,10 @@ extern BlockNumber CnGetRelationNumberOfBlocks(Relation relation, uint64 *reltup
 extern int CnAcquireSampleRowsFunc(Relation relation, int elevel,
 								   HeapTuple *rows, int targrows,
 								   double *totalrows, double *totaldeadrows);
+struct VacAttrStats;
+extern List *CnGetRemoteDistinct(Relation relation);
+extern void CnMergeRemoteDistinct(Relation relation, List *remote,
+								  struct VacAttrStats *stats, double totalrows);
 
 /* src/backend/intercomm/inter-copy.c */
 extern void StartRemoteCopy(RemoteCopyState *node);
@@ -40,6 +40,9 @@ typedef struct NodeHandle
 	struct pg_conn	   *node_conn;
 	void			   *node_context;	/* InterXactState, it is set by caller for callback */
 	void			   *node_owner;		/* RemoteQueryState, it is set by caller for cache data */
+	int64				node_snapshot;	/* serial of snapshot xids the node has, 0 for none */
+	int64				node_snapshot_sent;	/* serial sent but not acknowledged yet, 0 for none */
+	bool				node_pipelined;	/* result of a pipelined insert is pending */
 } NodeHandle;
 
 typedef struct NodeMixHandle
@@ -58,6 +61,7 @@ typedef struct CustomOption
 extern Oid SelfNodeID;
 
 extern void ResetNodeExecutor(void);
+extern void FinishPipelinedNodeHandles(void);
 extern void InitializeNodeExecutor(void);
 extern void AtStart_NodeExecutor(void);
 extern NodeHandle *GetNodeHandle(Oid node_id, bool attatch, void *context);
@@ -0,0 +1,44 @@
+/*
+ * bloomfilter.h
+ *
+ * Bloom filter over 32 bit hash values
+ *
+ * src/include/lib/bloomfilter.h
+ */
+
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+/*
+ * bloom_filter
+ *
+ * The struct is flat, so a filter can be sent to other processes as
+ * bloom_size(filter) bytes and restored by bloom_restore.
+ *
+ *		bf_size			total size in bytes, including header
+ *		bf_nhash		number of probes for each element
+ *		bf_mask			number of bits in bitset minus 1, bitset size is
+ *						always a power of 2
+ *		bf_seed			seed of the second hash function
+ *		bf_bitset		the bits
+ */
+typedef struct bloom_filter
+{
+	uint32		bf_size;
+	int32		bf_nhash;
+	uint32		bf_mask;
+	uint32		bf_seed;
+	unsigned char bf_bitset[FLEXIBLE_ARRAY_MEMBER];
+} bloom_filter;
+
+extern Size bloom_estimate_size(double total_elems, Size max_size);
+extern bloom_filter *bloom_create(double total_elems, Size max_size, uint32 seed);
+extern bloom_filter *bloom_restore(const char *data, Size len);
+extern void bloom_free(bloom_filter *filter);
+extern void bloom_add_hash(bloom_filter *filter, uint32 hashvalue);
+extern bool bloom_lacks_hash(bloom_filter *filter, uint32 hashvalue);
+extern double bloom_prop_bits_set(bloom_filter *filter);
+
+#define bloom_size(f)	((Size) (f)->bf_size)
+
+#endif   /* BLOOMFILTER_H */
@@ -0,0 +1,53 @@
+/*
+ * losertree.h
+ *
+ * A tournament (loser) tree for k-way merge
+ *
+ * src/include/lib/losertree.h
+ */
+
+#ifndef LOSERTREE_H
+#define LOSERTREE_H
+
+/*
+ * The comparator is called with the index of two valid inputs, and must
+ * return <0 iff input a sorts before input b, 0 iff they are equal and
+ * >0 iff a sorts after b.
+ */
+typedef int (*losertree_comparator) (int a, int b, void *arg);
+
+/*
+ * losertree
+ *
+ *		lt_size			number of inputs
+ *		lt_built		tree build since last unordered operation
+ *		lt_compare		comparison function of inputs
+ *		lt_arg			user data for comparison function
+ *		lt_valid		array of "size", false if input is exhausted
+ *		lt_nodes		array of "size", lt_nodes[0] is the winner and
+ *						others are losers of each internal match
+ */
+typedef struct losertree
+{
+	int			lt_size;
+	bool		lt_built;
+	losertree_comparator lt_compare;
+	void	   *lt_arg;
+	bool	   *lt_valid;
+	int			lt_nodes[FLEXIBLE_ARRAY_MEMBER];
+} losertree;
+
+extern losertree *losertree_allocate(int size,
+					losertree_comparator compare,
+					void *arg);
+extern void losertree_reset(losertree *tree);
+extern void losertree_free(losertree *tree);
+extern void losertree_add_unordered(losertree *tree, int input);
+extern void losertree_build(losertree *tree);
+extern int losertree_first(losertree *tree);
+extern void losertree_remove_first(losertree *tree);
+extern void losertree_replace_first(losertree *tree);
+
+#define losertree_empty(t)	(!(t)->lt_valid[(t)->lt_nodes[0]])
+
+#endif   /* LOSERTREE_H */
@@ -1176,6 +1176,7 @@ typedef struct ModifyTableState
 	PlanState **mt_plans;		/* subplans (one per target rel) */
 #ifdef ADB
 	PlanState **mt_remoterels;	/* per-target remote query node */
+	struct RemoteInsertState *mt_remote_insert;	/* rows sent by COPY, or NULL */
 #endif
 	int			mt_nplans;		/* number of plans in the array */
 	int			mt_whichplan;	/* which one is being executed (0..n-1) */
@@ -1803,6 +1804,9 @@ typedef struct HashJoinState
 	int			hj_JoinState;
 	bool		hj_MatchedOuter;
 	bool		hj_OuterNotEmpty;
+#ifdef ADB
+	bool		hj_ReduceFilter;	/* send bloom filter to outer ClusterReduce */
+#endif
 } HashJoinState;
 
 
@@ -2162,8 +2166,10 @@ typedef struct ClusterMergeGatherState
 	int				nremote;	/* number of PGconn for my inputs */
 	int				nkeys;		/* number of sork key */
 	SortSupport		sortkeys;	/* array of length nkeys */
-	TupleTableSlot **slots;		/* array of length nremote */
-	struct binaryheap *binheap;	/* binary heap of slot indices */
+	TupleTableSlot **slots;		/* array of length nremote+1, last is local */
+	struct losertree *tree;		/* loser tree of slot indices */
+	Datum		   *abbrevs;	/* abbreviated first key of each slot */
+	struct CMGBatch *batches;	/* prefetched tuples, array of length nremote */
 	struct pg_conn **conns;		/* remote connections */
 	struct ClusterRecvState *recv_state;
 	bool			initialized;
@@ -2182,6 +2188,12 @@ typedef struct
 	TupleTableSlot	   *re_slot;
 	Tuplestorestate	   *re_store;
 	bool				re_eof;
+	bool				re_filter_wait;	/* waiting for its runtime filter */
+	struct bloom_filter *re_filter;		/* its runtime filter, NULL accept all */
+	uint64				re_send_tuples;	/* statistics for EXPLAIN ANALYZE */
+	uint64				re_send_bytes;
+	uint64				re_recv_tuples;
+	uint64				re_recv_bytes;
 } ReduceEntryData;
 
 typedef ReduceEntryData *ReduceEntry;
@@ -2201,6 +2213,7 @@ typedef struct ClusterReduceState
 	ReduceEntry	   *rdc_entrys;		/* array of length nrdcs */
 	struct TupleTypeConvert *convert;
 	TupleTableSlot *convert_slot;
+	StringInfoData	recv_buf;		/* tuple buffer for GetSlotFromRemote */
 
 	int				eflags;			/* capability flags to pass to tuplestore */
 	Tuplestorestate*tuplestorestate;
@@ -2208,8 +2221,22 @@ typedef struct ClusterReduceState
 	/* used for merge reduce as below */
 	int				nkeys;
 	SortSupport 	sortkeys;	/* array of length nkeys */
-	struct binaryheap  *binheap; 	/* binary heap of slot indices */
+	struct losertree   *tree;		/* loser tree of rdc_entrys indices */
+	Datum		   *abbrevs;	/* abbreviated first key of rdc_entrys */
 	bool			initialized;/* are subplans started? */
+
+	/* used for runtime filter of parent HashJoin as below */
+	HashJoinState  *filter_hjstate;	/* NULL if not use filter */
+	bool			filter_sent;	/* sent local filter to remote? */
+	bool			filter_waited;	/* waited remote filters? */
+	int				nfilters_wait;	/* number of remote filters not got */
+	Tuplestorestate*filter_store;	/* remote tuples got while waiting */
+
+	/* used for parallel-aware ClusterReduce as below */
+	struct ClusterReduceShared *pshared;	/* NULL if not run by parallel workers */
+
+	/* used for EXPLAIN ANALYZE as below */
+	instr_time		network_time;	/* time blocked on sending or receiving */
 } ClusterReduceState;
 
 typedef struct ReduceScanState
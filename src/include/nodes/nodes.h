@@ -700,6 +700,7 @@ extern Oid load_oid_type(struct StringInfoData *buf);
 extern Oid load_namespace(struct StringInfoData *buf);
 extern Oid load_namespace_extend(struct StringInfoData *buf, bool missok);
 extern Oid load_oid_class(struct StringInfoData *buf);
+extern Oid load_oid_class_name(struct StringInfoData *buf, bool missok);
 extern struct List* load_oid_list_class(struct StringInfoData *buf);
 extern char * load_node_string(struct StringInfoData *buf, bool need_dup);
 extern Oid load_oid_ts_config(struct StringInfoData *buf);
@@ -711,11 +712,22 @@ extern void save_oid_collation(struct StringInfoData *buf, Oid collation);
 extern void save_oid_type(struct StringInfoData *buf, Oid typid);
 extern void save_namespace(struct StringInfoData *buf, Oid nsp);
 extern void save_oid_class(struct StringInfoData *buf, Oid oid_rel);
+extern void save_oid_class_name(struct StringInfoData *buf, Oid oid_rel);
 extern void save_oid_list_class(struct StringInfoData *buf, struct List *list);
 extern void save_node_string(struct StringInfoData *buf, const char *str);
 extern void save_node_bitmapset(struct StringInfoData *buf, const struct Bitmapset *node);
 extern void save_oid_ts_config(struct StringInfoData *buf, Oid cfg);
 extern void save_oid_authid(struct StringInfoData *buf, Oid authid);
+/*
+ * catalog reference cache, when it is active every non builtin catalog
+ * object saved (or loaded) more than once in same message is replaced
+ * by a reference to the first one. Save and load side must begin and
+ * end the cache at same position of message.
+ */
+extern void BeginSaveCatalogCache(void);
+extern void EndSaveCatalogCache(void);
+extern void BeginLoadCatalogCache(void);
+extern void EndLoadCatalogCache(void);
 #endif /* ADB */
 
 /*
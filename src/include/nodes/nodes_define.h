@@ -462,6 +462,7 @@ BEGIN_NODE(HashJoin)
 	NODE_NODE(List,hashclauses)
 #ifdef ADB
 	NODE_SCALAR(bool,cluster_hashtable_first)
+	NODE_SCALAR(bool,cluster_reduce_filter)
 #endif
 END_NODE(HashJoin)
 #endif /* NO_NODE_HashJoin */
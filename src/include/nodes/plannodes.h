@@ -669,6 +669,7 @@ typedef struct HashJoin
 	List	   *hashclauses;
 #ifdef ADB
 	bool		cluster_hashtable_first;	/* build hash table first when cluster plan if true */
+	bool		cluster_reduce_filter;		/* outer ClusterReduce filter rows by bloom filter of hash table */
 #endif
 } HashJoin;
 
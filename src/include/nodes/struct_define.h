@@ -319,6 +319,10 @@ BEGIN_STRUCT(RelationLocInfo)
 	NODE_OTHER_POINT(ListCell, roundRobinNode)
 	NODE_SCALAR(Oid,funcid)
 	NODE_NODE(List,funcAttrNums)
+	NODE_SCALAR(int,nbuckets)
+	NODE_SCALAR_POINT(Oid,bucketMap,NODE_ARG_->nbuckets)
+	NODE_DATUM(Datum,rangeBounds,ANYARRAYOID,NODE_ARG_->rangeBounds == (Datum) 0)
+	NODE_SCALAR(Oid,rangeCollation)
 END_STRUCT(RelationLocInfo)
 #endif /* NO_STRUCT_RelationLocInfo */
 #endif
@@ -90,6 +90,10 @@ extern PGDLLIMPORT bool enable_remotegroup;
 extern PGDLLIMPORT bool enable_remotesort;
 extern PGDLLIMPORT bool enable_remotelimit;
 extern PGDLLIMPORT bool enable_hashscan;
+extern PGDLLIMPORT bool enable_skew_reduce;
+extern PGDLLIMPORT bool enable_reduce_filter;
+extern PGDLLIMPORT bool enable_parallel_reduce;
+extern PGDLLIMPORT bool enable_remote_insert_copy;
 #endif
 
 extern double clamp_row_est(double nrows);
@@ -248,7 +252,11 @@ extern void cost_gather_merge(GatherMergePath *path, PlannerInfo *root,
 #ifdef ADB
 extern void cost_remotequery(RemoteQueryPath *rqpath, PlannerInfo *root, RelOptInfo *rel);
 extern void cost_div(Path *path, int n);
+extern void cost_div_skew(Path *path, int n, double skew);
 extern void cost_cluster_gather(ClusterGatherPath *path, RelOptInfo *baserel, ParamPathInfo *param_info, double *rows);
-extern void cost_cluster_reduce(ClusterReducePath *path);
+extern void cost_cluster_reduce(PlannerInfo *root, ClusterReducePath *path);
+extern Size reduce_filter_max_size(int nnodes);
+extern Cost cost_reduce_filter(double outer_rows, int outer_width, double inner_rows,
+							   double match_frac, int nnodes);
 #endif
 #endif   /* COST_H */
@@ -81,6 +81,7 @@ extern int use_aux_type;
 extern int use_aux_max_times;
 extern List *relation_remote_by_constraints(PlannerInfo *root, RelOptInfo *rel, bool modify_info_when_aux);
 extern List *relation_remote_by_constraints_base(PlannerInfo *root, Node *quals, struct RelationLocInfo *loc_info, Index varno);
+extern Expr *makeRangePartitionExpr(struct RelationLocInfo *loc_info, Expr *value);
 #endif /* ADB */
 
 #endif   /* PLANCAT_H */
@@ -8,6 +8,9 @@
 #define REDUCE_TYPE_REPLICATED	'R'
 #define REDUCE_TYPE_ROUND		'L'
 #define REDUCE_TYPE_COORDINATOR	'O'
+/* hash reduce, but skew values round robin or replicated to all nodes */
+#define REDUCE_TYPE_SKEW_SPREAD		'S'
+#define REDUCE_TYPE_SKEW_BROADCAST	'B'
 /* only using in ReducePathXXX functions */
 #define REDUCE_TYPE_IGNORE		'I'
 #define REDUCE_TYPE_GATHER		'G'
@@ -31,7 +34,8 @@ typedef struct ReduceInfo
 	List	   *storage_nodes;			/* when not reduce by value, it's sorted */
 	List	   *exclude_exec;
 	List	   *params;
-	Expr	   *expr;					/* for custom only */
+	Expr	   *expr;					/* for custom, array Const of skew values,
+										 * or oid array Const of bucket map for hash */
 	Relids		relids;					/* params include */
 	char		type;					/* REDUCE_TYPE_XXX */
 }ReduceInfo;
@@ -39,7 +43,12 @@ struct RelationLocInfo;
 
 typedef int(*ReducePathCallback_function)(PlannerInfo *root, Path *path, void *context);
 
+/* value with frequency above 1/(2*nnodes) is a skew value */
+#define IsSkewReduceFrequency(freq_, nnodes_) ((freq_) * (nnodes_) * 2 > 1.0)
+
 extern ReduceInfo *MakeHashReduceInfo(const List *storage, const List *exclude, const Expr *param);
+extern ReduceInfo *MakeBucketReduceInfo(const RelationLocInfo *loc_info, const List *exclude, const Expr *param);
+extern ReduceInfo *MakeRangeReduceInfo(const RelationLocInfo *loc_info, const List *exclude, const Expr *param);
 extern ReduceInfo *MakeCustomReduceInfoByRel(const List *storage, const List *exclude,
 						const List *attnums, Oid funcid, Oid reloid, Index rel_index);
 extern ReduceInfo *MakeCustomReduceInfo(const List *storage, const List *exclude, List *params, Oid funcid, Oid reloid);
@@ -48,6 +57,10 @@ extern ReduceInfo *MakeReplicateReduceInfo(const List *storage);
 extern ReduceInfo *MakeFinalReplicateReduceInfo(void);
 extern ReduceInfo *MakeRoundReduceInfo(const List *storage);
 extern ReduceInfo *MakeCoordinatorReduceInfo(void);
+extern ReduceInfo *MakeSkewReduceInfo(const List *storage, const Expr *param, Const *skew_values, bool broadcast);
+extern Const *GetSkewReduceValues(PlannerInfo *root, Expr *expr, int nnodes);
+extern double GetReduceMaxFrequency(PlannerInfo *root, Expr *expr);
+extern double GetReduceSkewFrequency(PlannerInfo *root, ReduceInfo *reduce);
 extern ReduceInfo *MakeReduceInfoFromLocInfo(const RelationLocInfo *loc_info, const List *exclude, Oid reloid, Index relid);
 extern ReduceInfo *MakeReduceInfoAs(const ReduceInfo *reduce, List *params);
 extern ReduceInfo *ConvertReduceInfo(const ReduceInfo *reduce, const PathTarget *target, Index new_relid);
@@ -142,6 +155,9 @@ extern bool IsReduceInfoListFinalReplicated(List *list);
 extern bool IsReduceInfoListRound(List *list);
 #define IsReduceInfoCoordinator(r)	((r)->type == REDUCE_TYPE_COORDINATOR)
 extern bool IsReduceInfoListCoordinator(List *list);
+#define IsReduceInfoSkew(r)			((r)->type == REDUCE_TYPE_SKEW_SPREAD || \
+									 (r)->type == REDUCE_TYPE_SKEW_BROADCAST)
+extern bool IsReduceInfoListSkew(List *list);
 
 #define IsReduceInfoInOneNode(r) (list_length(r->storage_nodes) - list_length(r->exclude_exec) == 1 && \
 								  !IsReduceInfoFinalReplicated(r))
@@ -174,12 +190,13 @@ extern bool ReduceInfoListMember(List *reduce_info_list, ReduceInfo *reduce_info
 extern List* GetPathListReduceInfoList(List *pathlist);
 
 extern int ReduceInfoIncludeExpr(ReduceInfo *reduce, Expr *expr);
+extern int ReduceInfoIncludeExprEC(PlannerInfo *root, ReduceInfo *reduce, Expr *expr);
 extern bool ReduceInfoListIncludeExpr(List *reduceList, Expr *expr);
 
 extern List* ReduceInfoFindPathTarget(const ReduceInfo* reduce, const PathTarget *target);
 extern List* ReduceInfoFindTargetList(const ReduceInfo* reduce, const List *targetlist, bool skip_junk);
 extern List* MakeVarList(const List *attnos, Index relid, const PathTarget *target);
-extern bool IsGroupingReduceExpr(PathTarget *target, ReduceInfo *info);
+extern bool IsGroupingReduceExpr(PlannerInfo *root, PathTarget *target, ReduceInfo *info);
 extern bool IsReduceInfoListCanInnerJoin(List *outer_reduce_list,
 									List *inner_reduce_list,
 									List *restrictlist);
@@ -201,11 +218,11 @@ extern bool reduce_info_list_is_one_node_can_join(List *outer_reduce_list,
 												  List **new_reduce_list,
 												  JoinType jointype,
 												  bool *is_dummy);
-extern bool CanOnceGroupingClusterPath(PathTarget *target, Path *path);
-extern bool CanOnceDistinctReduceInfoList(List *distinct, List *reduce_list);
-extern bool CanOnceDistinctReduceInfo(List *distinct, ReduceInfo *reduce_info);
-extern bool CanOnceWindowAggClusterPath(WindowClause *wclause, List *tlist, Path *path);
-extern bool HaveOnceWindowAggClusterPath(List *wclauses, List *tlist, Path *path);
+extern bool CanOnceGroupingClusterPath(PlannerInfo *root, PathTarget *target, Path *path);
+extern bool CanOnceDistinctReduceInfoList(PlannerInfo *root, List *distinct, List *reduce_list);
+extern bool CanOnceDistinctReduceInfo(PlannerInfo *root, List *distinct, ReduceInfo *reduce_info);
+extern bool CanOnceWindowAggClusterPath(PlannerInfo *root, WindowClause *wclause, List *tlist, Path *path);
+extern bool HaveOnceWindowAggClusterPath(PlannerInfo *root, List *wclauses, List *tlist, Path *path);
 
 extern Var *makeVarByRel(AttrNumber attno, Oid rel_oid, Index rel_index);
 extern Expr *CreateExprUsingReduceInfo(ReduceInfo *reduce);
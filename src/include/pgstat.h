@@ -739,6 +739,9 @@ typedef enum ProgressCommandType
 {
 	PROGRESS_COMMAND_INVALID,
 	PROGRESS_COMMAND_VACUUM
+#ifdef ADB
+	,PROGRESS_COMMAND_REDISTRIBUTE
+#endif
 } ProgressCommandType;
 
 #define PGSTAT_NUM_PROGRESS_PARAM	10
@@ -34,6 +34,7 @@
 
 /* GUC parameters */
 extern bool RequirePKeyForRepTab;
+extern bool pipeline_remote_insert;
 
 /*
  * Type of requests associated to a remote COPY OUT
@@ -46,6 +47,16 @@ typedef enum
 	REMOTE_COPY_TUPLESTORE	/* Store data in tuplestore */
 } RemoteCopyType;
 
+/*
+ * Use of coordinator cache by a remote query, see repcache.c
+ */
+typedef enum
+{
+	REP_CACHE_NONE,			/* result can not be cached */
+	REP_CACHE_MISS,			/* result is not cached, it is collected */
+	REP_CACHE_HIT			/* result is taken from cache */
+} RepCacheStatus;
+
 /* Combines results of INSERT statements using multiple values */
 typedef struct CombineTag
 {
@@ -108,6 +119,8 @@ typedef struct RemoteQueryState
 	Tuplestorestate *tuplestorestate;
 	CommandId	rqs_cmd_id;			/* Cmd id to use in some special cases */
 	uint32		rqs_processed;			/* Number of rows processed (only for DMLs) */
+	struct RepCacheScan *rep_cache;		/* result being cached, see repcache.c */
+	RepCacheStatus rep_cache_status;	/* shown by EXPLAIN ANALYZE */
 }	RemoteQueryState;
 
 typedef void (*xact_callback) (bool isCommit, void *args);
@@ -126,6 +139,12 @@ extern void SetDataRowForExtParams(ParamListInfo params, RemoteQueryState *rq_st
 /* Flags related to temporary objects included in query */
 extern TupleTableSlot * ExecProcNodeDMLInXC(EState *estate, TupleTableSlot *sourceDataSlot, TupleTableSlot *newDataSlot);
 
+/* rows of a multi-row remote INSERT sent to datanodes by COPY */
+struct RemoteInsertState;
+extern struct RemoteInsertState *ExecInitRemoteInsert(ModifyTableState *mtstate);
+extern void ExecRemoteInsertRow(struct RemoteInsertState *state, TupleTableSlot *slot);
+extern void ExecFinishRemoteInsert(struct RemoteInsertState *state);
+
 extern void AtEOXact_DBCleanup(bool isCommit);
 
 extern void set_dbcleanup_callback(xact_callback function, void *paraminfo, int paraminfo_size);
@@ -32,13 +32,30 @@
 #define HASH_SIZE 4096
 #define HASH_MASK 0x00000FFF;
 
+/*
+ * Hash algorithm of a hash distributed table, pgxc_class.pchashalgorithm.
+ * A bucket table maps the hash value to one of pchashbuckets virtual buckets
+ * and each bucket to a node by pgxc_class.pcbucketmap, so changing the node
+ * list only moves the rows of buckets assigned to another node.
+ */
+#define LOCATOR_HASH_MODULO			1
+#define LOCATOR_HASH_BUCKET			2
+
+/*
+ * A range distributed table splits values of the distribution column by
+ * the sorted bounds in pgxc_class.pcrangebounds, range i holds values from
+ * bound i-1 (included) to bound i (excluded), the first range also holds
+ * NULL.  pgxc_class.pcbucketmap gives the node of each range.
+ */
+
 #define IsLocatorNone(x)						((x) == LOCATOR_TYPE_NONE)
 #define IsLocatorReplicated(x) 					((x) == LOCATOR_TYPE_REPLICATED)
 #define IsLocatorColumnDistributed(x) 			((x) == LOCATOR_TYPE_HASH || \
 												 (x) == LOCATOR_TYPE_RROBIN || \
 												 (x) == LOCATOR_TYPE_MODULO || \
 												 (x) == LOCATOR_TYPE_DISTRIBUTED || \
-												 (x) == LOCATOR_TYPE_USER_DEFINED)
+												 (x) == LOCATOR_TYPE_USER_DEFINED || \
+												 (x) == LOCATOR_TYPE_RANGE)
 #define IsLocatorDistributedByValue(x)			((x) == LOCATOR_TYPE_HASH || \
 												 (x) == LOCATOR_TYPE_MODULO || \
 												 (x) == LOCATOR_TYPE_RANGE)
@@ -67,12 +84,20 @@ typedef struct RelationLocInfo
 	ListCell   *roundRobinNode;			/* the next node to use */
 	Oid			funcid;					/* Oid of user-defined distribution function */
 	List	   *funcAttrNums;			/* Attributes indices used for user-defined function  */
+	int			nbuckets;				/* Number of hash buckets or ranges, 0 if
+										 * neither bucket nor range table */
+	Oid		   *bucketMap;				/* Node id of each hash bucket or range */
+	Datum		rangeBounds;			/* Array of nbuckets - 1 range bounds */
+	Oid			rangeCollation;			/* Collation to compare range bounds */
 } RelationLocInfo;
 
 #define IsRelationReplicated(rel_loc)				IsLocatorReplicated((rel_loc)->locatorType)
 #define IsRelationColumnDistributed(rel_loc)		IsLocatorColumnDistributed((rel_loc)->locatorType)
 #define IsRelationDistributedByValue(rel_loc)		IsLocatorDistributedByValue((rel_loc)->locatorType)
 #define IsRelationDistributedByUserDefined(rel_loc)	IsLocatorDistributedByUserDefined((rel_loc)->locatorType)
+#define IsRelationDistributedByBucket(rel_loc)		((rel_loc)->locatorType == LOCATOR_TYPE_HASH && \
+													 (rel_loc)->bucketMap != NULL)
+#define IsRelationDistributedByRange(rel_loc)		((rel_loc)->locatorType == LOCATOR_TYPE_RANGE)
 
 /*
  * Nodes to execute on
@@ -117,6 +142,7 @@ extern bool HasRelationLocator(Oid relid);
 extern RelationLocInfo *RelationIdBuildLocator(Oid relid);
 extern void RelationBuildLocator(Relation rel);
 extern RelationLocInfo *GetRelationLocInfo(Oid relid);
+extern RelationLocInfo *GetRelationLocInfoCached(Oid relid);
 extern RelationLocInfo *CopyRelationLocInfo(RelationLocInfo *srcInfo);
 extern void FreeRelationLocInfo(RelationLocInfo *relationLocInfo);
 extern char *GetRelationDistribColumn(RelationLocInfo *locInfo);
@@ -128,6 +154,11 @@ extern bool IsTableDistOnPrimary(RelationLocInfo *locInfo);
 extern bool IsLocatorInfoEqual(RelationLocInfo *locInfo1,
 							   RelationLocInfo *locInfo2);
 extern Oid GetRoundRobinNodeId(Oid relid);
+extern Oid *MakeBucketMap(int nbuckets, const Oid *oldmap,
+						  const Oid *nodes, int numnodes);
+extern Oid *MakeRangeMap(int nranges, List *rangenodes, const Oid *oldmap,
+						 const Oid *nodes, int numnodes);
+extern int GetRangeIndex(RelationLocInfo *locInfo, Datum value, bool isnull);
 extern bool IsTypeDistributable(Oid colType);
 extern bool IsDistribColumn(Oid relid, AttrNumber attNum);
 
@@ -29,7 +29,9 @@ typedef enum RedistribOperation {
 	DISTRIB_COPY_TO,	/* Perform a COPY TO */
 	DISTRIB_COPY_FROM,	/* Perform a COPY FROM */
 	DISTRIB_TRUNCATE,	/* Truncate relation */
-	DISTRIB_REINDEX		/* Reindex relation */
+	DISTRIB_REINDEX,	/* Reindex relation */
+	DISTRIB_COPY_BUCKETS,	/* Perform a COPY TO of some hash buckets or ranges */
+	DISTRIB_DELETE_BUCKETS	/* Perform a DELETE of some hash buckets or ranges */
 } RedistribOperation;
 
 /*
@@ -52,8 +54,28 @@ typedef struct RedistribCommand {
 	ExecNodes	   *execNodes;			/* List of nodes where to perform operation */
 	RedistribCatalog	updateState;		/* Flag to determine if operation can be done
 										 * before or after catalog update */
+	List		   *buckets;			/* Moved hash buckets of a bucket table */
+	char		   *condition;			/* WHERE condition of moved rows */
 } RedistribCommand;
 
+/*
+ * Phases of redistribution, as advertised via PROGRESS_REDISTRIB_PHASE
+ * of pg_stat_progress_redistribute
+ */
+#define PROGRESS_REDISTRIB_PHASE				0
+#define PROGRESS_REDISTRIB_BUCKETS_TOTAL		1
+#define PROGRESS_REDISTRIB_BUCKETS_MOVED		2
+#define PROGRESS_REDISTRIB_TUPLES_MOVED			3
+#define PROGRESS_REDISTRIB_BYTES_MOVED			4
+
+#define PROGRESS_REDISTRIB_PHASE_COPY_TO		1
+#define PROGRESS_REDISTRIB_PHASE_DELETE			2
+#define PROGRESS_REDISTRIB_PHASE_COPY_FROM		3
+#define PROGRESS_REDISTRIB_PHASE_TRUNCATE		4
+#define PROGRESS_REDISTRIB_PHASE_REINDEX		5
+#define PROGRESS_REDISTRIB_PHASE_WAIT_LOCK		6
+#define PROGRESS_REDISTRIB_PHASE_UPDATE_CATALOG	7
+
 /*
  * Redistribution operation state
  * Maintainer of redistribution state having the list of commands
@@ -65,8 +87,16 @@ typedef struct RedistribState {
 	Oid			relid;			/* Oid of relation redistributed */
 	List	   *commands;		/* List of commands */
 	Tuplestorestate *store;		/* Tuple store used for temporary data storage */
+	RelationLocInfo *newLocInfo;	/* Locator used by COPY FROM before catalog
+								 * update, NULL if not used */
+	int64		bucketsMoved;	/* Progress counters */
+	int64		tuplesMoved;
+	int64		bytesMoved;
 } RedistribState;
 
+/* GUC parameter */
+extern int redistrib_bucket_batch_size;
+
 extern void PGXCRedistribTable(RedistribState *distribState, RedistribCatalog type);
 extern void PGXCRedistribCreateCommandList(RedistribState *distribState,
 										 RelationLocInfo *newLocInfo);
@@ -0,0 +1,42 @@
+/*-------------------------------------------------------------------------
+ *
+ * relstatcache.h
+ *
+ *	  Coordinator shared memory cache of relation size on datanodes
+ *
+ * IDENTIFICATION
+ *	  src/include/pgxc/relstatcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef RELSTATCACHE_H
+#define RELSTATCACHE_H
+
+#include "pgxc/locator.h"
+#include "storage/block.h"
+#include "utils/relcache.h"
+
+/* statistics of a relation on one datanode */
+typedef struct RelStatNodeInfo
+{
+	Oid			nodeoid;
+	BlockNumber	pages;
+	double		live_tuples;
+	double		mod_since_analyze;	/* rows changed since last ANALYZE */
+} RelStatNodeInfo;
+
+/* GUC parameters */
+extern int relstat_cache_size;
+extern int relstat_cache_refresh_interval;
+
+extern Size RelStatCacheShmemSize(void);
+extern void RelStatCacheShmemInit(void);
+
+extern int RelStatCacheGetNodeStats(Oid relid, RelStatNodeInfo *nodes);
+extern bool RelStatCacheGetPages(Relation rel, BlockNumber *pages);
+extern double RelStatCacheGetSkew(Oid relid, RelationLocInfo *loc_info);
+
+extern void RelStatCacheWorkerMain(Datum main_arg);
+
+#endif /* RELSTATCACHE_H */
@@ -0,0 +1,28 @@
+/*-------------------------------------------------------------------------
+ *
+ * repcache.h
+ *
+ *	  Coordinator cache of remote query results on replicated tables
+ *
+ * IDENTIFICATION
+ *	  src/include/pgxc/repcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef REPCACHE_H
+#define REPCACHE_H
+
+#include "pgxc/execRemote.h"
+
+/* GUC parameter */
+extern int rep_cache_size;
+
+extern void RepCacheInitScan(RemoteQueryState *node);
+extern void RepCacheCollect(RemoteQueryState *node, TupleTableSlot *slot);
+extern void RepCacheEndScan(RemoteQueryState *node);
+
+extern void RepCacheNoteModified(List *rangeTable);
+extern void RepCacheInvalidateRelation(Relation rel);
+
+#endif /* REPCACHE_H */
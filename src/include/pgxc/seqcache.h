@@ -0,0 +1,28 @@
+/*-------------------------------------------------------------------------
+ *
+ * seqcache.h
+ *
+ *	  Coordinator shared memory cache of sequence value ranges from AGTM
+ *
+ * IDENTIFICATION
+ *	  src/include/pgxc/seqcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef SEQCACHE_H
+#define SEQCACHE_H
+
+#include "utils/relcache.h"
+
+/* GUC parameter */
+extern int seq_cache_size;
+
+extern Size SeqCacheShmemSize(void);
+extern void SeqCacheShmemInit(void);
+
+extern bool SeqCacheNextVal(Relation seqrel, int64 cache, int64 *result);
+extern void SeqCacheInvalidate(Oid seqoid);
+extern void SeqCacheInvalidateAll(Relation seqrel);
+
+#endif /* SEQCACHE_H */
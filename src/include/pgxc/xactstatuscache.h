@@ -0,0 +1,26 @@
+/*-------------------------------------------------------------------------
+ *
+ * xactstatuscache.h
+ *
+ *	  Shared memory cache of global transaction status resolved by AGTM
+ *
+ * IDENTIFICATION
+ *	  src/include/pgxc/xactstatuscache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef XACTSTATUSCACHE_H
+#define XACTSTATUSCACHE_H
+
+#include "utils/snapshot.h"
+
+/* GUC parameter */
+extern int xact_status_cache_size;
+
+extern Size XactStatusCacheShmemSize(void);
+extern void XactStatusCacheShmemInit(void);
+
+extern bool XactStatusCacheCompleted(TransactionId xid, Snapshot gtm_snapshot);
+
+#endif /* XACTSTATUSCACHE_H */
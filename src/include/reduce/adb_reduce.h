@@ -47,12 +47,15 @@ extern void SendRejectToRemote(RdcPort *port, List *dest_nodes);
 extern void SendCloseToRemote(RdcPort *port, List *dest_nodes, bool noerror);
 
 extern void SendEofToRemote(RdcPort *port, List *dest_nodes);
+extern void SendParallelEofToRemote(RdcPort *port, List *dest_nodes, int nparticipants);
 
-extern void SendSlotToRemote(RdcPort *port, List *dest_nodes, TupleTableSlot *slot);
+extern int SendSlotToRemote(RdcPort *port, List *dest_nodes, TupleTableSlot *slot);
+
+extern void SendDataToRemote(RdcPort *port, List *dest_nodes, const char *data, int datalen);
 
 extern TupleTableSlot* GetSlotFromRemote(RdcPort *port, TupleTableSlot *slot,
 										 Oid *slot_oid, Oid *eof_oid,
-										 List **closed_remote);
+										 List **closed_remote, StringInfo tup_buf);
 
 extern Size EstimateReduceInfoSpace(void);
 extern void SerializeReduceInfo(Size maxsize, char *ptr);
@@ -146,6 +146,7 @@ struct RdcPort
 	time_t				create_time;	/* at now used for client */
 	uint64				recv_num;		/* at now used for client */
 	uint64				send_num;		/* at now used for client */
+	uint64				spill_bytes;	/* bytes spilled by reduce, see MSG_R2P_STAT */
 #endif
 
 	struct sockaddr		laddr;			/* local address */
@@ -36,6 +36,7 @@ extern RdcPortId		MyReduceId;
 #define MSG_R2P_DATA		'p'
 #define MSG_R2R_DATA		'R'
 #define MSG_PLAN_REJECT		'r'
+#define MSG_R2P_STAT		't'
 
 extern int rdc_send_startup_rqt(RdcPort *port, RdcPortType type, RdcPortId id, RdcPortPID pid, RdcExtra extra);
 extern int rdc_send_startup_rsp(RdcPort *port, RdcPortType type, RdcPortId id, RdcPortPID pid);
@@ -97,4 +97,8 @@ extern void ProcAssignedXids(int nxids, TransactionId *xids);
 extern void ProcUnassignedXids(int nxids, TransactionId *xids);
 #endif
 
+#ifdef AGTM
+extern uint64 ProcArrayGetCommitSeq(void);
+#endif
+
 #endif   /* PROCARRAY_H */
@@ -1521,6 +1521,12 @@ extern Datum rxact_get_running(PG_FUNCTION_ARGS);
 
 /* src/backend/access/transam/varsup.c */
 extern Datum current_xid(PG_FUNCTION_ARGS);
+
+/* src/backend/pgxc/cluster/repcache.c */
+extern Datum adb_rep_cache_invalidate(PG_FUNCTION_ARGS);
+
+/* src/backend/pgxc/cluster/seqcache.c */
+extern Datum adb_seq_cache_invalidate(PG_FUNCTION_ARGS);
 #endif   /* ADB */
 
 #if defined(ADB) || defined(AGTM)
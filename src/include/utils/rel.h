@@ -244,6 +244,9 @@ typedef struct StdRdOptions
 	bool		user_catalog_table;		/* use as an additional catalog
 										 * relation */
 	int			parallel_workers;		/* max number of parallel workers */
+#ifdef ADB
+	bool		coordinator_cache;		/* coordinators cache query results */
+#endif
 } StdRdOptions;
 
 #define HEAP_MIN_FILLFACTOR			10
@@ -282,6 +285,18 @@ typedef struct StdRdOptions
 	  (relation)->rd_rel->relkind == RELKIND_MATVIEW) ? \
 	 ((StdRdOptions *) (relation)->rd_options)->user_catalog_table : false)
 
+#ifdef ADB
+/*
+ * RelationIsCoordinatorCached
+ *		Returns whether coordinators may cache results of queries on the
+ *		relation, see pgxc/cluster/repcache.c.  Note multiple eval of argument!
+ */
+#define RelationIsCoordinatorCached(relation)	\
+	((relation)->rd_options && \
+	 (relation)->rd_rel->relkind == RELKIND_RELATION ? \
+	 ((StdRdOptions *) (relation)->rd_options)->coordinator_cache : false)
+#endif
+
 /*
  * RelationGetParallelWorkers
  *		Returns the relation's parallel_workers reloption setting.
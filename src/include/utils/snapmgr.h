@@ -111,6 +111,24 @@ extern Snapshot RestoreSnapshot(char *start_address);
 extern void RestoreTransactionSnapshot(Snapshot snapshot, void *master_pgproc);
 
 #ifdef ADB
+/*
+ * Identity of the xids of a global snapshot sent by a coordinator backend,
+ * the xids are not sent again when the node has them already.
+ */
+typedef struct GlobalSnapshotXidsId
+{
+	Oid			node;		/* coordinator */
+	int32		pid;		/* and backend of it */
+	int64		start;		/* start time of the backend */
+	int64		serial;		/* xids sent by the backend */
+} GlobalSnapshotXidsId;
+
+/* xcnt of a global snapshot message without xids */
+#define GLOBAL_SNAPSHOT_SAME_XIDS	PG_UINT32_MAX
+
+/* GUC parameter */
+extern bool reuse_global_snapshot;
+
 extern void SetGlobalSnapshot(StringInfo input_message);
 extern void UnsetGlobalSnapshot(void);
 extern Snapshot GetGlobalSnapshot(Snapshot snapshot);
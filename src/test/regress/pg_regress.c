@@ -838,6 +838,10 @@ set_node_config_file(ADBNodeTypeNum node)
 		/* Set pgxcnode_cancel_delay to 100msec only for this test */
 		fputs("pgxcnode_cancel_delay = 100\n", pg_conf);
 
+		/* Share sequence value ranges among backends, see test seq_cache */
+		if (node == ADB_COORD_1 || node == ADB_COORD_2)
+			fputs("seq_cache_size = 64\n", pg_conf);
+
 		/* Add extra configuration for ADB */
 		fputs("logging_collector = on\n"
 			  "log_destination = 'csvlog'\n"
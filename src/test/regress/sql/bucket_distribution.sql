@@ -0,0 +1,29 @@
+--
+-- DISTRIBUTE BY BUCKET
+--
+CREATE TABLE bucket_t1 (a int, b int) DISTRIBUTE BY BUCKET (a);
+CREATE TABLE bucket_t2 (a int, b int) DISTRIBUTE BY BUCKET (a);
+CREATE TABLE bucket_h (a int, b int) DISTRIBUTE BY HASH (b);
+INSERT INTO bucket_t1 SELECT i, i % 10 FROM generate_series(1, 1000) i;
+INSERT INTO bucket_t2 SELECT i, i % 7 FROM generate_series(1, 500) i;
+INSERT INTO bucket_h SELECT i, i FROM generate_series(1, 100) i;
+ANALYZE bucket_t1;
+ANALYZE bucket_t2;
+ANALYZE bucket_h;
+SELECT count(*), sum(a) FROM bucket_t1;
+-- single bucket
+SELECT * FROM bucket_t1 WHERE a = 77;
+SELECT b FROM bucket_t1 WHERE a IN (5, 4000);
+-- joins and grouping through the bucket map
+SET enable_cluster_plan = on;
+SELECT count(*), sum(t2.b) FROM bucket_t1 t1 JOIN bucket_t2 t2 ON t1.a = t2.a;
+SELECT count(*) FROM bucket_t1 t1 JOIN bucket_h h ON t1.a = h.b;
+SELECT b, count(*) FROM bucket_t1 GROUP BY b ORDER BY b LIMIT 3;
+RESET enable_cluster_plan;
+UPDATE bucket_t1 SET b = b + 1 WHERE a <= 10;
+SELECT sum(b) FROM bucket_t1 WHERE a <= 10;
+DELETE FROM bucket_t1 WHERE a > 900;
+SELECT count(*) FROM bucket_t1;
+DROP TABLE bucket_t1;
+DROP TABLE bucket_t2;
+DROP TABLE bucket_h;
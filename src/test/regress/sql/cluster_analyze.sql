@@ -0,0 +1,20 @@
+--
+-- Coordinator ANALYZE from datanode statistics
+--
+CREATE TABLE cluster_analyze_t (a int, b int, c int) DISTRIBUTE BY HASH (a);
+CREATE TABLE cluster_analyze_empty (a int) DISTRIBUTE BY HASH (a);
+INSERT INTO cluster_analyze_t SELECT i, i % 50, 1 FROM generate_series(1, 10000) i;
+ANALYZE cluster_analyze_t;
+ANALYZE cluster_analyze_empty;
+SELECT relname, reltuples FROM pg_class
+	WHERE relname IN ('cluster_analyze_t', 'cluster_analyze_empty') ORDER BY relname;
+SELECT attname, round(CASE WHEN n_distinct < 0 THEN -n_distinct * 10000 ELSE n_distinct END) AS n_distinct
+	FROM pg_stats WHERE tablename = 'cluster_analyze_t' ORDER BY attname;
+-- half of the rows deleted
+DELETE FROM cluster_analyze_t WHERE a % 2 = 0;
+ANALYZE cluster_analyze_t;
+SELECT reltuples FROM pg_class WHERE relname = 'cluster_analyze_t';
+SELECT attname, round(CASE WHEN n_distinct < 0 THEN -n_distinct * 5000 ELSE n_distinct END) AS n_distinct
+	FROM pg_stats WHERE tablename = 'cluster_analyze_t' ORDER BY attname;
+DROP TABLE cluster_analyze_t;
+DROP TABLE cluster_analyze_empty;
@@ -0,0 +1,25 @@
+--
+-- LIMIT and OFFSET pushed to datanodes
+--
+CREATE TABLE cluster_limit_t (a int, b int) DISTRIBUTE BY HASH (a);
+CREATE TABLE cluster_limit_rep (a int, b int) DISTRIBUTE BY REPLICATION;
+INSERT INTO cluster_limit_t SELECT i, i % 10 FROM generate_series(1, 10000) i;
+INSERT INTO cluster_limit_rep SELECT i, i % 10 FROM generate_series(1, 100) i;
+SET enable_fast_query_shipping = off;
+SELECT a FROM cluster_limit_t ORDER BY a LIMIT 5;
+SELECT a FROM cluster_limit_t ORDER BY a DESC LIMIT 3 OFFSET 2;
+SELECT b, a FROM cluster_limit_t ORDER BY b DESC, a LIMIT 4;
+SELECT a FROM cluster_limit_t ORDER BY a OFFSET 9998;
+SELECT a FROM cluster_limit_t ORDER BY a LIMIT 5 OFFSET 20000;
+SELECT count(*) FROM (SELECT * FROM cluster_limit_t LIMIT 10) s;
+SELECT a FROM cluster_limit_rep ORDER BY a LIMIT 2 OFFSET 50;
+PREPARE cluster_limit_p(int, int) AS
+	SELECT a FROM cluster_limit_t ORDER BY a LIMIT $1 OFFSET $2;
+EXECUTE cluster_limit_p(3, 10);
+EXECUTE cluster_limit_p(2, 0);
+DEALLOCATE cluster_limit_p;
+-- the connections stopped early are usable again
+SELECT count(*), sum(a) FROM cluster_limit_t;
+RESET enable_fast_query_shipping;
+DROP TABLE cluster_limit_t;
+DROP TABLE cluster_limit_rep;
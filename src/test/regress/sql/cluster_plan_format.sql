@@ -0,0 +1,18 @@
+--
+-- Cluster plans referencing the same relation many times
+--
+CREATE TABLE cpf_t (a int PRIMARY KEY, b int) DISTRIBUTE BY HASH (a);
+INSERT INTO cpf_t SELECT i, i % 100 + 1 FROM generate_series(1, 1000) i;
+ANALYZE cpf_t;
+SET enable_cluster_plan = on;
+SELECT count(*), sum(t1.a) FROM cpf_t t1
+	JOIN cpf_t t2 ON t1.a = t2.b
+	JOIN cpf_t t3 ON t2.a = t3.b;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+SELECT b FROM cpf_t WHERE a = 500;
+SELECT count(*), sum(t1.b) FROM cpf_t t1 JOIN cpf_t t2 ON t1.a = t2.a WHERE t1.a <= 10;
+RESET enable_bitmapscan;
+RESET enable_seqscan;
+RESET enable_cluster_plan;
+DROP TABLE cpf_t;
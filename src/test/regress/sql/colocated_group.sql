@@ -0,0 +1,39 @@
+--
+-- Grouping, distinct and window keys equal to a distribution key
+--
+CREATE TABLE colocated_group_a (id int, v int) DISTRIBUTE BY HASH (id);
+CREATE TABLE colocated_group_b (id int, w int) DISTRIBUTE BY HASH (id);
+INSERT INTO colocated_group_a SELECT i % 100 + 1, i FROM generate_series(1, 1000) i;
+INSERT INTO colocated_group_b SELECT i, i FROM generate_series(1, 50) i;
+ANALYZE colocated_group_a;
+ANALYZE colocated_group_b;
+-- number of reduces in a plan
+CREATE FUNCTION colocated_group_reduces(query text) RETURNS bigint AS $$
+DECLARE
+	line text;
+	n bigint := 0;
+BEGIN
+	FOR line IN EXECUTE 'EXPLAIN (COSTS OFF) ' || query LOOP
+		IF line ~ 'Cluster Reduce' THEN
+			n := n + 1;
+		END IF;
+	END LOOP;
+	RETURN n;
+END;
+$$ LANGUAGE plpgsql;
+SET enable_fast_query_shipping = off;
+-- grouped by b.id, distributed by a.id
+SELECT b.id, count(*), sum(a.v) FROM colocated_group_a a JOIN colocated_group_b b ON a.id = b.id
+	GROUP BY b.id ORDER BY b.id LIMIT 3;
+SELECT colocated_group_reduces('SELECT b.id, count(*) FROM colocated_group_a a JOIN colocated_group_b b ON a.id = b.id GROUP BY b.id');
+SELECT count(*) FROM (SELECT DISTINCT b.id FROM colocated_group_a a JOIN colocated_group_b b ON a.id = b.id) s;
+SELECT colocated_group_reduces('SELECT DISTINCT b.id FROM colocated_group_a a JOIN colocated_group_b b ON a.id = b.id');
+SELECT count(*), sum(v) FROM (SELECT a.v, row_number() OVER (PARTITION BY b.id ORDER BY a.v) AS rn
+	FROM colocated_group_a a JOIN colocated_group_b b ON a.id = b.id) s WHERE rn = 1;
+-- the nullable side of an outer join is not a grouping key of the rows
+SELECT count(*), sum(c) FROM (SELECT b.id, count(*) AS c
+	FROM colocated_group_a a LEFT JOIN colocated_group_b b ON a.id = b.id GROUP BY b.id) s;
+RESET enable_fast_query_shipping;
+DROP FUNCTION colocated_group_reduces(text);
+DROP TABLE colocated_group_a;
+DROP TABLE colocated_group_b;
@@ -0,0 +1,53 @@
+--
+-- EXPLAIN (ANALYZE, NODES)
+--
+CREATE TABLE explain_nodes_t1 (a int, b int) DISTRIBUTE BY MODULO (a);
+CREATE TABLE explain_nodes_t2 (a int, b int) DISTRIBUTE BY MODULO (a);
+INSERT INTO explain_nodes_t1 SELECT i, i % 99 FROM generate_series(1, 1000) i;
+INSERT INTO explain_nodes_t2 SELECT i, i FROM generate_series(1, 100) i;
+ANALYZE explain_nodes_t1;
+ANALYZE explain_nodes_t2;
+-- per node lines of EXPLAIN text output, without the numbers
+CREATE FUNCTION explain_node_lines(query text, options text) RETURNS SETOF text AS $$
+DECLARE
+	line text;
+BEGIN
+	FOR line IN EXECUTE 'EXPLAIN (' || options || ') ' || query LOOP
+		line := trim(line);
+		IF line ~ '^(Node|Peer) \w+:' THEN
+			RETURN NEXT substring(line from '^((Node|Peer) \w+):');
+		ELSIF line ~ '^(Memory|Network):' THEN
+			RETURN NEXT substring(line from '^(\w+):');
+		ELSIF line ~ '^Rows Skew:' THEN
+			RETURN NEXT line;
+		END IF;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+-- node names of EXPLAIN JSON output
+CREATE FUNCTION explain_node_names(query text) RETURNS SETOF text AS $$
+DECLARE
+	plan json;
+BEGIN
+	EXECUTE 'EXPLAIN (ANALYZE, NODES, COSTS OFF, TIMING OFF, FORMAT JSON) ' || query INTO plan;
+	RETURN QUERY SELECT DISTINCT m[1] FROM regexp_matches(plan::text, '"Node Name": "(\w+)"', 'g') m;
+END;
+$$ LANGUAGE plpgsql;
+SET enable_fast_query_shipping = off;
+-- per node statistics only with NODES
+SELECT DISTINCT l FROM explain_node_lines('SELECT count(*) FROM explain_nodes_t1',
+	'ANALYZE, COSTS OFF, TIMING OFF') l ORDER BY 1;
+SELECT DISTINCT l FROM explain_node_lines('SELECT count(*) FROM explain_nodes_t1',
+	'ANALYZE, NODES, COSTS OFF, TIMING OFF') l ORDER BY 1;
+-- memory of sorts
+SELECT DISTINCT l FROM explain_node_lines('SELECT * FROM explain_nodes_t1 ORDER BY b',
+	'ANALYZE, NODES, COSTS OFF, TIMING OFF') l ORDER BY 1;
+-- network of reduce
+SELECT DISTINCT l FROM explain_node_lines('SELECT count(*) FROM explain_nodes_t1 t1 JOIN explain_nodes_t2 t2 ON t1.b = t2.a',
+	'ANALYZE, NODES, COSTS OFF, TIMING OFF') l WHERE l NOT LIKE 'Rows Skew%' ORDER BY 1;
+SELECT n FROM explain_node_names('SELECT count(*) FROM explain_nodes_t1 t1 JOIN explain_nodes_t2 t2 ON t1.b = t2.a') n ORDER BY 1;
+RESET enable_fast_query_shipping;
+DROP FUNCTION explain_node_lines(text, text);
+DROP FUNCTION explain_node_names(text);
+DROP TABLE explain_nodes_t1;
+DROP TABLE explain_nodes_t2;
@@ -0,0 +1,15 @@
+--
+-- Gathered rows kept by the plan nodes above ClusterGather
+--
+CREATE TABLE gather_copy_t (a int, t text) DISTRIBUTE BY HASH (a);
+INSERT INTO gather_copy_t SELECT i, md5((i % 100)::text) FROM generate_series(1, 1000) i;
+SET enable_fast_query_shipping = off;
+SELECT count(*), count(DISTINCT t) FROM gather_copy_t;
+SELECT t, count(*) FROM (SELECT t FROM gather_copy_t WHERE a <= 300) s GROUP BY t ORDER BY t LIMIT 3;
+SELECT sum(CASE WHEN t = prev THEN 1 ELSE 0 END)
+	FROM (SELECT t, lag(t) OVER (ORDER BY t, a) AS prev FROM gather_copy_t) s;
+WITH c AS (SELECT a, t FROM gather_copy_t)
+	SELECT count(*) FROM c c1 JOIN c c2 ON c1.t = c2.t AND c1.a < c2.a WHERE c1.a <= 100;
+SELECT count(*) FROM gather_copy_t x WHERE x.t IN (SELECT t FROM gather_copy_t WHERE a <= 5);
+RESET enable_fast_query_shipping;
+DROP TABLE gather_copy_t;
@@ -0,0 +1,64 @@
+--
+-- Routing remote queries by distribution values
+--
+CREATE TABLE locator_mod (a int8, b int2, c text) DISTRIBUTE BY MODULO (a);
+CREATE TABLE locator_hash (k text, v int) DISTRIBUTE BY HASH (k);
+INSERT INTO locator_mod SELECT i - 50, i - 50, i::text FROM generate_series(1, 100) i;
+INSERT INTO locator_hash SELECT 'k' || i, i FROM generate_series(1, 100) i;
+-- rows inserted by value are found by constants and parameters
+SELECT c FROM locator_mod WHERE a = -7;
+SELECT c FROM locator_mod WHERE a = 49;
+PREPARE locator_p(int8) AS SELECT c FROM locator_mod WHERE a = $1;
+EXECUTE locator_p(-49);
+EXECUTE locator_p(-1);
+EXECUTE locator_p(0);
+EXECUTE locator_p(1);
+EXECUTE locator_p(17);
+EXECUTE locator_p(50);
+PREPARE locator_i(int8, int2, text) AS INSERT INTO locator_mod VALUES ($1, $2, $3);
+EXECUTE locator_i(1000, 0, 'n1000');
+EXECUTE locator_i(1001, 1, 'n1001');
+EXECUTE locator_i(1002, 2, 'n1002');
+EXECUTE locator_i(-1003, 3, 'n-1003');
+EXECUTE locator_i(1004, 4, 'n1004');
+EXECUTE locator_i(-1005, 5, 'n-1005');
+EXECUTE locator_p(1001);
+EXECUTE locator_p(-1003);
+SELECT count(*) FROM locator_mod;
+-- each datanode has values of one remainder only
+CREATE FUNCTION locator_remainders() RETURNS TABLE (node name, nremainders bigint) AS $$
+DECLARE
+	nnodes int;
+BEGIN
+	SELECT array_length(nodeoids::oid[], 1) INTO nnodes FROM pgxc_class
+		WHERE pcrelid = 'locator_mod'::regclass;
+	FOR node IN SELECT n.node_name FROM pgxc_node n, pgxc_class c
+		WHERE c.pcrelid = 'locator_mod'::regclass AND n.oid = ANY (c.nodeoids::oid[]) LOOP
+		EXECUTE 'EXECUTE DIRECT ON (' || quote_ident(node) || ') ' ||
+			quote_literal('SELECT count(DISTINCT abs(a % ' || nnodes || ')) FROM locator_mod')
+			INTO nremainders;
+		RETURN NEXT;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+SELECT DISTINCT nremainders FROM locator_remainders();
+PREPARE locator_h(text) AS SELECT v FROM locator_hash WHERE k = $1;
+EXECUTE locator_h('k1');
+EXECUTE locator_h('k2');
+EXECUTE locator_h('k3');
+EXECUTE locator_h('k4');
+EXECUTE locator_h('k5');
+EXECUTE locator_h('k100');
+-- routing follows a new distribution
+ALTER TABLE locator_mod DISTRIBUTE BY HASH (a);
+EXECUTE locator_p(-1);
+EXECUTE locator_p(1004);
+EXECUTE locator_i(2000, 0, 'n2000');
+EXECUTE locator_p(2000);
+SELECT count(*) FROM locator_mod;
+DEALLOCATE locator_p;
+DEALLOCATE locator_i;
+DEALLOCATE locator_h;
+DROP FUNCTION locator_remainders();
+DROP TABLE locator_mod;
+DROP TABLE locator_hash;
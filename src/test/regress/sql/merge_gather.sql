@@ -0,0 +1,18 @@
+--
+-- Ordered results merged from datanodes
+--
+CREATE TABLE merge_gather_t (a int, b text, c int) DISTRIBUTE BY HASH (a);
+INSERT INTO merge_gather_t SELECT i, 'key' || (i % 7), i % 3 FROM generate_series(1, 21) i;
+INSERT INTO merge_gather_t VALUES (22, NULL, NULL);
+CREATE TABLE merge_gather_big (a int, b text) DISTRIBUTE BY HASH (a);
+INSERT INTO merge_gather_big SELECT i, md5(i::text) FROM generate_series(1, 5000) i;
+SET enable_fast_query_shipping = off;
+SELECT b, a FROM merge_gather_t ORDER BY b, a;
+SELECT c, a FROM merge_gather_t ORDER BY c DESC, a;
+-- more rows than fetched from a datanode at once
+SELECT count(*), md5(string_agg(a::text, ',')) FROM (SELECT a FROM merge_gather_big ORDER BY b) s;
+SELECT count(*), md5(string_agg(a::text, ',')) FROM (SELECT a FROM merge_gather_big ORDER BY b DESC) s;
+SELECT count(*), md5(string_agg(a::text, ',')) FROM (SELECT a FROM merge_gather_big ORDER BY a % 10, a DESC) s;
+RESET enable_fast_query_shipping;
+DROP TABLE merge_gather_t;
+DROP TABLE merge_gather_big;
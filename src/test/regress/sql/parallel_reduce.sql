@@ -0,0 +1,28 @@
+--
+-- ClusterReduce in datanode parallel workers
+--
+CREATE TABLE parallel_reduce_t1 (a int, b int) DISTRIBUTE BY HASH (a);
+CREATE TABLE parallel_reduce_t2 (a int, b int) DISTRIBUTE BY HASH (a);
+INSERT INTO parallel_reduce_t1 SELECT i, i % 100 FROM generate_series(1, 20000) i;
+INSERT INTO parallel_reduce_t2 SELECT i, i FROM generate_series(1, 100) i;
+ANALYZE parallel_reduce_t1;
+ANALYZE parallel_reduce_t2;
+SET enable_fast_query_shipping = off;
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_relation_size = 0;
+SET max_parallel_workers_per_gather = 2;
+SELECT count(*), sum(t1.a) FROM parallel_reduce_t1 t1 JOIN parallel_reduce_t2 t2 ON t1.b = t2.a;
+SELECT count(*), sum(c) FROM (SELECT b, count(*) AS c FROM parallel_reduce_t1 GROUP BY b) s;
+SELECT b, count(*), sum(a) FROM parallel_reduce_t1 GROUP BY b ORDER BY b LIMIT 3;
+SET enable_parallel_reduce = off;
+SELECT count(*), sum(t1.a) FROM parallel_reduce_t1 t1 JOIN parallel_reduce_t2 t2 ON t1.b = t2.a;
+SELECT count(*), sum(c) FROM (SELECT b, count(*) AS c FROM parallel_reduce_t1 GROUP BY b) s;
+RESET enable_parallel_reduce;
+RESET max_parallel_workers_per_gather;
+RESET min_parallel_relation_size;
+RESET parallel_tuple_cost;
+RESET parallel_setup_cost;
+RESET enable_fast_query_shipping;
+DROP TABLE parallel_reduce_t1;
+DROP TABLE parallel_reduce_t2;
@@ -0,0 +1,39 @@
+--
+-- Pipelined single-row remote inserts
+--
+SET pipeline_remote_insert = on;
+CREATE TABLE pipeline_insert (a int PRIMARY KEY, b int) DISTRIBUTE BY HASH (a);
+BEGIN;
+INSERT INTO pipeline_insert VALUES (1, 1);
+INSERT INTO pipeline_insert VALUES (2, 2);
+INSERT INTO pipeline_insert VALUES (3, 3);
+COMMIT;
+SELECT * FROM pipeline_insert ORDER BY a;
+-- an INSERT failing on a datanode, then ROLLBACK
+BEGIN;
+INSERT INTO pipeline_insert VALUES (4, 4);
+INSERT INTO pipeline_insert VALUES (1, 5);
+ROLLBACK;
+SELECT * FROM pipeline_insert ORDER BY a;
+-- an INSERT failing on a datanode, then COMMIT
+BEGIN;
+INSERT INTO pipeline_insert VALUES (5, 5);
+INSERT INTO pipeline_insert VALUES (2, 6);
+COMMIT;
+SELECT * FROM pipeline_insert ORDER BY a;
+-- inserts run by a function are reported by the calling statement
+DO $$
+BEGIN
+  FOR i IN 5..7 LOOP
+    INSERT INTO pipeline_insert VALUES (i, i);
+  END LOOP;
+  INSERT INTO pipeline_insert VALUES (3, 8);
+END$$;
+SELECT * FROM pipeline_insert ORDER BY a;
+-- the session is usable again
+BEGIN;
+INSERT INTO pipeline_insert VALUES (4, 4);
+COMMIT;
+SELECT * FROM pipeline_insert ORDER BY a;
+DROP TABLE pipeline_insert;
+RESET pipeline_remote_insert;
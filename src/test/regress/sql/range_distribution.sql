@@ -0,0 +1,62 @@
+--
+-- DISTRIBUTE BY RANGE
+--
+CREATE TABLE range_t (a int, b int) DISTRIBUTE BY RANGE (a, dn1, 100, dn2);
+CREATE TABLE range_t2 (a int, b int) DISTRIBUTE BY RANGE (a, dn1, 100, dn2);
+INSERT INTO range_t SELECT i, i % 10 FROM generate_series(1, 300) i;
+INSERT INTO range_t VALUES (NULL, 0);
+INSERT INTO range_t2 SELECT i, i % 10 FROM generate_series(1, 300) i;
+SELECT count(*), sum(a) FROM range_t;
+-- rows on each datanode of range_t
+CREATE FUNCTION range_node_rows() RETURNS TABLE (node name, nrows bigint, min_a int, max_a int) AS $$
+BEGIN
+	FOR node IN SELECT n.node_name FROM pgxc_node n, pgxc_class c
+		WHERE c.pcrelid = 'range_t'::regclass AND n.oid = ANY (c.nodeoids::oid[])
+		ORDER BY n.node_name LOOP
+		EXECUTE 'EXECUTE DIRECT ON (' || quote_ident(node) || ') ' ||
+			quote_literal('SELECT count(*), min(a), max(a) FROM range_t') INTO nrows, min_a, max_a;
+		RETURN NEXT;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+-- a bound belongs to the range above it, NULL to the first range
+SELECT * FROM range_node_rows();
+SELECT count(*) FROM range_t WHERE a IS NULL;
+SELECT count(*), min(a), max(a) FROM range_t WHERE a >= 100 AND a < 200;
+-- joins on the range key stay co-located
+SELECT count(*), sum(r1.b + r2.b) FROM range_t r1 JOIN range_t2 r2 ON r1.a = r2.a;
+-- datanodes scanned by a cluster plan
+CREATE FUNCTION range_scan_nodes(query text) RETURNS SETOF text AS $$
+DECLARE
+	line text;
+BEGIN
+	FOR line IN EXECUTE 'EXPLAIN (VERBOSE, COSTS OFF) ' || query LOOP
+		IF line ~ 'Remote node: ' THEN
+			RETURN QUERY SELECT node_name::text FROM pgxc_node
+				WHERE oid::text = ANY (string_to_array(substring(line from 'Remote node: ([0-9,]+)'), ','));
+		END IF;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+SET enable_fast_query_shipping = off;
+SELECT DISTINCT n FROM range_scan_nodes('SELECT * FROM range_t WHERE a < 50') n ORDER BY 1;
+SELECT DISTINCT n FROM range_scan_nodes('SELECT * FROM range_t WHERE a >= 150') n ORDER BY 1;
+SELECT DISTINCT n FROM range_scan_nodes('SELECT * FROM range_t WHERE a BETWEEN 50 AND 150') n ORDER BY 1;
+-- split the upper range, new range on dn1
+ALTER TABLE range_t DISTRIBUTE BY RANGE (a, dn1, 100, dn2, 200, dn1);
+SELECT count(*), sum(a) FROM range_t;
+SELECT * FROM range_node_rows();
+SELECT DISTINCT n FROM range_scan_nodes('SELECT * FROM range_t WHERE a >= 250') n ORDER BY 1;
+SELECT DISTINCT n FROM range_scan_nodes('SELECT * FROM range_t WHERE a >= 150 AND a < 200') n ORDER BY 1;
+-- merge the two lower ranges
+ALTER TABLE range_t DISTRIBUTE BY RANGE (a, dn1, 200, dn2);
+SELECT count(*), sum(a) FROM range_t;
+SELECT * FROM range_node_rows();
+SELECT DISTINCT n FROM range_scan_nodes('SELECT * FROM range_t WHERE a < 150') n ORDER BY 1;
+RESET enable_fast_query_shipping;
+-- each range needs a node when nodes are given
+CREATE TABLE range_bad (a int) DISTRIBUTE BY RANGE (a, dn1, 100);
+DROP FUNCTION range_node_rows();
+DROP FUNCTION range_scan_nodes(text);
+DROP TABLE range_t;
+DROP TABLE range_t2;
@@ -0,0 +1,24 @@
+--
+-- Redistribution of a table and pg_stat_progress_redistribute
+--
+CREATE TABLE redistrib_t (a int, b int) DISTRIBUTE BY HASH (a);
+INSERT INTO redistrib_t SELECT i, i % 10 FROM generate_series(1, 1000) i;
+SELECT count(*) FROM pg_stat_progress_redistribute WHERE pid = pg_backend_pid();
+ALTER TABLE redistrib_t DISTRIBUTE BY BUCKET (a);
+SELECT count(*), sum(a), sum(b) FROM redistrib_t;
+ALTER TABLE redistrib_t DISTRIBUTE BY REPLICATION;
+SELECT count(*), sum(a), sum(b) FROM redistrib_t;
+-- the final lock is kept until end of transaction
+BEGIN;
+ALTER TABLE redistrib_t DISTRIBUTE BY HASH (a);
+SELECT mode FROM pg_locks WHERE locktype = 'relation' AND relation = 'redistrib_t'::regclass
+	AND pid = pg_backend_pid() AND mode = 'AccessExclusiveLock';
+COMMIT;
+SELECT count(*), sum(a), sum(b) FROM redistrib_t;
+SELECT count(*) FROM pg_stat_progress_redistribute WHERE pid = pg_backend_pid();
+-- bucket data moved one bucket at a time
+SET redistrib_bucket_batch_size = 1;
+ALTER TABLE redistrib_t DISTRIBUTE BY BUCKET (a);
+SELECT count(*), sum(a), sum(b) FROM redistrib_t;
+RESET redistrib_bucket_batch_size;
+DROP TABLE redistrib_t;
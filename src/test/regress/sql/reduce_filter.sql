@@ -0,0 +1,27 @@
+--
+-- Runtime bloom filter of cluster HashJoin on its outer ClusterReduce
+--
+CREATE TABLE reduce_filter_big (a int, b int) DISTRIBUTE BY HASH (a);
+CREATE TABLE reduce_filter_small (a int, b int) DISTRIBUTE BY HASH (a);
+INSERT INTO reduce_filter_big SELECT i, i % 1000 FROM generate_series(1, 10000) i;
+INSERT INTO reduce_filter_small SELECT i, i FROM generate_series(1, 20) i;
+ANALYZE reduce_filter_big;
+ANALYZE reduce_filter_small;
+SET enable_cluster_plan = on;
+SET enable_reduce_filter = on;
+SET enable_nestloop = off;
+SET enable_mergejoin = off;
+SELECT count(*), sum(b.a) FROM reduce_filter_big b JOIN reduce_filter_small s ON b.b = s.b;
+SELECT count(*) FROM reduce_filter_big b WHERE b.b IN (SELECT s.b FROM reduce_filter_small s);
+-- filter must not exceed work_mem
+SET work_mem = '64kB';
+SELECT count(*), sum(b.a) FROM reduce_filter_big b JOIN reduce_filter_small s ON b.b = s.b;
+RESET work_mem;
+SET enable_reduce_filter = off;
+SELECT count(*), sum(b.a) FROM reduce_filter_big b JOIN reduce_filter_small s ON b.b = s.b;
+RESET enable_reduce_filter;
+RESET enable_mergejoin;
+RESET enable_nestloop;
+RESET enable_cluster_plan;
+DROP TABLE reduce_filter_big;
+DROP TABLE reduce_filter_small;
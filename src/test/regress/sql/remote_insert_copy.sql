@@ -0,0 +1,38 @@
+--
+-- Multi-row remote INSERT sent by COPY
+--
+CREATE TABLE insert_copy (a int, b text, c text DEFAULT 'x') DISTRIBUTE BY HASH (a);
+CREATE TABLE insert_copy_rep (a int, b text) DISTRIBUTE BY REPLICATION;
+-- values needing escapes in COPY text format
+INSERT INTO insert_copy (a, b) VALUES (1, 'a'), (2, E'tab\there'), (3, E'back\\slash'),
+	(4, NULL), (5, ''), (6, E'new\nline');
+SELECT a, b IS NULL AS isnull, length(b),
+	replace(replace(replace(b, E'\t', '<t>'), E'\n', '<n>'), E'\\', '<b>'), c
+	FROM insert_copy ORDER BY a;
+INSERT INTO insert_copy SELECT i, i::text FROM generate_series(100, 1099) i;
+SELECT count(*), sum(a), sum(length(b)), count(c) FROM insert_copy;
+-- every node gets the rows of a replicated table
+INSERT INTO insert_copy_rep VALUES (1, 'a'), (2, 'b'), (3, 'c');
+CREATE FUNCTION insert_copy_node_rows() RETURNS TABLE (node name, nrows bigint, total bigint) AS $$
+BEGIN
+	FOR node IN SELECT n.node_name FROM pgxc_node n, pgxc_class c
+		WHERE c.pcrelid = 'insert_copy_rep'::regclass AND n.oid = ANY (c.nodeoids::oid[]) LOOP
+		EXECUTE 'EXECUTE DIRECT ON (' || quote_ident(node) || ') ' ||
+			quote_literal('SELECT count(*), sum(a) FROM insert_copy_rep') INTO nrows, total;
+		RETURN NEXT;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+SELECT DISTINCT nrows, total FROM insert_copy_node_rows();
+-- rolled back with the transaction
+BEGIN;
+INSERT INTO insert_copy (a, b) VALUES (7, 'g'), (8, 'h');
+ROLLBACK;
+SELECT count(*), sum(a) FROM insert_copy;
+SET enable_remote_insert_copy = off;
+INSERT INTO insert_copy (a, b) VALUES (7, 'g'), (8, 'h');
+SELECT count(*), sum(a) FROM insert_copy;
+RESET enable_remote_insert_copy;
+DROP FUNCTION insert_copy_node_rows();
+DROP TABLE insert_copy;
+DROP TABLE insert_copy_rep;
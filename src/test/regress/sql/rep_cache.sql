@@ -0,0 +1,61 @@
+--
+-- Coordinator cache of replicated table results
+--
+CREATE TABLE rep_cache_t (id int, name text) WITH (coordinator_cache = true) DISTRIBUTE BY REPLICATION;
+CREATE TABLE rep_cache_fact (id int, rid int) DISTRIBUTE BY HASH (id);
+INSERT INTO rep_cache_t VALUES (1, 'a'), (2, 'b'), (3, 'c');
+INSERT INTO rep_cache_fact SELECT i, i % 3 + 1 FROM generate_series(1, 30) i;
+SET rep_cache_size = '1MB';
+-- cache hits and invalidation shown by EXPLAIN ANALYZE
+CREATE FUNCTION rep_cache_explain(query text) RETURNS SETOF text AS $$
+DECLARE
+	line text;
+BEGIN
+	FOR line IN EXECUTE 'EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF) ' || query LOOP
+		IF line ~ 'Coordinator Cache' THEN
+			RETURN NEXT trim(line);
+		END IF;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+SELECT rep_cache_explain('SELECT name FROM rep_cache_t WHERE id = 1');
+SELECT rep_cache_explain('SELECT name FROM rep_cache_t WHERE id = 1');
+UPDATE rep_cache_t SET name = name WHERE id = 1;
+SELECT rep_cache_explain('SELECT name FROM rep_cache_t WHERE id = 1');
+SELECT rep_cache_explain('SELECT name FROM rep_cache_t WHERE id = 1');
+SELECT name FROM rep_cache_t WHERE id = 2;
+SELECT name FROM rep_cache_t WHERE id = 2;
+UPDATE rep_cache_t SET name = 'B' WHERE id = 2;
+SELECT name FROM rep_cache_t WHERE id = 2;
+-- not cached after the transaction changed the table
+BEGIN;
+UPDATE rep_cache_t SET name = 'bb' WHERE id = 2;
+SELECT name FROM rep_cache_t WHERE id = 2;
+ROLLBACK;
+SELECT name FROM rep_cache_t WHERE id = 2;
+-- other coordinators drop their results too
+CREATE FUNCTION rep_cache_on_others(query text) RETURNS SETOF text AS $$
+DECLARE
+	node name;
+	result text;
+BEGIN
+	FOR node IN SELECT node_name FROM pgxc_node
+		WHERE node_type = 'C' AND node_name <> pgxc_node_str() LOOP
+		FOR result IN EXECUTE 'EXECUTE DIRECT ON (' || quote_ident(node) || ') ' || quote_literal(query) LOOP
+			RETURN NEXT result;
+		END LOOP;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+SELECT DISTINCT name FROM rep_cache_on_others('SELECT name FROM rep_cache_t WHERE id = 2') name;
+UPDATE rep_cache_t SET name = 'b2' WHERE id = 2;
+SELECT DISTINCT name FROM rep_cache_on_others('SELECT name FROM rep_cache_t WHERE id = 2') name;
+-- cached table as join input
+SELECT r.name, count(*) FROM rep_cache_fact f JOIN rep_cache_t r ON f.rid = r.id GROUP BY 1 ORDER BY 1;
+DELETE FROM rep_cache_t WHERE id = 3;
+SELECT r.name, count(*) FROM rep_cache_fact f JOIN rep_cache_t r ON f.rid = r.id GROUP BY 1 ORDER BY 1;
+RESET rep_cache_size;
+DROP FUNCTION rep_cache_on_others(text);
+DROP FUNCTION rep_cache_explain(text);
+DROP TABLE rep_cache_t;
+DROP TABLE rep_cache_fact;
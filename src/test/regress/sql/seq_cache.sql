@@ -0,0 +1,17 @@
+--
+-- Coordinator range cache of sequence values
+--
+-- CACHE 1 sequences are never cached, values keep increasing
+CREATE SEQUENCE seq_cache_one;
+SELECT nextval('seq_cache_one'), nextval('seq_cache_one'), nextval('seq_cache_one');
+-- setval and ALTER discard cached values
+CREATE SEQUENCE seq_cache_ten CACHE 10;
+SELECT nextval('seq_cache_ten');
+SELECT setval('seq_cache_ten', 100);
+SELECT nextval('seq_cache_ten');
+ALTER SEQUENCE seq_cache_ten RESTART WITH 500;
+SELECT nextval('seq_cache_ten');
+-- values taken across several ranges
+SELECT count(DISTINCT v), min(v), max(v) FROM (SELECT nextval('seq_cache_ten') AS v FROM generate_series(1, 25)) s;
+DROP SEQUENCE seq_cache_one;
+DROP SEQUENCE seq_cache_ten;
@@ -0,0 +1,36 @@
+--
+-- Joins reducing a skewed key
+--
+CREATE TABLE skew_a (id int, k int) DISTRIBUTE BY HASH (id);
+CREATE TABLE skew_b (id int, k int) DISTRIBUTE BY HASH (id);
+-- half of skew_a has k = 1
+INSERT INTO skew_a SELECT i, CASE WHEN i % 2 = 0 THEN 1 ELSE i END FROM generate_series(1, 2000) i;
+INSERT INTO skew_b SELECT i, i FROM generate_series(1, 200) i;
+ANALYZE skew_a;
+ANALYZE skew_b;
+SET enable_cluster_plan = on;
+-- reduces of a plan, whether rows of hot values are spread or broadcast
+CREATE FUNCTION skew_reduce_kinds(query text) RETURNS SETOF text AS $$
+DECLARE
+	line text;
+BEGIN
+	FOR line IN EXECUTE 'EXPLAIN (VERBOSE, COSTS OFF) ' || query LOOP
+		IF line ~ '^\s*Reduce: ' THEN
+			RETURN NEXT CASE WHEN line ~ 'THEN \{' THEN 'skew spread'
+							 WHEN line ~ 'THEN \[' THEN 'skew broadcast'
+							 ELSE 'no skew' END;
+		END IF;
+	END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+SELECT DISTINCT k FROM skew_reduce_kinds('SELECT a.id, b.id FROM skew_a a JOIN skew_b b ON a.k = b.k') k ORDER BY 1;
+SELECT count(*), sum(a.id) FROM skew_a a JOIN skew_b b ON a.k = b.k;
+SELECT count(*) FROM skew_b b LEFT JOIN skew_a a ON a.k = b.k;
+SET enable_skew_reduce = off;
+SELECT DISTINCT k FROM skew_reduce_kinds('SELECT a.id, b.id FROM skew_a a JOIN skew_b b ON a.k = b.k') k ORDER BY 1;
+SELECT count(*), sum(a.id) FROM skew_a a JOIN skew_b b ON a.k = b.k;
+RESET enable_skew_reduce;
+RESET enable_cluster_plan;
+DROP FUNCTION skew_reduce_kinds(text);
+DROP TABLE skew_a;
+DROP TABLE skew_b;
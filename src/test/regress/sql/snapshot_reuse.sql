@@ -0,0 +1,27 @@
+--
+-- AGTM snapshot reused while no transaction ended
+--
+CREATE TABLE snapshot_reuse_t (a int) DISTRIBUTE BY HASH (a);
+INSERT INTO snapshot_reuse_t SELECT generate_series(1, 10);
+SELECT count(*) FROM snapshot_reuse_t;
+SELECT count(*) FROM snapshot_reuse_t;
+-- a committed transaction makes a new snapshot
+INSERT INTO snapshot_reuse_t SELECT generate_series(11, 15);
+SELECT count(*) FROM snapshot_reuse_t;
+BEGIN;
+INSERT INTO snapshot_reuse_t SELECT generate_series(16, 20);
+SELECT count(*) FROM snapshot_reuse_t;
+SELECT count(*) FROM snapshot_reuse_t;
+ROLLBACK;
+SELECT count(*) FROM snapshot_reuse_t;
+BEGIN ISOLATION LEVEL REPEATABLE READ;
+SELECT count(*) FROM snapshot_reuse_t;
+SELECT count(*) FROM snapshot_reuse_t;
+COMMIT;
+SET reuse_global_snapshot = off;
+SELECT count(*) FROM snapshot_reuse_t;
+DELETE FROM snapshot_reuse_t WHERE a > 10;
+SELECT count(*) FROM snapshot_reuse_t;
+RESET reuse_global_snapshot;
+SELECT count(*) FROM snapshot_reuse_t;
+DROP TABLE snapshot_reuse_t;
@@ -0,0 +1,28 @@
+--
+-- Global snapshot xids sent to datanodes only when changed
+--
+CREATE TABLE snapshot_xids_t (a int, b int) DISTRIBUTE BY HASH (a);
+-- a prepared transaction stays in the xids of later snapshots
+BEGIN;
+INSERT INTO snapshot_xids_t SELECT generate_series(1, 10), 0;
+PREPARE TRANSACTION 'snapshot_xids_1';
+SELECT count(*) FROM snapshot_xids_t;
+SELECT count(*) FROM snapshot_xids_t;
+INSERT INTO snapshot_xids_t SELECT generate_series(11, 15), 0;
+SELECT count(*) FROM snapshot_xids_t;
+COMMIT PREPARED 'snapshot_xids_1';
+SELECT count(*) FROM snapshot_xids_t;
+SELECT count(*) FROM snapshot_xids_t;
+BEGIN;
+DELETE FROM snapshot_xids_t WHERE a <= 5;
+PREPARE TRANSACTION 'snapshot_xids_2';
+SELECT count(*) FROM snapshot_xids_t;
+-- read committed statements of one transaction
+BEGIN;
+SELECT count(*) FROM snapshot_xids_t;
+UPDATE snapshot_xids_t SET b = 1 WHERE a > 10;
+SELECT count(*), sum(b) FROM snapshot_xids_t;
+COMMIT;
+ROLLBACK PREPARED 'snapshot_xids_2';
+SELECT count(*), sum(b) FROM snapshot_xids_t;
+DROP TABLE snapshot_xids_t;
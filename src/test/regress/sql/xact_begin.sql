@@ -0,0 +1,36 @@
+--
+-- Remote transactions begun on many nodes at once
+--
+CREATE TABLE xact_begin_t (a int PRIMARY KEY, b int) DISTRIBUTE BY HASH (a);
+CREATE TABLE xact_begin_rep (a int, b int) DISTRIBUTE BY REPLICATION;
+INSERT INTO xact_begin_rep VALUES (1, 0);
+BEGIN;
+INSERT INTO xact_begin_t SELECT generate_series(1, 100), 0;
+UPDATE xact_begin_rep SET b = b + 1;
+SELECT count(*), sum(b) FROM xact_begin_t;
+COMMIT;
+SELECT count(*), sum(b) FROM xact_begin_t;
+SELECT b FROM xact_begin_rep;
+-- an error on one node rolls back all of them
+BEGIN;
+UPDATE xact_begin_t SET b = 1;
+UPDATE xact_begin_rep SET b = b + 1;
+INSERT INTO xact_begin_t VALUES (1, 1);
+ROLLBACK;
+SELECT count(*), sum(b) FROM xact_begin_t;
+SELECT b FROM xact_begin_rep;
+-- DDL and DML in one transaction
+BEGIN;
+CREATE TABLE xact_begin_t2 (a int) DISTRIBUTE BY HASH (a);
+INSERT INTO xact_begin_t2 SELECT generate_series(1, 10);
+SELECT count(*) FROM xact_begin_t2;
+ROLLBACK;
+SELECT count(*) FROM pg_class WHERE relname = 'xact_begin_t2';
+BEGIN;
+DELETE FROM xact_begin_t WHERE a > 50;
+UPDATE xact_begin_rep SET b = 10;
+COMMIT;
+SELECT count(*), sum(a) FROM xact_begin_t;
+SELECT b FROM xact_begin_rep;
+DROP TABLE xact_begin_t;
+DROP TABLE xact_begin_rep;
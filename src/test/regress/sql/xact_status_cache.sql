@@ -0,0 +1,21 @@
+--
+-- Global transaction status resolved through the shared cache
+--
+CREATE TABLE xact_status_t (a int, b int) DISTRIBUTE BY HASH (a);
+INSERT INTO xact_status_t SELECT i, 0 FROM generate_series(1, 100) i;
+BEGIN;
+UPDATE xact_status_t SET b = 1 WHERE a <= 50;
+ROLLBACK;
+BEGIN;
+UPDATE xact_status_t SET b = 2 WHERE a > 50;
+SAVEPOINT s1;
+UPDATE xact_status_t SET b = 3 WHERE a > 90;
+ROLLBACK TO SAVEPOINT s1;
+UPDATE xact_status_t SET b = 4 WHERE a > 95;
+COMMIT;
+SELECT b, count(*) FROM xact_status_t GROUP BY b ORDER BY b;
+-- the same rows read again, statuses from the cache
+SELECT b, count(*) FROM xact_status_t GROUP BY b ORDER BY b;
+DELETE FROM xact_status_t WHERE b = 0;
+SELECT b, count(*) FROM xact_status_t GROUP BY b ORDER BY b;
+DROP TABLE xact_status_t;